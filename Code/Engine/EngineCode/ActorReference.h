@@ -3,7 +3,7 @@
 
 #include "PreCompiled.h"
 #include "ActorController.h"
-#include "SharedPointer.h"
+#include "ActorTable.h"
 
 namespace Engine
 {
@@ -15,14 +15,13 @@ namespace Engine
 	public:
 		IActorControllerWithReference(unsigned int i_UpdateFrequency) :
 			m_UpdateFrequency(i_UpdateFrequency),
-			m_TicksSinceUpdate(0),
-			m_pOtherActor(NULL)
+			m_TicksSinceUpdate(0)
 		{
 		}
 
 		~IActorControllerWithReference(){}
 		
-		void SetOtherActorReference(const SharedPointer<Actor> & i_pOtherActor) { m_pOtherActor = i_pOtherActor; }
+		void SetOtherActorReference(const ActorHandle & i_OtherActor) { m_OtherActor = i_OtherActor; }
 
 		virtual void UpdateActor(Actor &i_Actor, const float i_DeltaTime) = 0;
 
@@ -30,7 +29,7 @@ namespace Engine
 		unsigned int 			m_TicksSinceUpdate;
 		unsigned int			m_UpdateFrequency;
 
-		SharedPointer<Actor>	m_pOtherActor;
+		ActorHandle				m_OtherActor;		//Does not keep the other actor alive
 	};
 
 }
@@ -13,7 +13,7 @@ namespace Engine
 
 	CameraSystem * CameraSystem ::mInstance = NULL;
 
-	CameraSystem::CameraSystem(SharedPointer<Actor> &i_WorldObject,
+	CameraSystem::CameraSystem(const ActorHandle &i_WorldObject,
 		const unsigned int i_windowWidth,
 		const unsigned int i_windowHeight,
 		const float i_YFOV, 
@@ -33,6 +33,15 @@ namespace Engine
 		m_LookAt = i_LookAt.GetAsD3DXVECTOR3();
 		m_Up = i_Up.GetAsD3DXVECTOR3();
 
+		Actor *pActor = ActorTable::GetInstance()->Resolve(i_WorldObject);
+		assert(pActor);
+
+		m_Position = pActor->GetPosition();
+		m_StepPosition = m_Position;
+		m_PreviousStepPosition = m_Position;
+		m_StepLookAt = m_LookAt;
+		m_PreviousStepLookAt = m_LookAt;
+
 		if (!CreateViewToScreen(m_YFOV, m_ZNear, m_ZFar))
 		{
 			assert(false);
@@ -43,17 +52,70 @@ namespace Engine
 
 	CameraSystem::~CameraSystem()
 	{
-
+		//The camera actor lives as long as the camera
+		ActorTable::GetInstance()->DestroyActor(m_WorldObject);
 	}
 
 	void CameraSystem::Update(float i_deltaTime)
 	{
-		if (!CreateWorldToView(m_WorldObject->GetPosition().GetAsD3DXVECTOR3(), m_LookAt, m_Up))
+		Actor *pActor = GetActor();
+		assert(pActor);
+
+		//The view is built when drawing, between this step and the one before
+		m_PreviousStepPosition = m_StepPosition;
+		m_PreviousStepLookAt = m_StepLookAt;
+		m_StepPosition = pActor->GetPosition();
+		m_StepLookAt = m_LookAt;
+
+		pActor->Update(i_deltaTime);
+	}
+
+	/******************************************************************************
+		Function     : Interpolate
+		Description  : Builds the view from where the camera was between the
+					last two steps, the render list is blended the same way
+		Input        : const float i_fInterpolation, 0 at the step before the
+					last one, 1 at the last one
+		Output       : 
+		Return Value : 
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void CameraSystem::Interpolate(const float i_fInterpolation)
+	{
+		m_Position = m_PreviousStepPosition + ((m_StepPosition - m_PreviousStepPosition) * i_fInterpolation);
+
+		const D3DXVECTOR3 LookAt = m_PreviousStepLookAt + ((m_StepLookAt - m_PreviousStepLookAt) * i_fInterpolation);
+
+		if (!CreateWorldToView(m_Position.GetAsD3DXVECTOR3(), LookAt, m_Up))
 		{
 			assert(false);
 		}
+	}
 
-		m_WorldObject->Update(i_deltaTime);
+	void CameraSystem::UpdateTask(const sFrameTime &i_Time)
+	{
+		GetInstance()->Update(i_Time.m_fDeltaTime);
+	}
+
+	/******************************************************************************
+		Function     : AddFrameTasks
+		Description  : Adds the camera update to the frame graph, it keeps where
+					the camera actor was each step and moves it after the player
+		Input        : FrameGraph &io_Graph
+		Output       : 
+		Return Value : 
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void CameraSystem::AddFrameTasks(FrameGraph &io_Graph)
+	{
+		io_Graph.AddTask("Camera", &CameraSystem::UpdateTask, io_Graph.GetResource("Entities"),
+						 io_Graph.GetResource("Actors") | io_Graph.GetResource("Camera"));
 	}
 
 	bool CameraSystem::CreateViewToScreen(const float i_YFOV, const float i_ZNear, const float i_ZFar)
@@ -118,7 +180,7 @@ namespace Engine
 		return m_LookAt;
 	}
 
-	bool CameraSystem::CreateInstance(SharedPointer<Actor> &iNewActor,
+	bool CameraSystem::CreateInstance(const ActorHandle &iNewActor,
 									const unsigned int i_windowWidth,
 									const unsigned int i_windowHeight,
 									const float i_YFOV, const float i_ZNear,
@@ -4,7 +4,7 @@
 #include "PreCompiled.h"
 #include <d3dx9math.h>
 #include "Actor.h"
-#include "SharedPointer.h"
+#include "FrameGraph.h"
 
 namespace Engine
 {
@@ -12,7 +12,7 @@ namespace Engine
 	{
 	private:
 		float				mRotation;
-		CameraSystem(SharedPointer<Actor> &i_WorldObject,
+		CameraSystem(const ActorHandle &i_WorldObject,
 			const unsigned int i_windowWidth,
 			const unsigned int i_windowHeight,
 			const float i_YFOV,
@@ -29,6 +29,7 @@ namespace Engine
 		bool CreateWorldToView(const D3DXVECTOR3 & i_Eye,
 								const D3DXVECTOR3 & i_LookAt,
 								const D3DXVECTOR3 & i_Up);
+		static void UpdateTask(const sFrameTime &i_Time);
 
 		static D3DXVECTOR3 mLookAt, mUp;
 		static D3DXMATRIXA16 s_worldToView; //View matrix
@@ -43,14 +44,28 @@ namespace Engine
 		float m_ZFar;
 		D3DXVECTOR3 m_LookAt;
 		D3DXVECTOR3 m_Up;
+		Vector3 m_Position;		//The view was built from here, rendering reads this and not the actor
+		Vector3 m_StepPosition;			//Camera actor at the last simulation step
+		Vector3 m_PreviousStepPosition;
+		D3DXVECTOR3 m_StepLookAt;
+		D3DXVECTOR3 m_PreviousStepLookAt;
 	public:
-		SharedPointer<Actor> m_WorldObject;
+		ActorHandle m_WorldObject;
+
+		//NULL once the actor is destroyed
+		inline Actor *GetActor(void) const
+		{
+			return ActorTable::GetInstance()->Resolve(m_WorldObject);
+		}
+
 		void Update(float i_deltaTime);
+		void Interpolate(const float i_fInterpolation);
 		const D3DXMATRIXA16 GetWorldToView() const;
 		const D3DXMATRIXA16 GetViewToScreen() const;
 		void SetLookAt(const D3DXVECTOR3 &i_LookAt);
 		D3DXVECTOR3 GetLookAt() const;
-		static bool CreateInstance(SharedPointer<Actor> &iNewActor, 
+		inline Vector3 GetPosition() const { return m_Position; }
+		static bool CreateInstance(const ActorHandle &iNewActor, 
 			const unsigned int i_windowWidth,
 			const unsigned int i_windowHeight,
 			const float i_YFOV, const float i_ZNear,
@@ -60,6 +75,7 @@ namespace Engine
 		
 		static CameraSystem * GetInstance();
 		static void Destroy();
+		static void AddFrameTasks(FrameGraph &io_Graph);
 	} ;
 }
 #endif //__CAMERA_SYSTEM_H
\ No newline at end of file
@@ -1,6 +1,8 @@
 
 #include "PreCompiled.h"
 
+#include <algorithm>
+
 #include "CollisionSystem.h"
 #include "Actor.h"
 #include "Vector4.h"
@@ -9,18 +11,20 @@
 #include "Debug.h"
 #include "PhysicsSystem.h"
 #include "Profiling.h"
+#include "JobSystem.h"
 
 
 namespace Engine
 {
-	unsigned int CollisionSystem::MAX_COLLIDABLE_OBJECTS = 100;
+	unsigned int CollisionSystem::COLLIDABLE_OBJECTS_PER_CHUNK = 64;
 	CollisionSystem * CollisionSystem::mInstance = NULL;
-	MemoryPool *CollisionObject::CollisionMemoryPool = NULL;
+	ObjectMemoryPool *CollisionObject::CollisionMemoryPool = NULL;
+
 		
 	/******************************************************************************
 		Function     : CollisionObject
 		Description  : CollisionObject Constructor
-		Input        : SharedPointer<Actor> &i_WorldObject, AABB i_WorldBox
+		Input        : const ActorHandle &i_WorldObject, AABB i_WorldBox
 		Output       : 
 		Return Value :   
 
@@ -28,26 +32,33 @@ namespace Engine
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
-	CollisionObject::CollisionObject(SharedPointer<Actor> &i_WorldObject, AABB i_WorldBox):
+	CollisionObject::CollisionObject(const ActorHandle &i_WorldObject, AABB i_WorldBox):
 		m_WorldObject(i_WorldObject),
 		m_WorldBox(i_WorldBox),
 		m_CollidedObject(NULL),
 		m_CollisionTime(0xffff),
 		m_CollisionResponseVector(Vector3(0.0f, 0.0f, 0.0f))
 	{
-		Matrix4x4 Translation, Rotation;
-		Translation.CreateTranslation(m_WorldObject->GetPosition());
-		Rotation.CreateZRotation(0.0f);
-
-		Matrix4x4 ObjToWorld = Rotation * Translation;
-			
-		//Set Local to world matrix of actor for 3D rendering to use
-		i_WorldObject->SetLocalToWorldMatrix(ObjToWorld);
+		Actor *pActor = GetActor();
+		assert(pActor);
+
+		sCollider Collider;
+		Collider.m_pCollisionObject = this;
+		Collider.mClassBitIndex = pActor->mClassBitIndex;
+		Collider.mCollidesWithBitIndex = pActor->mCollidesWithBitIndex;
+
+		EntityStore::GetInstance()->AddComponent(pActor->GetEntity(), Collider);
 	}
 
 	CollisionObject::~CollisionObject()
 	{
-			
+		//The collider went with the entity if the actor is already gone
+		Actor *pActor = GetActor();
+
+		if (pActor != NULL)
+		{
+			EntityStore::GetInstance()->RemoveComponent<sCollider>(pActor->GetEntity());
+		}
 	}
 
 	/******************************************************************************
@@ -67,14 +78,20 @@ namespace Engine
 
 		if (CollisionObject::CollisionMemoryPool == NULL)
 		{
-			CollisionObject::CollisionMemoryPool = MemoryPool::Create(sizeof(CollisionObject), MAX_COLLIDABLE_OBJECTS);
+			CollisionObject::CollisionMemoryPool = ObjectMemoryPool::Create(sizeof(CollisionObject), COLLIDABLE_OBJECTS_PER_CHUNK);
 			if (CollisionObject::CollisionMemoryPool == NULL)
 			{
 				assert(false);
 				WereThereErrors = false;
 			}
+			else
+			{
+				CollisionObject::CollisionMemoryPool->RegisterStats("Collision objects");
+			}
 		}
 
+		ActorTable::GetInstance()->AddDestroyedCallback(&CollisionSystem::OnActorDestroyed);
+
 		mInitilized = !WereThereErrors;
 	}
 
@@ -91,20 +108,21 @@ namespace Engine
 	******************************************************************************/
 	CollisionSystem::~CollisionSystem()
 	{
+		ActorTable::GetInstance()->RemoveDestroyedCallback(&CollisionSystem::OnActorDestroyed);
+
 		DeleteAllGameObjects();
-		mCollisionObjects.clear();
 
 		if (CollisionObject::CollisionMemoryPool != NULL)
 		{
-			unsigned long o_ulOutPutLen;
-			CollisionObject::CollisionMemoryPool->Destroy(&o_ulOutPutLen);
+			CollisionObject::CollisionMemoryPool->Destroy();
+			CollisionObject::CollisionMemoryPool = NULL;
 		}
 	}
 
 	/******************************************************************************
 		Function     : AddActorGameObject
 		Description  : Function to add actor game object to collision system
-		Input        : SharedPointer<Actor> &i_Object
+		Input        : const ActorHandle &i_Object
 		Output       : void
 		Return Value : 
 
@@ -112,20 +130,22 @@ namespace Engine
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
-	void CollisionSystem::AddActorGameObject(SharedPointer<Actor> &i_Object)
+	void CollisionSystem::AddActorGameObject(const ActorHandle &i_Object)
 	{
-		AABB WorldBox(Vector3(0.0f, 0.0f, 0.0f), i_Object->GetSize().x() * 0.5f, i_Object->GetSize().y() * 0.5f, i_Object->GetSize().z() * 0.5f);
+		Actor *pActor = ActorTable::GetInstance()->Resolve(i_Object);
+		assert(pActor);
 
-		CollisionObject *NewObject = new CollisionObject(i_Object, WorldBox);
+		AABB WorldBox(Vector3(0.0f, 0.0f, 0.0f), pActor->GetSize().x() * 0.5f, pActor->GetSize().y() * 0.5f, pActor->GetSize().z() * 0.5f);
 
-		mCollisionObjects.push_back(NewObject);
+		//Owned by the collision object pool, deleted by OnActorDestroyed
+		new CollisionObject(i_Object, WorldBox);
 	}
 
 	/******************************************************************************
-		Function     : DeleteMarkedToDeathGameObjects
-		Description  : Function to delete marked to death actor game object from 
-					collision system
-		Input        : void
+		Function     : OnActorDestroyed
+		Description  : Deletes the collision object of a destroyed actor, found
+					through its collider component
+		Input        : Actor &i_Actor
 		Output       : void
 		Return Value : 
 
@@ -133,18 +153,13 @@ namespace Engine
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
-	void CollisionSystem::DeleteMarkedToDeathGameObjects(void)
+	void CollisionSystem::OnActorDestroyed(Actor &i_Actor)
 	{
-		for(unsigned int i = 0; i < mCollisionObjects.size(); )
-		{
-			if (mCollisionObjects[i]->m_WorldObject->IsMarkedForDeath() == true)
-			{
-				delete mCollisionObjects[i];
-				mCollisionObjects.erase(mCollisionObjects.begin() + i);
-				continue;
-			}
+		sCollider *pCollider = EntityStore::GetInstance()->GetComponent<sCollider>(i_Actor.GetEntity());
 
-			i++;
+		if (pCollider != NULL)
+		{
+			delete pCollider->m_pCollisionObject;
 		}
 	}
 
@@ -162,12 +177,32 @@ namespace Engine
 	******************************************************************************/
 	void CollisionSystem::DeleteAllGameObjects(void)
 	{
-		for (unsigned long ulCount = 0; ulCount < mCollisionObjects.size(); ulCount++)
+		ForEachCollisionObject([](CollisionObject *i_pCollisionObject)
 		{
-			delete mCollisionObjects.at(ulCount);
-		}
+			delete i_pCollisionObject;
+		});
+	}
 
-		mCollisionObjects.clear();
+	void CollisionSystem::UpdateTask(const sFrameTime &i_Time)
+	{
+		GetInstance()->Update(i_Time.m_fDeltaTime);
+	}
+
+	/******************************************************************************
+		Function     : AddFrameTasks
+		Description  : Adds the collision checks to the frame graph, collision
+					handlers change the actors that hit
+		Input        : FrameGraph &io_Graph
+		Output       : void
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void CollisionSystem::AddFrameTasks(FrameGraph &io_Graph)
+	{
+		io_Graph.AddTask("Collision", &CollisionSystem::UpdateTask, io_Graph.GetResource("Entities"), io_Graph.GetResource("Actors"));
 	}
 
 	void CollisionSystem::Update(float i_DeltaTime)
@@ -176,8 +211,6 @@ namespace Engine
 
 		long CollisionCheckPerFrame = MAX_COLLISION_CHECK_PER_FRAME;
 
-		DeleteMarkedToDeathGameObjects();
-
 		float FirstCollision_DeltaTime = static_cast<float>(MAXDWORD);
 
 		bool bFound = CheckCollision(i_DeltaTime, FirstCollision_DeltaTime);
@@ -185,18 +218,17 @@ namespace Engine
 #if 0
 		while (bFound && (CollisionCheckPerFrame > 0))
 		{
-			for (unsigned int i = 0; i < mCollisionObjects.size(); i++)
+			ForEachCollisionObject([FirstCollision_DeltaTime](CollisionObject *ObjectA)
 			{
-				if ((mCollisionObjects[i]->m_CollidedObject != NULL) && (AlmostEqualRelative(FirstCollision_DeltaTime,  mCollisionObjects[i]->m_CollisionTime)))
+				if ((ObjectA->m_CollidedObject != NULL) && (AlmostEqualRelative(FirstCollision_DeltaTime,  ObjectA->m_CollisionTime)))
 				{
-					CollisionObject *ObjectA = mCollisionObjects[i];
-					CollisionObject *ObjectB = mCollisionObjects[i]->m_CollidedObject;
+					CollisionObject *ObjectB = ObjectA->m_CollidedObject;
 
-					ObjectA->m_WorldObject->HandleCollision(ObjectA, ObjectB);
+					ObjectA->GetActor()->HandleCollision(ObjectA, ObjectB);
 					ObjectA->m_CollidedObject = NULL;
 					ObjectA->m_CollisionTime = 0xffff;
 				}
-			}
+			});
 
 			//Apply Physics
 			PhysicsSystem::ApplyEulerPhysics(FirstCollision_DeltaTime);
@@ -234,56 +266,107 @@ namespace Engine
 
 		bool bFoundCollision = false;
 
-		for(unsigned int i = 0; i < mCollisionObjects.size(); i++)
+		//Pairs need random access, gather the collider chunks into a list. This
+		//runs as a frame task on any worker, so not into the main thread's frame arena
+		std::vector<sCollisionCandidate> &Candidates = m_Candidates;
+		Candidates.clear();
+		Candidates.reserve(EntityStore::GetInstance()->Count<sCollider>());
+
+		//The matrices were rebuilt by Actor::UpdateTransforms earlier in the frame
+		EntityStore::GetInstance()->ForEach<sTransform, sVelocity, sCollider>([&Candidates](EntityId i_Entity, const sTransform &i_Transform, sVelocity &i_Velocity, sCollider &i_Collider)
 		{
-			mCollisionObjects[i]->m_CollisionTime = 0xffff;
-				
-			Matrix4x4 Translation, Rotation;
-			Translation.CreateTranslation(mCollisionObjects[i]->m_WorldObject->GetPosition());
-			Rotation.CreateZRotation(mCollisionObjects[i]->m_WorldObject->GetRotation());
+			i_Collider.m_pCollisionObject->m_CollisionTime = 0xffff;
 
-			mCollisionObjects[i]->m_WorldObject->SetLocalToWorldMatrix( Translation * Rotation );
-	
-		}
+			assert(false == i_Transform.mDirty);
+
+			sCollisionCandidate Candidate;
+			Candidate.m_pCollisionObject = i_Collider.m_pCollisionObject;
+			Candidate.m_pLocalToWorld = &i_Transform.mLocalToWorld;
+			Candidate.m_pWorldToLocal = &i_Transform.mWorldToLocal;
+			Candidate.mVelocity = i_Velocity.mVelocity;
+			Candidate.mClassBitIndex = i_Collider.mClassBitIndex;
+			Candidate.mCollidesWithBitIndex = i_Collider.mCollidesWithBitIndex;
+
+			Candidates.push_back(Candidate);
+		});
 
-		for(unsigned int i = 0; i < mCollisionObjects.size(); i++)
+		//The pair tests only read the candidates, so they run on the workers.
+		//Hits are applied on this thread afterwards, in the pair order the
+		//serial loop had
+		m_Hits.clear();
+
+		auto TestPairs = [this, &Candidates, i_DeltaTime](const unsigned long i_ulBegin, const unsigned long i_ulEnd)
 		{
-			for(unsigned int j = i + 1; j < mCollisionObjects.size(); j++)
+			for (unsigned long i = i_ulBegin; i < i_ulEnd; i++)
 			{
-				Vector3 SurfaceNormalA = Vector3(0.0f, 0.0f, 0.0f);
-				Vector3 SurfaceNormalB = Vector3(0.0f, 0.0f, 0.0f);
-				float CollisionTime = 0.0f;
-				bool ACollidesWithB = ((mCollisionObjects[i]->m_WorldObject->mCollidesWithBitIndex & mCollisionObjects[j]->m_WorldObject->mClassBitIndex) != 0);
-				bool BCollidesWithA = ((mCollisionObjects[j]->m_WorldObject->mCollidesWithBitIndex & mCollisionObjects[i]->m_WorldObject->mClassBitIndex) != 0);
-
-				if (ACollidesWithB || BCollidesWithA)
+				for (unsigned long j = i + 1; j < Candidates.size(); j++)
 				{
-					if ( true == CheckOOBBIntersection(mCollisionObjects[i]->m_WorldBox, (mCollisionObjects[i]->m_WorldObject->GetVelocity()), (mCollisionObjects[i]->m_WorldObject->GetLocalToWorldMatrix()), 
-									mCollisionObjects[j]->m_WorldBox, (mCollisionObjects[j]->m_WorldObject->GetVelocity()), (mCollisionObjects[j]->m_WorldObject->GetLocalToWorldMatrix()), SurfaceNormalA, SurfaceNormalB, i_DeltaTime, CollisionTime))
+					Vector3 SurfaceNormalA = Vector3(0.0f, 0.0f, 0.0f);
+					Vector3 SurfaceNormalB = Vector3(0.0f, 0.0f, 0.0f);
+					float CollisionTime = 0.0f;
+					bool ACollidesWithB = ((Candidates[i].mCollidesWithBitIndex & Candidates[j].mClassBitIndex) != 0);
+					bool BCollidesWithA = ((Candidates[j].mCollidesWithBitIndex & Candidates[i].mClassBitIndex) != 0);
+
+					if (ACollidesWithB || BCollidesWithA)
 					{
-						if (o_FirstCollisionTime > CollisionTime)
-						{
-							o_FirstCollisionTime = CollisionTime;
-						}
-	
-						if (ACollidesWithB)
-						{
-							mCollisionObjects[i]->m_CollisionResponseVector = SurfaceNormalA;
-							mCollisionObjects[i]->m_CollisionTime = CollisionTime;
-							mCollisionObjects[i]->m_CollidedObject = mCollisionObjects[j];
-							mCollisionObjects[i]->m_WorldObject->HandleCollision(mCollisionObjects[i], mCollisionObjects[j]);
-						}
+						const CollisionObject *pObjectA = Candidates[i].m_pCollisionObject;
+						const CollisionObject *pObjectB = Candidates[j].m_pCollisionObject;
 
-						if (BCollidesWithA)
+						if ( true == CheckOOBBIntersection(pObjectA->m_WorldBox, Candidates[i].mVelocity, *Candidates[i].m_pLocalToWorld, *Candidates[i].m_pWorldToLocal,
+										pObjectB->m_WorldBox, Candidates[j].mVelocity, *Candidates[j].m_pLocalToWorld, *Candidates[j].m_pWorldToLocal,
+										SurfaceNormalA, SurfaceNormalB, i_DeltaTime, CollisionTime))
 						{
-							mCollisionObjects[j]->m_CollisionResponseVector = SurfaceNormalB;
-							mCollisionObjects[j]->m_CollisionTime = CollisionTime;
-							mCollisionObjects[j]->m_CollidedObject = mCollisionObjects[i];
-							mCollisionObjects[j]->m_WorldObject->HandleCollision(mCollisionObjects[j], mCollisionObjects[i]);
+							sCollisionHit Hit;
+							Hit.m_ulCandidateA = i;
+							Hit.m_ulCandidateB = j;
+							Hit.m_SurfaceNormalA = SurfaceNormalA;
+							Hit.m_SurfaceNormalB = SurfaceNormalB;
+							Hit.m_CollisionTime = CollisionTime;
+							Hit.m_bACollidesWithB = ACollidesWithB;
+							Hit.m_bBCollidesWithA = BCollidesWithA;
+
+							std::lock_guard<std::mutex> Lock(m_HitsMutex);
+							m_Hits.push_back(Hit);
 						}
 					}
 				}
 			}
+		};
+
+		JobSystem::GetInstance()->ParallelFor(0, static_cast<unsigned long>(Candidates.size()), TestPairs);
+
+		std::sort(m_Hits.begin(), m_Hits.end(), [](const sCollisionHit &i_Left, const sCollisionHit &i_Right)
+		{
+			return (i_Left.m_ulCandidateA < i_Right.m_ulCandidateA) ||
+				((i_Left.m_ulCandidateA == i_Right.m_ulCandidateA) && (i_Left.m_ulCandidateB < i_Right.m_ulCandidateB));
+		});
+
+		for (unsigned long ulHit = 0; ulHit < m_Hits.size(); ulHit++)
+		{
+			const sCollisionHit &Hit = m_Hits[ulHit];
+			CollisionObject *pObjectA = Candidates[Hit.m_ulCandidateA].m_pCollisionObject;
+			CollisionObject *pObjectB = Candidates[Hit.m_ulCandidateB].m_pCollisionObject;
+
+			if (o_FirstCollisionTime > Hit.m_CollisionTime)
+			{
+				o_FirstCollisionTime = Hit.m_CollisionTime;
+			}
+
+			if (Hit.m_bACollidesWithB)
+			{
+				pObjectA->m_CollisionResponseVector = Hit.m_SurfaceNormalA;
+				pObjectA->m_CollisionTime = Hit.m_CollisionTime;
+				pObjectA->m_CollidedObject = pObjectB;
+				pObjectA->GetActor()->HandleCollision(pObjectA, pObjectB);
+			}
+
+			if (Hit.m_bBCollidesWithA)
+			{
+				pObjectB->m_CollisionResponseVector = Hit.m_SurfaceNormalB;
+				pObjectB->m_CollisionTime = Hit.m_CollisionTime;
+				pObjectB->m_CollidedObject = pObjectA;
+				pObjectB->GetActor()->HandleCollision(pObjectB, pObjectA);
+			}
 		}
 
 		return bFoundCollision;
@@ -349,8 +432,9 @@ namespace Engine
 	/******************************************************************************
 		Function     : CheckOOBBIntersection
 		Description  : Function to check OOBB intersection of two bounded boxes
-		Input        : const AABB & i_BoxA, const Vector3 & i_VelocityA, const Matrix4x4 & i_ObjAtoWorld, 
-					const AABB & i_BoxB, const Vector3 & i_VelocityB, const Matrix4x4 & i_ObjBtoWorld,  
+		Input        : const AABB & i_BoxA, const Vector3 & i_VelocityA, const Matrix4x4 & i_ObjAtoWorld,
+					const Matrix4x4 & i_WorldToObjA, const AABB & i_BoxB, const Vector3 & i_VelocityB,
+					const Matrix4x4 & i_ObjBtoWorld, const Matrix4x4 & i_WorldToObjB,
 					Vector3 &SurfaceNormalA, Vector3 &SurfaceNormalB, float DeltaTime, float &CollisionTime
 		Output       : 
 		Return Value : bool
@@ -359,15 +443,13 @@ namespace Engine
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
-	bool CollisionSystem::CheckOOBBIntersection(const AABB & i_BoxA, const Vector3 & i_VelocityA, const Matrix4x4 & i_ObjAtoWorld,
-								const AABB & i_BoxB, const Vector3 & i_VelocityB, const Matrix4x4 & i_ObjBtoWorld,  
+	bool CollisionSystem::CheckOOBBIntersection(const AABB & i_BoxA, const Vector3 & i_VelocityA, const Matrix4x4 & i_ObjAtoWorld, const Matrix4x4 & i_WorldToObjA,
+								const AABB & i_BoxB, const Vector3 & i_VelocityB, const Matrix4x4 & i_ObjBtoWorld, const Matrix4x4 & i_WorldToObjB,
 								Vector3 &SurfaceNormalA, Vector3 &SurfaceNormalB, float DeltaTime, float &CollisionTime)
 	{
-
-		Matrix4x4 WorldToObjA = i_ObjAtoWorld.GetInverse();
-		Matrix4x4 WorldToObjB = i_ObjBtoWorld.GetInverse();
-		Matrix4x4 ObjAtoObjB = i_ObjAtoWorld * WorldToObjB;
-		Matrix4x4 ObjBtoObjA = i_ObjBtoWorld * WorldToObjA;
+		//The inverses are cached with the transforms, not worked out per pair
+		Matrix4x4 ObjAtoObjB = i_ObjAtoWorld * i_WorldToObjB;
+		Matrix4x4 ObjBtoObjA = i_ObjBtoWorld * i_WorldToObjA;
 
 		float	fLastEnter = 0.0f;
 		float	fFirstExit = DeltaTime;
@@ -375,8 +457,8 @@ namespace Engine
 		// A In B
 		{
 			// Transform Velocities from World CS to ObjB CS
-			Vector3	VelAInB = (WorldToObjB * Vector4(i_VelocityA, 0.0f)).GetAsVector3();
-			Vector3	VelBInB = (WorldToObjB * Vector4(i_VelocityB, 0.0f)).GetAsVector3();
+			Vector3	VelAInB = (i_WorldToObjB * Vector4(i_VelocityA, 0.0f)).GetAsVector3();
+			Vector3	VelBInB = (i_WorldToObjB * Vector4(i_VelocityB, 0.0f)).GetAsVector3();
 
 			// Project ObjA BB extents onto ObjB axis
 			float ExtentsX = fabs( i_BoxA.HalfX() * ObjAtoObjB.At(1,1) ) + fabs( i_BoxA.HalfY() * ObjAtoObjB.At(2,1) ) + fabs( i_BoxA.HalfZ() * ObjAtoObjB.At(3,1) );
@@ -451,8 +533,8 @@ namespace Engine
 		// B In A
 		{
 			// Transform Velocities from World CS to ObjA CS
-			Vector3	VelBInA = (WorldToObjA * Vector4(i_VelocityB, 0.0f)).GetAsVector3();
-			Vector3	VelAInA = (WorldToObjA * Vector4(i_VelocityA, 0.0f)).GetAsVector3();
+			Vector3	VelBInA = (i_WorldToObjA * Vector4(i_VelocityB, 0.0f)).GetAsVector3();
+			Vector3	VelAInA = (i_WorldToObjA * Vector4(i_VelocityA, 0.0f)).GetAsVector3();
 
 			// Project ObjA BB extents onto ObjB axis
 			float ExtentsX = fabs( i_BoxB.HalfX() * ObjAtoObjB.At(1,1) ) + fabs( i_BoxB.HalfY() * ObjAtoObjB.At(2,1) ) + fabs( i_BoxB.HalfZ() * ObjAtoObjB.At(3,1) );
@@ -572,6 +654,7 @@ namespace Engine
 		if (mInstance)
 		{
 			delete mInstance;
+			mInstance = NULL;
 		}
 	}
 }
\ No newline at end of file
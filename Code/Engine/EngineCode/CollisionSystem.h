@@ -2,11 +2,15 @@
 #define __COLLISION_SYSTEM_HEADER
 
 #include "Precompiled.h"
+#include <mutex>
 #include <vector>
 #include "AABB.h"
 #include "SharedPointer.h"
-#include "MemoryPool.h"
+#include "ObjectMemoryPool.h"
 #include "Matrix4x4.h"
+#include "EntityStore.h"
+#include "ActorTable.h"
+#include "FrameGraph.h"
 
 #include "Vector3.h"
 
@@ -18,16 +22,22 @@ namespace Engine
 	class CollisionObject
 	{
 	public:
-		SharedPointer<Actor> m_WorldObject;
+		ActorHandle			 m_WorldObject;
 		AABB				 m_WorldBox;
 		CollisionObject		 *m_CollidedObject;
 		float				 m_CollisionTime;
 		Vector3				 m_CollisionResponseVector;
 
-		static MemoryPool *CollisionMemoryPool;
-		CollisionObject(SharedPointer<Actor> &i_WorldObject, AABB i_WorldBox);
+		static ObjectMemoryPool *CollisionMemoryPool;
+		CollisionObject(const ActorHandle &i_WorldObject, AABB i_WorldBox);
 		~CollisionObject();
 
+		//NULL once the actor is destroyed
+		inline Actor *GetActor(void) const
+		{
+			return ActorTable::GetInstance()->Resolve(m_WorldObject);
+		}
+
 		inline void * operator new(size_t i_size)
 		{
 			assert(i_size == sizeof(CollisionObject));
@@ -44,11 +54,45 @@ namespace Engine
 		}
 	} ;
 
+	//Component of the actors the collision system checks, the class bits are
+	//copied in so the pair loop does not have to go back to the actor
+	struct sCollider
+	{
+		CollisionObject		*m_pCollisionObject;
+		unsigned int		mClassBitIndex;
+		unsigned int		mCollidesWithBitIndex;
+	};
+
 	class CollisionSystem
 	{
-		static unsigned int MAX_COLLIDABLE_OBJECTS;
-		std::vector<CollisionObject *> mCollisionObjects;
+		//Everything the pair loop reads of one collider, gathered from the components
+		struct sCollisionCandidate
+		{
+			CollisionObject		*m_pCollisionObject;
+			const Matrix4x4		*m_pLocalToWorld;
+			const Matrix4x4		*m_pWorldToLocal;
+			Vector3				mVelocity;
+			unsigned int		mClassBitIndex;
+			unsigned int		mCollidesWithBitIndex;
+		};
+
+		//A pair that intersects, found on a worker and applied on the main thread
+		struct sCollisionHit
+		{
+			unsigned long	m_ulCandidateA;
+			unsigned long	m_ulCandidateB;
+			Vector3			m_SurfaceNormalA;
+			Vector3			m_SurfaceNormalB;
+			float			m_CollisionTime;
+			bool			m_bACollidesWithB;
+			bool			m_bBCollidesWithA;
+		};
+
+		static unsigned int COLLIDABLE_OBJECTS_PER_CHUNK;
 		static CollisionSystem * mInstance;
+		std::vector<sCollisionCandidate> m_Candidates;	//Kept to reuse the memory, filled every CheckCollision
+		std::vector<sCollisionHit> m_Hits;		//Kept to reuse the memory, filled every CheckCollision
+		std::mutex m_HitsMutex;
 		bool mInitilized;
 
 		CollisionSystem();
@@ -57,23 +101,35 @@ namespace Engine
 
 		CollisionSystem(const CollisionSystem & i_Other);
 		CollisionSystem & operator=(const CollisionSystem & i_rhs);
-		void DeleteMarkedToDeathGameObjects(void);
+		static void OnActorDestroyed(Actor &i_Actor);
+		static void UpdateTask(const sFrameTime &i_Time);
 		void DeleteAllGameObjects(void);
 		bool CheckCollision(float i_DeltaTime, float &o_FirstCollisionTime);
 		bool AxisRangeRayOverlap(float i_RangeStart, float i_RangeEnd, float i_RayStart, float i_RayLength, float & o_dEnter, float & o_dExit, Vector3 &SurfaceA, Vector3 &SurfaceB, float DeltaTime);
-		bool CheckOOBBIntersection(const AABB & i_BoxA, const Vector3 & i_VelocityA, const Matrix4x4 & i_ObjAtoWorld,
-			const AABB & i_BoxB, const Vector3 & i_VelocityB, const Matrix4x4 & i_ObjBtoWorld,
+		bool CheckOOBBIntersection(const AABB & i_BoxA, const Vector3 & i_VelocityA, const Matrix4x4 & i_ObjAtoWorld, const Matrix4x4 & i_WorldToObjA,
+			const AABB & i_BoxB, const Vector3 & i_VelocityB, const Matrix4x4 & i_ObjBtoWorld, const Matrix4x4 & i_WorldToObjB,
 			Vector3 &SurfaceNormalA, Vector3 &SurfaceNormalB, float DeltaTime, float &CollisionTime);
 		bool AxisCheck(float RelativeCentre, float Extent, float RelativeVelocity, float Centre, float i_DeltaTime, float &EnterTime, float &ExitTime, Vector3 & i_SurfaceNormal, Vector3 & o_SurfaceNormal);
 
+		//Every live collision object is in the pool, walk it in address order
+		template<class Function>
+		static void ForEachCollisionObject(Function i_Function)
+		{
+			CollisionObject::CollisionMemoryPool->ForEachAllocated([&i_Function](void *i_pObject)
+			{
+				i_Function(static_cast<CollisionObject *>(i_pObject));
+			});
+		}
+
 	public:
-		void AddActorGameObject(SharedPointer<Actor> &i_Object);
+		void AddActorGameObject(const ActorHandle &i_Object);
 
 		void Update(float i_DeltaTime);
 
 		static bool CreateInstance();
 		static CollisionSystem * GetInstance();
 		static void Destroy();
+		static void AddFrameTasks(FrameGraph &io_Graph);
 	};	
 }
 
@@ -15,6 +15,7 @@ namespace Engine
 		mShouldRenderDebugLinesThisFrame(false)
 	{
 		mLines.reserve(iMaxLines);
+		mRenderLines.reserve(iMaxLines);
 		assert(iName && i_direct3dDevice);
 	}
 
@@ -53,6 +54,16 @@ namespace Engine
 		assert(false);
 	}
 
+	//Hands the lines added so far to Render, later lines are for the next frame
+	void DebugLineRenderer::LatchLines()
+	{
+		std::lock_guard<std::mutex> Lock(mLinesMutex);
+
+		mRenderLines.swap(mLines);
+		mLines.clear();
+		mShouldRenderDebugLinesThisFrame = !mRenderLines.empty();
+	}
+
 	void DebugLineRenderer::Render()
 	{
 		if (UserInput::GetInstance() && (UserInput::GetInstance()->IsKeyReleased('O')))
@@ -61,9 +72,9 @@ namespace Engine
 		}
 
 		//Only render when in frame
-		if (mShouldRenderDebugLinesThisFrame && mShouldDraw && GraphicsSystem::GetInstance()->CanSubmit() && mLines.size() > 0)
+		if (mShouldRenderDebugLinesThisFrame && mShouldDraw && GraphicsSystem::GetInstance()->CanSubmit() && mRenderLines.size() > 0)
 		{
-			FillVertexBuffer(mLines);
+			FillVertexBuffer(mRenderLines);
 			// Set the shaders
 			{
 #ifdef EAE2014_SHOULDALLRETURNVALUESBECHECKED
@@ -109,7 +120,7 @@ namespace Engine
 				// It's possible to start rendering primitives in the middle of the stream
 				const unsigned int indexOfFirstVertexToRender = 0;
 
-				const unsigned int primitiveCountToRender = mLines.size();
+				const unsigned int primitiveCountToRender = mRenderLines.size();
 
 				HRESULT result = m_direct3dDevice->DrawPrimitive(primitiveType, indexOfFirstVertexToRender, primitiveCountToRender);
 
@@ -123,7 +134,7 @@ namespace Engine
 
 		//Only render the lines one frame and clear
 		mShouldRenderDebugLinesThisFrame = false;
-		mLines.clear();
+		mRenderLines.clear();
 	}
 #endif
 }
\ No newline at end of file
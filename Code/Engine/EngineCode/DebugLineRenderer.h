@@ -2,6 +2,7 @@
 #define __DEBUG_LINE_RENDERER_H
 
 #include "PreCompiled.h"
+#include <mutex>
 #include <vector>
 #include <d3d9.h>
 #include "Vector3.h"
@@ -14,6 +15,8 @@ namespace Engine
 	class DebugLineRenderer: private ILine
 	{
 		std::vector<sLine> mLines;
+		std::vector<sLine> mRenderLines;		//Latched for Render while the next frame's actors fill mLines
+		std::mutex mLinesMutex;				//Actor updates add lines from the job system workers
 		bool mShouldDraw;
 		bool mShouldRenderDebugLinesThisFrame;
 		DebugLineRenderer(const char *iName, IDirect3DDevice9 *i_direct3dDevice, unsigned int iMaxLines);
@@ -32,12 +35,13 @@ namespace Engine
 		
 		bool AddLines(const sLine &iLine)
 		{
+			std::lock_guard<std::mutex> Lock(mLinesMutex);
+
 			if (mLines.size() >= s_MaxLines)
 			{
 				return false;
 			}
 			mLines.push_back(iLine);
-			mShouldRenderDebugLinesThisFrame = true;
 			return true;
 			
 		}
@@ -68,6 +72,7 @@ namespace Engine
 			return CreateVertexBufferForLine();
 		}
 
+		void LatchLines();
 		void Render();
 	};
 #endif
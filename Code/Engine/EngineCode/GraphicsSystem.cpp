@@ -243,7 +243,7 @@ namespace Engine
 		return false;
 	}
 
-	void GraphicsSystem::Render(SharedPointer<Material> i_Material, SharedPointer<Mesh> i_Mesh, SharedPointer<Actor> ThisObject)
+	void GraphicsSystem::Render(const SharedPointer<Material> &i_Material, const SharedPointer<Mesh> &i_Mesh, const Matrix4x4 &i_LocalToWorld, const float i_DeltaTime)
 	{
 		assert(mInitilized == true);
 
@@ -255,7 +255,7 @@ namespace Engine
 #ifdef EAE2014_SHOULDALLRETURNVALUESBECHECKED
 				std::string errorMessage;
 #endif
-				HRESULT result = i_Material->Set(m_direct3dDevice, ThisObject
+				HRESULT result = i_Material->Set(m_direct3dDevice, i_LocalToWorld, i_DeltaTime
 #ifdef EAE2014_SHOULDALLRETURNVALUESBECHECKED
 					, &errorMessage
 #endif
@@ -313,7 +313,7 @@ namespace Engine
 		}
 	}
 
-	void GraphicsSystem::RenderSprite(SharedPointer<Sprite> i_Sprite)
+	void GraphicsSystem::RenderSprite(const SharedPointer<Sprite> &i_Sprite)
 	{
 		assert(mInitilized == true);
 
@@ -519,7 +519,7 @@ namespace Engine
 			{
 				SharedPointer<Material> pMaterial = NULL;
 				{
-					pMaterial = new Material(i_MaterialPath, m_direct3dDevice);
+					pMaterial = MakeShared<Material>(i_MaterialPath, m_direct3dDevice);
 					assert(pMaterial != NULL);
 
 #ifdef EAE2014_SHOULDALLRETURNVALUESBECHECKED
@@ -652,7 +652,7 @@ namespace Engine
 
 						SharedPointer<Mesh> pMesh = NULL;
 						{
-							pMesh = new Mesh(i_MeshPath, iO_DrawInfo, vertexBuffer, indexBuffer);
+							pMesh = MakeShared<Mesh>(i_MeshPath, iO_DrawInfo, vertexBuffer, indexBuffer);
 
 							if (pMesh == NULL)
 							{
@@ -845,7 +845,7 @@ namespace Engine
 
 				SharedPointer<Sprite> pSprite = NULL;
 				{
-					pSprite = new Sprite(i_TexturePath, m_direct3dDevice, vertexBuffer);
+					pSprite = MakeShared<Sprite>(i_TexturePath, m_direct3dDevice, vertexBuffer);
 
 					if (pSprite == NULL)
 					{
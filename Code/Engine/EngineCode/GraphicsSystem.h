@@ -23,7 +23,7 @@ namespace Engine
 {
 	class Material; //Forward Decleration
 	class Mesh;
-	class Actor;
+	class Matrix4x4;
 	class Sprite;
 	struct sRectangle;
 	struct sSprite;
@@ -80,8 +80,8 @@ namespace Engine
 		bool BeingFrame(const ColorRGBA & i_ClearColor = ColorRGBA(0, 0, 0, 0));
 		bool GraphicsSystem::Begin2D(void);
 		bool GraphicsSystem::Begin3D(void);
-		void Render(SharedPointer<Material> i_Material, SharedPointer<Mesh> i_Mesh, SharedPointer<Actor> ThisObject);
-		void RenderSprite(SharedPointer<Sprite> i_Sprite);
+		void Render(const SharedPointer<Material> &i_Material, const SharedPointer<Mesh> &i_Mesh, const Matrix4x4 &i_LocalToWorld, const float i_DeltaTime);
+		void RenderSprite(const SharedPointer<Sprite> &i_Sprite);
 		bool EndFrame(void);
 		bool CreateDebugLineRenderer(const char *iName, unsigned int iMaxLines);
 		SharedPointer<Mesh> CreateMesh(const char* i_MeshPath);
@@ -19,10 +19,6 @@ namespace Engine
 	{
 		assert(pcLevelName);
 
-		std::vector<std::string> ClassTypes;
-		std::vector<LightingData> LightingDatas;
-
-
 		bool WereThereErrors = false;
 		std::string errorMessage;
 
@@ -42,59 +38,69 @@ namespace Engine
 			}
 		}
 
-		if (!LoadClassTypes(*luaState, ClassTypes
+		//Everything the load needs only until it ends is taken from the level arena
+		LevelArena::sMarker LoadMarker = LevelArena::GetInstance()->BeginLevelLoad();
+
+		//The temporaries live in this block, so they are destroyed before the
+		//level arena takes their memory back in EndLevelLoad
+		{
+			LevelLoadVector<LevelLoadString> ClassTypes;
+			LevelLoadVector<LightingData> LightingDatas;
+
+			if (!LoadClassTypes(*luaState, ClassTypes
 #ifdef EAE2014_SHOULDALLRETURNVALUESBECHECKED
-			, &errorMessage
+				, &errorMessage
 #endif
-			))
-		{
-			WereThereErrors = true;
-			goto OnExit;
-		}
+				))
+			{
+				WereThereErrors = true;
+				goto OnExit;
+			}
 
-		//Add class types in global actor class types
-		for (unsigned int i = 0; i < ClassTypes.size(); i++)
-		{
-			Actor::AddGlobalClassTypes(ClassTypes[i].c_str());
-		}
+			//Add class types in global actor class types
+			for (unsigned int i = 0; i < ClassTypes.size(); i++)
+			{
+				Actor::AddGlobalClassTypes(ClassTypes[i].c_str());
+			}
 		
-		if (!LoadLightingData(*luaState, LightingDatas
+			if (!LoadLightingData(*luaState, LightingDatas
 #ifdef EAE2014_SHOULDALLRETURNVALUESBECHECKED
-			, &errorMessage
+				, &errorMessage
 #endif
-			))
-		{
-			WereThereErrors = true;
-			goto OnExit;
-		}
+				))
+			{
+				WereThereErrors = true;
+				goto OnExit;
+			}
 
-		if (!CreateLightingInstance(LightingDatas
+			if (!CreateLightingInstance(LightingDatas
 #ifdef EAE2014_SHOULDALLRETURNVALUESBECHECKED
-			, &errorMessage
+				, &errorMessage
 #endif
-			))
-		{
-			WereThereErrors = true;
-			goto OnExit;
-		}
+				))
+			{
+				WereThereErrors = true;
+				goto OnExit;
+			}
 
-		if (!LoadCameraDataAndCreate(*luaState
+			if (!LoadCameraDataAndCreate(*luaState
 #ifdef EAE2014_SHOULDALLRETURNVALUESBECHECKED
-			, &errorMessage
+				, &errorMessage
 #endif
-			))
-		{
-			WereThereErrors = true;
-			goto OnExit;
-		}
+				))
+			{
+				WereThereErrors = true;
+				goto OnExit;
+			}
 
-		if (!LoadActorsData(*luaState
+			if (!LoadActorsData(*luaState
 #ifdef EAE2014_SHOULDALLRETURNVALUESBECHECKED
-			, &errorMessage
+				, &errorMessage
 #endif
-			))
-		{
-			WereThereErrors = true;
+				))
+			{
+				WereThereErrors = true;
+			}
 		}
 
 	OnExit:
@@ -122,11 +128,22 @@ namespace Engine
 			MessageBox(NULL, errorMessage.c_str(), pcLevelName, MB_OK | MB_ICONERROR);
 		}
 #endif
+		//Releases the load temporaries in one go
+		LevelArena::GetInstance()->EndLevelLoad(LoadMarker);
+
 		return !WereThereErrors;
 	}
 
 	//******************************************************************************
-	bool CreateLightingInstance(std::vector<LightingData> &LightingDatas
+	//Releases all the level lifetime memory at once, every actor of the level
+	//must be destroyed before
+	void UnloadLevel(void)
+	{
+		LevelArena::GetInstance()->Reset();
+	}
+
+	//******************************************************************************
+	bool CreateLightingInstance(LevelLoadVector<LightingData> &LightingDatas
 #ifdef EAE2014_SHOULDALLRETURNVALUESBECHECKED
 		, std::string* o_errorMessage
 #endif
@@ -171,7 +188,7 @@ namespace Engine
 	}
 
 	//******************************************************************************
-	bool LoadClassTypes(lua_State &io_luaState, std::vector<std::string> & o_classTypes
+	bool LoadClassTypes(lua_State &io_luaState, LevelLoadVector<LevelLoadString> & o_classTypes
 #ifdef EAE2014_SHOULDALLRETURNVALUESBECHECKED
 		, std::string* o_errorMessage
 #endif
@@ -209,7 +226,7 @@ namespace Engine
 	}
 
 	//******************************************************************************
-	bool LoadLightingData(lua_State &io_luaState, std::vector<LightingData> & o_LightingDatas
+	bool LoadLightingData(lua_State &io_luaState, LevelLoadVector<LightingData> & o_LightingDatas
 #ifdef EAE2014_SHOULDALLRETURNVALUESBECHECKED
 		, std::string* o_errorMessage
 #endif
@@ -335,7 +352,7 @@ namespace Engine
 			float nearPlane = { 0.1f };
 			float farPlane = { 100.0f };
 			char * iType = "Camera";
-			std::vector<std::string> o_CollidesWith;
+			LevelLoadVector<LevelLoadString> o_CollidesWith;
 			bool IsCollidable = false;
 
 			//Iterating through the lightingdata key value pairs
@@ -751,12 +768,12 @@ namespace Engine
 				lua_pop(&io_luaState, 1);
 			}
 
-			SharedPointer<Actor> NewActor = Actor::Create(Vector3(eyeLocation[0], eyeLocation[1], eyeLocation[2]),
+			ActorHandle NewActor = Actor::Create(Vector3(eyeLocation[0], eyeLocation[1], eyeLocation[2]),
 				Vector3(InitialVelocity[0], InitialVelocity[1], InitialVelocity[2]),
 				Vector3(InitialAccln[0], InitialAccln[1], InitialAccln[2]),
 				"Camera", iType, Vector3(Size[0], Size[1], Size[2]), Rotation, o_CollidesWith);
 
-			assert(NewActor != NULL);
+			assert(!NewActor.IsNull());
 
 			fieldOfView = fieldOfView * static_cast<float>(Engine::Get_PI_Value() / 180.0f); //60 degrees to radians
 			if (!Engine::CameraSystem::CreateInstance(NewActor, UserSettings::GetWidth(), UserSettings::GetHeight(), fieldOfView,
@@ -876,7 +893,7 @@ namespace Engine
 
 		std::string MaterialPath = "data/genericMaterial.mat";
 		std::string MeshPath = "data/plane.dat";
-		std::vector<std::string> o_CollidesWith;
+		LevelLoadVector<LevelLoadString> o_CollidesWith;
 
 		bool wereThereErrors = false;
 
@@ -1225,7 +1242,7 @@ namespace Engine
 			assert(RenderableObjectSystem::GetInstance());
 			assert(PhysicsSystem::GetInstance());
 			//-----------------------------Actor Creation and adding to systems-----------------------------
-			SharedPointer<Actor> NewActor = Actor::Create(Position, Velocity, Acceleration, ActorName.c_str(), ActorClass.c_str(), Size, Rotation, o_CollidesWith);
+			ActorHandle NewActor = Actor::Create(Position, Velocity, Acceleration, ActorName.c_str(), ActorClass.c_str(), Size, Rotation, o_CollidesWith);
 			WorldSystem::GetInstance()->AddActorGameObject(NewActor);
 
 			PhysicsSystem::GetInstance()->AddActorGameObject(NewActor);
@@ -1280,7 +1297,7 @@ namespace Engine
 	}
 
 
-	bool LoadPhysicsSettings(lua_State &io_luaState, std::vector<std::string> &o_CollidesWith, bool & o_IsCollidable
+	bool LoadPhysicsSettings(lua_State &io_luaState, LevelLoadVector<LevelLoadString> &o_CollidesWith, bool & o_IsCollidable
 #ifdef EAE2014_SHOULDALLRETURNVALUESBECHECKED
 		, std::string* o_errorMessage
 #endif
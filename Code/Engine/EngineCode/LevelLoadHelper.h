@@ -3,26 +3,28 @@
 
 
 #include "../LuaHelper/LuaHelper.h"
+#include "LevelArena.h"
 
 namespace Engine
 {
 	struct LightingData;
 
 	bool LoadLevel(const char * pcLevelName);
+	void UnloadLevel(void);
 	
-	bool LoadClassTypes(lua_State &io_luaState, std::vector<std::string> & o_classTypes
+	bool LoadClassTypes(lua_State &io_luaState, LevelLoadVector<LevelLoadString> & o_classTypes
 #ifdef EAE2014_SHOULDALLRETURNVALUESBECHECKED
 		, std::string* o_errorMessage
 #endif
 		);
 	
-	bool LoadLightingData(lua_State &io_luaState, std::vector<LightingData> & o_LightingDatas
+	bool LoadLightingData(lua_State &io_luaState, LevelLoadVector<LightingData> & o_LightingDatas
 #ifdef EAE2014_SHOULDALLRETURNVALUESBECHECKED
 		, std::string* o_errorMessage
 #endif
 		);
 
-	bool CreateLightingInstance(std::vector<LightingData> &LightingDatas
+	bool CreateLightingInstance(LevelLoadVector<LightingData> &LightingDatas
 #ifdef EAE2014_SHOULDALLRETURNVALUESBECHECKED
 		, std::string* o_errorMessage
 #endif
@@ -52,7 +54,7 @@ namespace Engine
 #endif
 		);
 
-	bool LoadPhysicsSettings(lua_State &io_luaState, std::vector<std::string> &o_CollidesWith, bool & o_IsCollidable
+	bool LoadPhysicsSettings(lua_State &io_luaState, LevelLoadVector<LevelLoadString> &o_CollidesWith, bool & o_IsCollidable
 #ifdef EAE2014_SHOULDALLRETURNVALUESBECHECKED
 		, std::string* o_errorMessage
 #endif
@@ -5,7 +5,7 @@ namespace Engine
 {
 	LightingSystem * LightingSystem::mInstance = NULL;
 
-	LightingSystem::LightingSystem(SharedPointer<Actor> &i_WorldObject, const Vector3 & iAmbientLight, const Vector3 & iDiffuseLight, const Vector3 & iLightDirection):
+	LightingSystem::LightingSystem(const ActorHandle &i_WorldObject, const Vector3 & iAmbientLight, const Vector3 & iDiffuseLight, const Vector3 & iLightDirection):
 		m_WorldObject(i_WorldObject),
 		mAmbientLight(iAmbientLight),
 		mDiffuseLight(iDiffuseLight),
@@ -18,12 +18,39 @@ namespace Engine
 
 	LightingSystem::~LightingSystem()
 	{
-
+		//The light actor lives as long as the light
+		ActorTable::GetInstance()->DestroyActor(m_WorldObject);
 	}
 
 	void LightingSystem::Update(float i_deltaTime)
 	{
-		m_WorldObject->Update(i_deltaTime);
+		Actor *pActor = GetActor();
+		assert(pActor);
+
+		pActor->Update(i_deltaTime);
+	}
+
+	void LightingSystem::UpdateTask(const sFrameTime &i_Time)
+	{
+		GetInstance()->Update(i_Time.m_fDeltaTime);
+	}
+
+	/******************************************************************************
+		Function     : AddFrameTasks
+		Description  : Adds the light update to the frame graph, the light
+					controller moves the light actor and turns the light
+		Input        : FrameGraph &io_Graph
+		Output       : 
+		Return Value : 
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void LightingSystem::AddFrameTasks(FrameGraph &io_Graph)
+	{
+		io_Graph.AddTask("Lighting", &LightingSystem::UpdateTask, io_Graph.GetResource("Entities"),
+						 io_Graph.GetResource("Actors") | io_Graph.GetResource("Light"));
 	}
 
 	bool LightingSystem::CreateInstance(const Vector3 & iAmbientLight, const Vector3 & iDiffuseLight, const Vector3 & iLightDirection)
@@ -38,8 +65,8 @@ namespace Engine
 			
 			const std::vector<std::string> iCollidesWith; //Collides with none
 
-			SharedPointer<Actor> NewActor = Actor::Create(InitialPosition, InitialVelocity, InitialAccln, "DiffuseLight", "Light", Size, Rotation, iCollidesWith);
-			assert(NewActor != NULL);
+			ActorHandle NewActor = Actor::Create(InitialPosition, InitialVelocity, InitialAccln, "DiffuseLight", "Light", Size, Rotation, iCollidesWith);
+			assert(!NewActor.IsNull());
 
 			mInstance = new LightingSystem(NewActor, iAmbientLight, iDiffuseLight, iLightDirection);
 
@@ -1,27 +1,36 @@
 #ifndef __LIGHTING_SYSTEM_H
 #define __LIGHTING_SYSTEM_H
 #include "Actor.h"
-#include "SharedPointer.h"
+#include "FrameGraph.h"
 
 namespace Engine
 {
 	class LightingSystem
 	{
 	private:
-		LightingSystem(SharedPointer<Actor> &i_WorldObject, const Vector3 & iAmbientLight, const Vector3 & iDiffuseLight, const Vector3 & iLightDirection);
+		LightingSystem(const ActorHandle &i_WorldObject, const Vector3 & iAmbientLight, const Vector3 & iDiffuseLight, const Vector3 & iLightDirection);
 		~LightingSystem();
 		LightingSystem(const LightingSystem & i_Other);
 		LightingSystem & operator=(const LightingSystem & i_rhs);
 
 		static LightingSystem * mInstance;
 
+		static void UpdateTask(const sFrameTime &i_Time);
+
 		bool mInitilized;
 		Vector3 mAmbientLight;
 		Vector3 mDiffuseLight;
 		Vector3 mLightDirection;
 
 	public:
-		SharedPointer<Actor> m_WorldObject;
+		ActorHandle m_WorldObject;
+
+		//NULL once the actor is destroyed
+		inline Actor *GetActor(void) const
+		{
+			return ActorTable::GetInstance()->Resolve(m_WorldObject);
+		}
+
 		void Update(float i_deltaTime);
 		
 		inline Vector3 GetAmbientLight() const { return mAmbientLight; }
@@ -36,6 +45,7 @@ namespace Engine
 
 		static LightingSystem * GetInstance();
 		static void Destroy();
+		static void AddFrameTasks(FrameGraph &io_Graph);
 	};
 }
 #endif //__LIGHTING_SYSTEM_H
\ No newline at end of file
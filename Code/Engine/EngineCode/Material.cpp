@@ -85,7 +85,7 @@ namespace Engine
 		}
 	}
 
-	HRESULT Material::Set(IDirect3DDevice9 * i_direct3dDevice, SharedPointer<Actor> ThisObject
+	HRESULT Material::Set(IDirect3DDevice9 * i_direct3dDevice, const Matrix4x4 &i_LocalToWorld, const float i_DeltaTime
 #ifdef EAE2014_SHOULDALLRETURNVALUESBECHECKED
 		, std::string* o_errorMessage
 #endif
@@ -164,7 +164,7 @@ namespace Engine
 		D3DXMATRIX LocalToWorld;
 
 		//Transpose the stored matrix
-		Matrix4x4 ObjectMatrix = ThisObject->GetLocalToWorldMatrix().GetTranspose();
+		Matrix4x4 ObjectMatrix = i_LocalToWorld.GetTranspose();
 		LocalToWorld._11 = ObjectMatrix.At(1, 1);
 		LocalToWorld._12 = ObjectMatrix.At(1, 2);
 		LocalToWorld._13 = ObjectMatrix.At(1, 3);
@@ -215,7 +215,7 @@ namespace Engine
 		//Set per-view constants
 		static float TimeElapsed;
 		{
-			TimeElapsed += ThisObject->GetDeltaTime();
+			TimeElapsed += i_DeltaTime;
 		}
 
 		if (!SetPerViewConstantDataByName("TimeElapsed", &TimeElapsed, count))
@@ -226,7 +226,7 @@ namespace Engine
 		//Set per-view constants
 		float CameraPosition[3];
 		int PosotionDatacount;
-		CameraSystem::GetInstance()->m_WorldObject->GetPosition().GetAsFloatArray(CameraPosition, PosotionDatacount);
+		CameraSystem::GetInstance()->GetPosition().GetAsFloatArray(CameraPosition, PosotionDatacount);
 		if (!SetPerViewConstantDataByName("CameraPosition", CameraPosition, PosotionDatacount))
 		{
 			assert(false);
@@ -457,7 +457,7 @@ namespace Engine
 			if (lua_istable(&io_luaState, IndexOfValue)) //If it is a table
 			{
 				const unsigned int DataCountOfValue = luaL_len(&io_luaState, IndexOfValue);
-				float *EachDataOfValue = new float[DataCountOfValue];
+				float *EachDataOfValue = SmallNewArray<float>(DataCountOfValue);
 				if (!LuaHelper::GetEachNumberDataValuesInCurrentTable<float>(io_luaState, EachDataOfValue, DataCountOfValue
 #ifdef EAE2014_SHOULDALLRETURNVALUESBECHECKED
 					, o_errorMessage
@@ -465,6 +465,7 @@ namespace Engine
 					))
 				{
 					wereThereErrors = true;
+					SmallDeleteArray(EachDataOfValue, DataCountOfValue);
 					// Pop the returned key value pair on error
 					lua_pop(&io_luaState, 2);
 					goto OnExit;
@@ -509,7 +510,7 @@ namespace Engine
 					m_perMaterialConstantDatas.push_back(BaseClassPointer);
 				}
 
-				delete[] EachDataOfValue;
+				SmallDeleteArray(EachDataOfValue, DataCountOfValue);
 			}
 			else if (lua_type(&io_luaState, IndexOfValue) == LUA_TNUMBER)
 			{
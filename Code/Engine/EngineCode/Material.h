@@ -26,7 +26,7 @@ as well as the data that those shader program use
 
 namespace Engine
 {
-	class Actor;
+	class Matrix4x4;
 
 	class Material
 	{
@@ -41,7 +41,7 @@ namespace Engine
 
 		// Render
 		//-------
-		HRESULT Set(IDirect3DDevice9 * i_direct3dDevice, SharedPointer<Actor> ThisObject
+		HRESULT Set(IDirect3DDevice9 * i_direct3dDevice, const Matrix4x4 &i_LocalToWorld, const float i_DeltaTime
 #ifdef EAE2014_SHOULDALLRETURNVALUESBECHECKED
 			, std::string* o_errorMessage = NULL
 #endif
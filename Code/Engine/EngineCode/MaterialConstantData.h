@@ -3,6 +3,8 @@
 #include "PreCompiled.h"
 #include <d3dx9shader.h>
 
+#include "SmallObjectAllocator.h"
+
 namespace Engine
 {
 	struct BelongsToenum
@@ -27,7 +29,7 @@ namespace Engine
 		};
 	};
 
-	class IMaterialConstant
+	class IMaterialConstant : public SmallObject
 	{
 	public:
 		IMaterialConstant(){}
@@ -89,7 +91,7 @@ namespace Engine
 	{
 		assert(i_constantName && i_defaultValues && (i_count > 0) && (i_Handle != NULL) && (i_enbelongsto != BelongsToenum::BELONGSTO::NONE));
 
-		mDefaultValues = new T[mCount];
+		mDefaultValues = SmallNewArray<T>(mCount);
 
 		//Copy every object using its copy constructor
 		for (unsigned int i = 0; i < mCount; i++)
@@ -103,7 +105,7 @@ namespace Engine
 	{
 		if (mDefaultValues)
 		{
-			delete[] mDefaultValues;
+			SmallDeleteArray(mDefaultValues, mCount);
 		}
 	}
 
@@ -3,19 +3,20 @@
 #include "PhysicsSystem.h"
 #include "Vector3.h"
 #include "Debug.h"
+#include "JobSystem.h"
 
 namespace Engine
 {
-
-	const unsigned int  PhysicsSystem::MAX_PHYSICS_OBJECTS = 100;
+	const unsigned int  PhysicsSystem::PHYSICS_OBJECTS_INITIAL_CAPACITY = 64;
+	const unsigned int  PhysicsSystem::PHYSICS_DEFRAG_MOVES_PER_FRAME = 16;
 	PhysicsSystem *PhysicsSystem ::mInstance = NULL;
-	MemoryPool * PhysicsSystem::PhysicsObject::PhysicsMemoryPool = NULL;
+	CompactingPool<PhysicsSystem::PhysicsObject> * PhysicsSystem::PhysicsObject::PhysicsObjectPool = NULL;
 		
 
 	/******************************************************************************
 		Function     : PhysicsObject
 		Description  : Constructor of Physics object 
-		Input        : SharedPointer<Actor> &i_Object
+		Input        : const ActorHandle &i_Object
 		Output       : 
 		Return Value : 
 
@@ -23,10 +24,34 @@ namespace Engine
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/		
-	PhysicsSystem::PhysicsObject::PhysicsObject(SharedPointer<Actor> &i_Object) :
+	PhysicsSystem::PhysicsObject::PhysicsObject(const ActorHandle &i_Object) :
 		m_WorldObject(i_Object)
 	{
+		Actor *pActor = ActorTable::GetInstance()->Resolve(m_WorldObject);
+		assert(pActor);
+
+		sPhysicsBody Body;
+		Body.m_PoolHandle = INVALID_POOL_HANDLE;			//Filled in by AddActorGameObject
+
+		EntityStore::GetInstance()->AddComponent(pActor->GetEntity(), Body);
+
+	}
+
+	/******************************************************************************
+		Function     : PhysicsObject
+		Description  : Move constructor, used when the pool relocates the object
+		Input        : PhysicsObject &&i_Other
+		Output       : 
+		Return Value : 
 
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	PhysicsSystem::PhysicsObject::PhysicsObject(PhysicsObject &&i_Other) :
+		m_WorldObject(i_Other.m_WorldObject)
+	{
+		i_Other.m_WorldObject = ActorHandle();
 	}
 
 	/******************************************************************************
@@ -42,13 +67,20 @@ namespace Engine
 	******************************************************************************/
 	PhysicsSystem::PhysicsObject::~PhysicsObject()
 	{
+		//Nothing to do for the empty object left behind by a move, or when the actor is already gone
+		Actor *pActor = ActorTable::GetInstance()->Resolve(m_WorldObject);
+
+		if (pActor != NULL)
+		{
+			EntityStore::GetInstance()->RemoveComponent<sPhysicsBody>(pActor->GetEntity());
+		}
 
 	}
 
 	/******************************************************************************
 		Function     : AddActorGameObject
 		Description  : Function to add actor game object to physics system
-		Input        : SharedPointer<Actor> &i_Object
+		Input        : const ActorHandle &i_Object
 		Output       : void
 		Return Value : 
 
@@ -56,16 +88,25 @@ namespace Engine
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
-	void PhysicsSystem::AddActorGameObject(SharedPointer<Actor> &i_Object)
+	void PhysicsSystem::AddActorGameObject(const ActorHandle &i_Object)
 	{
-		m_PhysicsObjectList.push_back(new PhysicsObject(i_Object));
+		//Owned by the physics object pool, deleted by OnActorDestroyed
+		const sPoolHandle Handle = PhysicsObject::PhysicsObjectPool->Allocate(i_Object);
+
+		if (INVALID_POOL_HANDLE == Handle)
+		{
+			return;
+		}
+
+		Actor *pActor = ActorTable::GetInstance()->Resolve(i_Object);
+		EntityStore::GetInstance()->GetComponent<sPhysicsBody>(pActor->GetEntity())->m_PoolHandle = Handle;
 	}
 
 	/******************************************************************************
-		Function     : DeleteMarkedToDeathGameObjects
-		Description  : Function to delete marked to death actor game object from 
-					physics system
-		Input        : void
+		Function     : OnActorDestroyed
+		Description  : Deletes the physics object of a destroyed actor, found
+					through its physics body component
+		Input        : Actor &i_Actor
 		Output       : void
 		Return Value : 
 
@@ -73,19 +114,13 @@ namespace Engine
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
-	void PhysicsSystem::DeleteMarkedToDeathGameObjects(void)
+	void PhysicsSystem::OnActorDestroyed(Actor &i_Actor)
 	{
-		for (unsigned long ulCount = 0; ulCount < m_PhysicsObjectList.size(); )
+		sPhysicsBody *pBody = EntityStore::GetInstance()->GetComponent<sPhysicsBody>(i_Actor.GetEntity());
+
+		if (pBody != NULL)
 		{
-			if( m_PhysicsObjectList.at(ulCount)->m_WorldObject->IsMarkedForDeath() )
-			{
-				delete m_PhysicsObjectList.at(ulCount);
-				m_PhysicsObjectList.erase(m_PhysicsObjectList.begin() + ulCount);
-			}
-			else
-			{
-				ulCount++;
-			}
+			PhysicsObject::PhysicsObjectPool->DeAllocate(pBody->m_PoolHandle);
 		}
 	}
 
@@ -103,12 +138,10 @@ namespace Engine
 	******************************************************************************/
 	void PhysicsSystem::DeleteAllGameObjects(void)
 	{
-		for (unsigned long ulCount = 0; ulCount < m_PhysicsObjectList.size(); ulCount++)
+		ForEachPhysicsObject([](PhysicsObject *i_pPhysicsObject, sPoolHandle i_Handle)
 		{
-			delete m_PhysicsObjectList.at(ulCount);
-		}
-
-		m_PhysicsObjectList.clear();
+			PhysicsObject::PhysicsObjectPool->DeAllocate(i_Handle);
+		});
 	}
 
 	/******************************************************************************
@@ -126,39 +159,88 @@ namespace Engine
 	{
 			
 		{
-			Vector3  CurrentPosition;
-			Vector3 CurrentVelocity;
-			Vector3 CurrentAcceleration;
-			Vector3 CurrentFriction;
+			//Close a few of the holes left by deleted objects every frame
+			PhysicsObject::PhysicsObjectPool->Defragment(PHYSICS_DEFRAG_MOVES_PER_FRAME);
+
+			//Walk the component chunks of the physics bodies instead of the actors.
+			//The store is walked here, the workers get one chunk each. This runs
+			//as a frame task on any worker, so the chunks are not gathered in the
+			//main thread's frame arena
+			std::vector<sPhysicsChunk> &Chunks = m_Chunks;
+			Chunks.clear();
+
+			EntityStore::GetInstance()->ForEachChunk<sTransform, sVelocity, sPhysicsBody>([&Chunks](const unsigned long i_ulCount, const EntityId *i_pEntities,
+				sTransform *i_pTransforms, sVelocity *i_pVelocities, sPhysicsBody *i_pBodies)
+			{
+				sPhysicsChunk Chunk;
+				Chunk.m_ulCount = i_ulCount;
+				Chunk.m_pTransforms = i_pTransforms;
+				Chunk.m_pVelocities = i_pVelocities;
 
-			DeleteMarkedToDeathGameObjects();
+				Chunks.push_back(Chunk);
+			});
 
-			for (unsigned long ulCount = 0; ulCount< m_PhysicsObjectList.size(); ulCount++)
+			auto IntegrateChunks = [&Chunks, i_DeltaTime](const unsigned long i_ulBegin, const unsigned long i_ulEnd)
 			{
-				CurrentPosition = m_PhysicsObjectList.at(ulCount)->m_WorldObject->GetPosition();
-				CurrentVelocity = m_PhysicsObjectList.at(ulCount)->m_WorldObject->GetVelocity();
-				CurrentAcceleration = m_PhysicsObjectList.at(ulCount)->m_WorldObject->GetAcceleration();
-				CurrentFriction = m_PhysicsObjectList.at(ulCount)->m_WorldObject->GetFriction();
+				for (unsigned long ulChunk = i_ulBegin; ulChunk < i_ulEnd; ulChunk++)
+				{
+					const sPhysicsChunk &Chunk = Chunks[ulChunk];
+
+					for (unsigned long i = 0; i < Chunk.m_ulCount; i++)
+					{
+						sVelocity &Velocity = Chunk.m_pVelocities[i];
+
+						Velocity.mVelocity += Velocity.mAcceleration * i_DeltaTime;
+
+						//Update the Player position based on velocity, resting bodies
+						//keep their matrices
+						if (Velocity.mVelocity != Vector3(0.0f, 0.0f, 0.0f))
+						{
+							Chunk.m_pTransforms[i].mPosition += Velocity.mVelocity * i_DeltaTime;
+							Chunk.m_pTransforms[i].mDirty = true;
+						}
+
+						//Apply Friction if present
+						Velocity.mVelocity += Velocity.mFriction * i_DeltaTime;
+					}
+				}
+			};
+
+			JobSystem::GetInstance()->ParallelFor(0, static_cast<unsigned long>(Chunks.size()), IntegrateChunks, 1);
+
+			//The step ends with the bodies that moved and whatever is attached
+			//to them in place, for the camera and the render latch after this
+			Actor::UpdateTransforms();
+		}
+		return;
+	}
 
-				m_PhysicsObjectList.at(ulCount)->m_WorldObject->SetVelocity(CurrentVelocity +  Vector3(CurrentAcceleration.x() * i_DeltaTime, CurrentAcceleration.y() * i_DeltaTime, CurrentAcceleration.z() * i_DeltaTime ));
-				CurrentVelocity = m_PhysicsObjectList.at(ulCount)->m_WorldObject->GetVelocity();
+	void PhysicsSystem::ApplyEulerPhysicsTask(const sFrameTime &i_Time)
+	{
+		GetInstance()->ApplyEulerPhysics(i_Time.m_fDeltaTime);
+	}
 
-				//Update the Player position based on velocity
-				m_PhysicsObjectList.at(ulCount)->m_WorldObject->SetPosition(CurrentPosition + Vector3(CurrentVelocity.x() * i_DeltaTime, CurrentVelocity.y() * i_DeltaTime, CurrentVelocity.z() * i_DeltaTime));
+	/******************************************************************************
+		Function     : AddFrameTasks
+		Description  : Adds the integration of the physics bodies to the frame
+					graph
+		Input        : FrameGraph &io_Graph
+		Output       : 
+		Return Value : 
 
-				Vector3 CPosition = m_PhysicsObjectList.at(ulCount)->m_WorldObject->GetPosition();
-				//CONSOLE_PRINT("X=%f, Y=%f, Z=%f", CPosition.x(), CPosition.y(), CPosition.z());
-				//Apply Friction if present
-				m_PhysicsObjectList.at(ulCount)->m_WorldObject->SetVelocity(CurrentVelocity +  Vector3(CurrentFriction.x() * i_DeltaTime, CurrentFriction.y() * i_DeltaTime, CurrentFriction.z() * i_DeltaTime ));
-			}
-		}
-		return;
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void PhysicsSystem::AddFrameTasks(FrameGraph &io_Graph)
+	{
+		io_Graph.AddTask("Physics", &PhysicsSystem::ApplyEulerPhysicsTask, io_Graph.GetResource("Entities"), io_Graph.GetResource("Actors"));
 	}
 
 	/******************************************************************************
 		Function     : ApplyEulerPhysics
 		Description  : Function to apply Euler equation on input physics object
-		Input        : SharedPointer<Actor> i_Object, float i_DeltaTime
+		Input        : const ActorHandle &i_Object, float i_DeltaTime
 		Output       : 
 		Return Value : 
 
@@ -166,30 +248,34 @@ namespace Engine
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
-	void PhysicsSystem::ApplyEulerPhysics(SharedPointer<Actor> i_Object, float i_DeltaTime)
+	void PhysicsSystem::ApplyEulerPhysics(const ActorHandle &i_Object, float i_DeltaTime)
 	{
 		Vector3  CurrentPosition;
 		Vector3 CurrentVelocity;
 		Vector3 CurrentAcceleration;
 		Vector3 CurrentFriction;
 
-		DeleteMarkedToDeathGameObjects();
+		Actor *pObject = ActorTable::GetInstance()->Resolve(i_Object);
 
+		if (NULL == pObject)
+		{
+			return;
+		}
 		
-		CurrentPosition = i_Object->GetPosition();
-		CurrentVelocity = i_Object->GetVelocity();
+		CurrentPosition = pObject->GetPosition();
+		CurrentVelocity = pObject->GetVelocity();
 
-		CurrentAcceleration = i_Object->GetAcceleration();
-		CurrentFriction = i_Object->GetFriction();
+		CurrentAcceleration = pObject->GetAcceleration();
+		CurrentFriction = pObject->GetFriction();
 
-		i_Object->SetVelocity(CurrentVelocity +  Vector3(CurrentAcceleration.x() * i_DeltaTime, CurrentAcceleration.y() * i_DeltaTime, CurrentAcceleration.z() * i_DeltaTime ));
-		CurrentVelocity = i_Object->GetVelocity();
+		pObject->SetVelocity(CurrentVelocity +  Vector3(CurrentAcceleration.x() * i_DeltaTime, CurrentAcceleration.y() * i_DeltaTime, CurrentAcceleration.z() * i_DeltaTime ));
+		CurrentVelocity = pObject->GetVelocity();
 
 		//Update the Player position based on velocity
-		i_Object->SetPosition(CurrentPosition + Vector3(CurrentVelocity.x() * i_DeltaTime, CurrentVelocity.y() * i_DeltaTime, CurrentVelocity.z() * i_DeltaTime));
+		pObject->SetPosition(CurrentPosition + Vector3(CurrentVelocity.x() * i_DeltaTime, CurrentVelocity.y() * i_DeltaTime, CurrentVelocity.z() * i_DeltaTime));
 
 		//Apply Friction if present
-		i_Object->SetVelocity(CurrentVelocity -  Vector3(CurrentFriction.x() * i_DeltaTime, CurrentFriction.y() * i_DeltaTime, CurrentFriction.z() * i_DeltaTime ));
+		pObject->SetVelocity(CurrentVelocity -  Vector3(CurrentFriction.x() * i_DeltaTime, CurrentFriction.y() * i_DeltaTime, CurrentFriction.z() * i_DeltaTime ));
 
 		return;
 	}
@@ -198,28 +284,35 @@ namespace Engine
 	{
 		bool WereThereErrors = false;
 
-		if (PhysicsObject::PhysicsMemoryPool == NULL)
+		if (PhysicsObject::PhysicsObjectPool == NULL)
 		{
-			PhysicsObject::PhysicsMemoryPool = MemoryPool::Create(sizeof(PhysicsObject), MAX_PHYSICS_OBJECTS);
-			if (PhysicsObject::PhysicsMemoryPool == NULL)
+			PhysicsObject::PhysicsObjectPool = CompactingPool<PhysicsObject>::Create(PHYSICS_OBJECTS_INITIAL_CAPACITY);
+			if (PhysicsObject::PhysicsObjectPool == NULL)
 			{
 				assert(false);
 				WereThereErrors = false;
 			}
+			else
+			{
+				PhysicsObject::PhysicsObjectPool->RegisterStats("Physics objects");
+			}
 		}
 
+		ActorTable::GetInstance()->AddDestroyedCallback(&PhysicsSystem::OnActorDestroyed);
+
 		mInitilized = !WereThereErrors;
 	}
 
 	PhysicsSystem::~PhysicsSystem()
 	{
+		ActorTable::GetInstance()->RemoveDestroyedCallback(&PhysicsSystem::OnActorDestroyed);
+
 		DeleteAllGameObjects();
-		m_PhysicsObjectList.clear();
 
-		if (PhysicsObject::PhysicsMemoryPool)
+		if (PhysicsObject::PhysicsObjectPool)
 		{
-			unsigned long ulOutLength;
-			PhysicsObject::PhysicsMemoryPool->Destroy(&ulOutLength);
+			PhysicsObject::PhysicsObjectPool->Destroy();
+			PhysicsObject::PhysicsObjectPool = NULL;
 		}
 	}
 
@@ -5,60 +5,76 @@
 
 #include <vector>
 #include "Actor.h"
-#include "MemoryPool.h"
+#include "CompactingPool.h"
 #include "SharedPointer.h"
+#include "EntityStore.h"
+#include "FrameGraph.h"
 
 namespace Engine
 {
+	//Component of the actors the physics system integrates, the pool handle
+	//finds the physics object again when the actor is destroyed
+	struct sPhysicsBody
+	{
+		sPoolHandle	m_PoolHandle;
+	};
+
 	class PhysicsSystem
 	{
 	private:
 		class PhysicsObject
 		{
 		public:
-			SharedPointer<Actor> m_WorldObject;
+			ActorHandle m_WorldObject;
 
-			static MemoryPool *PhysicsMemoryPool;
+			//Objects are moved by defragmentation, nothing may point at them
+			static CompactingPool<PhysicsObject> *PhysicsObjectPool;
 
-			PhysicsObject(SharedPointer<Actor> &i_Object);
+			PhysicsObject(const ActorHandle &i_Object);
+			PhysicsObject(PhysicsObject &&i_Other);
 
 			~PhysicsObject();
+		} ;
 
-			inline void * operator new(size_t i_size)
-			{
-				assert(i_size == sizeof(PhysicsObject));
+		//Every live physics object is in the pool, walk it in storage order
+		template<class Function>
+		static void ForEachPhysicsObject(Function i_Function)
+		{
+			PhysicsObject::PhysicsObjectPool->ForEach(i_Function);
+		}
 
-				return PhysicsMemoryPool->Allocate(i_size);
-			}
+		//Component arrays of one chunk of physics bodies
+		struct sPhysicsChunk
+		{
+			unsigned long	m_ulCount;
+			sTransform		*m_pTransforms;
+			sVelocity		*m_pVelocities;
+		};
 
-			inline void operator delete(void *i_ptr)
-			{
-				if (i_ptr != NULL)
-				{
-					PhysicsMemoryPool->DeAllocate(i_ptr);
-				}
-			}
-		} ;
+		std::vector<sPhysicsChunk>	m_Chunks;		//Gathered by ApplyEulerPhysics, kept to reuse the memory
 
-		std::vector<PhysicsObject *> m_PhysicsObjectList;
 		static PhysicsSystem *mInstance;
 		bool mInitilized;
 
+		static void ApplyEulerPhysicsTask(const sFrameTime &i_Time);
+
 		PhysicsSystem();
 		~PhysicsSystem();
 		PhysicsSystem & operator=(const PhysicsSystem & i_rhs);
 		PhysicsSystem(const PhysicsSystem & i_Other);
-		static const unsigned int  MAX_PHYSICS_OBJECTS;
+		static const unsigned int  PHYSICS_OBJECTS_INITIAL_CAPACITY;
+		static const unsigned int  PHYSICS_DEFRAG_MOVES_PER_FRAME;
 	public:
 
-		void AddActorGameObject(SharedPointer<Actor> &i_Object);
-		void DeleteMarkedToDeathGameObjects(void);
+		void AddActorGameObject(const ActorHandle &i_Object);
+		static void OnActorDestroyed(Actor &i_Actor);
 		void DeleteAllGameObjects(void);
 		void ApplyEulerPhysics(float i_DeltaTime);
-		void ApplyEulerPhysics(SharedPointer<Actor> i_Object, float i_DeltaTime);
+		void ApplyEulerPhysics(const ActorHandle &i_Object, float i_DeltaTime);
 		static bool CreateInstance();
 		static PhysicsSystem * GetInstance();
 		static void Destroy();
+		static void AddFrameTasks(FrameGraph &io_Graph);
 	} ;
 }
 #endif //__PHYSICS_SYSTEM_HEADER
\ No newline at end of file
@@ -8,20 +8,21 @@
 #include "Vector3.h"
 #include "HashedString.h"
 #include "DebugLineRenderer.h"
+#include "CameraSystem.h"
 
 namespace Engine
 {
-	MemoryPool *RenderableObjectSystem::Renderable3DObject::Renderer3DMemoryPool = NULL;
-	MemoryPool *RenderableObjectSystem::RenderableSprites::SpriteMemoryPool = NULL;
-	unsigned int RenderableObjectSystem::MAX_3D_OBJECTS = 100;
-	unsigned int RenderableObjectSystem::MAX_2D_OBJECTS = 100;
+	ObjectMemoryPool *RenderableObjectSystem::Renderable3DObject::Renderer3DMemoryPool = NULL;
+	ObjectMemoryPool *RenderableObjectSystem::RenderableSprites::SpriteMemoryPool = NULL;
+	unsigned int RenderableObjectSystem::RENDERABLE_3D_OBJECTS_PER_CHUNK = 64;
+	unsigned int RenderableObjectSystem::SPRITES_PER_CHUNK = 64;
 	RenderableObjectSystem* RenderableObjectSystem::mInstance = NULL;
 
 	/***************************3D Rendering **************************************/
 	/******************************************************************************
 		Function     : Renderable3DObject
 		Description  : Constructor of 3D Rendering object 
-		Input        : SharedPointer<Actor> &i_WorldObject, 
+		Input        : const ActorHandle &i_WorldObject, 
 					SharedPointer<Cheesy::Material> &i_Material,
 					SharedPointer<Cheesy::Mesh> &i_Mesh
 		Output       : 
@@ -33,7 +34,7 @@ namespace Engine
 	******************************************************************************/	
 	RenderableObjectSystem::Renderable3DObject::Renderable3DObject
 	(
-		SharedPointer<Actor> &i_WorldObject, 
+		const ActorHandle &i_WorldObject, 
 		SharedPointer<Material> &i_Material,
 		SharedPointer<Mesh> &i_Mesh
 	):
@@ -41,7 +42,17 @@ namespace Engine
 	mMaterial(i_Material),
 	mMesh(i_Mesh)
 	{
-			
+		Actor *pActor = GetActor();
+		assert(pActor);
+
+		sRenderable Renderable;
+		Renderable.m_pRenderable = this;
+		Renderable.m_StepPosition = pActor->GetPosition();
+		Renderable.m_PreviousStepPosition = Renderable.m_StepPosition;
+		Renderable.m_fStepRotation = pActor->GetRotation();
+		Renderable.m_fPreviousStepRotation = Renderable.m_fStepRotation;
+
+		EntityStore::GetInstance()->AddComponent(pActor->GetEntity(), Renderable);
 	}
 
 	/******************************************************************************
@@ -57,7 +68,13 @@ namespace Engine
 	******************************************************************************/
 	RenderableObjectSystem::Renderable3DObject::~Renderable3DObject()
 	{
+		//The component went with the entity if the actor is already gone
+		Actor *pActor = GetActor();
 
+		if (pActor != NULL)
+		{
+			EntityStore::GetInstance()->RemoveComponent<sRenderable>(pActor->GetEntity());
+		}
 	}
 
 	/******************************************************************************
@@ -65,13 +82,13 @@ namespace Engine
 		Description  : Function to get material of 3D object for rendering
 		Input        : void
 		Output       : shared material pointer for rendering
-		Return Value : SharedPointer<Material> 
+		Return Value : const SharedPointer<Material> &
 
 		History      :
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
-	SharedPointer<Material> RenderableObjectSystem::Renderable3DObject::GetMaterial(void) const
+	const SharedPointer<Material> & RenderableObjectSystem::Renderable3DObject::GetMaterial(void) const
 	{
 		return mMaterial;
 	}
@@ -81,13 +98,13 @@ namespace Engine
 		Description  : Function to get mesh of 3D object for rendering
 		Input        : void
 		Output       : shared mesh pointer for rendering
-		Return Value : SharedPointer<Mesh> 
+		Return Value : const SharedPointer<Mesh> &
 
 		History      :
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
-	SharedPointer<Mesh> RenderableObjectSystem::Renderable3DObject::GetMesh(void) const
+	const SharedPointer<Mesh> & RenderableObjectSystem::Renderable3DObject::GetMesh(void) const
 	{
 		return mMesh;
 	}
@@ -104,7 +121,7 @@ namespace Engine
 
 	}
 
-	SharedPointer<Sprite> RenderableObjectSystem::RenderableSprites::GetSprite(void) const
+	const SharedPointer<Sprite> & RenderableObjectSystem::RenderableSprites::GetSprite(void) const
 	{
 		return mSprite;
 	}
@@ -124,7 +141,7 @@ namespace Engine
 	Modification : Created function
 	******************************************************************************/
 	void RenderableObjectSystem::Add3DActorGameObject(
-		SharedPointer<Actor> &i_Object,
+		const ActorHandle &i_Object,
 		const char *pcMaterialPath,
 		const char *pcMeshPath)
 	{
@@ -155,7 +172,13 @@ namespace Engine
 			return;
 		}
 
-		m3DRenderableObjects.push_back(new Renderable3DObject(i_Object, NewMaterial, NewMesh));
+		//Owned by the 3D object pool, deleted by OnActorDestroyed
+		Renderable3DObject *pRenderable = new Renderable3DObject(i_Object, NewMaterial, NewMesh);
+
+		if (pRenderable != NULL)
+		{
+			m_3DObjectNames.Add(pRenderable->GetActor()->GetName(), pRenderable);
+		}
 	}
 
 	void RenderableObjectSystem::CreateSprite(const char* i_TexturePath, const sRectangle &i_texcoordsRect, const float left, const float top, const float width,
@@ -176,14 +199,20 @@ namespace Engine
 			return;
 		}
 
-		mSpriteRenderableObjects.push_back(new RenderableSprites(NewSprite));
+		//Owned by the sprite pool, deleted by DeleteSpriteGameObjectByName
+		RenderableSprites *pSprite = new RenderableSprites(NewSprite);
+
+		if (pSprite != NULL)
+		{
+			m_SpriteNames.Add(NewSprite->GetName().c_str(), pSprite);
+		}
 	}
 
 	/******************************************************************************
-		Function     : DeleteMarkedToDeathGameObjects
-		Description  : Function to delete marked to death actor game object from 
-					rendering system
-		Input        : void
+		Function     : OnActorDestroyed
+		Description  : Deletes the 3D object of a destroyed actor, found through
+					its renderable component
+		Input        : Actor &i_Actor
 		Output       : void
 		Return Value : 
 
@@ -191,19 +220,14 @@ namespace Engine
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
-	void RenderableObjectSystem::DeleteMarkedToDeathGameObjects(void)
+	void RenderableObjectSystem::OnActorDestroyed(Actor &i_Actor)
 	{
-		for (unsigned long ulCount = 0; ulCount < m3DRenderableObjects.size(); )
+		sRenderable *pRenderable = EntityStore::GetInstance()->GetComponent<sRenderable>(i_Actor.GetEntity());
+
+		if( NULL != pRenderable )
 		{
-			if( m3DRenderableObjects.at(ulCount)->m_WorldObject->IsMarkedForDeath() )
-			{
-				delete (m3DRenderableObjects.at(ulCount));
-				m3DRenderableObjects.erase(m3DRenderableObjects.begin() + ulCount);
-			}
-			else
-			{
-				ulCount++;
-			}
+			mInstance->m_3DObjectNames.Remove(i_Actor.GetName(), pRenderable->m_pRenderable);
+			delete pRenderable->m_pRenderable;
 		}
 	}
 
@@ -222,67 +246,62 @@ namespace Engine
 	void RenderableObjectSystem::DeleteAllRenderableObjects(void)
 	{
 		//Delete 3D objects
-		for (unsigned long ulCount = 0; ulCount < m3DRenderableObjects.size(); ulCount++)
+		ForEach3DObject([](Renderable3DObject *i_pRenderable)
 		{
-			delete m3DRenderableObjects.at(ulCount);
-		}
-
-		m3DRenderableObjects.clear();
+			delete i_pRenderable;
+		});
 
-		//Delete 3D objects
-		for (unsigned long ulCount = 0; ulCount < mSpriteRenderableObjects.size(); ulCount++)
+		//Delete sprites
+		ForEachSprite([](RenderableSprites *i_pSprite)
 		{
-			delete mSpriteRenderableObjects.at(ulCount);
-		}
+			delete i_pSprite;
+		});
 
-		mSpriteRenderableObjects.clear();
+		m_3DObjectNames.Clear();
+		m_SpriteNames.Clear();
 
 	}
 
 	bool RenderableObjectSystem::Delete3DGameObjectByName(const char * iName)
 	{
-		//Delete 3D objects
-		for (unsigned long ulCount = 0; ulCount < m3DRenderableObjects.size(); ulCount++)
+		Renderable3DObject *pRenderable = NULL;
+
+		//Delete one 3D object with the name
+		if (false == m_3DObjectNames.Find(iName, pRenderable))
 		{
-			if (m3DRenderableObjects.at(ulCount)->m_WorldObject->mHashedName.Get() == HashedString::Hash(iName))
-			{
-				delete m3DRenderableObjects.at(ulCount);
-				return true;
-			}
+			return false;
 		}
 
-		return false;
+		m_3DObjectNames.Remove(iName, pRenderable);
+		delete pRenderable;
+
+		return true;
 	}
 
 	bool RenderableObjectSystem::DeleteSpriteGameObjectByName(const char * iName)
 	{
+		RenderableSprites *pSprite = NULL;
 
-		//Delete Sprite
-		for (unsigned long ulCount = 0; ulCount < mSpriteRenderableObjects.size(); ulCount++)
+		//Delete one sprite with the name
+		if (false == m_SpriteNames.Find(iName, pSprite))
 		{
-			if (mSpriteRenderableObjects.at(ulCount)->GetSprite()->GetName() == (iName))
-			{
-				delete mSpriteRenderableObjects.at(ulCount);
-				return true;
-			}
+			return false;
 		}
 
-		return false;
+		m_SpriteNames.Remove(iName, pSprite);
+		delete pSprite;
+
+		return true;
 	}
 
 	RenderableObjectSystem::RenderableSprites * RenderableObjectSystem::FindSpriteGameObjectByName(const char * iName)
 	{
+		RenderableSprites *pFound = NULL;
 
-		//Find Sprite
-		for (unsigned long ulCount = 0; ulCount < mSpriteRenderableObjects.size(); ulCount++)
-		{
-			if (mSpriteRenderableObjects.at(ulCount)->GetSprite()->GetName() == (iName))
-			{
-				return mSpriteRenderableObjects.at(ulCount);
-			}
-		}
+		//Looked up every frame, a hash lookup instead of comparing every sprite name
+		m_SpriteNames.Find(iName, pFound);
 
-		return NULL;
+		return pFound;
 	}
 
 	bool RenderableObjectSystem::CreateDebugLines(const char * iName, const unsigned int iMaxlines)
@@ -307,6 +326,76 @@ namespace Engine
 #endif
 	}
 
+	/******************************************************************************
+		Function     : LatchTransforms
+		Description  : Keeps where every 3D object is after this simulation
+					step and where it was after the one before, rendering
+					blends between the two
+		Input        : 
+		Output       : 
+		Return Value : 
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void RenderableObjectSystem::LatchTransforms()
+	{
+		EntityStore::GetInstance()->ForEach<sTransform, sRenderable>([](EntityId i_Entity, const sTransform &i_Transform, sRenderable &io_Renderable)
+		{
+			io_Renderable.m_PreviousStepPosition = io_Renderable.m_StepPosition;
+			io_Renderable.m_fPreviousStepRotation = io_Renderable.m_fStepRotation;
+			io_Renderable.m_StepPosition = i_Transform.mPosition;
+			io_Renderable.m_fStepRotation = i_Transform.mRotation;
+		});
+	}
+
+	/******************************************************************************
+		Function     : ExtractRenderList
+		Description  : Copies what Render needs of every 3D object and the debug
+					lines out of the actors, after this the actors may move on
+					to the next frame while Render draws this one. Objects and
+					the camera are placed between the last two steps
+		Input        : const float i_fInterpolation, 0 at the step before the
+					last one, 1 at the last one
+		Output       : 
+		Return Value : 
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void RenderableObjectSystem::ExtractRenderList(const float i_fInterpolation)
+	{
+		m_RenderList.clear();
+
+		std::vector<sRenderItem> &RenderList = m_RenderList;
+
+		EntityStore::GetInstance()->ForEach<sController, sRenderable>([&RenderList, i_fInterpolation](EntityId i_Entity, const sController &i_Controller, const sRenderable &i_Renderable)
+		{
+			const Vector3 Position = i_Renderable.m_PreviousStepPosition + ((i_Renderable.m_StepPosition - i_Renderable.m_PreviousStepPosition) * i_fInterpolation);
+			const float fRotation = i_Renderable.m_fPreviousStepRotation + ((i_Renderable.m_fStepRotation - i_Renderable.m_fPreviousStepRotation) * i_fInterpolation);
+
+			Matrix4x4 Translation, Rotation;
+			Translation.CreateTranslation(Position);
+			Rotation.CreateZRotation(fRotation);
+
+			sRenderItem Item;
+			Item.m_Material = i_Renderable.m_pRenderable->GetMaterial();
+			Item.m_Mesh = i_Renderable.m_pRenderable->GetMesh();
+			Item.m_LocalToWorld = Translation * Rotation;
+			Item.m_DeltaTime = i_Controller.mDeltaTime;
+
+			RenderList.push_back(Item);
+		});
+
+		CameraSystem::GetInstance()->Interpolate(i_fInterpolation);
+
+#ifdef EAE2014_DEBUGLINE_SHOULDDRAW
+		DebugLineRenderer::GetInstance()->LatchLines();
+#endif
+	}
+
 	/******************************************************************************
 		Function     : Render
 		Description  : Function to render #D, 2D, Text objects
@@ -320,12 +409,6 @@ namespace Engine
 	******************************************************************************/
 	void RenderableObjectSystem::Render()
 	{
-		Vector3  CurrentPosition;
-		Vector3 CurrentVelocity;
-		Vector3 CurrentAcceleration;
-		Vector3 CurrentFriction;
-		
-		DeleteMarkedToDeathGameObjects();
 #ifdef EAE2014_GRAPHICS_AREPIXEVENTSENABLED
 		D3DPERF_BeginEvent(0, L"Mesh Drawing");
 #endif
@@ -334,10 +417,12 @@ namespace Engine
 
 		if (GraphicsSystem::GetInstance()->Begin3D())
 		{
-			//Render Logic
-			for (unsigned long ulCount = 0; ulCount < m3DRenderableObjects.size(); ulCount++)
+			//Render Logic, from the copy ExtractRenderList made
+			for (unsigned int uiItem = 0; uiItem < m_RenderList.size(); uiItem++)
 			{
-				GraphicsSystem::GetInstance()->Render(m3DRenderableObjects.at(ulCount)->GetMaterial(), m3DRenderableObjects.at(ulCount)->GetMesh(), m3DRenderableObjects[ulCount]->m_WorldObject);
+				const sRenderItem &Item = m_RenderList[uiItem];
+
+				GraphicsSystem::GetInstance()->Render(Item.m_Material, Item.m_Mesh, Item.m_LocalToWorld, Item.m_DeltaTime);
 			}
 #ifdef EAE2014_GRAPHICS_AREPIXEVENTSENABLED
 			D3DPERF_EndEvent();
@@ -359,10 +444,10 @@ namespace Engine
 		if (GraphicsSystem::GetInstance()->Begin2D())
 		{
 			//Render sprites
-			for (unsigned long ulCount = 0; ulCount < mSpriteRenderableObjects.size(); ulCount++)
+			ForEachSprite([](RenderableSprites *i_pSprite)
 			{
-				GraphicsSystem::GetInstance()->RenderSprite(mSpriteRenderableObjects.at(ulCount)->GetSprite());
-			}
+				GraphicsSystem::GetInstance()->RenderSprite(i_pSprite->GetSprite());
+			});
 		}
 #ifdef EAE2014_GRAPHICS_AREPIXEVENTSENABLED
 		D3DPERF_EndEvent();
@@ -377,43 +462,53 @@ namespace Engine
 
 		if (Renderable3DObject::Renderer3DMemoryPool == NULL)
 		{
-			Renderable3DObject::Renderer3DMemoryPool = MemoryPool::Create(sizeof(Renderable3DObject), MAX_3D_OBJECTS);
+			Renderable3DObject::Renderer3DMemoryPool = ObjectMemoryPool::Create(sizeof(Renderable3DObject), RENDERABLE_3D_OBJECTS_PER_CHUNK);
 			if (Renderable3DObject::Renderer3DMemoryPool == NULL)
 			{
 				assert(false);
 				WereThereErrors = true;
 			}
+			else
+			{
+				Renderable3DObject::Renderer3DMemoryPool->RegisterStats("Renderable 3D objects");
+			}
 		}
 
 		if (RenderableSprites::SpriteMemoryPool == NULL)
 		{
-			RenderableSprites::SpriteMemoryPool = MemoryPool::Create(sizeof(RenderableSprites), MAX_2D_OBJECTS);
+			RenderableSprites::SpriteMemoryPool = ObjectMemoryPool::Create(sizeof(RenderableSprites), SPRITES_PER_CHUNK);
 			if (RenderableSprites::SpriteMemoryPool == NULL)
 			{
 				assert(false);
 				WereThereErrors = true;
 			}
+			else
+			{
+				RenderableSprites::SpriteMemoryPool->RegisterStats("Renderable sprites");
+			}
 		}
 
+		ActorTable::GetInstance()->AddDestroyedCallback(&RenderableObjectSystem::OnActorDestroyed);
+
 		mInitilized = !WereThereErrors;
 	}
 
 	RenderableObjectSystem::~RenderableObjectSystem()
 	{
+		ActorTable::GetInstance()->RemoveDestroyedCallback(&RenderableObjectSystem::OnActorDestroyed);
+
 		DeleteAllRenderableObjects();
-		m3DRenderableObjects.clear();
-		mSpriteRenderableObjects.clear();
 
 		if (Renderable3DObject::Renderer3DMemoryPool)
 		{
-			unsigned long ulOutLength;
-			Renderable3DObject::Renderer3DMemoryPool->Destroy(&ulOutLength);
+			Renderable3DObject::Renderer3DMemoryPool->Destroy();
+			Renderable3DObject::Renderer3DMemoryPool = NULL;
 		}
 
 		if (RenderableSprites::SpriteMemoryPool)
 		{
-			unsigned long ulOutLength;
-			RenderableSprites::SpriteMemoryPool->Destroy(&ulOutLength);
+			RenderableSprites::SpriteMemoryPool->Destroy();
+			RenderableSprites::SpriteMemoryPool = NULL;
 		}
 	}
 
@@ -460,6 +555,8 @@ namespace Engine
 	{
 		if (mInstance)
 		{
+			//The copies hold on to materials and meshes, let them go while there is a device
+			mInstance->m_RenderList.clear();
 			GraphicsSystem::Destroy();
 			delete mInstance;
 
@@ -468,4 +565,50 @@ namespace Engine
 
 		assert(false);
 	}
+	void RenderableObjectSystem::LatchTransformsTask(const sFrameTime &i_Time)
+	{
+		GetInstance()->LatchTransforms();
+	}
+
+	void RenderableObjectSystem::ExtractRenderListTask(const sFrameTime &i_Time)
+	{
+		GetInstance()->ExtractRenderList(i_Time.m_fInterpolation);
+	}
+
+	void RenderableObjectSystem::RenderTask(const sFrameTime &i_Time)
+	{
+		GetInstance()->Render();
+	}
+
+	/******************************************************************************
+		Function     : AddFrameTasks
+		Description  : Adds the step latch, the render list copy and the drawing
+					to the frame graph. The copy and the drawing run once a
+					frame on the main thread as they hold D3D objects. Render
+					only reads the copy, the camera and the light, so it can
+					draw a frame while the workers update the next one
+		Input        : FrameGraph &io_Graph
+		Output       : 
+		Return Value : 
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void RenderableObjectSystem::AddFrameTasks(FrameGraph &io_Graph)
+	{
+		io_Graph.AddTask("LatchTransforms", &RenderableObjectSystem::LatchTransformsTask,
+						 io_Graph.GetResource("Entities"),
+						 io_Graph.GetResource("Actors"));
+
+		io_Graph.AddTask("ExtractRenderList", &RenderableObjectSystem::ExtractRenderListTask,
+						 io_Graph.GetResource("Actors") | io_Graph.GetResource("Entities"),
+						 io_Graph.GetResource("RenderList") | io_Graph.GetResource("DebugLines") | io_Graph.GetResource("Camera"),
+						 FrameGraph::TASK_MAIN_THREAD, FrameGraph::TASK_EVERY_FRAME);
+
+		io_Graph.AddTask("Render", &RenderableObjectSystem::RenderTask,
+						 io_Graph.GetResource("RenderList") | io_Graph.GetResource("Camera") | io_Graph.GetResource("Light"),
+						 0,
+						 FrameGraph::TASK_MAIN_THREAD, FrameGraph::TASK_EVERY_FRAME);
+	}
 }
\ No newline at end of file
@@ -11,6 +11,8 @@
 #include "Sprite.h"
 #include "Actor.h"
 #include "SharedPointer.h"
+#include "HashedNameIndex.h"
+#include "FrameGraph.h"
 
 namespace Engine
 {
@@ -27,17 +29,23 @@ namespace Engine
 
 		public:
 
-			static MemoryPool *Renderer3DMemoryPool;
-			SharedPointer<Actor> m_WorldObject;
+			static ObjectMemoryPool *Renderer3DMemoryPool;
+			ActorHandle m_WorldObject;
 
-			Renderable3DObject(SharedPointer<Actor> &i_WorldObject,
+			Renderable3DObject(const ActorHandle &i_WorldObject,
 				SharedPointer<Material>	&i_Material,
 				SharedPointer<Mesh> &i_Mesh);
 
 			~Renderable3DObject();
 
-			SharedPointer<Material> GetMaterial(void) const;
-			SharedPointer<Mesh> GetMesh(void) const;
+			//NULL once the actor is destroyed
+			inline Actor *GetActor(void) const
+			{
+				return ActorTable::GetInstance()->Resolve(m_WorldObject);
+			}
+
+			const SharedPointer<Material> & GetMaterial(void) const;
+			const SharedPointer<Mesh> & GetMesh(void) const;
 
 			inline void * operator new(size_t i_size)
 			{
@@ -55,6 +63,17 @@ namespace Engine
 			}
 		};
 
+		//Component of the actors that are drawn as 3D objects, with where the
+		//actor was after each of the last two simulation steps
+		struct sRenderable
+		{
+			Renderable3DObject	*m_pRenderable;
+			Vector3				m_StepPosition;
+			Vector3				m_PreviousStepPosition;
+			float				m_fStepRotation;
+			float				m_fPreviousStepRotation;
+		};
+
 	public:
 		class RenderableSprites
 		{
@@ -63,13 +82,13 @@ namespace Engine
 
 		public:
 
-			static MemoryPool *SpriteMemoryPool;
+			static ObjectMemoryPool *SpriteMemoryPool;
 
 			RenderableSprites(SharedPointer<Sprite> &i_Sprite);
 
 			~RenderableSprites();
 
-			SharedPointer<Sprite> GetSprite(void) const;
+			const SharedPointer<Sprite> & GetSprite(void) const;
 
 			inline void * operator new(size_t i_size)
 			{
@@ -88,23 +107,59 @@ namespace Engine
 		};
 
 	private:
+		//What Render draws of one 3D object, copied out of the entity store so
+		//the next frame's actors can move while this one is drawn
+		struct sRenderItem
+		{
+			SharedPointer<Material>	m_Material;
+			SharedPointer<Mesh>		m_Mesh;
+			Matrix4x4				m_LocalToWorld;
+			float					m_DeltaTime;
+		};
+
 		RenderableObjectSystem();
 		~RenderableObjectSystem();
 		RenderableObjectSystem(const RenderableObjectSystem & i_Other);
 		RenderableObjectSystem & operator=(const RenderableObjectSystem & i_rhs);
 
-		std::vector<Renderable3DObject *> m3DRenderableObjects;
-		std::vector<RenderableSprites *> mSpriteRenderableObjects;
+		//Every live renderable is in its pool, walk them in address order
+		template<class Function>
+		static void ForEach3DObject(Function i_Function)
+		{
+			Renderable3DObject::Renderer3DMemoryPool->ForEachAllocated([&i_Function](void *i_pObject)
+			{
+				i_Function(static_cast<Renderable3DObject *>(i_pObject));
+			});
+		}
+
+		template<class Function>
+		static void ForEachSprite(Function i_Function)
+		{
+			RenderableSprites::SpriteMemoryPool->ForEachAllocated([&i_Function](void *i_pObject)
+			{
+				i_Function(static_cast<RenderableSprites *>(i_pObject));
+			});
+		}
+
+		//3D objects by the name of their actor, sprites by texture path
+		HashedNameIndex<Renderable3DObject *>	m_3DObjectNames;
+		HashedNameIndex<RenderableSprites *>	m_SpriteNames;
+
+		std::vector<sRenderItem>	m_RenderList;		//Filled by ExtractRenderList, drawn by Render
+
+		static void LatchTransformsTask(const sFrameTime &i_Time);
+		static void ExtractRenderListTask(const sFrameTime &i_Time);
+		static void RenderTask(const sFrameTime &i_Time);
 
-		static unsigned int MAX_3D_OBJECTS;
-		static unsigned int MAX_2D_OBJECTS;
+		static unsigned int RENDERABLE_3D_OBJECTS_PER_CHUNK;
+		static unsigned int SPRITES_PER_CHUNK;
 
 		static RenderableObjectSystem * mInstance;
 		bool mInitilized;
 	public:
 
 		void Add3DActorGameObject(
-			SharedPointer<Actor> &i_Object,
+			const ActorHandle &i_Object,
 			const char *pcMaterialPath,
 			const char *pcMeshPath);
 
@@ -114,18 +169,21 @@ namespace Engine
 		bool CreateDebugLines(const char * iName, const unsigned int iMaxlines);
 		void AddDebugLines(const sLine &iLine);
 		
+		void LatchTransforms();
+		void ExtractRenderList(const float i_fInterpolation);
 		void Render();
 
 		bool Delete3DGameObjectByName(const char * iName);
 		bool DeleteSpriteGameObjectByName(const char * iName);
 		RenderableSprites * FindSpriteGameObjectByName(const char * iName);
-		void DeleteMarkedToDeathGameObjects(void);
+		static void OnActorDestroyed(Actor &i_Actor);
 		void DeleteAllRenderableObjects(void);
 
 		static bool CreateInstance(const HWND i_mainWindow);
 
 		static RenderableObjectSystem * GetInstance();
 		static void Destroy();
+		static void AddFrameTasks(FrameGraph &io_Graph);
 	} ;
 }
 #endif //__RENDERABLE_OBJECT_SYSTEM_HEADER
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 #include "ActorController.h"
 #include "Debug.h"
+#include "JobSystem.h"
 #include "PhysicsSystem.h"
 #include "WorldSystem.h"
 #include "RenderableObjectSystem.h"
@@ -11,14 +12,15 @@
 
 namespace Engine
 {
-	unsigned int WorldSystem::MAX_WORLD_OBJECTS = 100;
+	unsigned int WorldSystem::WORLD_OBJECTS_PER_CHUNK = 64;
+	unsigned int WorldSystem::ACTORS_PER_UPDATE_JOB = 16;
 	WorldSystem* WorldSystem::mInstance = NULL;
-	MemoryPool * WorldSystem::WorldObject::WorldMemoryPool = NULL;
+	ObjectMemoryPool * WorldSystem::WorldObject::WorldMemoryPool = NULL;
 		
 	/******************************************************************************
 		Function     : WorldObject
 		Description  : Constructor for world object
-		Input        : SharedPointer<Actor> &i_ActorObject
+		Input        : const ActorHandle &i_ActorObject
 		Output       : 
 		Return Value : 
 
@@ -26,10 +28,18 @@ namespace Engine
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
-	WorldSystem::WorldObject::WorldObject(SharedPointer<Actor> &i_ActorObject) :
-		m_WorldObject(i_ActorObject)
+	WorldSystem::WorldObject::WorldObject(const ActorHandle &i_ActorObject) :
+		m_WorldObject(i_ActorObject),
+		m_uiType(0),
+		m_uiTypeSlot(0)
 	{
+		Actor *pActor = GetActor();
+		assert(pActor);
 
+		sWorldEntry Entry;
+		Entry.m_pWorldObject = this;
+
+		EntityStore::GetInstance()->AddComponent(pActor->GetEntity(), Entry);
 	}
 
 	/******************************************************************************
@@ -45,7 +55,13 @@ namespace Engine
 	******************************************************************************/
 	WorldSystem::WorldObject::~WorldObject()
 	{
+		//The component went with the entity if the actor is already gone
+		Actor *pActor = GetActor();
 
+		if (pActor != NULL)
+		{
+			EntityStore::GetInstance()->RemoveComponent<sWorldEntry>(pActor->GetEntity());
+		}
 	}
 
 	/******************************************************************************
@@ -72,7 +88,7 @@ namespace Engine
 	{
 		assert(pcMaterialPath && i_GameObjectName && i_ActorType);
 
-		SharedPointer<Actor> NewActor = Actor::Create(i_vInitialPosition, i_InitialVelocity, i_vInitialAcceleration, i_GameObjectName, i_ActorType, i_Size, i_Rotation, iCollidesWith);
+		ActorHandle NewActor = Actor::Create(i_vInitialPosition, i_InitialVelocity, i_vInitialAcceleration, i_GameObjectName, i_ActorType, i_Size, i_Rotation, iCollidesWith);
 
 		//Add actor in world system
 		AddActorGameObject(NewActor);
@@ -88,7 +104,7 @@ namespace Engine
 	/******************************************************************************
 		Function     : AddActorGameObject
 		Description  : Function to add actor to world system
-		Input        : SharedPointer<Actor> &i_Object
+		Input        : const ActorHandle &i_Object
 		Output       : 
 		Return Value : 
 
@@ -97,15 +113,103 @@ namespace Engine
 		Modification : Created function
 	******************************************************************************/
 		
-	void WorldSystem::AddActorGameObject(SharedPointer<Actor> &i_Object)
+	void WorldSystem::AddActorGameObject(const ActorHandle &i_Object)
 	{
-		m_WorldObjectList.push_back(new WorldObject(i_Object));
+		//Owned by the world object pool, deleted by OnActorDestroyed
+		WorldObject *pWorldObject = new WorldObject(i_Object);
+
+		if (NULL == pWorldObject)
+		{
+			return;
+		}
+
+		const unsigned int uiType = GetTypeIndex(pWorldObject->GetActor()->mClassBitIndex);
+
+		pWorldObject->m_uiType = uiType;
+		pWorldObject->m_uiTypeSlot = static_cast<unsigned int>(m_TypeActors[uiType].size());
+
+		m_TypeActors[uiType].push_back(i_Object);
+		m_TypeObjects[uiType].push_back(pWorldObject);
+
+		m_NameIndex.Add(pWorldObject->GetActor()->GetName(), i_Object);
 	}
 
 	/******************************************************************************
-		Function     : DeleteMarkedToDeathGameObjects
-		Description  : Function to delete all marked to death actors
-		Input        : 
+		Function     : RemoveFromTypeBucket
+		Description  : Takes the world object out of its class bucket, the last
+					entry of the bucket fills the hole
+		Input        : WorldObject *i_pWorldObject
+		Output       : 
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void WorldSystem::RemoveFromTypeBucket(WorldObject *i_pWorldObject)
+	{
+		assert(i_pWorldObject);
+
+		std::vector<ActorHandle> &Actors = m_TypeActors[i_pWorldObject->m_uiType];
+		std::vector<WorldObject *> &Objects = m_TypeObjects[i_pWorldObject->m_uiType];
+		const unsigned int uiSlot = i_pWorldObject->m_uiTypeSlot;
+
+		assert((uiSlot < Objects.size()) && (Objects[uiSlot] == i_pWorldObject));
+
+		Actors[uiSlot] = Actors.back();
+		Objects[uiSlot] = Objects.back();
+		Objects[uiSlot]->m_uiTypeSlot = uiSlot;
+
+		Actors.pop_back();
+		Objects.pop_back();
+	}
+
+	/******************************************************************************
+		Function     : GetTypeMask
+		Description  : Class bit mask of an actor type, 0 for a type no actor
+					was ever declared with
+		Input        : const char *i_ActorType
+		Output       : 
+		Return Value : unsigned int
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	unsigned int WorldSystem::GetTypeMask(const char *i_ActorType)
+	{
+		assert(i_ActorType);
+
+		unsigned int uiClassMask = 0;
+
+		if (false == Actor::FindClassBitMask(i_ActorType, uiClassMask))
+		{
+			return 0;
+		}
+
+		return uiClassMask;
+	}
+
+	//Bucket of a class, the class mask of an actor has exactly one bit set
+	unsigned int WorldSystem::GetTypeIndex(const unsigned int i_uiClassMask)
+	{
+		assert((0 != i_uiClassMask) && (0 == (i_uiClassMask & (i_uiClassMask - 1))));
+
+		unsigned int uiType = 0;
+
+		while (0 == (i_uiClassMask & (1u << uiType)))
+		{
+			uiType++;
+		}
+
+		return uiType;
+	}
+
+	/******************************************************************************
+		Function     : OnActorDestroyed
+		Description  : Deletes the world object of a destroyed actor, found
+					through its world entry component
+		Input        : Actor &i_Actor
 		Output       : 
 		Return Value : 
 
@@ -113,19 +217,15 @@ namespace Engine
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
-	void WorldSystem::DeleteMarkedToDeathGameObjects(void)
+	void WorldSystem::OnActorDestroyed(Actor &i_Actor)
 	{
-		for (unsigned long ulCount = 0; ulCount < m_WorldObjectList.size(); )
+		sWorldEntry *pEntry = EntityStore::GetInstance()->GetComponent<sWorldEntry>(i_Actor.GetEntity());
+
+		if( NULL != pEntry )
 		{
-			if( m_WorldObjectList.at(ulCount)->m_WorldObject->IsMarkedForDeath() )
-			{
-				delete m_WorldObjectList.at(ulCount);
-				m_WorldObjectList.erase(m_WorldObjectList.begin() + ulCount);
-			}
-			else
-			{
-				ulCount++;
-			}
+			mInstance->RemoveFromTypeBucket(pEntry->m_pWorldObject);
+			mInstance->m_NameIndex.Remove(i_Actor.GetName(), pEntry->m_pWorldObject->m_WorldObject);
+			delete pEntry->m_pWorldObject;
 		}
 	}
 
@@ -142,40 +242,49 @@ namespace Engine
 	******************************************************************************/	
 	void WorldSystem::DeleteAllGameObjects(void)
 	{
-		for (unsigned long ulCount = 0; ulCount < m_WorldObjectList.size(); ulCount++)
+		ForEachWorldObject([](WorldObject *i_pWorldObject)
+		{
+			delete i_pWorldObject;
+		});
+
+		for (unsigned int uiType = 0; uiType < MAX_ACTOR_TYPES; uiType++)
 		{
-			delete m_WorldObjectList.at(ulCount);
+			m_TypeActors[uiType].clear();
+			m_TypeObjects[uiType].clear();
 		}
 
-		m_WorldObjectList.clear();
+		m_NameIndex.Clear();
 	}
 
 	/******************************************************************************
 		Function     : FindActorsByType
 		Description  : Function to find and return actors of input class
 		Input        : const char *i_ActorType
-		Output       : returns vector of objects of input actor type
-		Return Value : std::vector< SharedPointer<Actor>>
+		Output       : returns the bucket of the input actor type, nothing is
+						copied so it is only valid until the world changes
+		Return Value : ActorSpan
 
 		History      :
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/	
-	std::vector< SharedPointer<Actor>> WorldSystem::FindActorsByType(const char *i_ActorType)
+	ActorSpan WorldSystem::FindActorsByType(const char *i_ActorType) const
 	{
-		assert(i_ActorType);
+		const unsigned int uiClassMask = GetTypeMask(i_ActorType);
+
+		if (0 == uiClassMask)
+		{
+			return ActorSpan(NULL, NULL);
+		}
 
-		std::vector< SharedPointer<Actor>> ActorsList;
+		const std::vector<ActorHandle> &Bucket = m_TypeActors[GetTypeIndex(uiClassMask)];
 
-		for (unsigned long ulCount = 0; ulCount < m_WorldObjectList.size(); ulCount++)
+		if (Bucket.empty())
 		{
-			if( true == m_WorldObjectList.at(ulCount)->m_WorldObject->IsA(i_ActorType) )
-			{
-				ActorsList.push_back(m_WorldObjectList.at(ulCount)->m_WorldObject);
-			}
+			return ActorSpan(NULL, NULL);
 		}
 
-		return ActorsList;
+		return ActorSpan(&Bucket[0], &Bucket[0] + Bucket.size());
 	}
 
 	/******************************************************************************
@@ -189,49 +298,159 @@ namespace Engine
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/	
-	unsigned int WorldSystem::FindActorCountByType(const char *i_ActorType)
+	unsigned int WorldSystem::FindActorCountByType(const char *i_ActorType) const
 	{
-		assert(i_ActorType);
+		return FindActorCountByTypes(GetTypeMask(i_ActorType));
+	}
+
+	/******************************************************************************
+		Function     : FindActorsByTypes
+		Description  : Function to walk the actors of several classes
+		Input        : const unsigned int i_uiTypeMask, class bit masks of the
+						types or'ed together
+		Output       : returns a range over the buckets of the types, valid
+						until the world changes
+		Return Value : ActorTypeRange
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/	
+	ActorTypeRange WorldSystem::FindActorsByTypes(const unsigned int i_uiTypeMask) const
+	{
+		return ActorTypeRange(m_TypeActors, i_uiTypeMask);
+	}
+
+	/******************************************************************************
+		Function     : FindActorCountByTypes
+		Description  : Function to count the actors of several classes
+		Input        : const unsigned int i_uiTypeMask, class bit masks of the
+						types or'ed together
+		Output       : returns count of objects of the input types
+		Return Value : unsigned int
 
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/	
+	unsigned int WorldSystem::FindActorCountByTypes(const unsigned int i_uiTypeMask) const
+	{
 		unsigned int Count = 0;
 
-		for (unsigned long ulCount = 0; ulCount < m_WorldObjectList.size(); ulCount++)
+		for (unsigned int uiType = 0; uiType < MAX_ACTOR_TYPES; uiType++)
 		{
-			if( true == m_WorldObjectList.at(ulCount)->m_WorldObject->IsA(i_ActorType) )
+			if (0 != (i_uiTypeMask & (1u << uiType)))
 			{
-				Count++;
+				Count += static_cast<unsigned int>(m_TypeActors[uiType].size());
 			}
 		}
 
 		return Count;
 	}
 
+	/******************************************************************************
+		Function     : FindActorByName
+		Description  : Function to find an actor by name
+		Input        : const char *i_ActorName
+		Output       : returns the handle of an actor with the name, a null
+						handle if there is none
+		Return Value : ActorHandle
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/	
+	ActorHandle WorldSystem::FindActorByName(const char *i_ActorName) const
+	{
+		ActorHandle Found;
+
+		m_NameIndex.Find(i_ActorName, Found);
+
+		return Found;
+	}
+
+	ActorTypeRange::Iterator::Iterator(const std::vector<ActorHandle> *i_pBuckets, const unsigned int i_uiTypeMask) :
+		m_pBuckets(i_pBuckets),
+		m_uiRemainingMask(i_uiTypeMask),
+		m_pCurrent(NULL),
+		m_pBucketEnd(NULL)
+	{
+		NextBucket();
+	}
+
+	ActorTypeRange::Iterator & ActorTypeRange::Iterator::operator++(void)
+	{
+		assert(NULL != m_pCurrent);
+
+		if (++m_pCurrent == m_pBucketEnd)
+		{
+			NextBucket();
+		}
+
+		return *this;
+	}
+
+	//Moves to the first actor of the next non empty bucket in the mask, the end
+	//iterator has no current actor
+	void ActorTypeRange::Iterator::NextBucket(void)
+	{
+		m_pCurrent = NULL;
+		m_pBucketEnd = NULL;
+
+		while (0 != m_uiRemainingMask)
+		{
+			unsigned int uiType = 0;
+
+			while (0 == (m_uiRemainingMask & (1u << uiType)))
+			{
+				uiType++;
+			}
+
+			m_uiRemainingMask &= ~(1u << uiType);
+
+			const std::vector<ActorHandle> &Bucket = m_pBuckets[uiType];
+
+			if (false == Bucket.empty())
+			{
+				m_pCurrent = &Bucket[0];
+				m_pBucketEnd = m_pCurrent + Bucket.size();
+				return;
+			}
+		}
+	}
+
 	/******************************************************************************
 		Function     : FindAllActors
 		Description  : Function to find all actors
 		Input        : void
-		Output       : returns all objects in world system
-		Return Value : vector< SharedPointer<Actor>>
+		Output       : returns all objects in world system, the vector lives in
+						the frame arena and must not be kept past next frame
+		Return Value : FrameVector<ActorHandle>
 
 		History      :
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/	
-	std::vector< SharedPointer<Actor>> WorldSystem::FindAllActors(void)
+	FrameVector<ActorHandle> WorldSystem::FindAllActors(void)
 	{
-		std::vector< SharedPointer<Actor>> ActorsList;
+		FrameVector<ActorHandle> ActorsList;
+		ActorsList.reserve(WorldObject::WorldMemoryPool->GetLiveCount());
 
-		for (unsigned long ulCount = 0; ulCount < m_WorldObjectList.size(); ulCount++)
+		ForEachWorldObject([&ActorsList](WorldObject *i_pWorldObject)
 		{
-			ActorsList.push_back(m_WorldObjectList.at(ulCount)->m_WorldObject);
-		}
+			if( NULL != i_pWorldObject->GetActor() )
+			{
+				ActorsList.push_back(i_pWorldObject->m_WorldObject);
+			}
+		});
 
 		return ActorsList;
 	}
 
 	/******************************************************************************
 		Function     : ActorsUpdate
-		Description  : Function to update all actors
+		Description  : Function to update all actors, spread over the job
+					system workers
 		Input        : const float i_DeltaTime
 		Output       : void
 		Return Value : void
@@ -242,12 +461,58 @@ namespace Engine
 	******************************************************************************/	
 	void WorldSystem::ActorsUpdate(const float i_DeltaTime)
 	{
-		DeleteMarkedToDeathGameObjects();
+		//This runs as a frame task on any worker, so the actors are gathered
+		//into a member array and not into the main thread's frame arena
+		std::vector<Actor *> &Actors = m_UpdateActors;
+		Actors.clear();
+		Actors.reserve(WorldObject::WorldMemoryPool->GetLiveCount());
 
-		for (unsigned long ulCount = 0; ulCount < m_WorldObjectList.size(); ulCount++)
+		ForEachWorldObject([&Actors](WorldObject *i_pWorldObject)
 		{
-				m_WorldObjectList.at(ulCount)->m_WorldObject->Update(i_DeltaTime);
-		}
+			Actors.push_back(i_pWorldObject->GetActor());
+		});
+
+		auto UpdateActors = [&Actors, i_DeltaTime](const unsigned long i_ulBegin, const unsigned long i_ulEnd)
+		{
+			for (unsigned long ulActor = i_ulBegin; ulActor < i_ulEnd; ulActor++)
+			{
+				Actors[ulActor]->Update(i_DeltaTime);
+			}
+		};
+
+		JobSystem::GetInstance()->ParallelFor(0, static_cast<unsigned long>(Actors.size()), UpdateActors, ACTORS_PER_UPDATE_JOB);
+	}
+
+	void WorldSystem::ActorsUpdateTask(const sFrameTime &i_Time)
+	{
+		GetInstance()->ActorsUpdate(i_Time.m_fDeltaTime);
+	}
+
+	void WorldSystem::UpdateTransformsTask(const sFrameTime &i_Time)
+	{
+		Actor::UpdateTransforms();
+	}
+
+	/******************************************************************************
+		Function     : AddFrameTasks
+		Description  : Adds the actor update to the frame graph, controllers
+					move their actors and draw debug lines. The matrices of
+					the actors that moved are rebuilt right after, before
+					anything later in the step reads them
+		Input        : FrameGraph &io_Graph
+		Output       : void
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void WorldSystem::AddFrameTasks(FrameGraph &io_Graph)
+	{
+		io_Graph.AddTask("ActorsUpdate", &WorldSystem::ActorsUpdateTask,
+						 io_Graph.GetResource("Entities"),
+						 io_Graph.GetResource("Actors") | io_Graph.GetResource("DebugLines"));
+		io_Graph.AddTask("UpdateTransforms", &WorldSystem::UpdateTransformsTask, io_Graph.GetResource("Entities"), io_Graph.GetResource("Actors"));
 	}
 
 	WorldSystem::WorldSystem()
@@ -256,26 +521,33 @@ namespace Engine
 
 		if (WorldObject::WorldMemoryPool == NULL)
 		{
-			WorldObject::WorldMemoryPool = MemoryPool::Create(sizeof(WorldObject), MAX_WORLD_OBJECTS);
+			WorldObject::WorldMemoryPool = ObjectMemoryPool::Create(sizeof(WorldObject), WORLD_OBJECTS_PER_CHUNK);
 			if (WorldObject::WorldMemoryPool == NULL)
 			{
 				assert(false);
 				WereThereErrors = false;
 			}
+			else
+			{
+				WorldObject::WorldMemoryPool->RegisterStats("World objects");
+			}
 		}
 
+		ActorTable::GetInstance()->AddDestroyedCallback(&WorldSystem::OnActorDestroyed);
+
 		mInitilized = !WereThereErrors;
 	}
 
 	WorldSystem::~WorldSystem()
 	{
+		ActorTable::GetInstance()->RemoveDestroyedCallback(&WorldSystem::OnActorDestroyed);
+
 		DeleteAllGameObjects();
-		m_WorldObjectList.clear();
 
 		if (WorldObject::WorldMemoryPool)
 		{
-			unsigned long ulOutLength;
-			WorldObject::WorldMemoryPool->Destroy(&ulOutLength);
+			WorldObject::WorldMemoryPool->Destroy();
+			WorldObject::WorldMemoryPool = NULL;
 		}
 	}
 
@@ -6,12 +6,78 @@
 #include <vector>
 
 #include "Actor.h"
-#include "MemoryPool.h"
-#include "SharedPointer.h"
+#include "ObjectMemoryPool.h"
+#include "FrameArena.h"
+#include "HashedNameIndex.h"
+#include "FrameGraph.h"
 #include "MeshData.h"
 
 namespace Engine
 {
+	//Run of actor handles owned by the world system, valid until an actor is
+	//added to or removed from the world
+	class ActorSpan
+	{
+		const ActorHandle	*m_pBegin;
+		const ActorHandle	*m_pEnd;
+
+	public:
+		ActorSpan(const ActorHandle *i_pBegin, const ActorHandle *i_pEnd) :
+			m_pBegin(i_pBegin),
+			m_pEnd(i_pEnd)
+		{
+		}
+
+		inline const ActorHandle *begin(void) const { return m_pBegin; }
+		inline const ActorHandle *end(void) const { return m_pEnd; }
+		inline unsigned int size(void) const { return static_cast<unsigned int>(m_pEnd - m_pBegin); }
+		inline bool empty(void) const { return m_pBegin == m_pEnd; }
+
+		inline const ActorHandle & operator[](const unsigned int i_uiIndex) const
+		{
+			assert(i_uiIndex < size());
+
+			return m_pBegin[i_uiIndex];
+		}
+	};
+
+	//Actors of every type in a class bit mask, walked type bucket by type
+	//bucket without allocating. Same lifetime as ActorSpan.
+	class ActorTypeRange
+	{
+	public:
+		class Iterator
+		{
+			const std::vector<ActorHandle>	*m_pBuckets;
+			unsigned int					m_uiRemainingMask;		//Types not visited yet
+			const ActorHandle				*m_pCurrent;
+			const ActorHandle				*m_pBucketEnd;
+
+			void NextBucket(void);
+
+		public:
+			Iterator(const std::vector<ActorHandle> *i_pBuckets, const unsigned int i_uiTypeMask);
+
+			inline const ActorHandle & operator*(void) const { return *m_pCurrent; }
+			inline bool operator==(const Iterator &i_Other) const { return m_pCurrent == i_Other.m_pCurrent; }
+			inline bool operator!=(const Iterator &i_Other) const { return m_pCurrent != i_Other.m_pCurrent; }
+			Iterator & operator++(void);
+		};
+
+		ActorTypeRange(const std::vector<ActorHandle> *i_pBuckets, const unsigned int i_uiTypeMask) :
+			m_pBuckets(i_pBuckets),
+			m_uiTypeMask(i_uiTypeMask)
+		{
+		}
+
+		inline Iterator begin(void) const { return Iterator(m_pBuckets, m_uiTypeMask); }
+		inline Iterator end(void) const { return Iterator(m_pBuckets, 0); }
+
+	private:
+		const std::vector<ActorHandle>	*m_pBuckets;
+		unsigned int					m_uiTypeMask;
+	};
+
 	class WorldSystem
 	{
 	private:
@@ -19,12 +85,20 @@ namespace Engine
 		{
 
 		public:
-			SharedPointer<Actor> m_WorldObject;
-			static MemoryPool* WorldMemoryPool;
+			ActorHandle m_WorldObject;
+			unsigned int m_uiType;			//Bucket of the actor's class
+			unsigned int m_uiTypeSlot;		//Position in that bucket
+			static ObjectMemoryPool* WorldMemoryPool;
 
-			WorldObject(SharedPointer<Actor> &i_ActorObject);
+			WorldObject(const ActorHandle &i_ActorObject);
 			~WorldObject();
 
+			//NULL once the actor is destroyed
+			inline Actor *GetActor(void) const
+			{
+				return ActorTable::GetInstance()->Resolve(m_WorldObject);
+			}
+
 			inline void * operator new (size_t i_size)
 			{
 				assert(i_size == sizeof(WorldObject));
@@ -41,16 +115,49 @@ namespace Engine
 			}
 		};
 
+		//Component of the actors in the world system
+		struct sWorldEntry
+		{
+			WorldObject	*m_pWorldObject;
+		};
+
 		WorldSystem();
 		~WorldSystem();
 		WorldSystem(const WorldSystem & i_Other);
 		WorldSystem & operator=(const WorldSystem & i_rhs);
 
-		void DeleteMarkedToDeathGameObjects(void);
+		static void OnActorDestroyed(Actor &i_Actor);
 		void DeleteAllGameObjects(void);
+		void RemoveFromTypeBucket(WorldObject *i_pWorldObject);
+		static unsigned int GetTypeMask(const char *i_ActorType);
+		static unsigned int GetTypeIndex(const unsigned int i_uiClassMask);
+
+		//Every live world object is in the pool, walk it in address order
+		template<class Function>
+		static void ForEachWorldObject(Function i_Function)
+		{
+			WorldObject::WorldMemoryPool->ForEachAllocated([&i_Function](void *i_pObject)
+			{
+				i_Function(static_cast<WorldObject *>(i_pObject));
+			});
+		}
 		
-		static unsigned int MAX_WORLD_OBJECTS;
-		std::vector<WorldObject *> m_WorldObjectList;
+		static const unsigned int MAX_ACTOR_TYPES = 32;	//Bits of an actor class mask
+
+		//One bucket per actor class, the handles and world objects at the same
+		//position belong together
+		std::vector<ActorHandle>	m_TypeActors[MAX_ACTOR_TYPES];
+		std::vector<WorldObject *>	m_TypeObjects[MAX_ACTOR_TYPES];
+
+		HashedNameIndex<ActorHandle>	m_NameIndex;	//By the name the actor was created with
+
+		std::vector<Actor *>	m_UpdateActors;			//Gathered by ActorsUpdate, kept to reuse the memory
+
+		static void ActorsUpdateTask(const sFrameTime &i_Time);
+		static void UpdateTransformsTask(const sFrameTime &i_Time);
+
+		static unsigned int WORLD_OBJECTS_PER_CHUNK;
+		static unsigned int ACTORS_PER_UPDATE_JOB;		//Smallest piece of ActorsUpdate a worker takes
 		static WorldSystem * mInstance;
 		bool mInitilized;
 	public:
@@ -66,15 +173,19 @@ namespace Engine
 			const char *pcMeshPath,
 			const std::vector<std::string> &iCollidesWith);
 
-		void AddActorGameObject(SharedPointer<Actor> &i_Object);
-		std::vector< SharedPointer<Actor>> FindActorsByType(const char *i_ActorType);
-		unsigned int FindActorCountByType(const char *i_ActorType);
-		std::vector< SharedPointer<Actor>> FindAllActors(void);
+		void AddActorGameObject(const ActorHandle &i_Object);
+		ActorSpan FindActorsByType(const char *i_ActorType) const;
+		unsigned int FindActorCountByType(const char *i_ActorType) const;
+		ActorTypeRange FindActorsByTypes(const unsigned int i_uiTypeMask) const;
+		unsigned int FindActorCountByTypes(const unsigned int i_uiTypeMask) const;
+		ActorHandle FindActorByName(const char *i_ActorName) const;
+		FrameVector<ActorHandle> FindAllActors(void);
 		void ActorsUpdate(const float i_DeltaTime);
 
 		static bool CreateInstance();
 		static WorldSystem * GetInstance();
 		static void Destroy();
+		static void AddFrameTasks(FrameGraph &io_Graph);
 	} ;
 }
 #endif //__WORLD_SYSTEM_HEADER
\ No newline at end of file
@@ -18,6 +18,8 @@ namespace
 	bool s_isFullScreenModeEnabled = false;
 	bool s_isAntiAliasingEnabled = false;
 	unsigned int s_width = 640;
+	float s_simulationRate = 60.0f;
+	unsigned int s_maxSimulationSteps = 5;
 
 	const char* s_userSettingsfileName = "settings.ini";
 }
@@ -61,6 +63,18 @@ bool UserSettings::IsAntiAliasingEnabled()
 	return s_isAntiAliasingEnabled;
 }
 
+float UserSettings::GetSimulationRate()
+{
+	InitializeIfNecessary();
+	return s_simulationRate;
+}
+
+unsigned int UserSettings::GetMaxSimulationSteps()
+{
+	InitializeIfNecessary();
+	return s_maxSimulationSteps;
+}
+
 // Helper Function Definitions
 //============================
 
@@ -369,6 +383,39 @@ namespace UserSettings
 				s_isAntiAliasingEnabled = lua_toboolean(&io_luaState, IndexOfValue) == 1 ? true : false;
 			}
 
+			if (strcmp(OptionName, "simulationrate") == 0)
+			{
+				if ((lua_type(&io_luaState, IndexOfValue) != LUA_TNUMBER) || (lua_tonumber(&io_luaState, IndexOfValue) < 0))
+				{
+					std::stringstream errorMessage;
+					errorMessage << "Ignoring the invalid entry for simulationrate: " << s_userSettingsfileName;
+					MessageBox(NULL, errorMessage.str().c_str(), "Error Reading UserSettings.ini", MB_OK | MB_ICONERROR);
+
+					// Pop the returned key value pair on error
+					lua_pop(&io_luaState, 2);
+					goto OnExit;
+				}
+
+				s_simulationRate = static_cast<float>(lua_tonumber(&io_luaState, IndexOfValue));
+			}
+
+			if (strcmp(OptionName, "maxsimulationsteps") == 0)
+			{
+				if ((lua_type(&io_luaState, IndexOfValue) != LUA_TNUMBER) || !IsNumberAnInteger(lua_tonumber(&io_luaState, IndexOfValue)) ||
+					(lua_tonumber(&io_luaState, IndexOfValue) < 1))
+				{
+					std::stringstream errorMessage;
+					errorMessage << "Ignoring the invalid entry for maxsimulationsteps: " << s_userSettingsfileName;
+					MessageBox(NULL, errorMessage.str().c_str(), "Error Reading UserSettings.ini", MB_OK | MB_ICONERROR);
+
+					// Pop the returned key value pair on error
+					lua_pop(&io_luaState, 2);
+					goto OnExit;
+				}
+
+				s_maxSimulationSteps = static_cast<unsigned int>(lua_tointeger(&io_luaState, IndexOfValue));
+			}
+
 			//Pop the value, but leave the key
 			lua_pop(&io_luaState, 1);
 		}
@@ -18,6 +18,8 @@ namespace UserSettings
 	unsigned int GetWidth();
 	bool IsFullScreenModeEnabled();
 	bool IsAntiAliasingEnabled();
+	float GetSimulationRate();
+	unsigned int GetMaxSimulationSteps();
 }
 
 #endif	// _USERSETTINGS_H
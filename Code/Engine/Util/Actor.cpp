@@ -8,12 +8,52 @@
 #include "NamedBitSet.h"
 #include "CollisionHandler.h"
 #include "CollisionSystem.h"
+#include "SmallObjectAllocator.h"
+#include "LevelArena.h"
+#include "TransformHierarchy.h"
 
 namespace Engine
 {
-	MemoryPool *Actor::m_pActorMemoryPool = NULL;
+	ObjectMemoryPool *Actor::m_pActorMemoryPool = NULL;
 	NamedBitSet<int> Actor::mActorTypeNamedBitSet;
 
+	sTransform::sTransform():
+		mPosition(Vector3(0.0f, 0.0f, 0.0f)),
+		mSize(Vector3(0.0f, 0.0f, 0.0f)),
+		mRotation(0.0f),
+		mDirty(true)
+	{
+
+	}
+
+	//Rebuilds the matrices from the position and rotation
+	void sTransform::UpdateMatrices(void)
+	{
+		Matrix4x4 Translation, Rotation;
+		Translation.CreateTranslation(mPosition);
+		Rotation.CreateZRotation(mRotation);
+
+		mLocalToWorld = Translation * Rotation;
+		mWorldToLocal = mLocalToWorld.GetInverse();
+		mDirty = false;
+	}
+
+	sVelocity::sVelocity():
+		mVelocity(Vector3(0.0f, 0.0f, 0.0f)),
+		mAcceleration(Vector3(0.0f, 0.0f, 0.0f)),
+		mFriction(Vector3(0.0f, 0.0f, 0.0f))
+	{
+
+	}
+
+	sController::sController():
+		m_pController(NULL),
+		m_pCollisionHandler(NULL),
+		mDeltaTime(static_cast<float>(CONSTANT_TIME_FRAME))
+	{
+
+	}
+
 	Actor::Actor
 	(
 		Vector3 i_Position,  
@@ -22,34 +62,32 @@ namespace Engine
 		Vector3 i_Acceleration,
 		float	i_Rotation,
 		char *i_GameObjectName,
-		const Matrix4x4 &i_LocalToWorld,
 		const unsigned int i_ClassBitIndex,
 		const unsigned int i_CollidesWithBitIndex,
 		const char *i_Type
 	):
-		mPosition(i_Position),
-		mSize(i_Size),
-		mVelocity(i_Velocity),
-		mAcceleration(i_Acceleration),
-		mRotation(i_Rotation),
+		mEntity(EntityStore::GetInstance()->CreateEntity<sTransform, sVelocity, sController>()),
 		mProjectedPosition(Vector3(0.0f, 0.0f, 0.0f)),
 		mProjectedVelocity(Vector3(0.0f, 0.0f, 0.0f)),
 		pGameObjectName(i_GameObjectName),
 		bMarkForDeath(false),
-		mFriction(Vector3(0.0f, 0.0f, 0.0f)),
-		mDeltaTime(static_cast<float>(CONSTANT_TIME_FRAME)),
-		mLocalToWorld(i_LocalToWorld),
-		m_pController(NULL),
-		m_pCollisionHandler(NULL),
 		mType(i_Type),
 		mClassBitIndex(i_ClassBitIndex),
 		mCollidesWithBitIndex(i_CollidesWithBitIndex),
 		mHashedName(i_GameObjectName)
 	{
+		sTransform &Transform = GetTransformComponent();
+		Transform.mPosition = i_Position;
+		Transform.mSize = i_Size;
+		Transform.mRotation = i_Rotation;
+		Transform.UpdateMatrices();
 
+		sVelocity &Velocity = GetVelocityComponent();
+		Velocity.mVelocity = i_Velocity;
+		Velocity.mAcceleration = i_Acceleration;
 	}
 
-	SharedPointer<Actor> Actor::Create
+	ActorHandle Actor::CreateWithCollisionMask
 	(
 		Vector3 i_Position,  
 		Vector3 i_Velocity, 
@@ -58,55 +96,97 @@ namespace Engine
 		const char *i_ActorType,
 		const Vector3 & i_Size,
 		const float i_Rotation,
-		const std::vector<std::string> &iCollidesWith
+		const unsigned int i_CollidesWithBitIndex
 	)
 	{
 		assert(i_ActorType && i_GameObjectName);
 		
-		char *pGameObjName = _strdup(i_GameObjectName);
+		//Actors made by LoadLevel keep their name in the level arena, it is released with the level
+		char *pGameObjName = LevelArena::IsLoadingLevel() ? LevelArena::GetInstance()->StrDup(i_GameObjectName) : SmallStrDup(i_GameObjectName);
 
+		unsigned int ClassBitIndex = GetClassBitIndex(i_ActorType);
+
+		Actor *pNewActor = new Actor(i_Position, i_Size, i_Velocity, i_Acceleration, i_Rotation, pGameObjName, ClassBitIndex, i_CollidesWithBitIndex, i_ActorType);
+		pNewActor->mHandle = ActorTable::GetInstance()->Add(pNewActor);
+
+		return pNewActor->mHandle;
+	}
+
+	unsigned int Actor::GetClassBitIndex(const char *i_ActorType)
+	{
 		int ClassBitIndex = 0;
+
 		if (false == mActorTypeNamedBitSet.FindBitMask(i_ActorType, ClassBitIndex))
 		{
-			CONSOLE_PRINT("Actor type is not present in global class types");
+			CONSOLE_PRINT("Actor type %s is not present in global class types", i_ActorType);
 			assert(false);
 		}
 
-		unsigned int CollidesWithBitIndex = 0;
-		int EachBitIndex = 0;
+		return ClassBitIndex;
+	}
 
-		for (unsigned int i = 0; i < iCollidesWith.size(); i++)
-		{
-			if (false == mActorTypeNamedBitSet.FindBitMask(iCollidesWith[i].c_str(), EachBitIndex))
-			{
-				CONSOLE_PRINT("Collides with type is not present in global class types");
-				assert(false);
-			}
+	//Same as GetClassBitIndex for a type that may not exist
+	bool Actor::FindClassBitMask(const char *i_ActorType, unsigned int &o_ClassBitMask)
+	{
+		int ClassBitMask = 0;
 
-			CollidesWithBitIndex |= EachBitIndex;
+		if (false == mActorTypeNamedBitSet.FindBitMask(i_ActorType, ClassBitMask))
+		{
+			return false;
 		}
 
-		Matrix4x4 Translation, Rotation, LocalToWorld;
+		o_ClassBitMask = static_cast<unsigned int>(ClassBitMask);
+		return true;
+	}
 
-		Translation.CreateTranslation(i_Position);
-		Rotation.CreateZRotation(i_Rotation);
+	/******************************************************************************
+		Function     : UpdateTransforms
+		Description  : Rebuilds the local to world and world to local matrices
+					of the actors that moved or turned since the last call.
+					Attached actors are placed by the hierarchy first, then
+					the rest in one walk over the transform components
+		Input        : void
+		Output       :
+		Return Value : void
 
-		LocalToWorld = Translation * Rotation;
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void Actor::UpdateTransforms(void)
+	{
+		TransformHierarchy::GetInstance()->Update();
 
-		return SharedPointer<Actor>(new Actor(i_Position, i_Size, i_Velocity, i_Acceleration, i_Rotation, pGameObjName, LocalToWorld, ClassBitIndex, CollidesWithBitIndex, i_ActorType));
+		EntityStore::GetInstance()->ForEachChunk<sTransform>([](const unsigned long i_ulCount, const EntityId *i_pEntities, sTransform *i_pTransforms)
+		{
+			for (unsigned long i = 0; i < i_ulCount; i++)
+			{
+				if (i_pTransforms[i].mDirty)
+				{
+					i_pTransforms[i].UpdateMatrices();
+				}
+			}
+		});
 	}
 
 	Actor::~Actor()
 	{
-		if (pGameObjectName != NULL)
+		EntityStore::GetInstance()->DestroyEntity(mEntity);
+
+		if ((pGameObjectName != NULL) && (false == LevelArena::IsLevelData(pGameObjectName)))
 		{
-			free(pGameObjectName);
+			SmallFree(pGameObjectName);
 		}
 	}
 
 	void Actor::MarkForDeath(void)
 	{
-		bMarkForDeath = true;
+		//Queued once, the table destroys it at the end of the frame
+		if (false == bMarkForDeath)
+		{
+			bMarkForDeath = true;
+			ActorTable::GetInstance()->QueueForDestruction(mHandle);
+		}
 	}
 
 	bool Actor::IsMarkedForDeath(void)
@@ -114,46 +194,98 @@ namespace Engine
 		return bMarkForDeath;
 	}
 
+	sTransform & Actor::GetTransformComponent(void) const
+	{
+		return *EntityStore::GetInstance()->GetComponent<sTransform>(mEntity);
+	}
+
+	sVelocity & Actor::GetVelocityComponent(void) const
+	{
+		return *EntityStore::GetInstance()->GetComponent<sVelocity>(mEntity);
+	}
+
+	sController & Actor::GetControllerComponent(void) const
+	{
+		return *EntityStore::GetInstance()->GetComponent<sController>(mEntity);
+	}
+
 	void Actor::SetPosition(const Vector3 & i_Position)
 	{
-		mPosition = i_Position;
+		sTransform &Transform = GetTransformComponent();
+		Transform.mPosition = i_Position;
+		Transform.mDirty = true;
 	}
 
 	void Actor::SetVelocity(const Vector3 & i_Velocity)
 	{
-		mVelocity = i_Velocity;
+		GetVelocityComponent().mVelocity = i_Velocity;
 	}
 
 	void Actor::SetAcceleration(const Vector3 & i_Acceleration)
 	{
-		mAcceleration = i_Acceleration;
+		GetVelocityComponent().mAcceleration = i_Acceleration;
 	}
 
 	void Actor::SetPosition(const float i_x, const float i_y, const float i_z)
 	{
-		mPosition.x(i_x);
-		mPosition.y(i_y);
-		mPosition.z(i_z);
+		sTransform &Transform = GetTransformComponent();
+		Transform.mPosition.SetCoordinates(i_x, i_y, i_z);
+		Transform.mDirty = true;
 	}
 
 	void Actor::SetVelocity(const float i_x, const float i_y, const float i_z)
 	{
-		mVelocity.x(i_x);
-		mVelocity.y(i_y);
-		mVelocity.z(i_z);
+		GetVelocityComponent().mVelocity.SetCoordinates(i_x, i_y, i_z);
 	}
 
 	void Actor::SetAcceleration(const float i_x, const float i_y, const float i_z)
 	{
-		mAcceleration.x(i_x);
-		mAcceleration.y(i_y);
-		mAcceleration.z(i_z);
+		GetVelocityComponent().mAcceleration.SetCoordinates(i_x, i_y, i_z);
 	}
 
 
 	void Actor::SetRotation(const float i_Rotation)
 	{
-		mRotation = i_Rotation;
+		sTransform &Transform = GetTransformComponent();
+		Transform.mRotation = i_Rotation;
+		Transform.mDirty = true;
+	}
+
+	/******************************************************************************
+		Function     : SetParent
+		Description  : Attaches the actor to another one, it follows it from
+					then on. A null handle detaches it. Either way it stays
+					where it is in the world until its parent moves
+		Input        : const ActorHandle &i_Parent
+		Output       :
+		Return Value : bool, false if the parent is attached below this actor
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	bool Actor::SetParent(const ActorHandle &i_Parent)
+	{
+		if (i_Parent.IsNull())
+		{
+			return TransformHierarchy::GetInstance()->SetParent(mEntity, INVALID_ENTITY);
+		}
+
+		Actor *pParent = ActorTable::GetInstance()->Resolve(i_Parent);
+		assert(pParent);
+
+		return TransformHierarchy::GetInstance()->SetParent(mEntity, pParent->mEntity);
+	}
+
+	//Position relative to the parent, only for an attached actor
+	void Actor::SetLocalPosition(const Vector3 & i_Position)
+	{
+		TransformHierarchy::GetInstance()->SetLocalPosition(mEntity, i_Position);
+	}
+
+	void Actor::SetLocalRotation(const float i_Rotation)
+	{
+		TransformHierarchy::GetInstance()->SetLocalRotation(mEntity, i_Rotation);
 	}
 
 	void Actor::SetProjectedPosition(const Vector3 & i_ProjectedPosition)
@@ -168,24 +300,26 @@ namespace Engine
 
 	void Actor::SetFriction(const Vector3 & i_Friction)
 	{
-		mFriction = i_Friction;
+		GetVelocityComponent().mFriction = i_Friction;
 	}
 
 	void Actor::SetDeltaTime(const float i_DeltaTime)
 	{
-		mDeltaTime = i_DeltaTime;
+		GetControllerComponent().mDeltaTime = i_DeltaTime;
 	}
 
 	void Actor::SetName(const char *i_Name)
 	{
 		//copying the i_Actorname to ActorName
-		pGameObjectName = _strdup(i_Name);
+		char *pOldName = pGameObjectName;
+
+		pGameObjectName = SmallStrDup(i_Name);
 		assert(pGameObjectName);
-	}
 
-	void Actor::SetLocalToWorldMatrix(const Matrix4x4 & i_Input)
-	{
-		mLocalToWorld = i_Input;
+		if ((pOldName != NULL) && (false == LevelArena::IsLevelData(pOldName)))
+		{
+			SmallFree(pOldName);
+		}
 	}
 
 	void Actor::AddGlobalClassTypes(const char * i_ActorType)
@@ -195,27 +329,27 @@ namespace Engine
 
 	const Vector3 & Actor::GetPosition(void) const
 	{
-		return mPosition;
+		return GetTransformComponent().mPosition;
 	}
 
 	const Vector3 & Actor::GetSize(void) const
 	{
-		return mSize;
+		return GetTransformComponent().mSize;
 	}
 
 	const Vector3 & Actor::GetVelocity(void) const
 	{
-		return mVelocity;
+		return GetVelocityComponent().mVelocity;
 	}
 
 	const Vector3 & Actor::GetAcceleration(void) const
 	{
-		return mAcceleration;
+		return GetVelocityComponent().mAcceleration;
 	}
 
 	const float & Actor::GetRotation(void) const
 	{
-		return mRotation;
+		return GetTransformComponent().mRotation;
 	}
 
 	const Vector3 & Actor::GetProjectedPosition(void) const
@@ -229,12 +363,12 @@ namespace Engine
 
 	const Vector3 & Actor::GetFriction(void) const
 	{
-		return mFriction;
+		return GetVelocityComponent().mFriction;
 	}
 
 	const float Actor::GetDeltaTime(void) const
 	{
-		return mDeltaTime;
+		return GetControllerComponent().mDeltaTime;
 	}
 
 	char * Actor::GetName(void) const
@@ -246,7 +380,12 @@ namespace Engine
 
 	const Matrix4x4 & Actor::GetLocalToWorldMatrix(void) const
 	{
-		return mLocalToWorld;
+		return GetTransformComponent().mLocalToWorld;
+	}
+
+	const Matrix4x4 & Actor::GetWorldToLocalMatrix(void) const
+	{
+		return GetTransformComponent().mWorldToLocal;
 	}
 
 	bool Actor::IsA(const char * i_ActorType) const
@@ -262,14 +401,24 @@ namespace Engine
 		return false;
 	}
 
+	EntityId Actor::GetEntity(void) const
+	{
+		return mEntity;
+	}
+
+	const ActorHandle & Actor::GetHandle(void) const
+	{
+		return mHandle;
+	}
+
 	void Actor::SetController(IActorController * i_pController)
 	{
-		m_pController = i_pController;
+		GetControllerComponent().m_pController = i_pController;
 	}
 	
 	bool Actor::IsControllerSet(void) const
 	{
-		if (m_pController)
+		if (GetControllerComponent().m_pController)
 		{
 			return true;
 		}
@@ -279,32 +428,24 @@ namespace Engine
 
 	void Actor::Update(const float i_DeltaTime)
 	{
-		if (m_pController)
+		IActorController *pController = GetControllerComponent().m_pController;
+
+		if (pController)
 		{
-			m_pController->UpdateActor(*this, i_DeltaTime);
+			pController->UpdateActor(*this, i_DeltaTime);
 		}
-		
-		Matrix4x4 Translation, Rotation;
-		Translation.CreateTranslation(mPosition);
-		Rotation.CreateZRotation(0.0f);
-
-		Matrix4x4 ObjToWorld = Rotation * Translation;
-
-		//Set Local to world matrix of actor for 3D rendering to use
-		SetLocalToWorldMatrix(ObjToWorld);
-
 	}
 
 	void Actor::SetCollisionHandler(ICollisionHandlerInterface *i_pCollisionHandler)
 	{
 		assert(i_pCollisionHandler != NULL);
 
-		m_pCollisionHandler = i_pCollisionHandler;
+		GetControllerComponent().m_pCollisionHandler = i_pCollisionHandler;
 	}
 
 	bool Actor::IsCollisionHandlerSet(void) const
 	{
-		if (m_pCollisionHandler)
+		if (GetControllerComponent().m_pCollisionHandler)
 		{
 			return true;
 		}
@@ -314,15 +455,17 @@ namespace Engine
 
 	void Actor::HandleCollision(CollisionObject *ThisCollisionObject, CollisionObject *OtherCollisionObject)
 	{
-		if (m_pCollisionHandler)
-			m_pCollisionHandler->Handler(ThisCollisionObject, OtherCollisionObject);
+		ICollisionHandlerInterface *pCollisionHandler = GetControllerComponent().m_pCollisionHandler;
+
+		if (pCollisionHandler)
+			pCollisionHandler->Handler(ThisCollisionObject, OtherCollisionObject);
 	}
 
 	void Actor::CreateActorMemoryPool()
 	{
 		if (NULL == m_pActorMemoryPool)
 		{
-			m_pActorMemoryPool =  MemoryPool::Create(sizeof(Actor), MAX_ACTOR_ALLOWED);
+			m_pActorMemoryPool = ObjectMemoryPool::Create(sizeof(Actor), ACTORS_PER_CHUNK);
 		}
 	}
 
@@ -330,15 +473,14 @@ namespace Engine
 	{
 		if (NULL != m_pActorMemoryPool)
 		{
-			unsigned long ulOutputLength = 0;
-			m_pActorMemoryPool->Destroy(&ulOutputLength );
+			m_pActorMemoryPool->Destroy();
+			m_pActorMemoryPool = NULL;
 		}
 	}
 
 	void * Actor::operator new(const size_t i_size)
 	{
-		Actor::CreateActorMemoryPool();
-
+		//Made with the actor table, see ActorTable::CreateInstance
 		assert(m_pActorMemoryPool != NULL);
 
 		return m_pActorMemoryPool->Allocate(i_size);
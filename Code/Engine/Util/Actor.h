@@ -4,14 +4,16 @@
 #include "PreCompiled.h"
 
 #include <vector>
-#include "MemoryPool.h"
+#include "ObjectMemoryPool.h"
 
 #include "Vector3.h"
 #include "Matrix4x4.h"
 #include "SharedPointer.h"
 #include "HashedString.h"
+#include "EntityStore.h"
+#include "ActorTable.h"
 
-const int MAX_ACTOR_ALLOWED = 101;
+const int ACTORS_PER_CHUNK = 64;
 static const double CONSTANT_TIME_FRAME = 1000.0f / 60.0f;
 
 namespace Engine
@@ -27,25 +29,56 @@ namespace Engine
 
 namespace Engine
 {
-	class Actor
+	//Components every actor has in the entity store, systems query them directly.
+	//The matrices follow the position and rotation, whoever changes those sets
+	//mDirty and Actor::UpdateTransforms rebuilds them. The position and
+	//rotation of an attached actor are set from its parent's by the
+	//TransformHierarchy
+	struct sTransform
 	{
 		Vector3				mPosition;
 		Vector3				mSize;
+		float				mRotation;
+		Matrix4x4			mLocalToWorld;
+		Matrix4x4			mWorldToLocal;
+		bool				mDirty;
+
+		sTransform();
+		void UpdateMatrices(void);
+	};
+
+	struct sVelocity
+	{
 		Vector3				mVelocity;
 		Vector3				mAcceleration;
+		Vector3				mFriction;
+
+		sVelocity();
+	};
+
+	struct sController
+	{
+		IActorController			*m_pController;
+		ICollisionHandlerInterface	*m_pCollisionHandler;
+		float						mDeltaTime;
+
+		sController();
+	};
+
+	//Facade over the components of one entity plus the data no system
+	//iterates. References returned by the getters point into the entity
+	//store and are only valid until the next actor is created or destroyed.
+	class Actor
+	{
+		EntityId			mEntity;
+		ActorHandle			mHandle;
 		Vector3				mProjectedPosition;
 		Vector3				mProjectedVelocity;
-		Vector3				mFriction;
-		float				mRotation;
-		float				mDeltaTime;
 		char				*pGameObjectName;
 		bool				bMarkForDeath;
-		Matrix4x4			mLocalToWorld;
-		static MemoryPool	*m_pActorMemoryPool;
+		static ObjectMemoryPool	*m_pActorMemoryPool;
 		static NamedBitSet<int>	mActorTypeNamedBitSet;
-		ICollisionHandlerInterface *m_pCollisionHandler;
 
-		IActorController	*m_pController;
 		HashedString		mType;
 
 		Actor(Vector3 i_Position,
@@ -54,19 +87,23 @@ namespace Engine
 			Vector3 i_Acceleration,
 			float	i_Rotation,
 			char *i_GameObjectName,
-			const Matrix4x4 &i_LocalToWorld,
 			const unsigned int i_ClassBitIndex,
 			const unsigned int i_CollidesWithBitIndex,
 			const char * i_Type);
 
-		static void CreateActorMemoryPool();
+		sTransform & GetTransformComponent(void) const;
+		sVelocity & GetVelocityComponent(void) const;
+		sController & GetControllerComponent(void) const;
 
 	public:
 		unsigned int		mClassBitIndex;
 		unsigned int		mCollidesWithBitIndex;
 		HashedString		mHashedName;
 		~Actor();
-		static SharedPointer<Actor> Create
+		//StringVector is any vector of strings, e.g. a LevelLoadVector
+		template<class StringVector>
+		//The actor is owned by the actor table, refer to it by the handle
+		static ActorHandle Create
 		(
 			Vector3 i_Position,
 			Vector3 i_Velocity,
@@ -75,9 +112,24 @@ namespace Engine
 			const char *i_ActorType,
 			const Vector3 & i_Size,
 			const float i_Rotation,
-			const std::vector<std::string> &iCollidesWith
+			const StringVector &iCollidesWith
 		);
+		static ActorHandle CreateWithCollisionMask
+		(
+			Vector3 i_Position,
+			Vector3 i_Velocity,
+			Vector3 i_Acceleration,
+			const char *i_GameObjectName, 
+			const char *i_ActorType,
+			const Vector3 & i_Size,
+			const float i_Rotation,
+			const unsigned int i_CollidesWithBitIndex
+		);
+		static unsigned int GetClassBitIndex(const char *i_ActorType);
+		static bool FindClassBitMask(const char *i_ActorType, unsigned int &o_ClassBitMask);
+		static void UpdateTransforms(void);
 
+		static void CreateActorMemoryPool();
 		static void DeleteActorMemoryPool();
 		void MarkForDeath(void);
 		bool IsMarkedForDeath(void);
@@ -90,12 +142,14 @@ namespace Engine
 		void SetAcceleration(const float i_x, const float i_y, const float i_z);
 
 		void SetRotation(const float i_Rotation);
+		bool SetParent(const ActorHandle &i_Parent);
+		void SetLocalPosition(const Vector3 & i_Position);
+		void SetLocalRotation(const float i_Rotation);
 		void SetProjectedPosition(const Vector3 & i_Velocity);
 		void SetProjectedVelocity(const Vector3 & i_Velocity);
 		void SetFriction(const Vector3 & i_Friction);
 		void SetDeltaTime(const float i_DeltaTime);
 		void SetName(const char *i_Name);
-		void SetLocalToWorldMatrix(const Matrix4x4 & i_Input);
 
 		const Vector3 & GetPosition(void) const;
 		const Vector3 & GetSize(void) const;
@@ -108,8 +162,11 @@ namespace Engine
 		const float GetDeltaTime(void) const;
 		char *GetName(void) const;
 		const Matrix4x4 & GetLocalToWorldMatrix(void) const;
+		const Matrix4x4 & GetWorldToLocalMatrix(void) const;
 		static void AddGlobalClassTypes(const char * i_ActorType);
 		bool IsA(const char * i_ActorType) const;
+		EntityId GetEntity(void) const;
+		const ActorHandle & GetHandle(void) const;
 
 		void SetController(IActorController * i_pController);
 		bool IsControllerSet(void) const;
@@ -121,4 +178,7 @@ namespace Engine
 		void operator delete(void * i_ptr);
 	} ;
 }
+
+#include "Actor.inl"
+
 #endif //__ACTOR_H
@@ -0,0 +1,25 @@
+namespace Engine
+{
+	template<class StringVector>
+	ActorHandle Actor::Create
+	(
+		Vector3 i_Position,
+		Vector3 i_Velocity,
+		Vector3 i_Acceleration,
+		const char *i_GameObjectName,
+		const char *i_ActorType,
+		const Vector3 & i_Size,
+		const float i_Rotation,
+		const StringVector &iCollidesWith
+	)
+	{
+		unsigned int CollidesWithBitIndex = 0;
+
+		for (unsigned int i = 0; i < iCollidesWith.size(); i++)
+		{
+			CollidesWithBitIndex |= GetClassBitIndex(iCollidesWith[i].c_str());
+		}
+
+		return CreateWithCollisionMask(i_Position, i_Velocity, i_Acceleration, i_GameObjectName, i_ActorType, i_Size, i_Rotation, CollidesWithBitIndex);
+	}
+}
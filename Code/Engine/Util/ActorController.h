@@ -19,6 +19,8 @@ namespace Engine
 
 		}
 
+		//Runs on job system workers, several actors at once. Change only
+		//i_Actor, anything shared needs its own lock
 		virtual void UpdateActor(Actor &i_Actor, const float i_DeltaTime) = 0;
 	};
 }
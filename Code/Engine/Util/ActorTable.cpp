@@ -0,0 +1,424 @@
+#include "PreCompiled.h"
+
+#include <limits.h>
+
+#include "ActorTable.h"
+#include "Actor.h"
+#include "EntityStore.h"
+#include "Debug.h"
+
+//Index of a handle that refers to nothing, also ends the free slot list
+#define INVALID_ACTOR_INDEX	0xffffffff
+
+namespace Engine
+{
+	ActorTable * ActorTable::mInstance = NULL;
+
+	ActorHandle::ActorHandle():
+		m_ulIndex(INVALID_ACTOR_INDEX),
+		m_ulGeneration(0)
+	{
+
+	}
+
+	ActorHandle::ActorHandle(const unsigned long i_ulIndex, const unsigned long i_ulGeneration):
+		m_ulIndex(i_ulIndex),
+		m_ulGeneration(i_ulGeneration)
+	{
+
+	}
+
+	bool ActorHandle::IsNull(void) const
+	{
+		return INVALID_ACTOR_INDEX == m_ulIndex;
+	}
+
+	bool operator==(const ActorHandle &i_Left, const ActorHandle &i_Right)
+	{
+		return (i_Left.m_ulIndex == i_Right.m_ulIndex) && (i_Left.m_ulGeneration == i_Right.m_ulGeneration);
+	}
+
+	bool operator!=(const ActorHandle &i_Left, const ActorHandle &i_Right)
+	{
+		return !(i_Left == i_Right);
+	}
+
+	ActorTable::ActorTable(void):
+		m_ulFreeSlot(INVALID_ACTOR_INDEX),
+		m_ulLiveCount(0),
+		mInitilized(true)
+	{
+
+	}
+
+	ActorTable::~ActorTable()
+	{
+		DestroyAllActors();
+	}
+
+	bool ActorTable::CreateInstance()
+	{
+		if (mInstance == NULL)
+		{
+			mInstance = new ActorTable();
+
+			if (mInstance == NULL)
+			{
+				return false;
+			}
+
+			if (mInstance->mInitilized == false)
+			{
+				delete mInstance;
+				mInstance = NULL;
+				return false;
+			}
+
+			//Actors are only created on the main thread once the table exists,
+			//so their pool is made here rather than on the first new
+			Actor::CreateActorMemoryPool();
+		}
+
+		return true;
+	}
+
+	ActorTable * ActorTable::GetInstance()
+	{
+		if (mInstance != NULL)
+		{
+			return mInstance;
+		}
+
+		assert(false);
+
+		return NULL;
+	}
+
+	void ActorTable::Destroy()
+	{
+		if (mInstance)
+		{
+			delete mInstance;
+			mInstance = NULL;
+		}
+	}
+
+	/******************************************************************************
+		Function     : Add
+		Description  : Takes ownership of i_pActor and gives it a slot, freed
+					slots are reused with the next generation
+		Input        : Actor *i_pActor
+		Output       :
+		Return Value : ActorHandle
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	ActorHandle ActorTable::Add(Actor *i_pActor)
+	{
+		assert(i_pActor);
+
+		unsigned long ulIndex = m_ulFreeSlot;
+
+		if (INVALID_ACTOR_INDEX != ulIndex)
+		{
+			m_ulFreeSlot = m_Slots[ulIndex].m_ulNextFree;
+		}
+		else
+		{
+			sSlot NewSlot;
+			NewSlot.m_pActor = NULL;
+			NewSlot.m_ulGeneration = 1;			//A zeroed handle never resolves
+			NewSlot.m_ulNextFree = INVALID_ACTOR_INDEX;
+
+			ulIndex = static_cast<unsigned long>(m_Slots.size());
+			m_Slots.push_back(NewSlot);
+		}
+
+		sSlot &Slot = m_Slots[ulIndex];
+		Slot.m_pActor = i_pActor;
+		Slot.m_ulNextFree = INVALID_ACTOR_INDEX;
+		m_ulLiveCount++;
+
+		return ActorHandle(ulIndex, Slot.m_ulGeneration);
+	}
+
+	/******************************************************************************
+		Function     : DestroyActor
+		Description  : Deletes the actor now, every handle to it goes stale. The
+					destroyed callbacks run in between so each system drops
+					its part of the actor. A stale handle is ignored
+		Input        : const ActorHandle &i_Handle
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void ActorTable::DestroyActor(const ActorHandle &i_Handle)
+	{
+		Actor *pActor = Resolve(i_Handle);
+
+		if (NULL == pActor)
+		{
+			return;
+		}
+
+		sSlot &Slot = m_Slots[i_Handle.m_ulIndex];
+
+		Slot.m_pActor = NULL;
+		Slot.m_ulGeneration++;
+
+		if (0 == Slot.m_ulGeneration)
+		{
+			Slot.m_ulGeneration = 1;
+		}
+
+		Slot.m_ulNextFree = m_ulFreeSlot;
+		m_ulFreeSlot = i_Handle.m_ulIndex;
+		m_ulLiveCount--;
+
+		//Handles already resolve to NULL, so the systems skip component removal
+		//for an entity that is about to go as a whole
+		for (unsigned long ulCallback = 0; ulCallback < m_DestroyedCallbacks.size(); ulCallback++)
+		{
+			m_DestroyedCallbacks[ulCallback](*pActor);
+		}
+
+		delete pActor;
+	}
+
+	/******************************************************************************
+		Function     : QueueForDestruction
+		Description  : Queues the actor for DestroyMarkedActors, called by
+					Actor::MarkForDeath from any worker. An actor queued twice
+					is destroyed once, the second handle is stale by then
+		Input        : const ActorHandle &i_Handle
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void ActorTable::QueueForDestruction(const ActorHandle &i_Handle)
+	{
+		assert(IsValid(i_Handle));
+
+		std::lock_guard<std::mutex> Lock(m_QueueMutex);
+		m_DestructionQueue.push_back(i_Handle);
+	}
+
+	/******************************************************************************
+		Function     : DestroyMarkedActors
+		Description  : Deletes every actor marked for death, called once at the
+					end of the frame after the systems have run. Costs nothing
+					when nothing died
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void ActorTable::DestroyMarkedActors(void)
+	{
+		//A destroyed actor may mark others, they go in the same pass
+		for (unsigned long ulIndex = 0; ulIndex < m_DestructionQueue.size(); ulIndex++)
+		{
+			DestroyActor(m_DestructionQueue[ulIndex]);
+		}
+
+		m_DestructionQueue.clear();
+	}
+
+	void ActorTable::DestroyAllActors(void)
+	{
+		for (unsigned long ulIndex = 0; ulIndex < m_Slots.size(); ulIndex++)
+		{
+			if (NULL != m_Slots[ulIndex].m_pActor)
+			{
+				DestroyActor(ActorHandle(ulIndex, m_Slots[ulIndex].m_ulGeneration));
+			}
+		}
+
+		m_DestructionQueue.clear();
+
+		assert(0 == m_ulLiveCount);
+	}
+
+	void ActorTable::AddDestroyedCallback(ActorDestroyedCallback i_pCallback)
+	{
+		assert(i_pCallback);
+
+		m_DestroyedCallbacks.push_back(i_pCallback);
+	}
+
+	void ActorTable::RemoveDestroyedCallback(ActorDestroyedCallback i_pCallback)
+	{
+		for (unsigned long ulCallback = 0; ulCallback < m_DestroyedCallbacks.size(); ulCallback++)
+		{
+			if (i_pCallback == m_DestroyedCallbacks[ulCallback])
+			{
+				m_DestroyedCallbacks[ulCallback] = m_DestroyedCallbacks.back();
+				m_DestroyedCallbacks.pop_back();
+				return;
+			}
+		}
+
+		assert(false);
+	}
+
+	unsigned long ActorTable::GetLiveCount(void) const
+	{
+		return m_ulLiveCount;
+	}
+
+	unsigned long ActorTable::GetQueuedCount(void) const
+	{
+		return m_DestructionQueue.size();
+	}
+
+	//Unit test helpers
+	static ActorHandle UTChainedActor;
+	static unsigned long UTDestroyedCallbacks = 0;
+	static unsigned long UTLiveHandlesInCallback = 0;
+
+	//Marks UTChainedActor when another actor goes, like a system killing what it owned
+	static void UTOnActorDestroyed(Actor &i_Actor)
+	{
+		ActorTable *pTable = ActorTable::GetInstance();
+
+		UTDestroyedCallbacks++;
+
+		if (pTable->IsValid(i_Actor.GetHandle()))
+		{
+			UTLiveHandlesInCallback++;
+		}
+
+		if (pTable->IsValid(UTChainedActor))
+		{
+			pTable->Resolve(UTChainedActor)->MarkForDeath();
+			UTChainedActor = ActorHandle();
+		}
+	}
+
+	static ActorHandle UTCreateActor(void)
+	{
+		return Actor::CreateWithCollisionMask(Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 0.0f, 0.0f),
+											  "UTActor", "UTActor", Vector3(1.0f, 1.0f, 1.0f), 0.0f, 0);
+	}
+
+	/******************************************************************************
+		Function     : ActorTable_UnitTest
+		Description  : UnitTest function to test stale handles, slot reuse with
+					the next generation, the generation wrapping past 0,
+					zeroed handles and destroying marked actors at the end
+					of the frame
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void ActorTable_UnitTest(void)
+	{
+	#ifdef _DEBUG
+		//Run before the game creates its own actor table
+		EntityStore::CreateInstance();
+		ActorTable::CreateInstance();
+		Actor::AddGlobalClassTypes("UTActor");
+
+		ActorTable *pTable = ActorTable::GetInstance();
+
+		ActorHandle First = UTCreateActor();
+		assert(NULL != pTable->Resolve(First));
+		assert(1 == pTable->GetLiveCount());
+
+		//Neither a default nor a zeroed handle finds an actor, not even the one in slot 0
+		ActorHandle UTNullHandle;
+		ActorHandle UTZeroedHandle;
+		memset(&UTZeroedHandle, 0, sizeof(UTZeroedHandle));
+
+		assert(UTNullHandle.IsNull());
+		assert(NULL == pTable->Resolve(UTNullHandle));
+		assert(0 == First.m_ulIndex);
+		assert(NULL == pTable->Resolve(UTZeroedHandle));
+
+		//Destroyed, every copy of the handle is stale and destroying again does nothing
+		ActorHandle FirstCopy = First;
+		pTable->DestroyActor(First);
+		assert(NULL == pTable->Resolve(First));
+		assert(false == pTable->IsValid(FirstCopy));
+		assert(0 == pTable->GetLiveCount());
+		pTable->DestroyActor(FirstCopy);
+		assert(0 == pTable->GetLiveCount());
+
+		//The slot is reused with the next generation, the old handle stays stale
+		ActorHandle Second = UTCreateActor();
+		assert(Second.m_ulIndex == First.m_ulIndex);
+		assert(Second.m_ulGeneration == First.m_ulGeneration + 1);
+		assert(NULL != pTable->Resolve(Second));
+		assert(NULL == pTable->Resolve(First));
+		pTable->DestroyActor(Second);
+
+		//The generation skips 0 when it wraps, so a zeroed handle never resolves
+		pTable->m_Slots[Second.m_ulIndex].m_ulGeneration = ULONG_MAX;
+
+		ActorHandle Last = UTCreateActor();
+		assert((Last.m_ulIndex == Second.m_ulIndex) && (ULONG_MAX == Last.m_ulGeneration));
+		pTable->DestroyActor(Last);
+
+		ActorHandle Wrapped = UTCreateActor();
+		assert((Wrapped.m_ulIndex == Last.m_ulIndex) && (1 == Wrapped.m_ulGeneration));
+		assert(NULL == pTable->Resolve(Last));
+		assert(NULL == pTable->Resolve(UTZeroedHandle));
+		pTable->DestroyActor(Wrapped);
+
+		assert(0 == pTable->GetLiveCount());
+
+		pTable->AddDestroyedCallback(&UTOnActorDestroyed);
+
+		//Nothing marked, nothing is done
+		pTable->DestroyMarkedActors();
+		assert(0 == UTDestroyedCallbacks);
+
+		//Queued twice, destroyed once, the second handle is stale by then
+		ActorHandle Twice = UTCreateActor();
+		ActorHandle Kept = UTCreateActor();
+		pTable->QueueForDestruction(Twice);
+		pTable->QueueForDestruction(Twice);
+		assert(2 == pTable->GetQueuedCount());
+
+		pTable->DestroyMarkedActors();
+		assert(1 == UTDestroyedCallbacks);
+		assert(0 == pTable->GetQueuedCount());
+		assert(NULL == pTable->Resolve(Twice));
+		assert(NULL != pTable->Resolve(Kept));
+
+		//An actor marked by a callback goes in the same pass, and every
+		//callback sees the handle of its actor already stale
+		ActorHandle Killer = UTCreateActor();
+		UTChainedActor = Kept;
+		pTable->Resolve(Killer)->MarkForDeath();
+
+		pTable->DestroyMarkedActors();
+		assert(3 == UTDestroyedCallbacks);
+		assert(NULL == pTable->Resolve(Killer));
+		assert(NULL == pTable->Resolve(Kept));
+		assert(0 == pTable->GetQueuedCount());
+		assert(0 == UTLiveHandlesInCallback);
+		assert(0 == pTable->GetLiveCount());
+
+		pTable->RemoveDestroyedCallback(&UTOnActorDestroyed);
+
+		ActorTable::Destroy();
+		EntityStore::Destroy();
+	#endif
+	}
+}
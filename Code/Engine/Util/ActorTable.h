@@ -0,0 +1,102 @@
+#ifndef __ACTOR_TABLE_HEADER
+#define __ACTOR_TABLE_HEADER
+
+#include "PreCompiled.h"
+
+#include <mutex>
+#include <vector>
+
+namespace Engine
+{
+	class Actor;
+
+	//Reference to an actor that does not keep it alive. The generation of the
+	//slot changes when its actor is destroyed, so a handle kept past that
+	//resolves to NULL instead of to whatever actor uses the slot next.
+	struct ActorHandle
+	{
+		unsigned long	m_ulIndex;
+		unsigned long	m_ulGeneration;
+
+		ActorHandle();
+		ActorHandle(const unsigned long i_ulIndex, const unsigned long i_ulGeneration);
+
+		bool IsNull(void) const;
+	};
+
+	bool operator==(const ActorHandle &i_Left, const ActorHandle &i_Right);
+	bool operator!=(const ActorHandle &i_Left, const ActorHandle &i_Right);
+
+	//Called for every actor that is destroyed, after its handles have gone
+	//stale and before it is deleted. A system drops whatever it keeps for
+	//the actor, found through the actor's components.
+	typedef void (*ActorDestroyedCallback)(Actor &i_Actor);
+
+	//Owns every actor, an actor lives until DestroyActor or the end of the
+	//frame it was marked for death in. Actors are added and destroyed on the
+	//main thread, never while frame tasks that touch actors run. Resolve and
+	//QueueForDestruction may be called from frame tasks on the workers.
+	class ActorTable
+	{
+		struct sSlot
+		{
+			Actor			*m_pActor;
+			unsigned long	m_ulGeneration;
+			unsigned long	m_ulNextFree;
+		};
+
+		std::vector<sSlot>					m_Slots;
+		std::vector<ActorHandle>			m_DestructionQueue;		//Marked this frame, in marking order
+		std::mutex							m_QueueMutex;
+		std::vector<ActorDestroyedCallback>	m_DestroyedCallbacks;
+		unsigned long						m_ulFreeSlot;
+		unsigned long						m_ulLiveCount;
+		bool								mInitilized;
+
+		static ActorTable	*mInstance;
+
+		ActorTable(void);
+		~ActorTable();
+		ActorTable(const ActorTable & i_Other);
+		ActorTable & operator=(const ActorTable & i_rhs);
+
+		friend void ActorTable_UnitTest(void);
+
+	public:
+		static bool CreateInstance();
+		static ActorTable * GetInstance();
+		static void Destroy();
+
+		ActorHandle Add(Actor *i_pActor);
+		void DestroyActor(const ActorHandle &i_Handle);
+		void QueueForDestruction(const ActorHandle &i_Handle);
+		void DestroyMarkedActors(void);
+		void DestroyAllActors(void);
+
+		void AddDestroyedCallback(ActorDestroyedCallback i_pCallback);
+		void RemoveDestroyedCallback(ActorDestroyedCallback i_pCallback);
+
+		//O(1), NULL when the actor is gone
+		inline Actor *Resolve(const ActorHandle &i_Handle) const
+		{
+			if ((i_Handle.m_ulIndex < m_Slots.size()) && (m_Slots[i_Handle.m_ulIndex].m_ulGeneration == i_Handle.m_ulGeneration))
+			{
+				return m_Slots[i_Handle.m_ulIndex].m_pActor;
+			}
+
+			return NULL;
+		}
+
+		inline bool IsValid(const ActorHandle &i_Handle) const
+		{
+			return NULL != Resolve(i_Handle);
+		}
+
+		unsigned long GetLiveCount(void) const;
+		unsigned long GetQueuedCount(void) const;
+	};
+
+	void ActorTable_UnitTest(void);
+}
+
+#endif //__ACTOR_TABLE_HEADER
@@ -1,4 +1,3 @@
-
 #include "PreCompiled.h"
 
 #include <bitset>
@@ -14,57 +13,85 @@ namespace Engine
 {
 	/******************************************************************************
 		Function     : BitArray
-		Description  : Constructor for BitArray that assigns memory for the bitarray, 
+		Description  : Constructor for BitArray that assigns memory for the bitarray,
 					sets the number of bits to be used and initilizes them to zero.
-		Input        : unsigned long *i_pBitArray, unsigned long i_ulItemCount
-		Output       : 
-		Return Value :   
-		Data Accessed: 
-		Data Updated : 
- 
+		Input        : uint64_t *i_pBitArray, unsigned long i_ulItemCount
+		Output       :
+		Return Value :
+		Data Accessed:
+		Data Updated :
+
 		History      :
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
-	BitArray::BitArray(unsigned long *i_pBitArray, unsigned long i_ulItemCount, bool i_bIsPlacementCreate):
-		m_pBitArray(i_pBitArray), m_ulItemCount(i_ulItemCount), bIsPlacementCreate(i_bIsPlacementCreate)
+	BitArray::BitArray(uint64_t *i_pBitArray, unsigned long i_ulItemCount, bool i_bIsPlacementCreate):
+		m_pBitArray(i_pBitArray),
+		m_ulItemCount(i_ulItemCount),
+		m_ulNumberOfWords(GetNumberOfWords(i_ulItemCount)),
+		m_ulSearchCursor(0),
+		m_LastWordMask(FULL_WORD_VALUE),
+		bIsPlacementCreate(i_bIsPlacementCreate)
 	{
 		assert(m_pBitArray != NULL);
 
-		for (unsigned long ulCount = 0; ulCount < ((i_ulItemCount +  SIZE_OF_LONG - 1)/ (SIZE_OF_LONG)); ulCount++)
+		for (unsigned long ulCount = 0; ulCount < m_ulNumberOfWords; ulCount++)
 		{
 			m_pBitArray[ulCount] = 0;
 		}
+
+		if ((i_ulItemCount % SIZE_OF_WORD) != 0)
+		{
+			m_LastWordMask = (static_cast<uint64_t>(1) << (i_ulItemCount % SIZE_OF_WORD)) - 1;
+		}
 	}
 
 	/******************************************************************************
 		Function     : ~BitArray
 		Description  : Destructor
 		Input        : void
-		Output       : 
-		Return Value :   
-		Data Accessed: 
-		Data Updated : 
- 
+		Output       :
+		Return Value :
+		Data Accessed:
+		Data Updated :
+
 		History      :
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
 	BitArray::~BitArray(void)
 	{
-	
+
+	}
+
+	/******************************************************************************
+		Function     : GetNumberOfWords
+		Description  : Returns the number of 64 bit words needed for the item count
+		Input        : const unsigned long i_ulItemCount
+		Output       :
+		Return Value : unsigned long
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	unsigned long BitArray::GetNumberOfWords(const unsigned long i_ulItemCount)
+	{
+		return (i_ulItemCount + SIZE_OF_WORD - 1) / SIZE_OF_WORD;
 	}
 
 	/******************************************************************************
 		Function     : Destroy
-		Description  : frees the memory allocated for the bitarray based on Placement 
+		Description  : frees the memory allocated for the bitarray based on Placement
 					   new or regular new, Used instead of destructor
 		Input        : unsigned long *o_ulOutputLen
-		Output       : 
-		Return Value :   
-		Data Accessed: 
-		Data Updated : 
- 
+		Output       :
+		Return Value :
+		Data Accessed:
+		Data Updated :
+
 		History      :
 		Author       : Vinod VM
 		Modification : Created function
@@ -84,8 +111,8 @@ namespace Engine
 		{
 			assert(o_ulOutputLen != NULL);
 
-			*o_ulOutputLen = (sizeof(unsigned long) * (m_ulItemCount +  SIZE_OF_LONG - 1) / (SIZE_OF_LONG)) + sizeof(BitArray);
-		
+			*o_ulOutputLen = (sizeof(uint64_t) * m_ulNumberOfWords) + sizeof(BitArray);
+
 			this->~BitArray();
 		}
 
@@ -94,22 +121,22 @@ namespace Engine
 
 	/******************************************************************************
 		Function     : Create
-		Description  : Static function that allocates memory for the bitarray and 
+		Description  : Static function that allocates memory for the bitarray and
 					creates it of size i_ulItemCount
 		Input        : const unsigned long i_ulItemCount
-		Output       : 
-		Return Value : BitArray *   
-		Data Accessed: 
-		Data Updated : 
- 
+		Output       :
+		Return Value : BitArray *
+		Data Accessed:
+		Data Updated :
+
 		History      :
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
 	BitArray * BitArray::Create(const unsigned long i_ulItemCount)
 	{
-		unsigned long * pNewBitArray = reinterpret_cast<unsigned long *> (_aligned_malloc((sizeof(unsigned long) * (i_ulItemCount +  SIZE_OF_LONG - 1)/ (SIZE_OF_LONG)), 64));
-	
+		uint64_t * pNewBitArray = reinterpret_cast<uint64_t *> (_aligned_malloc(sizeof(uint64_t) * GetNumberOfWords(i_ulItemCount), 64));
+
 		if(NULL == pNewBitArray )
 		{
 			return NULL;
@@ -122,14 +149,14 @@ namespace Engine
 
 	/******************************************************************************
 		Function     : CreateFromExistingMemory
-		Description  : Static function that creates a bitarray from input memory of 
+		Description  : Static function that creates a bitarray from input memory of
 					size i_ulItemCount
 		Input        : const unsigned long i_ulItemCount
-		Output       : 
-		Return Value : BitArray *   
-		Data Accessed: 
-		Data Updated : 
- 
+		Output       :
+		Return Value : BitArray *
+		Data Accessed:
+		Data Updated :
+
 		History      :
 		Author       : Vinod VM
 		Modification : Created function
@@ -141,119 +168,105 @@ namespace Engine
 			return NULL;
 		}
 
-		unsigned long * pBitArray = reinterpret_cast<unsigned long *> (reinterpret_cast<uintptr_t>(i_MemoryBlock) + sizeof(BitArray));
-	
-		*o_pulUsed += (sizeof(unsigned long) * (i_ulItemCount +  SIZE_OF_LONG - 1) / (SIZE_OF_LONG)) + sizeof(BitArray);
+		uint64_t * pBitArray = reinterpret_cast<uint64_t *> (reinterpret_cast<uintptr_t>(i_MemoryBlock) + sizeof(BitArray));
+
+		*o_pulUsed += GetRequiredMemorySize(i_ulItemCount);
 		bool i_bIsPlacementCreate = true;
 		return new (i_MemoryBlock) BitArray(pBitArray, i_ulItemCount, i_bIsPlacementCreate);
 	}
 
+	/******************************************************************************
+		Function     : GetRequiredMemorySize
+		Description  : Returns the bytes CreateFromExistingMemory uses for the item
+					count, the bitarray object followed by its words
+		Input        : const unsigned long i_ulItemCount
+		Output       :
+		Return Value : unsigned long
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	unsigned long BitArray::GetRequiredMemorySize(const unsigned long i_ulItemCount)
+	{
+		return (sizeof(uint64_t) * GetNumberOfWords(i_ulItemCount)) + sizeof(BitArray);
+	}
+
 	/******************************************************************************
 		Function     : operator[]
 		Description  : Overloades the [] operator for accessing bits like bytes
 		Input        : const unsigned long ulItemIndex
-		Output       : 
-		Return Value : bool  
-		Data Accessed: 
-		Data Updated : 
- 
+		Output       :
+		Return Value : bool
+		Data Accessed:
+		Data Updated :
+
 		History      :
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
 	bool BitArray::operator[](const unsigned long ulItemIndex)
 	{
-		unsigned long ulInnerBit;
-		unsigned long ucLongFromBitArray;
-		unsigned long ForShifting = 0x00000001;
-		
-		ucLongFromBitArray = m_pBitArray[ulItemIndex / SIZE_OF_LONG];
-		
-		ulInnerBit = ulItemIndex % SIZE_OF_LONG;
-
-		ForShifting = ForShifting << ulInnerBit;
-
-		if(ucLongFromBitArray == (ucLongFromBitArray & ForShifting))
-		{
-			return true;
-		}
-
-		return false;
+		return CheckBit(ulItemIndex);
 	}
 
 	/******************************************************************************
 		Function     : GetFirstFreeBitIndex
-		Description  : Returns the first free bit in the bit array
+		Description  : Returns a free bit in the bit array, the search starts at
+					the search cursor and wraps around
 		Input        : void
-		Output       : 
+		Output       :
 		Return Value : long  (-1 if failed)
-		Data Accessed: 
-		Data Updated : 
- 
+		Data Accessed:
+		Data Updated :
+
 		History      :
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
 	long BitArray::GetFirstFreeBitIndex(void) const
 	{
-		unsigned long ulLongFreeIndex = 0;
-		unsigned long ulNumberOfLongs = (m_ulItemCount +  SIZE_OF_LONG - 1) / (SIZE_OF_LONG);
-		unsigned long ulFirstFreeBitIndex = 0;
-		unsigned long ForShifting = 0x00000001;
+		unsigned long ulWordIndex = m_ulSearchCursor;
 
-		while (ulLongFreeIndex < ulNumberOfLongs)
+		for (unsigned long ulCount = 0; ulCount < m_ulNumberOfWords; ulCount++)
 		{
-			if (m_pBitArray[ulLongFreeIndex] != FULL_LONG_VALUE)
+			uint64_t FreeBits = GetFreeBitsOfWord(ulWordIndex);
+
+			if (FreeBits != 0)
 			{
-				break;
+				return ulWordIndex * SIZE_OF_WORD + CountTrailingZeros(FreeBits);
 			}
-			
-			ulLongFreeIndex++;
-		}
-
-		if(ulLongFreeIndex == ulNumberOfLongs)
-		{
-			CONSOLE_PRINT("No free bit, memory pool is full");
-			return -1;
-		}
 
-		for (unsigned long ulCount = 0; ulCount < SIZE_OF_LONG; ulCount++)
-		{
-			if (0x00000000 == (m_pBitArray[ulLongFreeIndex] & (ForShifting << ulCount)))
+			if (++ulWordIndex == m_ulNumberOfWords)
 			{
-				ulFirstFreeBitIndex = ulCount;
-				break;
+				ulWordIndex = 0;
 			}
 		}
 
-		ulFirstFreeBitIndex += ulLongFreeIndex * SIZE_OF_LONG;
-
-		return ulFirstFreeBitIndex;
+		CONSOLE_PRINT("No free bit, memory pool is full");
+		return -1;
 	}
 
 	/******************************************************************************
 		Function     : SetBit
 		Description  : Set the bit at the input bitindex as true.
 		Input        : const unsigned long ulBitIndex
-		Output       : 
-		Return Value : void  
-		Data Accessed: 
-		Data Updated : 
- 
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
 		History      :
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
 	void BitArray::SetBit(const unsigned long ulBitIndex)
 	{
-		unsigned long ulInnerIndex;
-		unsigned long ForShifting = 0x000000001;
-		unsigned long AfterShifting;
-		unsigned long ulByteIndex = ulBitIndex / SIZE_OF_LONG;
-		
-		ulInnerIndex = ulBitIndex % SIZE_OF_LONG;
-		AfterShifting = (ForShifting << ulInnerIndex);
-		m_pBitArray[ulByteIndex] |= AfterShifting;
+		assert(ulBitIndex < m_ulItemCount);
+
+		m_pBitArray[ulBitIndex / SIZE_OF_WORD] |= (static_cast<uint64_t>(1) << (ulBitIndex % SIZE_OF_WORD));
 
 		return;
 	}
@@ -262,22 +275,20 @@ namespace Engine
 		Function     : CheckBit
 		Description  : Returns true or false if the bit is set or unset.
 		Input        : const unsigned long ulBitIndex
-		Output       : 
-		Return Value : bool  
-		Data Accessed: 
-		Data Updated : 
- 
+		Output       :
+		Return Value : bool
+		Data Accessed:
+		Data Updated :
+
 		History      :
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
 	bool BitArray::CheckBit(const unsigned long ulBitIndex) const
 	{
-		unsigned long ulInnerIndex;
-		unsigned long ForShifting = 0x000000001;
-		ulInnerIndex = ulBitIndex % SIZE_OF_LONG;
+		assert(ulBitIndex < m_ulItemCount);
 
-		if ((ForShifting << ulInnerIndex) == (m_pBitArray[ulBitIndex / SIZE_OF_LONG] & (ForShifting << ulInnerIndex)))
+		if (0 != (m_pBitArray[ulBitIndex / SIZE_OF_WORD] & (static_cast<uint64_t>(1) << (ulBitIndex % SIZE_OF_WORD))))
 		{
 			return true;
 		}
@@ -286,240 +297,631 @@ namespace Engine
 	}
 
 	/******************************************************************************
-		Function     : RotateLeftShift
-		Description  : Rotate Left shift operation
-		Input        : unsigned long ulToRotate, const unsigned long ulNumberofShifts
-		Output       : 
-		Return Value : unsigned long  
-		Data Accessed: 
-		Data Updated : 
- 
+		Function     : ClearSetBit
+		Description  : Clear the set bit at input ulBitIndex, the word now has a
+					free bit so it becomes the search cursor
+		Input        : const unsigned long ulBitIndex
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void BitArray::ClearSetBit(const unsigned long ulBitIndex)
+	{
+		assert(ulBitIndex < m_ulItemCount);
+
+		unsigned long ulWordIndex = ulBitIndex / SIZE_OF_WORD;
+
+		m_pBitArray[ulWordIndex] &= ~(static_cast<uint64_t>(1) << (ulBitIndex % SIZE_OF_WORD));
+		m_ulSearchCursor = ulWordIndex;
+
+		return;
+	}
+
+	/******************************************************************************
+		Function     : GetAndSetFirstFreeBitIndex
+		Description  : Return a free bit index after setting it used, the cursor
+					stays on the word until it is full
+		Input        : void
+		Output       :
+		Return Value : long  (-1 if failed)
+		Data Accessed:
+		Data Updated :
+
 		History      :
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
-	unsigned long BitArray::RotateLeftShift(unsigned long ulToRotate, const unsigned long ulNumberofShifts)
+	long BitArray::GetAndSetFirstFreeBitIndex(void)
 	{
-		unsigned long ulMostSignificantBit;
+		unsigned long ulWordIndex = m_ulSearchCursor;
 
-		for (unsigned long ulCount = 0; ulCount < ulNumberofShifts; ulCount++)
+		for (unsigned long ulCount = 0; ulCount < m_ulNumberOfWords; ulCount++)
 		{
-			//Get the most significant bit from ulToRotate but right shifting 32 -1 times
-			ulMostSignificantBit = ulToRotate >> (SIZE_OF_LONG - 1);
-			ulToRotate = ulToRotate << 1;
-			ulToRotate = ulToRotate + ulMostSignificantBit;
-		}
+			uint64_t FreeBits = GetFreeBitsOfWord(ulWordIndex);
+
+			if (FreeBits != 0)
+			{
+				unsigned long ulInnerIndex = CountTrailingZeros(FreeBits);
 
-		return ulToRotate;
+				m_pBitArray[ulWordIndex] |= (static_cast<uint64_t>(1) << ulInnerIndex);
+				m_ulSearchCursor = ulWordIndex;
+
+				return ulWordIndex * SIZE_OF_WORD + ulInnerIndex;
+			}
 
+			if (++ulWordIndex == m_ulNumberOfWords)
+			{
+				ulWordIndex = 0;
+			}
+		}
+
+		CONSOLE_PRINT("No free bit, memory pool is full");
+		return -1;
 	}
 
 	/******************************************************************************
-		Function     : ClearSetBit
-		Description  : Clear the set bit at input ulBitIndex
-		Input        : const unsigned long ulBitIndex
-		Output       : 
-		Return Value : void  
-		Data Accessed: 
-		Data Updated : 
- 
+		Function     : GetFirstSetBitIndex
+		Description  : Return the first set bit index
+		Input        : void
+		Output       :
+		Return Value : long  (-1 if failed)
+		Data Accessed:
+		Data Updated :
+
 		History      :
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
-	void BitArray::ClearSetBit(const unsigned long ulBitIndex)
+	long BitArray::GetFirstSetBitIndex(void) const
 	{
-		unsigned long ulInnerIndex;
-		unsigned long ForShifting = 0xFFFFFFFE; //Last bit is zero and hence use RotateLeftShift
-		unsigned long ulByteIndex = ulBitIndex / SIZE_OF_LONG;
-		ulInnerIndex = ulBitIndex % SIZE_OF_LONG;
+		long lFirstSetBitIndex = GetNextSetBitIndex(0);
 
-		m_pBitArray[ulByteIndex] = m_pBitArray[ulByteIndex] & (RotateLeftShift(ForShifting, ulInnerIndex));
+		if (-1 == lFirstSetBitIndex)
+		{
+			CONSOLE_PRINT("No bit is set, memory pool is empty");
+		}
 
-		return;
+		return lFirstSetBitIndex;
 	}
 
 	/******************************************************************************
-		Function     : GetAndSetFirstFreeBitIndex
-		Description  : Return the first free bit index after setting it used
+		Function     : GetAndClearFirstSetBitIndex
+		Description  : Return the first set bit index after clearing it.
 		Input        : void
-		Output       : 
+		Output       :
 		Return Value : long  (-1 if failed)
-		Data Accessed: 
-		Data Updated : 
- 
+		Data Accessed:
+		Data Updated :
+
 		History      :
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
-	long BitArray::GetAndSetFirstFreeBitIndex(void)
+	long BitArray::GetAndClearFirstSetBitIndex(void)
 	{
-		unsigned long ulFirstFreeLongIndex = 0;
-		unsigned long ulNumberOfLongs = (m_ulItemCount + SIZE_OF_LONG - 1) / (SIZE_OF_LONG);
-		unsigned long ulFirstFreeBitIndex = 0;
-		unsigned long ForShifting = 0x00000001;
+		long lFirstSetBitIndex = GetFirstSetBitIndex();
 
-		//Traverse the first byte in bitarray with free bit
-		while (ulFirstFreeLongIndex < ulNumberOfLongs)
+		if (-1 != lFirstSetBitIndex)
 		{
-			if (m_pBitArray[ulFirstFreeLongIndex] != FULL_LONG_VALUE)
+			ClearSetBit(lFirstSetBitIndex);
+		}
+
+		return lFirstSetBitIndex;
+	}
+
+	/******************************************************************************
+		Function     : GetNextSetBitIndex
+		Description  : Return the first set bit index at or after i_ulFromIndex
+		Input        : const unsigned long i_ulFromIndex
+		Output       :
+		Return Value : long  (-1 if none)
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	long BitArray::GetNextSetBitIndex(const unsigned long i_ulFromIndex) const
+	{
+		if (i_ulFromIndex >= m_ulItemCount)
+		{
+			return -1;
+		}
+
+		unsigned long ulWordIndex = i_ulFromIndex / SIZE_OF_WORD;
+
+		//Mask off the bits below the start index in the first word
+		uint64_t Word = m_pBitArray[ulWordIndex] & (FULL_WORD_VALUE << (i_ulFromIndex % SIZE_OF_WORD));
+
+		while (true)
+		{
+			if (Word != 0)
+			{
+				return ulWordIndex * SIZE_OF_WORD + CountTrailingZeros(Word);
+			}
+
+			if (++ulWordIndex == m_ulNumberOfWords)
 			{
 				break;
 			}
-			
-			ulFirstFreeLongIndex++;
+
+			Word = m_pBitArray[ulWordIndex];
 		}
 
-		if(ulFirstFreeLongIndex == ulNumberOfLongs)
+		return -1;
+	}
+
+	/******************************************************************************
+		Function     : GetNextFreeBitIndex
+		Description  : Return the first free bit index at or after i_ulFromIndex
+		Input        : const unsigned long i_ulFromIndex
+		Output       :
+		Return Value : long  (-1 if none)
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	long BitArray::GetNextFreeBitIndex(const unsigned long i_ulFromIndex) const
+	{
+		if (i_ulFromIndex >= m_ulItemCount)
 		{
-			CONSOLE_PRINT("No free bit, memory pool is full");
 			return -1;
 		}
 
-		for (unsigned long ulCount = 0; ulCount < SIZE_OF_LONG; ulCount++)
+		unsigned long ulWordIndex = i_ulFromIndex / SIZE_OF_WORD;
+
+		//Mask off the bits below the start index in the first word
+		uint64_t FreeBits = GetFreeBitsOfWord(ulWordIndex) & (FULL_WORD_VALUE << (i_ulFromIndex % SIZE_OF_WORD));
+
+		while (true)
 		{
-			if (0x00000000 == (m_pBitArray[ulFirstFreeLongIndex] & (ForShifting << ulCount)))
+			if (FreeBits != 0)
+			{
+				return ulWordIndex * SIZE_OF_WORD + CountTrailingZeros(FreeBits);
+			}
+
+			if (++ulWordIndex == m_ulNumberOfWords)
 			{
-				ulFirstFreeBitIndex = ulCount;
 				break;
 			}
-		}
-		SetBit(ulFirstFreeBitIndex);
 
-		ulFirstFreeBitIndex += ulFirstFreeLongIndex * SIZE_OF_LONG;
+			FreeBits = GetFreeBitsOfWord(ulWordIndex);
+		}
 
-		return ulFirstFreeBitIndex;
+		return -1;
 	}
 
 	/******************************************************************************
-		Function     : GetFirstSetBitIndex
-		Description  : Return the first set bit index
-		Input        : void
-		Output       : 
-		Return Value : long  (-1 if failed)
-		Data Accessed: 
-		Data Updated : 
- 
+		Function     : FindFreeRun
+		Description  : Finds i_ulCount consecutive free bits. Runs are walked by
+					jumping between the next free and the next set bit, so full
+					and empty words are skipped whole. First fit returns the
+					lowest run that is long enough, best fit the shortest one.
+		Input        : const unsigned long i_ulCount, const bool i_bBestFit
+		Output       :
+		Return Value : long  (index of the first bit of the run, -1 if none)
+		Data Accessed:
+		Data Updated :
+
 		History      :
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
-	long BitArray::GetFirstSetBitIndex(void) const
+	long BitArray::FindFreeRun(const unsigned long i_ulCount, const bool i_bBestFit) const
 	{
-		unsigned long ulLongSetIndex = 0;
-		unsigned long ulNumberOfLongs = (m_ulItemCount + SIZE_OF_LONG - 1) / (SIZE_OF_LONG);
-		unsigned long ulFirstSetBitIndex = 0;
-		unsigned long ForShifting = 0x00000001;
+		assert(i_ulCount > 0);
+
+		long lBestStart = -1;
+		unsigned long ulBestLength = 0;
+		long lRunStart = GetNextFreeBitIndex(0);
 
-		while (ulLongSetIndex < ulNumberOfLongs)
+		while (-1 != lRunStart)
 		{
-			if (m_pBitArray[ulLongSetIndex] != 0x00000000)
+			long lRunEnd = GetNextSetBitIndex(lRunStart);
+			unsigned long ulRunEnd = (-1 == lRunEnd) ? m_ulItemCount : static_cast<unsigned long>(lRunEnd);
+			unsigned long ulLength = ulRunEnd - lRunStart;
+
+			if (ulLength >= i_ulCount)
 			{
-				break;
+				//An exact fit cannot be beaten
+				if ((false == i_bBestFit) || (ulLength == i_ulCount))
+				{
+					return lRunStart;
+				}
+
+				if ((-1 == lBestStart) || (ulLength < ulBestLength))
+				{
+					lBestStart = lRunStart;
+					ulBestLength = ulLength;
+				}
 			}
-			
-			ulLongSetIndex++;
+
+			lRunStart = GetNextFreeBitIndex(ulRunEnd);
 		}
 
-		if(ulLongSetIndex == ulNumberOfLongs)
+		return lBestStart;
+	}
+
+	//Bits i_ulFirstBit to i_ulFirstBit + i_ulBitCount - 1 of one word
+	static inline uint64_t GetWordMask(const unsigned long i_ulFirstBit, const unsigned long i_ulBitCount)
+	{
+		if (i_ulBitCount == SIZE_OF_WORD)
 		{
-			CONSOLE_PRINT("No bit is set, memory pool is empty");
-			return -1;
+			return FULL_WORD_VALUE;
 		}
 
-		for (unsigned long ulCount = 0; ulCount < SIZE_OF_LONG; ulCount++)
+		return ((static_cast<uint64_t>(1) << i_ulBitCount) - 1) << i_ulFirstBit;
+	}
+
+	/******************************************************************************
+		Function     : SetBitRange
+		Description  : Sets i_ulCount bits starting at i_ulFirstBit, one word at a
+					time
+		Input        : const unsigned long i_ulFirstBit, const unsigned long i_ulCount
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void BitArray::SetBitRange(const unsigned long i_ulFirstBit, const unsigned long i_ulCount)
+	{
+		assert((i_ulFirstBit + i_ulCount) <= m_ulItemCount);
+
+		unsigned long ulIndex = i_ulFirstBit;
+		const unsigned long ulEnd = i_ulFirstBit + i_ulCount;
+
+		while (ulIndex < ulEnd)
 		{
-			if (m_pBitArray[ulLongSetIndex] == (m_pBitArray[ulLongSetIndex] & (ForShifting << ulCount)))
-			{
-				ulFirstSetBitIndex = ulCount;
-				break;
-			}
+			unsigned long ulBit = ulIndex % SIZE_OF_WORD;
+			unsigned long ulBitCount = ((ulEnd - ulIndex) < (SIZE_OF_WORD - ulBit)) ? (ulEnd - ulIndex) : (SIZE_OF_WORD - ulBit);
+
+			m_pBitArray[ulIndex / SIZE_OF_WORD] |= GetWordMask(ulBit, ulBitCount);
+			ulIndex += ulBitCount;
 		}
+	}
 
-		//Convert the bit local index to final index by adding the full byte count
-		ulFirstSetBitIndex += ulLongSetIndex * SIZE_OF_LONG;
+	/******************************************************************************
+		Function     : ClearBitRange
+		Description  : Clears i_ulCount bits starting at i_ulFirstBit, the first
+					word now has free bits so it becomes the search cursor
+		Input        : const unsigned long i_ulFirstBit, const unsigned long i_ulCount
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
 
-		return ulFirstSetBitIndex;
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void BitArray::ClearBitRange(const unsigned long i_ulFirstBit, const unsigned long i_ulCount)
+	{
+		assert((i_ulFirstBit + i_ulCount) <= m_ulItemCount);
+
+		unsigned long ulIndex = i_ulFirstBit;
+		const unsigned long ulEnd = i_ulFirstBit + i_ulCount;
+
+		while (ulIndex < ulEnd)
+		{
+			unsigned long ulBit = ulIndex % SIZE_OF_WORD;
+			unsigned long ulBitCount = ((ulEnd - ulIndex) < (SIZE_OF_WORD - ulBit)) ? (ulEnd - ulIndex) : (SIZE_OF_WORD - ulBit);
+
+			m_pBitArray[ulIndex / SIZE_OF_WORD] &= ~GetWordMask(ulBit, ulBitCount);
+			ulIndex += ulBitCount;
+		}
+
+		if (i_ulCount > 0)
+		{
+			m_ulSearchCursor = i_ulFirstBit / SIZE_OF_WORD;
+		}
 	}
 
 	/******************************************************************************
-		Function     : GetAndClearFirstSetBitIndex
-		Description  : Return the first set bit index after clearing it.
-		Input        : void
-		Output       : 
-		Return Value : long  (-1 if failed)
-		Data Accessed: 
-		Data Updated : 
- 
+		Function     : IsBitRangeSet
+		Description  : Returns true if all i_ulCount bits starting at i_ulFirstBit
+					are set
+		Input        : const unsigned long i_ulFirstBit, const unsigned long i_ulCount
+		Output       :
+		Return Value : bool
+		Data Accessed:
+		Data Updated :
+
 		History      :
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
-	long BitArray::GetAndClearFirstSetBitIndex(void)
+	bool BitArray::IsBitRangeSet(const unsigned long i_ulFirstBit, const unsigned long i_ulCount) const
 	{
-		unsigned long ulLongSetIndex = 0;
-		unsigned long ulNumberOfLongs = (m_ulItemCount + SIZE_OF_LONG - 1) / (SIZE_OF_LONG);
-		unsigned long ulFirstSetBitIndex = 0;
-		unsigned long ForShifting = 0x00000001;
+		assert((i_ulFirstBit + i_ulCount) <= m_ulItemCount);
 
-		while (ulLongSetIndex < ulNumberOfLongs)
+		unsigned long ulIndex = i_ulFirstBit;
+		const unsigned long ulEnd = i_ulFirstBit + i_ulCount;
+
+		while (ulIndex < ulEnd)
 		{
-			if (m_pBitArray[ulLongSetIndex] != 0x00000000)
+			unsigned long ulBit = ulIndex % SIZE_OF_WORD;
+			unsigned long ulBitCount = ((ulEnd - ulIndex) < (SIZE_OF_WORD - ulBit)) ? (ulEnd - ulIndex) : (SIZE_OF_WORD - ulBit);
+			uint64_t Mask = GetWordMask(ulBit, ulBitCount);
+
+			if ((m_pBitArray[ulIndex / SIZE_OF_WORD] & Mask) != Mask)
 			{
-				break;
+				return false;
 			}
-			
-			ulLongSetIndex++;
+
+			ulIndex += ulBitCount;
 		}
 
-		if(ulLongSetIndex == ulNumberOfLongs)
+		return true;
+	}
+
+	/******************************************************************************
+		Function     : GetFirstNFreeBitIndices
+		Description  : Writes up to i_ulCount free bit indices in ascending order
+					to o_pulIndices, the bits are not set
+		Input        : unsigned long *o_pulIndices, const unsigned long i_ulCount
+		Output       :
+		Return Value : unsigned long (number of indices found)
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	unsigned long BitArray::GetFirstNFreeBitIndices(unsigned long *o_pulIndices, const unsigned long i_ulCount) const
+	{
+		assert(o_pulIndices != NULL);
+
+		unsigned long ulFound = 0;
+
+		for (unsigned long ulWordIndex = 0; (ulWordIndex < m_ulNumberOfWords) && (ulFound < i_ulCount); ulWordIndex++)
 		{
-			CONSOLE_PRINT("No bit is set, memory pool is empty");
-			return -1;
+			uint64_t FreeBits = GetFreeBitsOfWord(ulWordIndex);
+
+			while ((FreeBits != 0) && (ulFound < i_ulCount))
+			{
+				o_pulIndices[ulFound++] = ulWordIndex * SIZE_OF_WORD + CountTrailingZeros(FreeBits);
+				FreeBits &= (FreeBits - 1);
+			}
 		}
 
-		for (unsigned long ulCount = 0; ulCount < SIZE_OF_LONG; ulCount++)
+		return ulFound;
+	}
+
+	/******************************************************************************
+		Function     : GetAndSetFirstNFreeBitIndices
+		Description  : Writes up to i_ulCount free bit indices to o_pulIndices and
+					marks them used, a whole word is updated at once
+		Input        : unsigned long *o_pulIndices, const unsigned long i_ulCount
+		Output       :
+		Return Value : unsigned long (number of indices found)
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	unsigned long BitArray::GetAndSetFirstNFreeBitIndices(unsigned long *o_pulIndices, const unsigned long i_ulCount)
+	{
+		assert(o_pulIndices != NULL);
+
+		unsigned long ulFound = 0;
+		unsigned long ulWordIndex = m_ulSearchCursor;
+
+		for (unsigned long ulCount = 0; (ulCount < m_ulNumberOfWords) && (ulFound < i_ulCount); ulCount++)
 		{
-			if (m_pBitArray[ulLongSetIndex] == (m_pBitArray[ulLongSetIndex] & (ForShifting << ulCount)))
+			uint64_t FreeBits = GetFreeBitsOfWord(ulWordIndex);
+			uint64_t TakenBits = 0;
+
+			while ((FreeBits != 0) && (ulFound < i_ulCount))
 			{
-				ulFirstSetBitIndex = ulCount;
-				break;
+				uint64_t LowestBit = FreeBits & (~FreeBits + 1);
+
+				o_pulIndices[ulFound++] = ulWordIndex * SIZE_OF_WORD + CountTrailingZeros(FreeBits);
+				TakenBits |= LowestBit;
+				FreeBits ^= LowestBit;
+			}
+
+			m_pBitArray[ulWordIndex] |= TakenBits;
+			m_ulSearchCursor = ulWordIndex;
+
+			if (++ulWordIndex == m_ulNumberOfWords)
+			{
+				ulWordIndex = 0;
 			}
 		}
 
-		ClearSetBit(ulFirstSetBitIndex);
+		return ulFound;
+	}
 
-		ulFirstSetBitIndex += ulLongSetIndex * SIZE_OF_LONG;
+	/******************************************************************************
+		Function     : CountSetBits
+		Description  : Returns the number of set bits using popcount per word
+		Input        : void
+		Output       :
+		Return Value : unsigned long
+		Data Accessed:
+		Data Updated :
 
-		return ulFirstSetBitIndex;
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	unsigned long BitArray::CountSetBits(void) const
+	{
+		unsigned long ulSetCount = 0;
+
+		for (unsigned long ulWordIndex = 0; ulWordIndex < m_ulNumberOfWords; ulWordIndex++)
+		{
+			ulSetCount += PopCount(m_pBitArray[ulWordIndex]);
+		}
+
+		return ulSetCount;
+	}
+
+	/******************************************************************************
+		Function     : GetItemCount
+		Description  : Returns the number of bits in the bitarray
+		Input        : void
+		Output       :
+		Return Value : unsigned long
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	unsigned long BitArray::GetItemCount(void) const
+	{
+		return m_ulItemCount;
 	}
 
 	/******************************************************************************
 		Function     : ShowAllIndex
 		Description  : Function to display the bits in bitarray
 		Input        : void
-		Output       : 
+		Output       :
 		Return Value : void
-		Data Accessed: 
-		Data Updated : 
- 
+		Data Accessed:
+		Data Updated :
+
 		History      :
 		Author       : Vinod VM
 		Modification : Created function
 	******************************************************************************/
 	void BitArray::ShowAllIndex(void) const
 	{
-		unsigned long ulLongSetIndex = 0;
-		unsigned long ulNumberOfLongs = (m_ulItemCount + SIZE_OF_LONG - 1) / (SIZE_OF_LONG);
-
-		while (ulLongSetIndex < ulNumberOfLongs)
+		for (unsigned long ulWordIndex = 0; ulWordIndex < m_ulNumberOfWords; ulWordIndex++)
 		{
-			unsigned long long n = m_pBitArray[0];
-			std::bitset<32> x(n);
+			std::bitset<SIZE_OF_WORD> x(m_pBitArray[ulWordIndex]);
 			std::cout<< x <<"\n";
-			ulLongSetIndex++;
 		}
 
 		return;
 	}
-}
\ No newline at end of file
+
+	/******************************************************************************
+		Function     : BitArray_UnitTest
+		Description  : UnitTest function to test BitArray
+		Input        : void
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void BitArray_UnitTest(void)
+	{
+	#ifdef _DEBUG
+		const unsigned long UTItemCount = 150;
+
+		BitArray *pUTBitArray = BitArray::Create(UTItemCount);
+
+		assert(pUTBitArray != NULL);
+		assert(pUTBitArray->CountSetBits() == 0);
+		assert(pUTBitArray->GetFirstSetBitIndex() == -1);
+
+		for (unsigned long i = 0; i < UTItemCount; i++)
+		{
+			assert(pUTBitArray->GetAndSetFirstFreeBitIndex() == static_cast<long>(i));
+		}
+
+		//Padding bits of the last word must never be handed out
+		assert(pUTBitArray->GetAndSetFirstFreeBitIndex() == -1);
+		assert(pUTBitArray->CountSetBits() == UTItemCount);
+
+		pUTBitArray->ClearSetBit(3);
+		pUTBitArray->ClearSetBit(70);
+		pUTBitArray->ClearSetBit(149);
+
+		assert(pUTBitArray->CheckBit(70) == false);
+		assert(pUTBitArray->CheckBit(71) == true);
+		assert(pUTBitArray->CountSetBits() == UTItemCount - 3);
+
+		unsigned long UTIndices[4];
+		assert(pUTBitArray->GetFirstNFreeBitIndices(UTIndices, 4) == 3);
+		assert((UTIndices[0] == 3) && (UTIndices[1] == 70) && (UTIndices[2] == 149));
+
+		assert(pUTBitArray->GetAndSetFirstNFreeBitIndices(UTIndices, 4) == 3);
+		assert(pUTBitArray->CountSetBits() == UTItemCount);
+
+		for (unsigned long i = 0; i < UTItemCount; i++)
+		{
+			if ((i % 7) != 0)
+			{
+				pUTBitArray->ClearSetBit(i);
+			}
+		}
+
+		unsigned long ulVisited = 0;
+		long lIndex = pUTBitArray->GetNextSetBitIndex(0);
+
+		while (lIndex != -1)
+		{
+			assert((lIndex % 7) == 0);
+			ulVisited++;
+			lIndex = pUTBitArray->GetNextSetBitIndex(lIndex + 1);
+		}
+
+		assert(ulVisited == pUTBitArray->CountSetBits());
+
+		unsigned long ulForEachCount = 0;
+		pUTBitArray->ForEachSetBit([&ulForEachCount](unsigned long i_ulIndex)
+		{
+			assert((i_ulIndex % 7) == 0);
+			ulForEachCount++;
+		});
+
+		assert(ulForEachCount == ulVisited);
+
+		//Free runs, every 7th bit is set so the longest run is 6 bits
+		assert(pUTBitArray->GetNextFreeBitIndex(0) == 1);
+		assert(pUTBitArray->GetNextFreeBitIndex(140) == 141);
+		assert(pUTBitArray->FindFreeRun(6, false) == 1);
+		assert(pUTBitArray->FindFreeRun(7, false) == -1);
+
+		//Open a 20 bit run across the first word boundary and a 13 bit one after it
+		pUTBitArray->ClearBitRange(50, 20);
+		pUTBitArray->ClearBitRange(100, 10);
+		assert(pUTBitArray->IsBitRangeSet(50, 1) == false);
+		assert(pUTBitArray->CheckBit(49) == true);
+		assert(pUTBitArray->FindFreeRun(8, false) == 50);
+		assert(pUTBitArray->FindFreeRun(8, true) == 99);
+
+		pUTBitArray->SetBitRange(50, 20);
+		assert(pUTBitArray->IsBitRangeSet(50, 20) == true);
+		assert(pUTBitArray->FindFreeRun(8, false) == 99);
+
+		//Whole words at once, the trailing free bits end at the item count
+		pUTBitArray->ClearBitRange(0, UTItemCount);
+		assert(pUTBitArray->CountSetBits() == 0);
+		assert(pUTBitArray->FindFreeRun(UTItemCount, true) == 0);
+		assert(pUTBitArray->FindFreeRun(UTItemCount + 1, false) == -1);
+
+		pUTBitArray->SetBitRange(0, UTItemCount);
+		assert(pUTBitArray->CountSetBits() == UTItemCount);
+		assert(pUTBitArray->GetNextFreeBitIndex(0) == -1);
+
+		unsigned long ulOutputLength = 0;
+		pUTBitArray->Destroy(&ulOutputLength);
+	#endif
+	}
+}
@@ -3,11 +3,16 @@
 
 #include "PreCompiled.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 #define BYTE_LENGTH 8
-#define SIZE_OF_LONG  (sizeof(unsigned long) * BYTE_LENGTH)
-#define	FULL_LONG_VALUE 0xffffffff
+#define SIZE_OF_WORD  (sizeof(uint64_t) * BYTE_LENGTH)
+#define	FULL_WORD_VALUE 0xffffffffffffffffULL
 
 namespace Engine
 {
@@ -15,17 +20,23 @@ namespace Engine
 	class BitArray
 	{
 		unsigned long m_ulItemCount;
-		unsigned long * m_pBitArray;
+		unsigned long m_ulNumberOfWords;
+		unsigned long m_ulSearchCursor;		//Word index where the next free bit search starts
+		uint64_t m_LastWordMask;			//Valid bits of the last word, padding bits are never free
+		uint64_t * m_pBitArray;
 		bool bIsPlacementCreate;
-		BitArray(unsigned long *i_pBitArray, unsigned long i_ulItemCount, bool i_bIsPlacementCreate);
+		BitArray(uint64_t *i_pBitArray, unsigned long i_ulItemCount, bool i_bIsPlacementCreate);
 		~BitArray();
-		unsigned long RotateLeftShift(unsigned long ulToRotate, unsigned long ulNumberofShifts);
+
+		inline uint64_t GetFreeBitsOfWord(const unsigned long i_ulWordIndex) const;
+		static unsigned long GetNumberOfWords(const unsigned long i_ulItemCount);
 
 	public:
 
 		void Destroy(unsigned long *o_ulOutputLen);
 		static BitArray * Create(const unsigned long i_ulItemCount);
 		static BitArray * CreateFromExistingMemory(void * i_MemoryBlock, const unsigned long i_ulItemCount, unsigned long *o_pulUsed);
+		static unsigned long GetRequiredMemorySize(const unsigned long i_ulItemCount);
 		bool CheckBit(const unsigned long ulBitIndex) const;
 		void SetBit(const unsigned long ulBitIndex);
 		void ClearSetBit(const unsigned long ulBitIndex);
@@ -33,9 +44,29 @@ namespace Engine
 		long GetAndSetFirstFreeBitIndex(void);
 		long GetFirstSetBitIndex(void) const;
 		long GetAndClearFirstSetBitIndex(void);
+		long GetNextSetBitIndex(const unsigned long i_ulFromIndex) const;
+		long GetNextFreeBitIndex(const unsigned long i_ulFromIndex) const;
+		long FindFreeRun(const unsigned long i_ulCount, const bool i_bBestFit) const;
+		void SetBitRange(const unsigned long i_ulFirstBit, const unsigned long i_ulCount);
+		void ClearBitRange(const unsigned long i_ulFirstBit, const unsigned long i_ulCount);
+		bool IsBitRangeSet(const unsigned long i_ulFirstBit, const unsigned long i_ulCount) const;
+		unsigned long GetFirstNFreeBitIndices(unsigned long *o_pulIndices, const unsigned long i_ulCount) const;
+		unsigned long GetAndSetFirstNFreeBitIndices(unsigned long *o_pulIndices, const unsigned long i_ulCount);
+		unsigned long CountSetBits(void) const;
+		unsigned long GetItemCount(void) const;
 		void ShowAllIndex(void) const;
 		bool operator[] (unsigned long ulItemIndex);
+
+		template<class Function>
+		void ForEachSetBit(Function i_Function) const;
+
+		static inline unsigned long CountTrailingZeros(const uint64_t i_Word);
+		static inline unsigned long PopCount(const uint64_t i_Word);
 	};
+
+	void BitArray_UnitTest(void);
 }
 
-#endif //__BIT_ARRAY_HEADER
\ No newline at end of file
+#include "BitArray.inl"
+
+#endif //__BIT_ARRAY_HEADER
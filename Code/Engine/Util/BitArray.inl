@@ -0,0 +1,120 @@
+namespace Engine
+{
+	/******************************************************************************
+		Function     : CountTrailingZeros
+		Description  : Returns the index of the lowest set bit of a non zero word
+		Input        : const uint64_t i_Word
+		Output       :
+		Return Value : unsigned long
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	inline unsigned long BitArray::CountTrailingZeros(const uint64_t i_Word)
+	{
+		assert(i_Word != 0);
+
+	#if defined(_MSC_VER) && defined(_M_X64)
+		unsigned long ulIndex;
+		_BitScanForward64(&ulIndex, i_Word);
+		return ulIndex;
+	#elif defined(_MSC_VER)
+		//Win32 has no 64 bit scan, scan the two halves
+		unsigned long ulIndex;
+
+		if (_BitScanForward(&ulIndex, static_cast<unsigned long>(i_Word)))
+		{
+			return ulIndex;
+		}
+
+		_BitScanForward(&ulIndex, static_cast<unsigned long>(i_Word >> 32));
+		return ulIndex + 32;
+	#else
+		return static_cast<unsigned long>(__builtin_ctzll(i_Word));
+	#endif
+	}
+
+	/******************************************************************************
+		Function     : PopCount
+		Description  : Returns the number of set bits in the word
+		Input        : const uint64_t i_Word
+		Output       :
+		Return Value : unsigned long
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	inline unsigned long BitArray::PopCount(const uint64_t i_Word)
+	{
+	#if defined(_MSC_VER) && defined(_M_X64)
+		return static_cast<unsigned long>(__popcnt64(i_Word));
+	#elif defined(_MSC_VER)
+		return __popcnt(static_cast<unsigned int>(i_Word)) + __popcnt(static_cast<unsigned int>(i_Word >> 32));
+	#else
+		return static_cast<unsigned long>(__builtin_popcountll(i_Word));
+	#endif
+	}
+
+	/******************************************************************************
+		Function     : GetFreeBitsOfWord
+		Description  : Returns the free bits of the word as set bits, padding bits
+					of the last word are masked out
+		Input        : const unsigned long i_ulWordIndex
+		Output       :
+		Return Value : uint64_t
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	inline uint64_t BitArray::GetFreeBitsOfWord(const unsigned long i_ulWordIndex) const
+	{
+		uint64_t FreeBits = ~m_pBitArray[i_ulWordIndex];
+
+		if (i_ulWordIndex == (m_ulNumberOfWords - 1))
+		{
+			FreeBits &= m_LastWordMask;
+		}
+
+		return FreeBits;
+	}
+
+	/******************************************************************************
+		Function     : ForEachSetBit
+		Description  : Calls i_Function with the index of every set bit in
+					ascending order, one word at a time
+		Input        : Function i_Function
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class Function>
+	void BitArray::ForEachSetBit(Function i_Function) const
+	{
+		for (unsigned long ulWordIndex = 0; ulWordIndex < m_ulNumberOfWords; ulWordIndex++)
+		{
+			uint64_t Word = m_pBitArray[ulWordIndex];
+
+			while (Word != 0)
+			{
+				i_Function(ulWordIndex * SIZE_OF_WORD + CountTrailingZeros(Word));
+
+				//Clear the lowest set bit
+				Word &= (Word - 1);
+			}
+		}
+	}
+}
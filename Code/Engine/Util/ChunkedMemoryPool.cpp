@@ -0,0 +1,591 @@
+#include "PreCompiled.h"
+
+#include "ChunkedMemoryPool.h"
+#include "Debug.h"
+
+namespace Engine
+{
+	/******************************************************************************
+		Function     : ChunkedMemoryPool
+		Description  : Constructor for chunked memory pool, chunks are added on
+					the first allocation
+		Input        : const unsigned long i_ulSize, const unsigned long i_ulItemsPerChunk,
+					const unsigned long i_ulMaxChunks
+		Output       :
+		Return Value :
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	ChunkedMemoryPool::ChunkedMemoryPool
+	(
+		const unsigned long i_ulSize,
+		const unsigned long i_ulItemsPerChunk,
+		const unsigned long i_ulMaxChunks
+	):
+		m_ulSize(i_ulSize),
+		m_ulItemsPerChunk(i_ulItemsPerChunk),
+		m_ulMaxChunks(i_ulMaxChunks),
+		m_ulLiveCount(0),
+		m_ulEmptyChunkCount(0),
+		m_ulAllocateChunk(0),
+		m_ulHighWaterMark(0),
+		m_ulAllocations(0),
+		m_ulFrees(0),
+		m_ulFailedAllocations(0),
+		m_ulIterationDepth(0)
+	{
+
+	}
+
+	/******************************************************************************
+		Function     : ~ChunkedMemoryPool
+		Description  : Releases every chunk
+		Input        :
+		Output       :
+		Return Value :
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	ChunkedMemoryPool::~ChunkedMemoryPool()
+	{
+		UnregisterStats();
+
+		if (m_ulLiveCount != 0)
+		{
+			CONSOLE_PRINT("Chunked memory pool destroyed with %d live objects", m_ulLiveCount);
+		}
+
+		while (m_Chunks.size() > 0)
+		{
+			ReleaseChunk(m_Chunks.size() - 1);
+		}
+	}
+
+	/******************************************************************************
+		Function     : Create
+		Description  : Static function to create a chunked memory pool
+		Input        : const unsigned long i_ulSize, const unsigned long i_ulItemsPerChunk,
+					const unsigned long i_ulMaxChunks (UNLIMITED_CHUNKS to grow without limit)
+		Output       :
+		Return Value : ChunkedMemoryPool *
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	ChunkedMemoryPool * ChunkedMemoryPool::Create
+	(
+		const unsigned long i_ulSize,
+		const unsigned long i_ulItemsPerChunk,
+		const unsigned long i_ulMaxChunks
+	)
+	{
+		if ((0 == i_ulSize) || (0 == i_ulItemsPerChunk))
+		{
+			return NULL;
+		}
+
+		return new ChunkedMemoryPool(i_ulSize, i_ulItemsPerChunk, i_ulMaxChunks);
+	}
+
+	/******************************************************************************
+		Function     : Destroy
+		Description  : Deletes the chunked memory pool and all its chunks
+		Input        : void
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void ChunkedMemoryPool::Destroy(void)
+	{
+		delete this;
+	}
+
+	//Every chunk holds a pool header, its bitarray and the slots
+	unsigned long ChunkedMemoryPool::GetChunkBytes(void) const
+	{
+		return MemoryPool::GetRequiredMemorySize(m_ulSize, m_ulItemsPerChunk);
+	}
+
+	/******************************************************************************
+		Function     : AddChunk
+		Description  : Appends a new chunk, the chunk list is kept sorted by
+					address and the new chunk becomes the allocation chunk
+		Input        : void
+		Output       :
+		Return Value : bool
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	bool ChunkedMemoryPool::AddChunk(void)
+	{
+		if ((UNLIMITED_CHUNKS != m_ulMaxChunks) && (m_Chunks.size() >= m_ulMaxChunks))
+		{
+			CONSOLE_PRINT("Chunked memory pool reached its chunk limit %d", m_ulMaxChunks);
+			return false;
+		}
+
+		//Chunks come straight from the OS so they can be given back when empty
+		unsigned long ulBytes = GetChunkBytes();
+		ePageBacking eBacking = PAGE_BACKING_OS_PAGES;
+		void *pBlock = PageAllocator::Reserve(ulBytes, &eBacking);
+
+		if (NULL == pBlock)
+		{
+			CONSOLE_PRINT("Failed to reserve %d bytes for memory pool chunk", ulBytes);
+			return false;
+		}
+
+		unsigned long ulUsed = 0;
+
+		sChunk NewChunk;
+		NewChunk.m_pBlock = pBlock;
+		NewChunk.m_ulLiveCount = 0;
+		NewChunk.m_eBacking = eBacking;
+		NewChunk.m_pPool = MemoryPool::CreateFromExistingMemory(pBlock, m_ulSize, m_ulItemsPerChunk, &ulUsed);
+
+		if (NULL == NewChunk.m_pPool)
+		{
+			PageAllocator::Release(pBlock, ulBytes, eBacking);
+			return false;
+		}
+
+		NewChunk.m_pPool->SetPageBacking(eBacking);
+
+		assert(ulUsed <= ulBytes);
+
+		unsigned long ulInsertIndex = 0;
+
+		while ((ulInsertIndex < m_Chunks.size()) && (m_Chunks[ulInsertIndex].m_pPool->GetStartAddress() < NewChunk.m_pPool->GetStartAddress()))
+		{
+			ulInsertIndex++;
+		}
+
+		m_Chunks.insert(m_Chunks.begin() + ulInsertIndex, NewChunk);
+		m_ulAllocateChunk = ulInsertIndex;
+		m_ulEmptyChunkCount++;
+
+		return true;
+	}
+
+	/******************************************************************************
+		Function     : ReleaseChunk
+		Description  : Destroys the chunk pool and gives its block back to the OS
+		Input        : const unsigned long i_ulChunkIndex
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void ChunkedMemoryPool::ReleaseChunk(const unsigned long i_ulChunkIndex)
+	{
+		assert(i_ulChunkIndex < m_Chunks.size());
+
+		sChunk &Chunk = m_Chunks[i_ulChunkIndex];
+
+		if (0 == Chunk.m_ulLiveCount)
+		{
+			m_ulEmptyChunkCount--;
+		}
+
+		unsigned long ulOutputLength = 0;
+		Chunk.m_pPool->Destroy(&ulOutputLength);
+		PageAllocator::Release(Chunk.m_pBlock, GetChunkBytes(), Chunk.m_eBacking);
+
+		m_Chunks.erase(m_Chunks.begin() + i_ulChunkIndex);
+		m_ulAllocateChunk = 0;
+	}
+
+	/******************************************************************************
+		Function     : ReleaseSpareChunks
+		Description  : Releases empty chunks until only one is kept as a spare,
+					catches up with the releases skipped during ForEachAllocated
+		Input        : void
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void ChunkedMemoryPool::ReleaseSpareChunks(void)
+	{
+		for (unsigned long ulCount = m_Chunks.size(); (ulCount > 0) && (m_ulEmptyChunkCount > 1); ulCount--)
+		{
+			if (0 == m_Chunks[ulCount - 1].m_ulLiveCount)
+			{
+				ReleaseChunk(ulCount - 1);
+			}
+		}
+	}
+
+	/******************************************************************************
+		Function     : FindChunkIndex
+		Description  : Binary search for the chunk holding the pointer
+		Input        : const void *pPointer
+		Output       :
+		Return Value : long (-1 if the pointer is not from this pool)
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	long ChunkedMemoryPool::FindChunkIndex(const void *pPointer) const
+	{
+		const char *pAddress = static_cast<const char *>(pPointer);
+		long lLow = 0;
+		long lHigh = static_cast<long>(m_Chunks.size()) - 1;
+
+		while (lLow <= lHigh)
+		{
+			long lMid = (lLow + lHigh) / 2;
+			const MemoryPool *pPool = m_Chunks[lMid].m_pPool;
+
+			if (pAddress < pPool->GetStartAddress())
+			{
+				lHigh = lMid - 1;
+			}
+			else if (pAddress >= pPool->GetEndAddress())
+			{
+				lLow = lMid + 1;
+			}
+			else
+			{
+				return lMid;
+			}
+		}
+
+		return -1;
+	}
+
+	/******************************************************************************
+		Function     : Allocate
+		Description  : Allocates from the current chunk, falls back to any chunk
+					with a free slot and appends a new chunk when all are full
+		Input        : const size_t i_size
+		Output       :
+		Return Value : void *
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void * ChunkedMemoryPool::Allocate(const size_t i_size)
+	{
+		assert(i_size == m_ulSize);
+
+		if ((m_ulAllocateChunk >= m_Chunks.size()) || (m_Chunks[m_ulAllocateChunk].m_ulLiveCount == m_ulItemsPerChunk))
+		{
+			if (m_ulLiveCount < GetCapacity())
+			{
+				for (m_ulAllocateChunk = 0; m_ulAllocateChunk < m_Chunks.size(); m_ulAllocateChunk++)
+				{
+					if (m_Chunks[m_ulAllocateChunk].m_ulLiveCount < m_ulItemsPerChunk)
+					{
+						break;
+					}
+				}
+			}
+			else if (false == AddChunk())
+			{
+				if (0 == m_ulFailedAllocations++)
+				{
+					CONSOLE_PRINT("Memory full, cannot add memory pool chunk to %s", GetPoolName());
+				}
+				return NULL;
+			}
+		}
+
+		sChunk &Chunk = m_Chunks[m_ulAllocateChunk];
+
+		void *pPointer = Chunk.m_pPool->Allocate(i_size);
+		assert(pPointer != NULL);
+
+		if (0 == Chunk.m_ulLiveCount)
+		{
+			m_ulEmptyChunkCount--;
+		}
+
+		Chunk.m_ulLiveCount++;
+		m_ulLiveCount++;
+		m_ulAllocations++;
+
+		if (m_ulLiveCount > m_ulHighWaterMark)
+		{
+			m_ulHighWaterMark = m_ulLiveCount;
+		}
+
+		return pPointer;
+	}
+
+	/******************************************************************************
+		Function     : DeAllocate
+		Description  : Returns the slot to its chunk, a chunk that becomes empty
+					is released when another empty chunk is already kept as spare
+		Input        : const void *pPointer
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void ChunkedMemoryPool::DeAllocate(const void *pPointer)
+	{
+		assert(pPointer != NULL);
+
+		long lChunkIndex = FindChunkIndex(pPointer);
+
+		if (-1 == lChunkIndex)
+		{
+			CONSOLE_PRINT("Pointer does not belong to the chunked memory pool");
+			assert(false);
+			return;
+		}
+
+		sChunk &Chunk = m_Chunks[lChunkIndex];
+
+		Chunk.m_pPool->DeAllocate(pPointer);
+		Chunk.m_ulLiveCount--;
+		m_ulLiveCount--;
+		m_ulFrees++;
+
+		if (0 == Chunk.m_ulLiveCount)
+		{
+			m_ulEmptyChunkCount++;
+
+			//Keep one empty chunk around so a spawn/despawn cycle does not thrash the OS
+			if ((m_ulEmptyChunkCount > 1) && (0 == m_ulIterationDepth))
+			{
+				ReleaseChunk(lChunkIndex);
+			}
+		}
+		else
+		{
+			m_ulAllocateChunk = lChunkIndex;
+		}
+	}
+
+	/******************************************************************************
+		Function     : Contains
+		Description  : Returns true if the pointer belongs to one of the chunks
+		Input        : const void *pPointer
+		Output       :
+		Return Value : bool
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	bool ChunkedMemoryPool::Contains(const void *pPointer) const
+	{
+		return (-1 != FindChunkIndex(pPointer));
+	}
+
+	/******************************************************************************
+		Function     : ReleaseEmptyChunks
+		Description  : Gives every empty chunk back to the OS, used on level unload
+		Input        : void
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void ChunkedMemoryPool::ReleaseEmptyChunks(void)
+	{
+		assert(0 == m_ulIterationDepth);
+
+		for (unsigned long ulCount = m_Chunks.size(); ulCount > 0; ulCount--)
+		{
+			if (0 == m_Chunks[ulCount - 1].m_ulLiveCount)
+			{
+				ReleaseChunk(ulCount - 1);
+			}
+		}
+
+		assert(0 == m_ulEmptyChunkCount);
+	}
+
+	unsigned long ChunkedMemoryPool::GetLiveCount(void) const
+	{
+		return m_ulLiveCount;
+	}
+
+	unsigned long ChunkedMemoryPool::GetCapacity(void) const
+	{
+		return m_ulItemsPerChunk * m_Chunks.size();
+	}
+
+	unsigned long ChunkedMemoryPool::GetChunkCount(void) const
+	{
+		return m_Chunks.size();
+	}
+
+	/******************************************************************************
+		Function     : GetPoolStats
+		Description  : Fills the stats of this pool for the pool registry, the
+					capacity is that of the chunks allocated right now. The
+					backing is mixed when the chunks got different pages.
+		Input        : sPoolStats &o_Stats
+		Output       : sPoolStats &o_Stats
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void ChunkedMemoryPool::GetPoolStats(sPoolStats &o_Stats) const
+	{
+		memset(&o_Stats, 0, sizeof(o_Stats));
+
+		o_Stats.m_ulSlotSize = m_ulSize;
+		o_Stats.m_ulCapacity = GetCapacity();
+		o_Stats.m_ulLiveCount = m_ulLiveCount;
+		o_Stats.m_ulHighWaterMark = m_ulHighWaterMark;
+		o_Stats.m_ulAllocations = m_ulAllocations;
+		o_Stats.m_ulFrees = m_ulFrees;
+		o_Stats.m_ulFailedAllocations = m_ulFailedAllocations;
+		o_Stats.m_eBacking = PAGE_BACKING_OS_PAGES;
+
+		for (unsigned long ulCount = 0; ulCount < m_Chunks.size(); ulCount++)
+		{
+			if (0 == ulCount)
+			{
+				o_Stats.m_eBacking = m_Chunks[ulCount].m_eBacking;
+			}
+			else if (m_Chunks[ulCount].m_eBacking != o_Stats.m_eBacking)
+			{
+				o_Stats.m_eBacking = PAGE_BACKING_MIXED;
+				break;
+			}
+		}
+	}
+
+	/******************************************************************************
+		Function     : ChunkedMemoryPool_UnitTest
+		Description  : UnitTest function to test ChunkedMemoryPool growth, pointer
+					stability and chunk release
+		Input        : void
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void ChunkedMemoryPool_UnitTest(void)
+	{
+	#ifdef _DEBUG
+		const unsigned long UTItemSize = sizeof(unsigned long);
+		const unsigned long UTItemsPerChunk = 16;
+		const unsigned long UTItemCount = UTItemsPerChunk * 10 + 3;
+
+		ChunkedMemoryPool *pUTPool = ChunkedMemoryPool::Create(UTItemSize, UTItemsPerChunk);
+		assert(pUTPool != NULL);
+
+		std::vector<unsigned long *> UTPointers;
+
+		for (unsigned long i = 0; i < UTItemCount; i++)
+		{
+			unsigned long *pValue = static_cast<unsigned long *>(pUTPool->Allocate(UTItemSize));
+			assert(pValue != NULL);
+			*pValue = i;
+			UTPointers.push_back(pValue);
+		}
+
+		assert(pUTPool->GetChunkCount() == 11);
+		assert(pUTPool->GetLiveCount() == UTItemCount);
+
+		//Growing must not move earlier allocations
+		for (unsigned long i = 0; i < UTItemCount; i++)
+		{
+			assert(*UTPointers[i] == i);
+			assert(pUTPool->Contains(UTPointers[i]));
+		}
+
+		//Every object is visited in address order, chunks emptied by the walk are released after it
+		const unsigned long *pLastVisited = NULL;
+		unsigned long ulVisited = 0;
+
+		pUTPool->ForEachAllocated([&](void *i_pSlot)
+		{
+			const unsigned long *pValue = static_cast<const unsigned long *>(i_pSlot);
+
+			assert((NULL == pLastVisited) || (pValue > pLastVisited));
+			assert(UTPointers[*pValue] == pValue);
+
+			pLastVisited = pValue;
+			ulVisited++;
+			pUTPool->DeAllocate(i_pSlot);
+		});
+
+		assert(ulVisited == UTItemCount);
+
+		//Only the spare empty chunk is kept
+		assert(pUTPool->GetLiveCount() == 0);
+		assert(pUTPool->GetChunkCount() == 1);
+
+		pUTPool->ReleaseEmptyChunks();
+		assert(pUTPool->GetChunkCount() == 0);
+
+		ChunkedMemoryPool *pUTLimitedPool = ChunkedMemoryPool::Create(UTItemSize, UTItemsPerChunk, 1);
+
+		for (unsigned long i = 0; i < UTItemsPerChunk; i++)
+		{
+			UTPointers[i] = static_cast<unsigned long *>(pUTLimitedPool->Allocate(UTItemSize));
+			assert(UTPointers[i] != NULL);
+		}
+
+		assert(pUTLimitedPool->Allocate(UTItemSize) == NULL);
+
+		for (unsigned long i = 0; i < UTItemsPerChunk; i++)
+		{
+			pUTLimitedPool->DeAllocate(UTPointers[i]);
+		}
+
+		pUTLimitedPool->Destroy();
+		pUTPool->Destroy();
+	#endif
+	}
+}
@@ -0,0 +1,74 @@
+#ifndef __CHUNKED_MEMORY_POOL_HEADER
+#define __CHUNKED_MEMORY_POOL_HEADER
+
+#include "PreCompiled.h"
+
+#include <vector>
+
+#include "MemoryPool.h"
+
+namespace Engine
+{
+	//Memory pool that grows by appending fixed size chunks, each chunk is a
+	//MemoryPool created in its own reserved block so slots never move
+	class ChunkedMemoryPool : public IPoolStats
+	{
+		struct sChunk
+		{
+			MemoryPool		*m_pPool;
+			void			*m_pBlock;
+			unsigned long	m_ulLiveCount;
+			ePageBacking	m_eBacking;
+		};
+
+		unsigned long m_ulSize;
+		unsigned long m_ulItemsPerChunk;
+		unsigned long m_ulMaxChunks;
+		unsigned long m_ulLiveCount;
+		unsigned long m_ulEmptyChunkCount;
+		unsigned long m_ulAllocateChunk;		//Chunk tried first by Allocate
+		unsigned long m_ulHighWaterMark;
+		unsigned long m_ulAllocations;
+		unsigned long m_ulFrees;
+		unsigned long m_ulFailedAllocations;
+		unsigned long m_ulIterationDepth;		//Chunks are not released while ForEachAllocated runs
+		std::vector<sChunk> m_Chunks;			//Sorted by start address for DeAllocate lookup
+
+		ChunkedMemoryPool(const unsigned long i_ulSize, const unsigned long i_ulItemsPerChunk, const unsigned long i_ulMaxChunks);
+		~ChunkedMemoryPool();
+		ChunkedMemoryPool(const ChunkedMemoryPool & i_Other);
+		ChunkedMemoryPool & operator=(const ChunkedMemoryPool & i_rhs);
+
+		bool AddChunk(void);
+		void ReleaseChunk(const unsigned long i_ulChunkIndex);
+		void ReleaseSpareChunks(void);
+		long FindChunkIndex(const void *pPointer) const;
+		unsigned long GetChunkBytes(void) const;
+
+	public:
+		static const unsigned long UNLIMITED_CHUNKS = 0;
+
+		static ChunkedMemoryPool *Create(const unsigned long i_ulSize, const unsigned long i_ulItemsPerChunk,
+										 const unsigned long i_ulMaxChunks = UNLIMITED_CHUNKS);
+		void Destroy(void);
+
+		void *Allocate(const size_t i_size);
+		void DeAllocate(const void *pPointer);
+		bool Contains(const void *pPointer) const;
+		void ReleaseEmptyChunks(void);
+
+		unsigned long GetLiveCount(void) const;
+		unsigned long GetCapacity(void) const;
+		unsigned long GetChunkCount(void) const;
+		void GetPoolStats(sPoolStats &o_Stats) const;
+
+		template<class Function>
+		void ForEachAllocated(Function i_Function);
+	};
+
+	void ChunkedMemoryPool_UnitTest(void);
+}
+
+#include "ChunkedMemoryPool.inl"
+
+#endif //__CHUNKED_MEMORY_POOL_HEADER
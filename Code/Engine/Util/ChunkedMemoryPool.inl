@@ -0,0 +1,45 @@
+namespace Engine
+{
+	/******************************************************************************
+		Function     : ForEachAllocated
+		Description  : Calls i_Function with every allocated slot in address order,
+					one chunk bitarray at a time. The function may free the slot
+					it is given and may allocate, slots allocated by it may or
+					may not be visited.
+		Input        : Function i_Function, called as i_Function(void *)
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class Function>
+	void ChunkedMemoryPool::ForEachAllocated(Function i_Function)
+	{
+		const char *pLastVisited = NULL;
+
+		m_ulIterationDepth++;
+
+		for (unsigned long ulCount = 0; ulCount < m_Chunks.size(); ulCount++)
+		{
+			const MemoryPool *pPool = m_Chunks[ulCount].m_pPool;
+
+			//A chunk added by i_Function shifts the sorted list, do not visit a chunk twice
+			if ((NULL != pLastVisited) && (pPool->GetStartAddress() <= pLastVisited))
+			{
+				continue;
+			}
+
+			pLastVisited = pPool->GetStartAddress();
+			pPool->ForEachAllocated(i_Function);
+		}
+
+		if (0 == --m_ulIterationDepth)
+		{
+			ReleaseSpareChunks();
+		}
+	}
+}
@@ -0,0 +1,197 @@
+#include "PreCompiled.h"
+
+#include <vector>
+
+#include "CompactingPool.h"
+#include "Debug.h"
+
+namespace Engine
+{
+#ifdef _DEBUG
+	//Counts its live instances so the test can see every constructor paired
+	//with a destructor across moves
+	struct sCompactingPoolTestObject
+	{
+		static long s_lLiveInstances;
+
+		unsigned long	m_ulValue;
+		unsigned long	*m_pOwnedValue;
+
+		sCompactingPoolTestObject(const unsigned long i_ulValue) :
+			m_ulValue(i_ulValue),
+			m_pOwnedValue(new unsigned long(i_ulValue))
+		{
+			s_lLiveInstances++;
+		}
+
+		sCompactingPoolTestObject(sCompactingPoolTestObject &&i_Other) :
+			m_ulValue(i_Other.m_ulValue),
+			m_pOwnedValue(i_Other.m_pOwnedValue)
+		{
+			i_Other.m_pOwnedValue = NULL;
+			s_lLiveInstances++;
+		}
+
+		~sCompactingPoolTestObject()
+		{
+			delete m_pOwnedValue;
+			s_lLiveInstances--;
+		}
+	};
+
+	long sCompactingPoolTestObject::s_lLiveInstances = 0;
+#endif
+
+	/******************************************************************************
+		Function     : CompactingPool_UnitTest
+		Description  : UnitTest function to test CompactingPool handles, growth
+					and incremental defragmentation
+		Input        : void
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void CompactingPool_UnitTest(void)
+	{
+	#ifdef _DEBUG
+		typedef sCompactingPoolTestObject TestObject;
+
+		const unsigned long UTInitialCapacity = 16;
+		const unsigned long UTItemCount = UTInitialCapacity * 4 + 3;
+		const unsigned long UTMovesPerFrame = 4;
+
+		CompactingPool<TestObject> *pUTPool = CompactingPool<TestObject>::Create(UTInitialCapacity);
+		assert(pUTPool != NULL);
+
+		std::vector<sPoolHandle> UTHandles;
+
+		for (unsigned long i = 0; i < UTItemCount; i++)
+		{
+			sPoolHandle Handle = pUTPool->Allocate(i);
+			assert(Handle != INVALID_POOL_HANDLE);
+			UTHandles.push_back(Handle);
+		}
+
+		//Growing moves the objects but every handle still finds its own
+		assert(pUTPool->GetCapacity() >= UTItemCount);
+		assert(pUTPool->GetLiveCount() == UTItemCount);
+		assert(pUTPool->IsCompact());
+
+		for (unsigned long i = 0; i < UTItemCount; i++)
+		{
+			TestObject *pObject = pUTPool->Get(UTHandles[i]);
+			assert((pObject != NULL) && (pObject->m_ulValue == i) && (*pObject->m_pOwnedValue == i));
+		}
+
+		//Free the front half and every odd object after it
+		for (unsigned long i = 0; i < UTItemCount; i++)
+		{
+			if ((i < UTItemCount / 2) || (i & 1))
+			{
+				assert(pUTPool->DeAllocate(UTHandles[i]));
+			}
+		}
+
+		unsigned long ulLiveCount = pUTPool->GetLiveCount();
+
+		//Freed handles are stale, freeing twice is caught
+		assert(pUTPool->Get(UTHandles[0]) == NULL);
+		assert(false == pUTPool->DeAllocate(UTHandles[0]));
+		assert(pUTPool->Get(INVALID_POOL_HANDLE) == NULL);
+		assert(false == pUTPool->IsCompact());
+
+		//Each frame moves at most the budget, until the live objects are a prefix
+		unsigned long ulFrames = 0;
+		unsigned long ulMoves = 0;
+
+		while (false == pUTPool->IsCompact())
+		{
+			unsigned long ulFrameMoves = pUTPool->Defragment(UTMovesPerFrame);
+
+			assert((ulFrameMoves > 0) && (ulFrameMoves <= UTMovesPerFrame));
+			ulMoves += ulFrameMoves;
+			ulFrames++;
+		}
+
+		assert(ulFrames > 1);
+		assert(ulMoves == pUTPool->GetRelocationCount());
+		assert(pUTPool->Defragment(UTMovesPerFrame) == 0);
+		assert(pUTPool->GetLiveCount() == ulLiveCount);
+		assert(TestObject::s_lLiveInstances == static_cast<long>(ulLiveCount));
+
+		//The live objects sit in the first slots and keep their handles
+		TestObject *pFirst = NULL;
+		unsigned long ulVisited = 0;
+
+		pUTPool->ForEach([&](TestObject *i_pObject, sPoolHandle i_Handle)
+		{
+			if (NULL == pFirst)
+			{
+				pFirst = i_pObject;
+			}
+
+			assert(i_pObject == pFirst + ulVisited);
+			assert(pUTPool->Get(i_Handle) == i_pObject);
+			assert(UTHandles[i_pObject->m_ulValue] == i_Handle);
+			assert(*i_pObject->m_pOwnedValue == i_pObject->m_ulValue);
+			ulVisited++;
+		});
+
+		assert(ulVisited == ulLiveCount);
+
+		//A reused handle slot gets a new generation
+		sPoolHandle NewHandle = pUTPool->Allocate(UTItemCount);
+		assert(NewHandle != INVALID_POOL_HANDLE);
+		assert(pUTPool->Get(NewHandle)->m_ulValue == UTItemCount);
+
+		for (unsigned long i = 0; i < UTItemCount; i++)
+		{
+			if (UTHandles[i].m_ulIndex == NewHandle.m_ulIndex)
+			{
+				assert(UTHandles[i].m_ulGeneration != NewHandle.m_ulGeneration);
+				assert(pUTPool->Get(UTHandles[i]) == NULL);
+			}
+		}
+
+		//Objects may be freed while walking the pool
+		pUTPool->ForEach([&](TestObject *i_pObject, sPoolHandle i_Handle)
+		{
+			pUTPool->DeAllocate(i_Handle);
+		});
+
+		assert(pUTPool->GetLiveCount() == 0);
+		assert(pUTPool->IsCompact());
+		assert(TestObject::s_lLiveInstances == 0);
+
+		//Destroying the pool destroys what is still in it
+		pUTPool->Allocate(1);
+		pUTPool->Allocate(2);
+		pUTPool->Destroy();
+		assert(TestObject::s_lLiveInstances == 0);
+
+		CompactingPool<TestObject> *pUTLimitedPool = CompactingPool<TestObject>::Create(2, 3);
+		assert(pUTLimitedPool != NULL);
+
+		for (unsigned long i = 0; i < 3; i++)
+		{
+			assert(pUTLimitedPool->Allocate(i) != INVALID_POOL_HANDLE);
+		}
+
+		assert(pUTLimitedPool->Allocate(3) == INVALID_POOL_HANDLE);
+
+		sPoolStats Stats;
+		pUTLimitedPool->GetPoolStats(Stats);
+		assert(Stats.m_ulCapacity == 3);
+		assert(Stats.m_ulLiveCount == 3);
+		assert(Stats.m_ulFailedAllocations == 1);
+
+		pUTLimitedPool->Destroy();
+		assert(TestObject::s_lLiveInstances == 0);
+	#endif
+	}
+}
@@ -0,0 +1,110 @@
+#ifndef __COMPACTING_POOL_HEADER
+#define __COMPACTING_POOL_HEADER
+
+#include "PreCompiled.h"
+
+#include <type_traits>
+#include <vector>
+
+#include "PoolStats.h"
+
+namespace Engine
+{
+	//Stable reference to an object in a CompactingPool. The generation changes
+	//every time the handle slot is reused, so a handle to a freed object never
+	//finds the object that replaced it.
+	struct sPoolHandle
+	{
+		unsigned long	m_ulIndex;
+		unsigned long	m_ulGeneration;
+
+		bool operator==(const sPoolHandle &i_rhs) const
+		{
+			return (m_ulIndex == i_rhs.m_ulIndex) && (m_ulGeneration == i_rhs.m_ulGeneration);
+		}
+
+		bool operator!=(const sPoolHandle &i_rhs) const
+		{
+			return !(*this == i_rhs);
+		}
+	};
+
+	//Generation 0 is never handed out
+	static const sPoolHandle INVALID_POOL_HANDLE = { 0, 0 };
+
+	//Pool of T that moves its live objects into a dense prefix of its storage.
+	//Objects are reached through handles, Defragment moves a bounded number of
+	//objects from the end of the storage into the lowest holes. A pointer from
+	//Get is valid until the next Allocate or Defragment. T must be movable and
+	//must not be pointed to by anything but its handles.
+	template<class T>
+	class CompactingPool : public IPoolStats
+	{
+		typedef typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type Storage;
+
+		struct sHandleEntry
+		{
+			unsigned long	m_ulSlot;			//Next free handle while the entry is free
+			unsigned long	m_ulGeneration;
+		};
+
+		static const unsigned long FREE_SLOT = 0xffffffffUL;
+
+		Storage							*m_pSlots;
+		std::vector<unsigned long>		m_SlotHandles;		//Handle index of each slot, FREE_SLOT for holes
+		std::vector<sHandleEntry>		m_Handles;
+		unsigned long m_ulCapacity;
+		unsigned long m_ulMaxCapacity;
+		unsigned long m_ulLiveCount;
+		unsigned long m_ulEndSlot;			//One past the highest live slot
+		unsigned long m_ulFirstFreeSlot;	//Every slot below it is live
+		unsigned long m_ulFreeHandle;		//Head of the free handle list, FREE_SLOT if empty
+		unsigned long m_ulIterationDepth;	//Nothing moves while ForEach runs
+		unsigned long m_ulHighWaterMark;
+		unsigned long m_ulAllocations;
+		unsigned long m_ulFrees;
+		unsigned long m_ulFailedAllocations;
+		unsigned long m_ulRelocations;
+
+		CompactingPool(const unsigned long i_ulInitialCapacity, const unsigned long i_ulMaxCapacity);
+		~CompactingPool();
+		CompactingPool(const CompactingPool & i_Other);
+		CompactingPool & operator=(const CompactingPool & i_rhs);
+
+		T *GetSlot(const unsigned long i_ulSlot) const;
+		bool Grow(void);
+		void MoveSlot(const unsigned long i_ulFrom, const unsigned long i_ulTo);
+		void SkipLiveSlots(void);
+		void TrimEndSlot(void);
+
+	public:
+		static const unsigned long UNLIMITED_CAPACITY = 0;
+
+		static CompactingPool<T> *Create(const unsigned long i_ulInitialCapacity,
+										 const unsigned long i_ulMaxCapacity = UNLIMITED_CAPACITY);
+		void Destroy(void);
+
+		template<class... Args>
+		sPoolHandle Allocate(Args&&... i_Args);
+		bool DeAllocate(const sPoolHandle i_Handle);
+		T *Get(const sPoolHandle i_Handle) const;
+		bool IsValid(const sPoolHandle i_Handle) const;
+
+		unsigned long Defragment(const unsigned long i_ulMaxMoves);
+		bool IsCompact(void) const;
+
+		unsigned long GetLiveCount(void) const;
+		unsigned long GetCapacity(void) const;
+		unsigned long GetRelocationCount(void) const;
+		void GetPoolStats(sPoolStats &o_Stats) const;
+
+		template<class Function>
+		void ForEach(Function i_Function);
+	};
+
+	void CompactingPool_UnitTest(void);
+}
+
+#include "CompactingPool.inl"
+
+#endif //__COMPACTING_POOL_HEADER
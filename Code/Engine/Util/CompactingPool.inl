@@ -0,0 +1,498 @@
+#include <new>
+#include <string.h>
+#include <utility>
+
+#include "Debug.h"
+
+namespace Engine
+{
+	template<class T>
+	const unsigned long CompactingPool<T>::FREE_SLOT;
+
+	template<class T>
+	const unsigned long CompactingPool<T>::UNLIMITED_CAPACITY;
+
+	/******************************************************************************
+		Function     : CompactingPool
+		Description  : Constructor for compacting pool
+		Input        : const unsigned long i_ulInitialCapacity,
+					const unsigned long i_ulMaxCapacity
+		Output       :
+		Return Value :
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class T>
+	CompactingPool<T>::CompactingPool(const unsigned long i_ulInitialCapacity, const unsigned long i_ulMaxCapacity) :
+		m_pSlots(new Storage[i_ulInitialCapacity]),
+		m_SlotHandles(i_ulInitialCapacity, FREE_SLOT),
+		m_ulCapacity(i_ulInitialCapacity),
+		m_ulMaxCapacity(i_ulMaxCapacity),
+		m_ulLiveCount(0),
+		m_ulEndSlot(0),
+		m_ulFirstFreeSlot(0),
+		m_ulFreeHandle(FREE_SLOT),
+		m_ulIterationDepth(0),
+		m_ulHighWaterMark(0),
+		m_ulAllocations(0),
+		m_ulFrees(0),
+		m_ulFailedAllocations(0),
+		m_ulRelocations(0)
+	{
+		m_Handles.reserve(i_ulInitialCapacity);
+	}
+
+	/******************************************************************************
+		Function     : ~CompactingPool
+		Description  : Destroys the objects that are still live and frees the
+					storage
+		Input        :
+		Output       :
+		Return Value :
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class T>
+	CompactingPool<T>::~CompactingPool()
+	{
+		UnregisterStats();
+
+		if (m_ulLiveCount != 0)
+		{
+			CONSOLE_PRINT("Compacting pool destroyed with %d live objects", m_ulLiveCount);
+		}
+
+		for (unsigned long ulSlot = 0; ulSlot < m_ulEndSlot; ulSlot++)
+		{
+			if (FREE_SLOT != m_SlotHandles[ulSlot])
+			{
+				GetSlot(ulSlot)->~T();
+			}
+		}
+
+		delete[] m_pSlots;
+	}
+
+	/******************************************************************************
+		Function     : Create
+		Description  : Static function to create a compacting pool, the storage
+					doubles when it is full up to i_ulMaxCapacity
+		Input        : const unsigned long i_ulInitialCapacity,
+					const unsigned long i_ulMaxCapacity (UNLIMITED_CAPACITY to grow without limit)
+		Output       :
+		Return Value : CompactingPool<T> *
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class T>
+	CompactingPool<T> * CompactingPool<T>::Create(const unsigned long i_ulInitialCapacity, const unsigned long i_ulMaxCapacity)
+	{
+		if ((0 == i_ulInitialCapacity) || (i_ulInitialCapacity >= FREE_SLOT) ||
+			((UNLIMITED_CAPACITY != i_ulMaxCapacity) && (i_ulMaxCapacity < i_ulInitialCapacity)))
+		{
+			return NULL;
+		}
+
+		return new CompactingPool<T>(i_ulInitialCapacity, i_ulMaxCapacity);
+	}
+
+	template<class T>
+	void CompactingPool<T>::Destroy(void)
+	{
+		delete this;
+	}
+
+	template<class T>
+	inline T * CompactingPool<T>::GetSlot(const unsigned long i_ulSlot) const
+	{
+		return reinterpret_cast<T *>(&m_pSlots[i_ulSlot]);
+	}
+
+	/******************************************************************************
+		Function     : Grow
+		Description  : Doubles the storage and moves every live object to the same
+					slot of the new storage
+		Input        : void
+		Output       :
+		Return Value : bool, false if the pool is at its max capacity
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class T>
+	bool CompactingPool<T>::Grow(void)
+	{
+		unsigned long ulNewCapacity = m_ulCapacity * 2;
+
+		if ((UNLIMITED_CAPACITY != m_ulMaxCapacity) && (ulNewCapacity > m_ulMaxCapacity))
+		{
+			ulNewCapacity = m_ulMaxCapacity;
+		}
+
+		if ((ulNewCapacity <= m_ulCapacity) || (ulNewCapacity >= FREE_SLOT))
+		{
+			return false;
+		}
+
+		Storage *pNewSlots = new Storage[ulNewCapacity];
+
+		for (unsigned long ulSlot = 0; ulSlot < m_ulEndSlot; ulSlot++)
+		{
+			if (FREE_SLOT != m_SlotHandles[ulSlot])
+			{
+				T *pObject = GetSlot(ulSlot);
+
+				new (&pNewSlots[ulSlot]) T(std::move(*pObject));
+				pObject->~T();
+			}
+		}
+
+		delete[] m_pSlots;
+		m_pSlots = pNewSlots;
+		m_SlotHandles.resize(ulNewCapacity, FREE_SLOT);
+		m_ulCapacity = ulNewCapacity;
+
+		return true;
+	}
+
+	/******************************************************************************
+		Function     : MoveSlot
+		Description  : Moves the live object of i_ulFrom into the hole at i_ulTo
+					and points its handle at the new slot
+		Input        : const unsigned long i_ulFrom, const unsigned long i_ulTo
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class T>
+	void CompactingPool<T>::MoveSlot(const unsigned long i_ulFrom, const unsigned long i_ulTo)
+	{
+		assert(FREE_SLOT != m_SlotHandles[i_ulFrom]);
+		assert(FREE_SLOT == m_SlotHandles[i_ulTo]);
+
+		T *pObject = GetSlot(i_ulFrom);
+
+		new (GetSlot(i_ulTo)) T(std::move(*pObject));
+		pObject->~T();
+
+		unsigned long ulHandleIndex = m_SlotHandles[i_ulFrom];
+
+		m_Handles[ulHandleIndex].m_ulSlot = i_ulTo;
+		m_SlotHandles[i_ulTo] = ulHandleIndex;
+		m_SlotHandles[i_ulFrom] = FREE_SLOT;
+
+		m_ulRelocations++;
+	}
+
+	//Moves the first free slot past the live slots after it
+	template<class T>
+	void CompactingPool<T>::SkipLiveSlots(void)
+	{
+		while ((m_ulFirstFreeSlot < m_ulCapacity) && (FREE_SLOT != m_SlotHandles[m_ulFirstFreeSlot]))
+		{
+			m_ulFirstFreeSlot++;
+		}
+	}
+
+	//Moves the end slot back over the holes before it
+	template<class T>
+	void CompactingPool<T>::TrimEndSlot(void)
+	{
+		while ((m_ulEndSlot > 0) && (FREE_SLOT == m_SlotHandles[m_ulEndSlot - 1]))
+		{
+			m_ulEndSlot--;
+		}
+	}
+
+	/******************************************************************************
+		Function     : Allocate
+		Description  : Constructs an object in the lowest free slot, growing the
+					storage if there is none
+		Input        : Args&&... i_Args, forwarded to the constructor of T
+		Output       :
+		Return Value : sPoolHandle, INVALID_POOL_HANDLE if the pool is full
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class T>
+	template<class... Args>
+	sPoolHandle CompactingPool<T>::Allocate(Args&&... i_Args)
+	{
+		assert(0 == m_ulIterationDepth);
+
+		if ((m_ulFirstFreeSlot == m_ulCapacity) && (false == Grow()))
+		{
+			m_ulFailedAllocations++;
+			CONSOLE_PRINT("Compacting pool %s is full", GetPoolName());
+			return INVALID_POOL_HANDLE;
+		}
+
+		unsigned long ulHandleIndex = m_ulFreeHandle;
+
+		if (FREE_SLOT != ulHandleIndex)
+		{
+			m_ulFreeHandle = m_Handles[ulHandleIndex].m_ulSlot;
+		}
+		else
+		{
+			sHandleEntry NewEntry = { 0, 1 };
+
+			ulHandleIndex = m_Handles.size();
+			m_Handles.push_back(NewEntry);
+		}
+
+		unsigned long ulSlot = m_ulFirstFreeSlot;
+
+		new (GetSlot(ulSlot)) T(std::forward<Args>(i_Args)...);
+
+		m_Handles[ulHandleIndex].m_ulSlot = ulSlot;
+		m_SlotHandles[ulSlot] = ulHandleIndex;
+
+		if (ulSlot >= m_ulEndSlot)
+		{
+			m_ulEndSlot = ulSlot + 1;
+		}
+
+		m_ulFirstFreeSlot++;
+		SkipLiveSlots();
+
+		m_ulAllocations++;
+
+		if (++m_ulLiveCount > m_ulHighWaterMark)
+		{
+			m_ulHighWaterMark = m_ulLiveCount;
+		}
+
+		sPoolHandle Handle = { ulHandleIndex, m_Handles[ulHandleIndex].m_ulGeneration };
+		return Handle;
+	}
+
+	/******************************************************************************
+		Function     : DeAllocate
+		Description  : Destroys the object of the handle and leaves a hole in its
+					slot, every copy of the handle becomes invalid
+		Input        : const sPoolHandle i_Handle
+		Output       :
+		Return Value : bool, false if the handle was not valid
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class T>
+	bool CompactingPool<T>::DeAllocate(const sPoolHandle i_Handle)
+	{
+		if (false == IsValid(i_Handle))
+		{
+			CONSOLE_PRINT("Stale or invalid handle %d freed", i_Handle.m_ulIndex);
+			return false;
+		}
+
+		sHandleEntry &Entry = m_Handles[i_Handle.m_ulIndex];
+		unsigned long ulSlot = Entry.m_ulSlot;
+
+		GetSlot(ulSlot)->~T();
+		m_SlotHandles[ulSlot] = FREE_SLOT;
+
+		//Skip generation 0 when it wraps, it belongs to INVALID_POOL_HANDLE
+		if (0 == ++Entry.m_ulGeneration)
+		{
+			Entry.m_ulGeneration = 1;
+		}
+
+		Entry.m_ulSlot = m_ulFreeHandle;
+		m_ulFreeHandle = i_Handle.m_ulIndex;
+
+		if (ulSlot < m_ulFirstFreeSlot)
+		{
+			m_ulFirstFreeSlot = ulSlot;
+		}
+
+		TrimEndSlot();
+
+		m_ulLiveCount--;
+		m_ulFrees++;
+
+		return true;
+	}
+
+	template<class T>
+	bool CompactingPool<T>::IsValid(const sPoolHandle i_Handle) const
+	{
+		return (i_Handle.m_ulIndex < m_Handles.size()) &&
+			(0 != i_Handle.m_ulGeneration) &&
+			(m_Handles[i_Handle.m_ulIndex].m_ulGeneration == i_Handle.m_ulGeneration);
+	}
+
+	/******************************************************************************
+		Function     : Get
+		Description  : Returns the object of the handle, the pointer is valid
+					until the next Allocate or Defragment
+		Input        : const sPoolHandle i_Handle
+		Output       :
+		Return Value : T *, NULL if the handle is stale or invalid
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class T>
+	T * CompactingPool<T>::Get(const sPoolHandle i_Handle) const
+	{
+		if (false == IsValid(i_Handle))
+		{
+			return NULL;
+		}
+
+		return GetSlot(m_Handles[i_Handle.m_ulIndex].m_ulSlot);
+	}
+
+	/******************************************************************************
+		Function     : Defragment
+		Description  : Moves up to i_ulMaxMoves objects from the end of the
+					storage into the lowest holes. Call once a frame with a
+					budget, the live objects end up in a dense prefix.
+		Input        : const unsigned long i_ulMaxMoves
+		Output       :
+		Return Value : unsigned long, number of objects moved
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class T>
+	unsigned long CompactingPool<T>::Defragment(const unsigned long i_ulMaxMoves)
+	{
+		assert(0 == m_ulIterationDepth);
+
+		unsigned long ulMoves = 0;
+
+		while ((ulMoves < i_ulMaxMoves) && (false == IsCompact()))
+		{
+			//The end slot is live and the first free slot is below it
+			MoveSlot(m_ulEndSlot - 1, m_ulFirstFreeSlot);
+			ulMoves++;
+
+			TrimEndSlot();
+			SkipLiveSlots();
+		}
+
+		return ulMoves;
+	}
+
+	template<class T>
+	bool CompactingPool<T>::IsCompact(void) const
+	{
+		return m_ulEndSlot == m_ulLiveCount;
+	}
+
+	template<class T>
+	unsigned long CompactingPool<T>::GetLiveCount(void) const
+	{
+		return m_ulLiveCount;
+	}
+
+	template<class T>
+	unsigned long CompactingPool<T>::GetCapacity(void) const
+	{
+		return m_ulCapacity;
+	}
+
+	template<class T>
+	unsigned long CompactingPool<T>::GetRelocationCount(void) const
+	{
+		return m_ulRelocations;
+	}
+
+	/******************************************************************************
+		Function     : GetPoolStats
+		Description  : Fills the stats of this pool for the pool registry
+		Input        : sPoolStats &o_Stats
+		Output       : sPoolStats &o_Stats
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class T>
+	void CompactingPool<T>::GetPoolStats(sPoolStats &o_Stats) const
+	{
+		memset(&o_Stats, 0, sizeof(o_Stats));
+
+		o_Stats.m_ulSlotSize = sizeof(T);
+		o_Stats.m_ulCapacity = m_ulCapacity;
+		o_Stats.m_ulLiveCount = m_ulLiveCount;
+		o_Stats.m_ulHighWaterMark = m_ulHighWaterMark;
+		o_Stats.m_ulAllocations = m_ulAllocations;
+		o_Stats.m_ulFrees = m_ulFrees;
+		o_Stats.m_ulFailedAllocations = m_ulFailedAllocations;
+	}
+
+	/******************************************************************************
+		Function     : ForEach
+		Description  : Calls i_Function with every live object and its handle in
+					storage order. The function may DeAllocate the handle it is
+					given but must not Allocate or Defragment.
+		Input        : Function i_Function, called as i_Function(T *, sPoolHandle)
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class T>
+	template<class Function>
+	void CompactingPool<T>::ForEach(Function i_Function)
+	{
+		m_ulIterationDepth++;
+
+		for (unsigned long ulSlot = 0; ulSlot < m_ulEndSlot; ulSlot++)
+		{
+			unsigned long ulHandleIndex = m_SlotHandles[ulSlot];
+
+			if (FREE_SLOT != ulHandleIndex)
+			{
+				sPoolHandle Handle = { ulHandleIndex, m_Handles[ulHandleIndex].m_ulGeneration };
+				i_Function(GetSlot(ulSlot), Handle);
+			}
+		}
+
+		m_ulIterationDepth--;
+	}
+}
@@ -0,0 +1,811 @@
+#include "PreCompiled.h"
+
+#include <algorithm>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "ConcurrentMemoryPool.h"
+#include "Debug.h"
+#include "HighResTime.h"
+
+#define SLOT_ALIGNMENT		8
+#define MIN_CHUNK_BYTES		4096
+#define SLOT_INDEX_MASK		0x00000000ffffffffULL
+#define TAG_INCREMENT		0x0000000100000000ULL
+
+namespace Engine
+{
+	/******************************************************************************
+		Function     : ConcurrentMemoryPool
+		Description  : Constructor, works out the chunk size. The header slots of
+					every chunk hold the chunk index, so the chunk table is
+					never searched, followed by the occupancy bits
+		Input        : const unsigned long i_ulSize, const unsigned long i_ulItemsPerChunk,
+					const unsigned long i_ulMaxChunks
+		Output       :
+		Return Value :
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	ConcurrentMemoryPool::ConcurrentMemoryPool
+	(
+		const unsigned long i_ulSize,
+		const unsigned long i_ulItemsPerChunk,
+		const unsigned long i_ulMaxChunks
+	):
+		m_ulSize(i_ulSize),
+		m_ulMaxChunks(i_ulMaxChunks),
+		m_ulChunkCount(0),
+		m_FreeListHead(0),
+		m_ulAllocations(0),
+		m_ulFrees(0),
+		m_ulFailedAllocations(0)
+	{
+		m_ulSlotSize = (i_ulSize + SLOT_ALIGNMENT - 1) & ~(SLOT_ALIGNMENT - 1);
+
+		m_ulChunkBytes = MIN_CHUNK_BYTES;
+
+		while (m_ulChunkBytes < (OCCUPANCY_OFFSET + ((i_ulItemsPerChunk + SIZE_OF_WORD - 1) / SIZE_OF_WORD) * sizeof(uint64_t) +
+								 i_ulItemsPerChunk * sizeof(uint32_t) + (i_ulItemsPerChunk + 1) * m_ulSlotSize))
+		{
+			m_ulChunkBytes <<= 1;
+		}
+
+		//Whatever is left after rounding up to a power of two is used for slots as well,
+		//the header grows a slot at a time until the occupancy bits and links of all slots fit
+		m_ulHeaderSlots = 1;
+
+		while (true)
+		{
+			m_ulItemsPerChunk = (m_ulChunkBytes / m_ulSlotSize) - m_ulHeaderSlots;
+			m_ulOccupancyWords = (m_ulItemsPerChunk + SIZE_OF_WORD - 1) / SIZE_OF_WORD;
+
+			if ((OCCUPANCY_OFFSET + m_ulOccupancyWords * sizeof(uint64_t) + m_ulItemsPerChunk * sizeof(uint32_t)) <= (m_ulHeaderSlots * m_ulSlotSize))
+			{
+				break;
+			}
+
+			m_ulHeaderSlots++;
+		}
+
+		m_ppChunks = new char*[m_ulMaxChunks];
+	}
+
+	/******************************************************************************
+		Function     : ~ConcurrentMemoryPool
+		Description  : Frees every chunk, must not race with Allocate/DeAllocate
+		Input        :
+		Output       :
+		Return Value :
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	ConcurrentMemoryPool::~ConcurrentMemoryPool()
+	{
+		UnregisterStats();
+
+		if (GetLiveCount() != 0)
+		{
+			CONSOLE_PRINT("Concurrent memory pool destroyed with %d live objects", GetLiveCount());
+		}
+
+		unsigned long ulChunkCount = m_ulChunkCount.load();
+
+		for (unsigned long ulCount = 0; ulCount < ulChunkCount; ulCount++)
+		{
+			_aligned_free(m_ppChunks[ulCount]);
+		}
+
+		delete [] m_ppChunks;
+	}
+
+	/******************************************************************************
+		Function     : Create
+		Description  : Static function to create a concurrent memory pool
+		Input        : const unsigned long i_ulSize, const unsigned long i_ulItemsPerChunk,
+					const unsigned long i_ulMaxChunks
+		Output       :
+		Return Value : ConcurrentMemoryPool *
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	ConcurrentMemoryPool * ConcurrentMemoryPool::Create
+	(
+		const unsigned long i_ulSize,
+		const unsigned long i_ulItemsPerChunk,
+		const unsigned long i_ulMaxChunks
+	)
+	{
+		if ((0 == i_ulSize) || (0 == i_ulItemsPerChunk) || (0 == i_ulMaxChunks))
+		{
+			return NULL;
+		}
+
+		return new ConcurrentMemoryPool(i_ulSize, i_ulItemsPerChunk, i_ulMaxChunks);
+	}
+
+	/******************************************************************************
+		Function     : Destroy
+		Description  : Deletes the pool, all threads must be done with it
+		Input        : void
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void ConcurrentMemoryPool::Destroy(void)
+	{
+		delete this;
+	}
+
+	inline char * ConcurrentMemoryPool::GetSlot(const uint32_t i_SlotIndex) const
+	{
+		return m_ppChunks[i_SlotIndex / m_ulItemsPerChunk] + ((i_SlotIndex % m_ulItemsPerChunk) + m_ulHeaderSlots) * m_ulSlotSize;
+	}
+
+	//Free list link of a slot, in the chunk header after the occupancy words
+	inline std::atomic<uint32_t> * ConcurrentMemoryPool::GetLink(const uint32_t i_SlotIndex) const
+	{
+		char *pLinks = m_ppChunks[i_SlotIndex / m_ulItemsPerChunk] + OCCUPANCY_OFFSET + m_ulOccupancyWords * sizeof(uint64_t);
+
+		return reinterpret_cast<std::atomic<uint32_t> *>(pLinks) + (i_SlotIndex % m_ulItemsPerChunk);
+	}
+
+	inline uint32_t ConcurrentMemoryPool::GetSlotIndex(const void *pPointer) const
+	{
+		uintptr_t Address = reinterpret_cast<uintptr_t>(pPointer);
+		const char *pChunk = reinterpret_cast<const char *>(Address & ~static_cast<uintptr_t>(m_ulChunkBytes - 1));
+		uint32_t ChunkIndex = *reinterpret_cast<const uint32_t *>(pChunk);
+
+		assert((ChunkIndex < m_ulChunkCount.load(std::memory_order_relaxed)) && (m_ppChunks[ChunkIndex] == pChunk));
+
+		return static_cast<uint32_t>(ChunkIndex * m_ulItemsPerChunk + (static_cast<const char *>(pPointer) - pChunk) / m_ulSlotSize - m_ulHeaderSlots);
+	}
+
+	inline unsigned long ConcurrentMemoryPool::GetIndexInChunk(const void *pPointer, const char **o_ppChunk) const
+	{
+		uintptr_t Address = reinterpret_cast<uintptr_t>(pPointer);
+		*o_ppChunk = reinterpret_cast<const char *>(Address & ~static_cast<uintptr_t>(m_ulChunkBytes - 1));
+
+		return static_cast<unsigned long>((static_cast<const char *>(pPointer) - *o_ppChunk) / m_ulSlotSize - m_ulHeaderSlots);
+	}
+
+	/******************************************************************************
+		Function     : PushChain
+		Description  : Pushes already linked slots from first to last on to the
+					free list with one CAS
+		Input        : const uint32_t i_FirstIndex, const uint32_t i_LastIndex
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void ConcurrentMemoryPool::PushChain(const uint32_t i_FirstIndex, const uint32_t i_LastIndex)
+	{
+		std::atomic<uint32_t> *pLastLink = GetLink(i_LastIndex);
+		uint64_t Head = m_FreeListHead.load(std::memory_order_relaxed);
+		uint64_t NewHead;
+
+		do
+		{
+			pLastLink->store(static_cast<uint32_t>(Head & SLOT_INDEX_MASK), std::memory_order_relaxed);
+			NewHead = ((Head & ~SLOT_INDEX_MASK) + TAG_INCREMENT) | (i_FirstIndex + 1);
+		} while (false == m_FreeListHead.compare_exchange_weak(Head, NewHead, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	/******************************************************************************
+		Function     : AddChunk
+		Description  : Adds a chunk under the grow lock. Another thread may have
+					grown the pool while this one waited, then nothing is added
+		Input        : void
+		Output       :
+		Return Value : bool (false if the chunk limit is hit or out of memory)
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	bool ConcurrentMemoryPool::AddChunk(void)
+	{
+		std::lock_guard<std::mutex> Lock(m_GrowMutex);
+
+		if (0 != (m_FreeListHead.load(std::memory_order_acquire) & SLOT_INDEX_MASK))
+		{
+			return true;
+		}
+
+		unsigned long ulChunkIndex = m_ulChunkCount.load(std::memory_order_relaxed);
+
+		if (ulChunkIndex >= m_ulMaxChunks)
+		{
+			CONSOLE_PRINT("Concurrent memory pool reached its chunk limit %d", m_ulMaxChunks);
+			return false;
+		}
+
+		char *pChunk = static_cast<char *>(_aligned_malloc(m_ulChunkBytes, m_ulChunkBytes));
+
+		if (NULL == pChunk)
+		{
+			CONSOLE_PRINT("Failed to allocate %d bytes for concurrent memory pool chunk", m_ulChunkBytes);
+			return false;
+		}
+
+		*reinterpret_cast<uint32_t *>(pChunk) = ulChunkIndex;
+		m_ppChunks[ulChunkIndex] = pChunk;
+
+		std::atomic<uint64_t> *pOccupancy = GetOccupancyWords(pChunk);
+
+		for (unsigned long ulWord = 0; ulWord < m_ulOccupancyWords; ulWord++)
+		{
+			new (&pOccupancy[ulWord]) std::atomic<uint64_t>(0);
+		}
+
+		uint32_t FirstIndex = ulChunkIndex * m_ulItemsPerChunk;
+		uint32_t LastIndex = FirstIndex + m_ulItemsPerChunk - 1;
+
+		for (uint32_t SlotIndex = FirstIndex; SlotIndex <= LastIndex; SlotIndex++)
+		{
+			new (GetLink(SlotIndex)) std::atomic<uint32_t>(SlotIndex + 2);
+		}
+
+		m_ulChunkCount.store(ulChunkIndex + 1, std::memory_order_release);
+
+		//The release CAS publishes the chunk table entry to whoever pops these slots
+		PushChain(FirstIndex, LastIndex);
+
+		return true;
+	}
+
+	/******************************************************************************
+		Function     : Allocate
+		Description  : Pops a slot off the free list, grows the pool when empty
+		Input        : const size_t i_size
+		Output       :
+		Return Value : void *
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void * ConcurrentMemoryPool::Allocate(const size_t i_size)
+	{
+		assert(i_size == m_ulSize);
+
+		uint64_t Head = m_FreeListHead.load(std::memory_order_acquire);
+
+		while (true)
+		{
+			uint32_t IndexPlusOne = static_cast<uint32_t>(Head & SLOT_INDEX_MASK);
+
+			if (0 == IndexPlusOne)
+			{
+				if (false == AddChunk())
+				{
+					if (0 == m_ulFailedAllocations.fetch_add(1, std::memory_order_relaxed))
+					{
+						CONSOLE_PRINT("Memory full, cannot add concurrent memory pool chunk to %s", GetPoolName());
+					}
+					return NULL;
+				}
+
+				Head = m_FreeListHead.load(std::memory_order_acquire);
+				continue;
+			}
+
+			char *pSlot = GetSlot(IndexPlusOne - 1);
+
+			//The slot may already be taken by another thread, its link is then
+			//stale but the tag makes the CAS below fail. Chunks are never freed
+			//while the pool is alive so the read itself is safe.
+			uint32_t Next = GetLink(IndexPlusOne - 1)->load(std::memory_order_relaxed);
+			uint64_t NewHead = ((Head & ~SLOT_INDEX_MASK) + TAG_INCREMENT) | Next;
+
+			if (m_FreeListHead.compare_exchange_weak(Head, NewHead, std::memory_order_acquire, std::memory_order_acquire))
+			{
+				m_ulAllocations.fetch_add(1, std::memory_order_relaxed);
+				MarkAllocated(pSlot);
+				return pSlot;
+			}
+		}
+	}
+
+	/******************************************************************************
+		Function     : DeAllocate
+		Description  : Pushes the slot back on to the free list
+		Input        : const void *pPointer
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void ConcurrentMemoryPool::DeAllocate(const void *pPointer)
+	{
+		assert(pPointer != NULL);
+
+		uint32_t SlotIndex = GetSlotIndex(pPointer);
+
+		MarkFreed(pPointer);
+		PushChain(SlotIndex, SlotIndex);
+		m_ulFrees.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/******************************************************************************
+		Function     : AllocateBatch
+		Description  : Pops up to i_ulCount slots with a single CAS. If the tag
+					has not changed nothing was popped or pushed since the head
+					was read, so the links walked are the real ones. The slots
+					are not marked allocated, see MarkAllocated
+		Input        : void **o_ppSlots, const unsigned long i_ulCount
+		Output       : void **o_ppSlots
+		Return Value : unsigned long (slots popped, 0 if the pool cannot grow)
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	unsigned long ConcurrentMemoryPool::AllocateBatch(void **o_ppSlots, const unsigned long i_ulCount)
+	{
+		assert(o_ppSlots != NULL);
+
+		uint64_t Head = m_FreeListHead.load(std::memory_order_acquire);
+
+		while (true)
+		{
+			uint32_t Next = static_cast<uint32_t>(Head & SLOT_INDEX_MASK);
+
+			if (0 == Next)
+			{
+				if (false == AddChunk())
+				{
+					if (0 == m_ulFailedAllocations.fetch_add(1, std::memory_order_relaxed))
+					{
+						CONSOLE_PRINT("Memory full, cannot add concurrent memory pool chunk to %s", GetPoolName());
+					}
+					return 0;
+				}
+
+				Head = m_FreeListHead.load(std::memory_order_acquire);
+				continue;
+			}
+
+			uint32_t SlotCount = static_cast<uint32_t>(m_ulItemsPerChunk * m_ulChunkCount.load(std::memory_order_acquire));
+			unsigned long ulTaken = 0;
+
+			//A stale link can hold any value, stop before it indexes past the chunk table
+			while ((ulTaken < i_ulCount) && (0 != Next) && (Next <= SlotCount))
+			{
+				char *pSlot = GetSlot(Next - 1);
+				o_ppSlots[ulTaken++] = pSlot;
+				Next = GetLink(Next - 1)->load(std::memory_order_relaxed);
+			}
+
+			uint64_t NewHead = ((Head & ~SLOT_INDEX_MASK) + TAG_INCREMENT) | Next;
+
+			if (m_FreeListHead.compare_exchange_weak(Head, NewHead, std::memory_order_acquire, std::memory_order_acquire))
+			{
+				m_ulAllocations.fetch_add(ulTaken, std::memory_order_relaxed);
+				return ulTaken;
+			}
+		}
+	}
+
+	/******************************************************************************
+		Function     : DeAllocateBatch
+		Description  : Links the slots together and pushes them with a single CAS,
+					the slots must already be marked freed
+		Input        : void * const *i_ppSlots, const unsigned long i_ulCount
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void ConcurrentMemoryPool::DeAllocateBatch(void * const *i_ppSlots, const unsigned long i_ulCount)
+	{
+		if (0 == i_ulCount)
+		{
+			return;
+		}
+
+		assert(i_ppSlots != NULL);
+
+		uint32_t FirstIndex = GetSlotIndex(i_ppSlots[0]);
+		uint32_t SlotIndex = FirstIndex;
+
+		for (unsigned long ulCount = 1; ulCount < i_ulCount; ulCount++)
+		{
+			uint32_t NextIndex = GetSlotIndex(i_ppSlots[ulCount]);
+			GetLink(SlotIndex)->store(NextIndex + 1, std::memory_order_relaxed);
+			SlotIndex = NextIndex;
+		}
+
+		PushChain(FirstIndex, SlotIndex);
+		m_ulFrees.fetch_add(i_ulCount, std::memory_order_relaxed);
+	}
+
+	/******************************************************************************
+		Function     : MarkAllocated
+		Description  : Sets the occupancy bit of the slot. Allocate does this
+					itself, a cache in front of AllocateBatch marks each slot
+					as it hands it out so ForEachAllocated skips cached slots
+		Input        : const void *pPointer
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void ConcurrentMemoryPool::MarkAllocated(const void *pPointer)
+	{
+		const char *pChunk;
+		unsigned long ulIndex = GetIndexInChunk(pPointer, &pChunk);
+		uint64_t Bit = 1ULL << (ulIndex % SIZE_OF_WORD);
+
+		uint64_t OldWord = GetOccupancyWords(pChunk)[ulIndex / SIZE_OF_WORD].fetch_or(Bit, std::memory_order_relaxed);
+
+		if (0 != (OldWord & Bit))
+		{
+			CONSOLE_PRINT("Concurrent memory pool slot %d is already allocated", ulIndex);
+			assert(false);
+		}
+	}
+
+	/******************************************************************************
+		Function     : MarkFreed
+		Description  : Clears the occupancy bit of the slot, catches double frees
+					in debug builds
+		Input        : const void *pPointer
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void ConcurrentMemoryPool::MarkFreed(const void *pPointer)
+	{
+		const char *pChunk;
+		unsigned long ulIndex = GetIndexInChunk(pPointer, &pChunk);
+		uint64_t Bit = 1ULL << (ulIndex % SIZE_OF_WORD);
+
+		uint64_t OldWord = GetOccupancyWords(pChunk)[ulIndex / SIZE_OF_WORD].fetch_and(~Bit, std::memory_order_relaxed);
+
+		if (0 == (OldWord & Bit))
+		{
+			CONSOLE_PRINT("Double free of concurrent memory pool slot %d", ulIndex);
+			assert(false);
+		}
+	}
+
+	/******************************************************************************
+		Function     : Contains
+		Description  : Returns true if the pointer is a slot of this pool, walks
+					the chunk table so it is meant for asserts
+		Input        : const void *pPointer
+		Output       :
+		Return Value : bool
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	bool ConcurrentMemoryPool::Contains(const void *pPointer) const
+	{
+		const char *pAddress = static_cast<const char *>(pPointer);
+		unsigned long ulChunkCount = m_ulChunkCount.load(std::memory_order_acquire);
+
+		for (unsigned long ulCount = 0; ulCount < ulChunkCount; ulCount++)
+		{
+			const char *pFirstSlot = m_ppChunks[ulCount] + m_ulHeaderSlots * m_ulSlotSize;
+
+			if ((pAddress >= pFirstSlot) && (pAddress < (pFirstSlot + m_ulItemsPerChunk * m_ulSlotSize)))
+			{
+				return (0 == ((pAddress - pFirstSlot) % m_ulSlotSize));
+			}
+		}
+
+		return false;
+	}
+
+	unsigned long ConcurrentMemoryPool::GetLiveCount(void) const
+	{
+		//Frees are read first so a free racing with the reads cannot make this negative
+		unsigned long ulFrees = m_ulFrees.load(std::memory_order_relaxed);
+
+		return m_ulAllocations.load(std::memory_order_relaxed) - ulFrees;
+	}
+
+	unsigned long ConcurrentMemoryPool::GetCapacity(void) const
+	{
+		return m_ulItemsPerChunk * m_ulChunkCount.load(std::memory_order_relaxed);
+	}
+
+	unsigned long ConcurrentMemoryPool::GetChunkCount(void) const
+	{
+		return m_ulChunkCount.load(std::memory_order_relaxed);
+	}
+
+	/******************************************************************************
+		Function     : GetPoolStats
+		Description  : Fills the stats of this pool for the pool registry, the peak
+					is left to the registry as it is not tracked on the lock free
+					path
+		Input        : sPoolStats &o_Stats
+		Output       : sPoolStats &o_Stats
+		Return Value : void
+		Data Accessed: 
+		Data Updated : 
+ 
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void ConcurrentMemoryPool::GetPoolStats(sPoolStats &o_Stats) const
+	{
+		memset(&o_Stats, 0, sizeof(o_Stats));
+
+		unsigned long ulFrees = m_ulFrees.load(std::memory_order_relaxed);
+
+		o_Stats.m_ulSlotSize = m_ulSize;
+		o_Stats.m_ulCapacity = GetCapacity();
+		o_Stats.m_ulAllocations = m_ulAllocations.load(std::memory_order_relaxed);
+		o_Stats.m_ulFrees = ulFrees;
+		o_Stats.m_ulLiveCount = o_Stats.m_ulAllocations - ulFrees;
+		o_Stats.m_ulFailedAllocations = m_ulFailedAllocations.load(std::memory_order_relaxed);
+	}
+
+	/******************************************************************************
+		Function     : ConcurrentMemoryPool_UnitTest
+		Description  : Stress test, every thread keeps a batch of slots stamped
+					with its own id and checks that no other thread wrote to them
+		Input        : void
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void ConcurrentMemoryPool_UnitTest(void)
+	{
+	#ifdef _DEBUG
+		static const unsigned long UTItemSize = 4 * sizeof(unsigned long);
+		static const unsigned long UTBatchSize = 200;
+		static const unsigned long UTRounds = 500;
+		unsigned int uThreadCount = std::thread::hardware_concurrency();
+
+		if (uThreadCount < 4)
+		{
+			uThreadCount = 4;
+		}
+
+		//Small chunks so the threads also race on growing the pool
+		ConcurrentMemoryPool *pUTPool = ConcurrentMemoryPool::Create(UTItemSize, 16);
+		assert(pUTPool != NULL);
+
+		std::atomic<unsigned long> ulErrors(0);
+		std::vector<std::thread> UTThreads;
+
+		for (unsigned int uThread = 0; uThread < uThreadCount; uThread++)
+		{
+			UTThreads.push_back(std::thread([pUTPool, uThread, &ulErrors]()
+			{
+				unsigned long *pSlots[UTBatchSize];
+
+				for (unsigned long ulRound = 0; ulRound < UTRounds; ulRound++)
+				{
+					for (unsigned long i = 0; i < UTBatchSize; i++)
+					{
+						pSlots[i] = static_cast<unsigned long *>(pUTPool->Allocate(UTItemSize));
+
+						if (NULL == pSlots[i])
+						{
+							ulErrors++;
+							return;
+						}
+
+						pSlots[i][0] = uThread;
+						pSlots[i][1] = i;
+						pSlots[i][2] = ulRound;
+						pSlots[i][3] = uThread;
+					}
+
+					for (unsigned long i = 0; i < UTBatchSize; i++)
+					{
+						if ((pSlots[i][0] != uThread) || (pSlots[i][1] != i) || (pSlots[i][2] != ulRound) || (pSlots[i][3] != uThread))
+						{
+							ulErrors++;
+						}
+					}
+
+					//Free every other slot first so the free list gets interleaved between threads
+					for (unsigned long i = 0; i < UTBatchSize; i += 2)
+					{
+						pUTPool->DeAllocate(pSlots[i]);
+					}
+
+					for (unsigned long i = 1; i < UTBatchSize; i += 2)
+					{
+						pUTPool->DeAllocate(pSlots[i]);
+					}
+				}
+			}));
+		}
+
+		for (unsigned int uThread = 0; uThread < uThreadCount; uThread++)
+		{
+			UTThreads[uThread].join();
+		}
+
+		assert(0 == ulErrors.load());
+		assert(0 == pUTPool->GetLiveCount());
+
+		//Every slot must be on the free list exactly once
+		unsigned long ulCapacity = pUTPool->GetCapacity();
+		std::vector<void *> AllSlots;
+
+		for (unsigned long i = 0; i < ulCapacity; i++)
+		{
+			AllSlots.push_back(pUTPool->Allocate(UTItemSize));
+			assert(pUTPool->Contains(AllSlots[i]));
+		}
+
+		assert(pUTPool->GetCapacity() == ulCapacity);
+
+		std::sort(AllSlots.begin(), AllSlots.end());
+		assert(std::unique(AllSlots.begin(), AllSlots.end()) == AllSlots.end());
+
+		//The walk sees every slot once and may free the slot it is given
+		unsigned long ulVisited = 0;
+
+		pUTPool->ForEachAllocated([&](void *i_pSlot)
+		{
+			assert(std::binary_search(AllSlots.begin(), AllSlots.end(), i_pSlot));
+
+			ulVisited++;
+			pUTPool->DeAllocate(i_pSlot);
+		});
+
+		assert(ulVisited == ulCapacity);
+
+		pUTPool->ForEachAllocated([&](void *i_pSlot)
+		{
+			ulVisited++;
+		});
+
+		assert(ulVisited == ulCapacity);
+
+		pUTPool->Destroy();
+
+		ConcurrentMemoryPool *pUTLimitedPool = ConcurrentMemoryPool::Create(UTItemSize, 16, 1);
+		std::vector<void *> LimitedSlots;
+		void *pPointer;
+
+		while (NULL != (pPointer = pUTLimitedPool->Allocate(UTItemSize)))
+		{
+			LimitedSlots.push_back(pPointer);
+		}
+
+		assert(LimitedSlots.size() == pUTLimitedPool->GetCapacity());
+
+		for (unsigned long i = 0; i < LimitedSlots.size(); i++)
+		{
+			pUTLimitedPool->DeAllocate(LimitedSlots[i]);
+		}
+
+		pUTLimitedPool->Destroy();
+	#endif
+	}
+
+	/******************************************************************************
+		Function     : ConcurrentMemoryPool_Benchmark
+		Description  : Allocate and free throughput from 1 to hardware thread
+					count threads sharing one pool
+		Input        : void
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void ConcurrentMemoryPool_Benchmark(void)
+	{
+		static const unsigned long BenchItemSize = 32;
+		static const unsigned long BenchBatchSize = 64;
+		static const unsigned long BenchOpsPerThread = 1000000;
+		unsigned int uMaxThreads = std::thread::hardware_concurrency();
+
+		if (0 == uMaxThreads)
+		{
+			uMaxThreads = 1;
+		}
+
+		for (unsigned int uThreadCount = 1; uThreadCount <= uMaxThreads; uThreadCount++)
+		{
+			ConcurrentMemoryPool *pBenchPool = ConcurrentMemoryPool::Create(BenchItemSize, uThreadCount * BenchBatchSize);
+			std::vector<std::thread> BenchThreads;
+
+			Tick BenchStart;
+			BenchStart.CalcCurrentTick();
+
+			for (unsigned int uThread = 0; uThread < uThreadCount; uThread++)
+			{
+				BenchThreads.push_back(std::thread([pBenchPool]()
+				{
+					void *pSlots[BenchBatchSize];
+
+					for (unsigned long ulOps = 0; ulOps < BenchOpsPerThread; ulOps += BenchBatchSize)
+					{
+						for (unsigned long i = 0; i < BenchBatchSize; i++)
+						{
+							pSlots[i] = pBenchPool->Allocate(BenchItemSize);
+						}
+
+						for (unsigned long i = 0; i < BenchBatchSize; i++)
+						{
+							pBenchPool->DeAllocate(pSlots[i]);
+						}
+					}
+				}));
+			}
+
+			for (unsigned int uThread = 0; uThread < uThreadCount; uThread++)
+			{
+				BenchThreads[uThread].join();
+			}
+
+			double BenchMS = BenchStart.GetTickDifferenceinMS();
+			double OpsPerMS = (static_cast<double>(BenchOpsPerThread) * uThreadCount) / BenchMS;
+
+			DebugPrint("ConcurrentMemoryPool Benchmark: Threads: %u	|	Total MS: %f	|	Allocate+Free per MS: %f", uThreadCount, BenchMS, OpsPerMS);
+
+			pBenchPool->Destroy();
+		}
+	}
+}
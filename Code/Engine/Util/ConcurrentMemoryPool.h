@@ -0,0 +1,87 @@
+#ifndef __CONCURRENT_MEMORY_POOL_HEADER
+#define __CONCURRENT_MEMORY_POOL_HEADER
+
+#include "PreCompiled.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+
+#include "BitArray.h"
+#include "PoolStats.h"
+
+//Occupancy words follow the chunk index in the chunk header
+#define OCCUPANCY_OFFSET	sizeof(uint64_t)
+
+namespace Engine
+{
+	//Thread safe growable memory pool. Free slots form a Treiber stack linked by
+	//slot index, the head carries a tag in its upper 32 bits so a slot that is
+	//popped and pushed back between a read and the CAS cannot be mistaken (ABA).
+	//Chunks are aligned to their own size so DeAllocate finds the chunk from the
+	//pointer without a lock. Chunks are only given back on Destroy. The chunk
+	//header also holds an occupancy bit per slot for ForEachAllocated, and the
+	//free list links. A pop reads the link of a slot that another thread may
+	//just have taken, so links are atomics kept out of the slots themselves
+	//where the new owner writes its data.
+	class ConcurrentMemoryPool : public IPoolStats
+	{
+		unsigned long m_ulSize;
+		unsigned long m_ulSlotSize;
+		unsigned long m_ulItemsPerChunk;
+		unsigned long m_ulHeaderSlots;			//Chunk index, occupancy words and links in front of the first slot
+		unsigned long m_ulOccupancyWords;
+		unsigned long m_ulChunkBytes;			//Power of two, also the chunk alignment
+		unsigned long m_ulMaxChunks;
+		char **m_ppChunks;
+		std::atomic<unsigned long> m_ulChunkCount;
+		std::atomic<uint64_t> m_FreeListHead;	//Low 32 bits: slot index + 1 (0 is empty), high 32 bits: tag
+		std::atomic<unsigned long> m_ulAllocations;	//Live count is allocations - frees
+		std::atomic<unsigned long> m_ulFrees;
+		std::atomic<unsigned long> m_ulFailedAllocations;
+		std::mutex m_GrowMutex;					//Only taken when the free list runs dry
+
+		ConcurrentMemoryPool(const unsigned long i_ulSize, const unsigned long i_ulItemsPerChunk, const unsigned long i_ulMaxChunks);
+		~ConcurrentMemoryPool();
+		ConcurrentMemoryPool(const ConcurrentMemoryPool & i_Other);
+		ConcurrentMemoryPool & operator=(const ConcurrentMemoryPool & i_rhs);
+
+		bool AddChunk(void);
+		inline char *GetSlot(const uint32_t i_SlotIndex) const;
+		inline std::atomic<uint32_t> *GetLink(const uint32_t i_SlotIndex) const;
+		inline uint32_t GetSlotIndex(const void *pPointer) const;
+		inline std::atomic<uint64_t> *GetOccupancyWords(const char *i_pChunk) const;
+		inline unsigned long GetIndexInChunk(const void *pPointer, const char **o_ppChunk) const;
+		void PushChain(const uint32_t i_FirstIndex, const uint32_t i_LastIndex);
+
+	public:
+		static const unsigned long DEFAULT_MAX_CHUNKS = 4096;
+
+		static ConcurrentMemoryPool *Create(const unsigned long i_ulSize, const unsigned long i_ulItemsPerChunk,
+											const unsigned long i_ulMaxChunks = DEFAULT_MAX_CHUNKS);
+		void Destroy(void);
+
+		void *Allocate(const size_t i_size);
+		void DeAllocate(const void *pPointer);
+		unsigned long AllocateBatch(void **o_ppSlots, const unsigned long i_ulCount);
+		void DeAllocateBatch(void * const *i_ppSlots, const unsigned long i_ulCount);
+		void MarkAllocated(const void *pPointer);
+		void MarkFreed(const void *pPointer);
+		bool Contains(const void *pPointer) const;
+
+		unsigned long GetLiveCount(void) const;
+		unsigned long GetCapacity(void) const;
+		unsigned long GetChunkCount(void) const;
+		void GetPoolStats(sPoolStats &o_Stats) const;
+
+		template<class Function>
+		void ForEachAllocated(Function i_Function) const;
+	};
+
+	void ConcurrentMemoryPool_UnitTest(void);
+	void ConcurrentMemoryPool_Benchmark(void);
+}
+
+#include "ConcurrentMemoryPool.inl"
+
+#endif //__CONCURRENT_MEMORY_POOL_HEADER
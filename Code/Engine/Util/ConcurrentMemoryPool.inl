@@ -0,0 +1,49 @@
+namespace Engine
+{
+	inline std::atomic<uint64_t> * ConcurrentMemoryPool::GetOccupancyWords(const char *i_pChunk) const
+	{
+		return reinterpret_cast<std::atomic<uint64_t> *>(const_cast<char *>(i_pChunk) + OCCUPANCY_OFFSET);
+	}
+
+	/******************************************************************************
+		Function     : ForEachAllocated
+		Description  : Calls i_Function with every allocated slot, walking the
+					occupancy bits of each chunk. Slots of a chunk come in
+					address order, chunks in the order they were added. The
+					function may free the slot it is given and may allocate,
+					slots allocated meanwhile may or may not be visited. Other
+					threads must not allocate or free while this runs.
+		Input        : Function i_Function, called as i_Function(void *)
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class Function>
+	void ConcurrentMemoryPool::ForEachAllocated(Function i_Function) const
+	{
+		for (unsigned long ulChunk = 0; ulChunk < m_ulChunkCount.load(std::memory_order_acquire); ulChunk++)
+		{
+			char *pFirstSlot = m_ppChunks[ulChunk] + m_ulHeaderSlots * m_ulSlotSize;
+			const std::atomic<uint64_t> *pOccupancy = GetOccupancyWords(m_ppChunks[ulChunk]);
+
+			for (unsigned long ulWord = 0; ulWord < m_ulOccupancyWords; ulWord++)
+			{
+				uint64_t Word = pOccupancy[ulWord].load(std::memory_order_relaxed);
+
+				while (Word != 0)
+				{
+					unsigned long ulIndex = ulWord * SIZE_OF_WORD + BitArray::CountTrailingZeros(Word);
+					i_Function(static_cast<void *>(pFirstSlot + ulIndex * m_ulSlotSize));
+
+					//Clear the lowest set bit
+					Word &= (Word - 1);
+				}
+			}
+		}
+	}
+}
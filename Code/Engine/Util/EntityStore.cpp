@@ -0,0 +1,957 @@
+#include "PreCompiled.h"
+
+#include <math.h>
+
+#include "EntityStore.h"
+#include "MemoryPool.h"
+#include "HighResTime.h"
+#include "Debug.h"
+
+//Record of a destroyed entity, its row links to the next free record
+#define FREE_ENTITY_RECORD	0xffffffff
+
+namespace Engine
+{
+	EntityStore::sComponentInfo EntityStore::s_Components[EntityStore::MAX_COMPONENTS];
+	unsigned long EntityStore::s_ulComponentCount = 0;
+	EntityStore * EntityStore::mInstance = NULL;
+
+	/******************************************************************************
+		Function     : EntityStore
+		Description  : Constructor, starts with the empty archetype every new
+					entity without components lives in
+		Input        : void
+		Output       :
+		Return Value :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	EntityStore::EntityStore(void):
+		m_ulFreeEntity(FREE_ENTITY_RECORD),
+		m_ulLiveEntities(0),
+		m_ulIterationDepth(0),
+		mInitilized(false)
+	{
+		(void)FindOrCreateArchetype(0);
+
+		mInitilized = true;
+	}
+
+	EntityStore::~EntityStore()
+	{
+		if (0 != m_ulLiveEntities)
+		{
+			CONSOLE_PRINT("EntityStore destroyed with %lu live entities", m_ulLiveEntities);
+		}
+
+		for (unsigned long ulArchetype = 0; ulArchetype < m_Archetypes.size(); ulArchetype++)
+		{
+			sArchetype *pArchetype = m_Archetypes[ulArchetype];
+
+			for (unsigned long ulChunk = 0; ulChunk < pArchetype->m_Chunks.size(); ulChunk++)
+			{
+				sChunk &Chunk = pArchetype->m_Chunks[ulChunk];
+
+				for (unsigned long ulComponent = 0; ulComponent < s_ulComponentCount; ulComponent++)
+				{
+					if (0 == (pArchetype->m_Mask & (static_cast<ComponentMask>(1) << ulComponent)))
+					{
+						continue;
+					}
+
+					char *pArray = GetArray(*pArchetype, Chunk, ulComponent);
+
+					for (unsigned long ulRow = 0; ulRow < Chunk.m_ulCount; ulRow++)
+					{
+						s_Components[ulComponent].m_pDestroy(pArray + ulRow * s_Components[ulComponent].m_ulSize);
+					}
+				}
+
+				_aligned_free(Chunk.m_pMemory);
+			}
+
+			delete pArchetype;
+		}
+	}
+
+	bool EntityStore::CreateInstance()
+	{
+		if (mInstance == NULL)
+		{
+			mInstance = new EntityStore();
+
+			if (mInstance == NULL)
+			{
+				return false;
+			}
+
+			if (mInstance->mInitilized == false)
+			{
+				delete mInstance;
+				mInstance = NULL;
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	EntityStore * EntityStore::GetInstance()
+	{
+		if (mInstance != NULL)
+		{
+			return mInstance;
+		}
+
+		assert(false);
+
+		return NULL;
+	}
+
+	void EntityStore::Destroy()
+	{
+		if (mInstance)
+		{
+			delete mInstance;
+			mInstance = NULL;
+		}
+	}
+
+	unsigned long EntityStore::RegisterComponent(const sComponentInfo &i_Info)
+	{
+		assert(s_ulComponentCount < MAX_COMPONENTS);
+		assert(i_Info.m_ulAlignment <= CHUNK_ALIGNMENT);
+
+		s_Components[s_ulComponentCount] = i_Info;
+
+		return s_ulComponentCount++;
+	}
+
+	char *EntityStore::GetArray(const sArchetype &i_Archetype, const sChunk &i_Chunk, const unsigned long i_ulComponent)
+	{
+		return i_Chunk.m_pMemory + i_Archetype.m_ulOffsets[i_ulComponent];
+	}
+
+	//The entity ids are the first array of every chunk
+	EntityId *EntityStore::GetEntities(const sChunk &i_Chunk)
+	{
+		return reinterpret_cast<EntityId *>(i_Chunk.m_pMemory);
+	}
+
+	/******************************************************************************
+		Function     : FindOrCreateArchetype
+		Description  : Finds the archetype of i_Mask, a new one gets its chunk
+					layout: the entity ids followed by one aligned array per
+					component, sized so a chunk holds as many rows as fit
+		Input        : const ComponentMask i_Mask
+		Output       :
+		Return Value : unsigned long, index of the archetype
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	unsigned long EntityStore::FindOrCreateArchetype(const ComponentMask i_Mask)
+	{
+		//There are only a handful of archetypes, a linear search beats a map
+		for (unsigned long ulArchetype = 0; ulArchetype < m_Archetypes.size(); ulArchetype++)
+		{
+			if (i_Mask == m_Archetypes[ulArchetype]->m_Mask)
+			{
+				return ulArchetype;
+			}
+		}
+
+		sArchetype *pArchetype = new sArchetype;
+		pArchetype->m_Mask = i_Mask;
+		pArchetype->m_ulEntityCount = 0;
+
+		unsigned long ulRowBytes = sizeof(EntityId);
+		unsigned long ulPaddingBytes = 0;
+
+		for (unsigned long ulComponent = 0; ulComponent < MAX_COMPONENTS; ulComponent++)
+		{
+			pArchetype->m_ulOffsets[ulComponent] = 0;
+
+			if (0 != (i_Mask & (static_cast<ComponentMask>(1) << ulComponent)))
+			{
+				assert(ulComponent < s_ulComponentCount);
+
+				ulRowBytes += s_Components[ulComponent].m_ulSize;
+				ulPaddingBytes += s_Components[ulComponent].m_ulAlignment;
+			}
+		}
+
+		assert(ulPaddingBytes < CHUNK_BYTES);
+		pArchetype->m_ulCapacity = (CHUNK_BYTES - ulPaddingBytes) / ulRowBytes;
+		assert(pArchetype->m_ulCapacity > 0);
+
+		unsigned long ulOffset = pArchetype->m_ulCapacity * sizeof(EntityId);
+
+		for (unsigned long ulComponent = 0; ulComponent < s_ulComponentCount; ulComponent++)
+		{
+			if (0 != (i_Mask & (static_cast<ComponentMask>(1) << ulComponent)))
+			{
+				const unsigned long ulAlignment = s_Components[ulComponent].m_ulAlignment;
+
+				ulOffset = (ulOffset + ulAlignment - 1) & ~(ulAlignment - 1);
+				pArchetype->m_ulOffsets[ulComponent] = ulOffset;
+				ulOffset += pArchetype->m_ulCapacity * s_Components[ulComponent].m_ulSize;
+			}
+		}
+
+		assert(ulOffset <= CHUNK_BYTES);
+
+		m_Archetypes.push_back(pArchetype);
+
+		return static_cast<unsigned long>(m_Archetypes.size() - 1);
+	}
+
+	/******************************************************************************
+		Function     : AddRow
+		Description  : Appends i_Entity to the last chunk of the archetype, the
+					components of the row are left for the caller to construct
+		Input        : const unsigned long i_ulArchetype, const EntityId i_Entity
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void EntityStore::AddRow(const unsigned long i_ulArchetype, const EntityId i_Entity)
+	{
+		sArchetype &Archetype = *m_Archetypes[i_ulArchetype];
+
+		if (Archetype.m_Chunks.empty() || (Archetype.m_Chunks.back().m_ulCount == Archetype.m_ulCapacity))
+		{
+			sChunk NewChunk;
+			NewChunk.m_pMemory = static_cast<char *>(_aligned_malloc(CHUNK_BYTES, CHUNK_ALIGNMENT));
+			NewChunk.m_ulCount = 0;
+			assert(NewChunk.m_pMemory);
+
+			Archetype.m_Chunks.push_back(NewChunk);
+		}
+
+		sChunk &Chunk = Archetype.m_Chunks.back();
+		const unsigned long ulRow = Chunk.m_ulCount++;
+
+		GetEntities(Chunk)[ulRow] = i_Entity;
+		Archetype.m_ulEntityCount++;
+
+		sEntityRecord &Record = m_Entities[i_Entity];
+		Record.m_ulArchetype = i_ulArchetype;
+		Record.m_ulChunk = static_cast<unsigned long>(Archetype.m_Chunks.size() - 1);
+		Record.m_ulRow = ulRow;
+	}
+
+	/******************************************************************************
+		Function     : RemoveRow
+		Description  : Removes a row whose components are already destroyed or
+					moved out, the last row of the archetype is moved into the
+					hole so the chunks stay packed
+		Input        : const unsigned long i_ulArchetype, const unsigned long i_ulChunk,
+					const unsigned long i_ulRow
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void EntityStore::RemoveRow(const unsigned long i_ulArchetype, const unsigned long i_ulChunk, const unsigned long i_ulRow)
+	{
+		sArchetype &Archetype = *m_Archetypes[i_ulArchetype];
+		const unsigned long ulLastChunk = static_cast<unsigned long>(Archetype.m_Chunks.size() - 1);
+		sChunk &LastChunk = Archetype.m_Chunks[ulLastChunk];
+		const unsigned long ulLastRow = LastChunk.m_ulCount - 1;
+
+		if ((i_ulChunk != ulLastChunk) || (i_ulRow != ulLastRow))
+		{
+			sChunk &Chunk = Archetype.m_Chunks[i_ulChunk];
+
+			for (unsigned long ulComponent = 0; ulComponent < s_ulComponentCount; ulComponent++)
+			{
+				if (0 != (Archetype.m_Mask & (static_cast<ComponentMask>(1) << ulComponent)))
+				{
+					const unsigned long ulSize = s_Components[ulComponent].m_ulSize;
+					char *pLast = GetArray(Archetype, LastChunk, ulComponent) + ulLastRow * ulSize;
+
+					s_Components[ulComponent].m_pMoveConstruct(GetArray(Archetype, Chunk, ulComponent) + i_ulRow * ulSize, pLast);
+					s_Components[ulComponent].m_pDestroy(pLast);
+				}
+			}
+
+			const EntityId MovedEntity = GetEntities(LastChunk)[ulLastRow];
+
+			GetEntities(Chunk)[i_ulRow] = MovedEntity;
+			m_Entities[MovedEntity].m_ulChunk = i_ulChunk;
+			m_Entities[MovedEntity].m_ulRow = i_ulRow;
+		}
+
+		LastChunk.m_ulCount--;
+		Archetype.m_ulEntityCount--;
+
+		if (0 == LastChunk.m_ulCount)
+		{
+			_aligned_free(LastChunk.m_pMemory);
+			Archetype.m_Chunks.pop_back();
+		}
+	}
+
+	/******************************************************************************
+		Function     : MoveToArchetype
+		Description  : Moves an entity to the archetype of i_NewMask. Components in
+					both archetypes are moved, ones only in the old archetype
+					are destroyed, ones only in the new archetype are left for
+					the caller to construct
+		Input        : const EntityId i_Entity, const ComponentMask i_NewMask
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void EntityStore::MoveToArchetype(const EntityId i_Entity, const ComponentMask i_NewMask)
+	{
+		assert(0 == m_ulIterationDepth);
+
+		const sEntityRecord OldRecord = m_Entities[i_Entity];
+		const unsigned long ulNewArchetype = FindOrCreateArchetype(i_NewMask);
+
+		assert(ulNewArchetype != OldRecord.m_ulArchetype);
+
+		AddRow(ulNewArchetype, i_Entity);
+
+		const sArchetype &OldArchetype = *m_Archetypes[OldRecord.m_ulArchetype];
+		const sArchetype &NewArchetype = *m_Archetypes[ulNewArchetype];
+		const sEntityRecord &NewRecord = m_Entities[i_Entity];
+
+		for (unsigned long ulComponent = 0; ulComponent < s_ulComponentCount; ulComponent++)
+		{
+			const ComponentMask Bit = static_cast<ComponentMask>(1) << ulComponent;
+
+			if (0 == (OldArchetype.m_Mask & Bit))
+			{
+				continue;
+			}
+
+			const unsigned long ulSize = s_Components[ulComponent].m_ulSize;
+			char *pOld = GetArray(OldArchetype, OldArchetype.m_Chunks[OldRecord.m_ulChunk], ulComponent) + OldRecord.m_ulRow * ulSize;
+
+			if (0 != (i_NewMask & Bit))
+			{
+				s_Components[ulComponent].m_pMoveConstruct(GetArray(NewArchetype, NewArchetype.m_Chunks[NewRecord.m_ulChunk], ulComponent) + NewRecord.m_ulRow * ulSize, pOld);
+			}
+
+			s_Components[ulComponent].m_pDestroy(pOld);
+		}
+
+		RemoveRow(OldRecord.m_ulArchetype, OldRecord.m_ulChunk, OldRecord.m_ulRow);
+	}
+
+	void *EntityStore::GetComponentPointer(const EntityId i_Entity, const unsigned long i_ulComponent) const
+	{
+		const sEntityRecord &Record = m_Entities[i_Entity];
+		const sArchetype &Archetype = *m_Archetypes[Record.m_ulArchetype];
+
+		return GetArray(Archetype, Archetype.m_Chunks[Record.m_ulChunk], i_ulComponent) + Record.m_ulRow * s_Components[i_ulComponent].m_ulSize;
+	}
+
+	/******************************************************************************
+		Function     : CreateEntityInArchetype
+		Description  : Takes a free entity record, or a new one, and gives it a
+					row in the archetype of i_Mask
+		Input        : const ComponentMask i_Mask
+		Output       :
+		Return Value : EntityId
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	EntityId EntityStore::CreateEntityInArchetype(const ComponentMask i_Mask)
+	{
+		assert(0 == m_ulIterationDepth);
+
+		EntityId Entity = m_ulFreeEntity;
+
+		if (FREE_ENTITY_RECORD != Entity)
+		{
+			m_ulFreeEntity = m_Entities[Entity].m_ulRow;
+		}
+		else
+		{
+			sEntityRecord NewRecord;
+			NewRecord.m_ulArchetype = FREE_ENTITY_RECORD;
+			NewRecord.m_ulChunk = 0;
+			NewRecord.m_ulRow = FREE_ENTITY_RECORD;
+
+			Entity = static_cast<EntityId>(m_Entities.size());
+			m_Entities.push_back(NewRecord);
+		}
+
+		AddRow(FindOrCreateArchetype(i_Mask), Entity);
+		m_ulLiveEntities++;
+
+		return Entity;
+	}
+
+	/******************************************************************************
+		Function     : DestroyEntity
+		Description  : Destroys every component of the entity and frees its id
+		Input        : const EntityId i_Entity
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void EntityStore::DestroyEntity(const EntityId i_Entity)
+	{
+		assert(0 == m_ulIterationDepth);
+		assert(IsAlive(i_Entity));
+
+		sEntityRecord &Record = m_Entities[i_Entity];
+		const sArchetype &Archetype = *m_Archetypes[Record.m_ulArchetype];
+		const sChunk &Chunk = Archetype.m_Chunks[Record.m_ulChunk];
+
+		for (unsigned long ulComponent = 0; ulComponent < s_ulComponentCount; ulComponent++)
+		{
+			if (0 != (Archetype.m_Mask & (static_cast<ComponentMask>(1) << ulComponent)))
+			{
+				s_Components[ulComponent].m_pDestroy(GetArray(Archetype, Chunk, ulComponent) + Record.m_ulRow * s_Components[ulComponent].m_ulSize);
+			}
+		}
+
+		RemoveRow(Record.m_ulArchetype, Record.m_ulChunk, Record.m_ulRow);
+
+		Record.m_ulArchetype = FREE_ENTITY_RECORD;
+		Record.m_ulRow = m_ulFreeEntity;
+		m_ulFreeEntity = i_Entity;
+		m_ulLiveEntities--;
+	}
+
+	bool EntityStore::IsAlive(const EntityId i_Entity) const
+	{
+		return (i_Entity < m_Entities.size()) && (FREE_ENTITY_RECORD != m_Entities[i_Entity].m_ulArchetype);
+	}
+
+	unsigned long EntityStore::GetEntityCount(void) const
+	{
+		return m_ulLiveEntities;
+	}
+
+	unsigned long EntityStore::GetArchetypeCount(void) const
+	{
+		return static_cast<unsigned long>(m_Archetypes.size());
+	}
+
+	unsigned long EntityStore::GetChunkCount(void) const
+	{
+		unsigned long ulChunks = 0;
+
+		for (unsigned long ulArchetype = 0; ulArchetype < m_Archetypes.size(); ulArchetype++)
+		{
+			ulChunks += static_cast<unsigned long>(m_Archetypes[ulArchetype]->m_Chunks.size());
+		}
+
+		return ulChunks;
+	}
+
+	namespace
+	{
+		struct sUTPosition
+		{
+			float	m_x;
+			float	m_y;
+
+			sUTPosition() : m_x(0.0f), m_y(0.0f) {}
+		};
+
+		struct sUTVelocity
+		{
+			float	m_x;
+			float	m_y;
+
+			sUTVelocity() : m_x(0.0f), m_y(0.0f) {}
+		};
+
+		//Counts live instances so moves and destroys can be checked
+		struct sUTTracked
+		{
+			static long s_lLiveCount;
+			unsigned long	m_ulValue;
+
+			sUTTracked() : m_ulValue(0) { s_lLiveCount++; }
+			sUTTracked(const sUTTracked &i_Other) : m_ulValue(i_Other.m_ulValue) { s_lLiveCount++; }
+			sUTTracked & operator=(const sUTTracked &i_Other) { m_ulValue = i_Other.m_ulValue; return *this; }
+			~sUTTracked() { s_lLiveCount--; }
+		};
+
+		long sUTTracked::s_lLiveCount = 0;
+
+		//Benchmark data, the vector and matrix are plain so only the layout differs
+		struct sBenchVector
+		{
+			float	x, y, z;
+		};
+
+		struct sBenchMatrix
+		{
+			float	m[16];
+		};
+
+		//Same fields in the same order as an Actor kept them before the store
+		struct sBenchActor
+		{
+			sBenchVector	Position;
+			sBenchVector	Size;
+			sBenchVector	Velocity;
+			sBenchVector	Acceleration;
+			sBenchVector	ProjectedPosition;
+			sBenchVector	ProjectedVelocity;
+			sBenchVector	Friction;
+			float			Rotation;
+			float			DeltaTime;
+			char			*pName;
+			bool			bMarkForDeath;
+			sBenchMatrix	LocalToWorld;
+			void			*pCollisionHandler;
+			void			*pController;
+			unsigned int	Type;
+			unsigned int	ClassBitIndex;
+			unsigned int	CollidesWithBitIndex;
+			unsigned int	HashedName;
+		};
+
+		struct sBenchTransform
+		{
+			sBenchVector	Position;
+			sBenchVector	Size;
+			float			Rotation;
+			sBenchMatrix	LocalToWorld;
+		};
+
+		struct sBenchVelocity
+		{
+			sBenchVector	Velocity;
+			sBenchVector	Acceleration;
+			sBenchVector	Friction;
+		};
+
+		struct sBenchController
+		{
+			void			*pController;
+			void			*pCollisionHandler;
+			float			DeltaTime;
+		};
+
+		struct sBenchPhysicsBody
+		{
+			char			Unused;
+		};
+
+		struct sBenchCollider
+		{
+			void			*pCollisionObject;
+			unsigned int	ClassBitIndex;
+			unsigned int	CollidesWithBitIndex;
+		};
+
+		struct sBenchRenderable
+		{
+			void			*pRenderable;
+		};
+
+		//What the collision pair loop reads for one object
+		struct sBenchCandidate
+		{
+			void				*pCollisionObject;
+			const sBenchMatrix	*pLocalToWorld;
+			sBenchVector		Velocity;
+			unsigned int		ClassBitIndex;
+			unsigned int		CollidesWithBitIndex;
+		};
+
+		inline void BenchIntegrate(sBenchVector &io_Position, sBenchVector &io_Velocity, const sBenchVector &i_Acceleration, const sBenchVector &i_Friction, const float i_DeltaTime)
+		{
+			io_Velocity.x += i_Acceleration.x * i_DeltaTime;
+			io_Velocity.y += i_Acceleration.y * i_DeltaTime;
+			io_Velocity.z += i_Acceleration.z * i_DeltaTime;
+			io_Position.x += io_Velocity.x * i_DeltaTime;
+			io_Position.y += io_Velocity.y * i_DeltaTime;
+			io_Position.z += io_Velocity.z * i_DeltaTime;
+			io_Velocity.x += i_Friction.x * i_DeltaTime;
+			io_Velocity.y += i_Friction.y * i_DeltaTime;
+			io_Velocity.z += i_Friction.z * i_DeltaTime;
+		}
+
+		//Translation * ZRotation, the matrix the collision gather builds
+		inline void BenchLocalToWorld(sBenchMatrix &o_Matrix, const sBenchVector &i_Position, const float i_Rotation)
+		{
+			const float fCos = cosf(i_Rotation);
+			const float fSin = sinf(i_Rotation);
+
+			o_Matrix.m[0] = fCos;	o_Matrix.m[1] = fSin;	o_Matrix.m[2] = 0.0f;	o_Matrix.m[3] = 0.0f;
+			o_Matrix.m[4] = -fSin;	o_Matrix.m[5] = fCos;	o_Matrix.m[6] = 0.0f;	o_Matrix.m[7] = 0.0f;
+			o_Matrix.m[8] = 0.0f;	o_Matrix.m[9] = 0.0f;	o_Matrix.m[10] = 1.0f;	o_Matrix.m[11] = 0.0f;
+			o_Matrix.m[12] = i_Position.x;	o_Matrix.m[13] = i_Position.y;	o_Matrix.m[14] = i_Position.z;	o_Matrix.m[15] = 1.0f;
+		}
+
+		//The transposed copy render submit hands to the per instance constants
+		inline void BenchSubmit(sBenchMatrix &o_Constant, const sBenchMatrix &i_LocalToWorld)
+		{
+			for (unsigned int uRow = 0; uRow < 4; uRow++)
+			{
+				for (unsigned int uColumn = 0; uColumn < 4; uColumn++)
+				{
+					o_Constant.m[uColumn * 4 + uRow] = i_LocalToWorld.m[uRow * 4 + uColumn];
+				}
+			}
+		}
+	}
+
+	/******************************************************************************
+		Function     : EntityStore_UnitTest
+		Description  : UnitTest function to test EntityStore
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void EntityStore_UnitTest(void)
+	{
+	#ifdef _DEBUG
+		//Run before the game creates its own entity store
+		EntityStore::CreateInstance();
+
+		EntityStore *pStore = EntityStore::GetInstance();
+		const unsigned long UTEntityCount = 1000;
+		EntityId UTEntities[UTEntityCount];
+
+		for (unsigned long i = 0; i < UTEntityCount; i++)
+		{
+			UTEntities[i] = pStore->CreateEntity<sUTPosition, sUTTracked>();
+
+			pStore->GetComponent<sUTPosition>(UTEntities[i])->m_x = static_cast<float>(i);
+			pStore->GetComponent<sUTTracked>(UTEntities[i])->m_ulValue = i;
+		}
+
+		assert(UTEntityCount == pStore->GetEntityCount());
+		assert(UTEntityCount == static_cast<unsigned long>(sUTTracked::s_lLiveCount));
+		assert(UTEntityCount == pStore->Count<sUTPosition>());
+		assert(0 == pStore->Count<sUTVelocity>());
+		assert(pStore->GetChunkCount() > 1);
+		assert(false == pStore->HasComponent<sUTVelocity>(UTEntities[0]));
+		assert(NULL == pStore->GetComponent<sUTVelocity>(UTEntities[0]));
+
+		//Every even entity moves to the archetype with a velocity
+		sUTVelocity UTVelocity;
+		UTVelocity.m_x = 1.0f;
+
+		for (unsigned long i = 0; i < UTEntityCount; i += 2)
+		{
+			pStore->AddComponent(UTEntities[i], UTVelocity);
+		}
+
+		assert((UTEntityCount / 2) == pStore->Count<sUTVelocity>());
+		assert(UTEntityCount == pStore->Count<sUTPosition>());
+		assert(UTEntityCount == static_cast<unsigned long>(sUTTracked::s_lLiveCount));
+
+		for (unsigned long i = 0; i < UTEntityCount; i++)
+		{
+			assert(pStore->GetComponent<sUTPosition>(UTEntities[i])->m_x == static_cast<float>(i));
+			assert(pStore->GetComponent<sUTTracked>(UTEntities[i])->m_ulValue == i);
+			assert(pStore->HasComponent<sUTVelocity>(UTEntities[i]) == (0 == (i % 2)));
+		}
+
+		//Queries only see matching entities, chunk by chunk
+		unsigned long ulVisited = 0;
+		pStore->ForEach<sUTPosition, sUTVelocity>([&ulVisited](EntityId i_Entity, sUTPosition &io_Position, sUTVelocity &i_Velocity)
+		{
+			io_Position.m_x += i_Velocity.m_x;
+			ulVisited++;
+		});
+
+		assert((UTEntityCount / 2) == ulVisited);
+
+		unsigned long ulChunkRows = 0;
+		pStore->ForEachChunk<sUTTracked>([&ulChunkRows](const unsigned long i_ulCount, const EntityId *i_pEntities, sUTTracked *i_pTracked)
+		{
+			for (unsigned long i = 0; i < i_ulCount; i++)
+			{
+				assert(i_pTracked[i].m_ulValue == i_pEntities[i]);
+			}
+
+			ulChunkRows += i_ulCount;
+		});
+
+		assert(UTEntityCount == ulChunkRows);
+
+		for (unsigned long i = 0; i < UTEntityCount; i++)
+		{
+			const float fExpected = static_cast<float>(i) + ((0 == (i % 2)) ? 1.0f : 0.0f);
+			assert(pStore->GetComponent<sUTPosition>(UTEntities[i])->m_x == fExpected);
+		}
+
+		//Removing the tracked component destroys it
+		pStore->RemoveComponent<sUTTracked>(UTEntities[1]);
+		assert(false == pStore->HasComponent<sUTTracked>(UTEntities[1]));
+		assert((UTEntityCount - 1) == static_cast<unsigned long>(sUTTracked::s_lLiveCount));
+		assert(pStore->GetComponent<sUTPosition>(UTEntities[1])->m_x == 1.0f);
+
+		//Destroying from the middle keeps the others where their records say
+		for (unsigned long i = 0; i < UTEntityCount; i += 3)
+		{
+			pStore->DestroyEntity(UTEntities[i]);
+			assert(false == pStore->IsAlive(UTEntities[i]));
+		}
+
+		for (unsigned long i = 0; i < UTEntityCount; i++)
+		{
+			if (0 != (i % 3))
+			{
+				assert(pStore->GetComponent<sUTPosition>(UTEntities[i])->m_y == 0.0f);
+				assert((1 == i) || (pStore->GetComponent<sUTTracked>(UTEntities[i])->m_ulValue == i));
+			}
+		}
+
+		//Destroyed ids are handed out again
+		const EntityId ReusedEntity = pStore->CreateEntity<sUTVelocity>();
+		assert(0 == (ReusedEntity % 3));
+		assert(ReusedEntity < UTEntityCount);
+
+		//Nothing is left alive, so the destructor has no leak to report
+		pStore->DestroyEntity(ReusedEntity);
+
+		for (unsigned long i = 0; i < UTEntityCount; i++)
+		{
+			if (0 != (i % 3))
+			{
+				pStore->DestroyEntity(UTEntities[i]);
+			}
+		}
+
+		assert(0 == pStore->GetEntityCount());
+		assert(0 == sUTTracked::s_lLiveCount);
+
+		EntityStore::Destroy();
+	#endif
+	}
+
+	/******************************************************************************
+		Function     : EntityStore_Benchmark
+		Description  : Physics integrate, collision gather and render submit over
+					actors laid out like before the store, pool allocated and
+					reached through a pointer list per system, against the same
+					work as queries over component chunks
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void EntityStore_Benchmark(void)
+	{
+		const unsigned long BenchEntityCounts[] = { 10000, 50000 };
+		const unsigned long BenchFrames = 100;
+		const unsigned long BenchColliderEvery = 3;
+		const float BenchDeltaTime = 1.0f / 60.0f;
+
+		for (unsigned int uCount = 0; uCount < (sizeof(BenchEntityCounts) / sizeof(BenchEntityCounts[0])); uCount++)
+		{
+			const unsigned long ulEntityCount = BenchEntityCounts[uCount];
+			double LegacyMS[3];
+			double StoreMS[3];
+			float fChecksum = 0.0f;
+
+			//Actor layout, each system keeps its own list of actor pointers
+			{
+				MemoryPool *pActorPool = MemoryPool::Create(sizeof(sBenchActor), ulEntityCount);
+				sBenchActor **pPhysicsList = new sBenchActor*[ulEntityCount];
+				sBenchActor **pRenderList = new sBenchActor*[ulEntityCount];
+				sBenchActor **pCollisionList = new sBenchActor*[ulEntityCount];
+				sBenchCandidate *pCandidates = new sBenchCandidate[ulEntityCount];
+				sBenchMatrix *pConstants = new sBenchMatrix[ulEntityCount];
+				unsigned long ulColliders = 0;
+
+				for (unsigned long i = 0; i < ulEntityCount; i++)
+				{
+					sBenchActor *pActor = static_cast<sBenchActor *>(pActorPool->Allocate(sizeof(sBenchActor)));
+					memset(pActor, 0, sizeof(sBenchActor));
+					pActor->Acceleration.y = -9.8f;
+					pActor->Rotation = static_cast<float>(i);
+
+					pPhysicsList[i] = pActor;
+					pRenderList[i] = pActor;
+
+					if (0 == (i % BenchColliderEvery))
+					{
+						pCollisionList[ulColliders++] = pActor;
+					}
+				}
+
+				Tick PhysicsStart;
+				PhysicsStart.CalcCurrentTick();
+
+				for (unsigned long ulFrame = 0; ulFrame < BenchFrames; ulFrame++)
+				{
+					for (unsigned long i = 0; i < ulEntityCount; i++)
+					{
+						sBenchActor *pActor = pPhysicsList[i];
+						BenchIntegrate(pActor->Position, pActor->Velocity, pActor->Acceleration, pActor->Friction, BenchDeltaTime);
+					}
+				}
+
+				LegacyMS[0] = PhysicsStart.GetTickDifferenceinMS();
+
+				Tick CollisionStart;
+				CollisionStart.CalcCurrentTick();
+
+				for (unsigned long ulFrame = 0; ulFrame < BenchFrames; ulFrame++)
+				{
+					for (unsigned long i = 0; i < ulColliders; i++)
+					{
+						sBenchActor *pActor = pCollisionList[i];
+						BenchLocalToWorld(pActor->LocalToWorld, pActor->Position, pActor->Rotation);
+
+						pCandidates[i].pCollisionObject = pActor;
+						pCandidates[i].pLocalToWorld = &pActor->LocalToWorld;
+						pCandidates[i].Velocity = pActor->Velocity;
+						pCandidates[i].ClassBitIndex = pActor->ClassBitIndex;
+						pCandidates[i].CollidesWithBitIndex = pActor->CollidesWithBitIndex;
+					}
+				}
+
+				LegacyMS[1] = CollisionStart.GetTickDifferenceinMS();
+
+				Tick RenderStart;
+				RenderStart.CalcCurrentTick();
+
+				for (unsigned long ulFrame = 0; ulFrame < BenchFrames; ulFrame++)
+				{
+					for (unsigned long i = 0; i < ulEntityCount; i++)
+					{
+						BenchSubmit(pConstants[i], pRenderList[i]->LocalToWorld);
+					}
+				}
+
+				LegacyMS[2] = RenderStart.GetTickDifferenceinMS();
+
+				fChecksum += pConstants[0].m[3] + pCandidates[0].Velocity.y;
+
+				delete [] pConstants;
+				delete [] pCandidates;
+				delete [] pCollisionList;
+				delete [] pRenderList;
+				delete [] pPhysicsList;
+
+				unsigned long ulOutputLength = 0;
+				pActorPool->Destroy(&ulOutputLength);
+			}
+
+			//Component chunks
+			{
+				EntityStore::CreateInstance();
+
+				EntityStore *pStore = EntityStore::GetInstance();
+				sBenchCandidate *pCandidates = new sBenchCandidate[ulEntityCount];
+				sBenchMatrix *pConstants = new sBenchMatrix[ulEntityCount];
+				sBenchCollider Collider;
+				memset(&Collider, 0, sizeof(Collider));
+
+				for (unsigned long i = 0; i < ulEntityCount; i++)
+				{
+					const EntityId Entity = pStore->CreateEntity<sBenchTransform, sBenchVelocity, sBenchController, sBenchPhysicsBody, sBenchRenderable>();
+
+					memset(pStore->GetComponent<sBenchTransform>(Entity), 0, sizeof(sBenchTransform));
+					memset(pStore->GetComponent<sBenchVelocity>(Entity), 0, sizeof(sBenchVelocity));
+					pStore->GetComponent<sBenchVelocity>(Entity)->Acceleration.y = -9.8f;
+					pStore->GetComponent<sBenchTransform>(Entity)->Rotation = static_cast<float>(i);
+
+					if (0 == (i % BenchColliderEvery))
+					{
+						pStore->AddComponent(Entity, Collider);
+					}
+				}
+
+				Tick PhysicsStart;
+				PhysicsStart.CalcCurrentTick();
+
+				for (unsigned long ulFrame = 0; ulFrame < BenchFrames; ulFrame++)
+				{
+					pStore->ForEachChunk<sBenchTransform, sBenchVelocity, sBenchPhysicsBody>([BenchDeltaTime](const unsigned long i_ulCount, const EntityId *i_pEntities,
+						sBenchTransform *i_pTransforms, sBenchVelocity *i_pVelocities, sBenchPhysicsBody *i_pBodies)
+					{
+						for (unsigned long i = 0; i < i_ulCount; i++)
+						{
+							BenchIntegrate(i_pTransforms[i].Position, i_pVelocities[i].Velocity, i_pVelocities[i].Acceleration, i_pVelocities[i].Friction, BenchDeltaTime);
+						}
+					});
+				}
+
+				StoreMS[0] = PhysicsStart.GetTickDifferenceinMS();
+
+				Tick CollisionStart;
+				CollisionStart.CalcCurrentTick();
+
+				for (unsigned long ulFrame = 0; ulFrame < BenchFrames; ulFrame++)
+				{
+					unsigned long ulColliders = 0;
+
+					pStore->ForEach<sBenchTransform, sBenchVelocity, sBenchCollider>([pCandidates, &ulColliders](EntityId i_Entity,
+						sBenchTransform &io_Transform, sBenchVelocity &i_Velocity, sBenchCollider &i_Collider)
+					{
+						BenchLocalToWorld(io_Transform.LocalToWorld, io_Transform.Position, io_Transform.Rotation);
+
+						sBenchCandidate &Candidate = pCandidates[ulColliders++];
+						Candidate.pCollisionObject = i_Collider.pCollisionObject;
+						Candidate.pLocalToWorld = &io_Transform.LocalToWorld;
+						Candidate.Velocity = i_Velocity.Velocity;
+						Candidate.ClassBitIndex = i_Collider.ClassBitIndex;
+						Candidate.CollidesWithBitIndex = i_Collider.CollidesWithBitIndex;
+					});
+				}
+
+				StoreMS[1] = CollisionStart.GetTickDifferenceinMS();
+
+				Tick RenderStart;
+				RenderStart.CalcCurrentTick();
+
+				for (unsigned long ulFrame = 0; ulFrame < BenchFrames; ulFrame++)
+				{
+					unsigned long ulSubmitted = 0;
+
+					pStore->ForEach<sBenchTransform, sBenchRenderable>([pConstants, &ulSubmitted](EntityId i_Entity, sBenchTransform &i_Transform, sBenchRenderable &i_Renderable)
+					{
+						BenchSubmit(pConstants[ulSubmitted++], i_Transform.LocalToWorld);
+					});
+				}
+
+				StoreMS[2] = RenderStart.GetTickDifferenceinMS();
+
+				fChecksum += pConstants[0].m[3] + pCandidates[0].Velocity.y;
+
+				delete [] pConstants;
+				delete [] pCandidates;
+
+				EntityStore::Destroy();
+			}
+
+			DebugPrint("EntityStore Benchmark: Entities: %lu	|	Frames: %lu	|	Checksum: %f", ulEntityCount, BenchFrames, fChecksum);
+			DebugPrint("	Physics MS: Actors %f	|	Chunks %f", LegacyMS[0], StoreMS[0]);
+			DebugPrint("	Collision gather MS: Actors %f	|	Chunks %f", LegacyMS[1], StoreMS[1]);
+			DebugPrint("	Render submit MS: Actors %f	|	Chunks %f", LegacyMS[2], StoreMS[2]);
+		}
+	}
+}
@@ -0,0 +1,145 @@
+#ifndef __ENTITY_STORE_HEADER
+#define __ENTITY_STORE_HEADER
+
+#include "PreCompiled.h"
+
+#include <vector>
+
+namespace Engine
+{
+	typedef unsigned long EntityId;
+	typedef unsigned long ComponentMask;
+
+	static const EntityId INVALID_ENTITY = 0xffffffff;
+
+	//Components of entities stored by archetype, the set of component types an
+	//entity has. Every archetype keeps its entities in fixed size chunks, each
+	//chunk holds one array per component, so a query walks matching chunks
+	//linearly. Adding or removing a component moves the entity to another
+	//archetype, the hole is filled with the last entity of the archetype.
+	//Component pointers are valid until the next add, remove, create or
+	//destroy. Main thread only.
+	class EntityStore
+	{
+		struct sComponentInfo
+		{
+			unsigned long	m_ulSize;
+			unsigned long	m_ulAlignment;
+			void			(*m_pMoveConstruct)(void *o_pDestination, void *i_pSource);
+			void			(*m_pDestroy)(void *i_pComponent);
+		};
+
+		struct sChunk
+		{
+			char			*m_pMemory;
+			unsigned long	m_ulCount;
+		};
+
+		struct sArchetype
+		{
+			ComponentMask		m_Mask;
+			unsigned long		m_ulCapacity;					//Entities per chunk
+			unsigned long		m_ulOffsets[32];				//Of each component array in a chunk
+			std::vector<sChunk>	m_Chunks;						//Only the last chunk is partly full
+			unsigned long		m_ulEntityCount;
+		};
+
+		//Where an entity lives, free records chain through m_ulRow
+		struct sEntityRecord
+		{
+			unsigned long	m_ulArchetype;
+			unsigned long	m_ulChunk;
+			unsigned long	m_ulRow;
+		};
+
+		template<class T>
+		struct sComponentType
+		{
+			static unsigned long s_ulId;
+		};
+
+		std::vector<sArchetype *>	m_Archetypes;
+		std::vector<sEntityRecord>	m_Entities;
+		unsigned long				m_ulFreeEntity;
+		unsigned long				m_ulLiveEntities;
+		unsigned long				m_ulIterationDepth;			//Structural changes are not allowed inside a query
+		bool						mInitilized;
+
+		static sComponentInfo	s_Components[32];
+		static unsigned long	s_ulComponentCount;
+		static EntityStore		*mInstance;
+
+		EntityStore(void);
+		~EntityStore();
+		EntityStore(const EntityStore & i_Other);
+		EntityStore & operator=(const EntityStore & i_rhs);
+
+		template<class T>
+		static void MoveConstructComponent(void *o_pDestination, void *i_pSource);
+		template<class T>
+		static void DestroyComponent(void *i_pComponent);
+		static unsigned long RegisterComponent(const sComponentInfo &i_Info);
+		template<class Function, class... Components>
+		static void CallForEachRow(Function &i_Function, const unsigned long i_ulCount, const EntityId *i_pEntities, Components *... i_pArrays);
+
+		unsigned long FindOrCreateArchetype(const ComponentMask i_Mask);
+		void AddRow(const unsigned long i_ulArchetype, const EntityId i_Entity);
+		void RemoveRow(const unsigned long i_ulArchetype, const unsigned long i_ulChunk, const unsigned long i_ulRow);
+		void MoveToArchetype(const EntityId i_Entity, const ComponentMask i_NewMask);
+		void *GetComponentPointer(const EntityId i_Entity, const unsigned long i_ulComponent) const;
+		EntityId CreateEntityInArchetype(const ComponentMask i_Mask);
+
+		static char *GetArray(const sArchetype &i_Archetype, const sChunk &i_Chunk, const unsigned long i_ulComponent);
+		static EntityId *GetEntities(const sChunk &i_Chunk);
+
+	public:
+		static const unsigned long MAX_COMPONENTS = 32;
+		static const unsigned long CHUNK_BYTES = 16 * 1024;
+		static const unsigned long CHUNK_ALIGNMENT = 64;
+
+		static bool CreateInstance();
+		static EntityStore * GetInstance();
+		static void Destroy();
+
+		//Ids are handed out on first use, in any order
+		template<class T>
+		static unsigned long GetComponentId(void);
+		template<class... Components>
+		static ComponentMask GetMask(void);
+
+		//New entity with default constructed Components
+		template<class... Components>
+		EntityId CreateEntity(void);
+		void DestroyEntity(const EntityId i_Entity);
+		bool IsAlive(const EntityId i_Entity) const;
+
+		template<class T>
+		T *AddComponent(const EntityId i_Entity, const T &i_Value);
+		template<class T>
+		void RemoveComponent(const EntityId i_Entity);
+		template<class T>
+		T *GetComponent(const EntityId i_Entity) const;
+		template<class T>
+		bool HasComponent(const EntityId i_Entity) const;
+
+		//i_Function(EntityId, Components &...) for every entity that has all Components
+		template<class... Components, class Function>
+		void ForEach(Function i_Function);
+		//i_Function(Count, const EntityId *, Components *...) once per matching chunk
+		template<class... Components, class Function>
+		void ForEachChunk(Function i_Function);
+		template<class... Components>
+		unsigned long Count(void) const;
+
+		unsigned long GetEntityCount(void) const;
+		unsigned long GetArchetypeCount(void) const;
+		unsigned long GetChunkCount(void) const;
+	};
+
+	void EntityStore_UnitTest(void);
+	void EntityStore_Benchmark(void);
+}
+
+#include "EntityStore.inl"
+
+#endif //__ENTITY_STORE_HEADER
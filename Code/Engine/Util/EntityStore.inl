@@ -0,0 +1,274 @@
+#include <new>
+#include <utility>
+
+namespace Engine
+{
+	template<class T>
+	unsigned long EntityStore::sComponentType<T>::s_ulId = EntityStore::MAX_COMPONENTS;
+
+	template<class T>
+	void EntityStore::MoveConstructComponent(void *o_pDestination, void *i_pSource)
+	{
+		new (o_pDestination) T(std::move(*static_cast<T *>(i_pSource)));
+	}
+
+	template<class T>
+	void EntityStore::DestroyComponent(void *i_pComponent)
+	{
+		static_cast<T *>(i_pComponent)->~T();
+	}
+
+	template<class Function, class... Components>
+	void EntityStore::CallForEachRow(Function &i_Function, const unsigned long i_ulCount, const EntityId *i_pEntities, Components *... i_pArrays)
+	{
+		for (unsigned long i = 0; i < i_ulCount; i++)
+		{
+			i_Function(i_pEntities[i], i_pArrays[i]...);
+		}
+	}
+
+	/******************************************************************************
+		Function     : GetComponentId
+		Description  : Id of component type T, registers the type on first use
+		Input        : void
+		Output       :
+		Return Value : unsigned long
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class T>
+	unsigned long EntityStore::GetComponentId(void)
+	{
+		if (MAX_COMPONENTS == sComponentType<T>::s_ulId)
+		{
+			sComponentInfo Info;
+			Info.m_ulSize = sizeof(T);
+			Info.m_ulAlignment = __alignof(T);
+			Info.m_pMoveConstruct = &MoveConstructComponent<T>;
+			Info.m_pDestroy = &DestroyComponent<T>;
+
+			sComponentType<T>::s_ulId = RegisterComponent(Info);
+		}
+
+		return sComponentType<T>::s_ulId;
+	}
+
+	template<class... Components>
+	ComponentMask EntityStore::GetMask(void)
+	{
+		//Leading 0 keeps the array valid for an empty pack
+		const ComponentMask Bits[] = { 0, (static_cast<ComponentMask>(1) << GetComponentId<Components>())... };
+		ComponentMask Mask = 0;
+
+		for (unsigned long i = 0; i < (sizeof(Bits) / sizeof(Bits[0])); i++)
+		{
+			Mask |= Bits[i];
+		}
+
+		return Mask;
+	}
+
+	/******************************************************************************
+		Function     : CreateEntity
+		Description  : Creates an entity straight in the archetype of Components,
+					every component is default constructed
+		Input        : void
+		Output       :
+		Return Value : EntityId
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class... Components>
+	EntityId EntityStore::CreateEntity(void)
+	{
+		const EntityId Entity = CreateEntityInArchetype(GetMask<Components...>());
+		const sEntityRecord &Record = m_Entities[Entity];
+		const sArchetype &Archetype = *m_Archetypes[Record.m_ulArchetype];
+		const sChunk &Chunk = Archetype.m_Chunks[Record.m_ulChunk];
+
+		const int Constructed[] = { 0, (new (GetArray(Archetype, Chunk, GetComponentId<Components>()) + Record.m_ulRow * sizeof(Components)) Components(), 0)... };
+		(void)Constructed;
+
+		return Entity;
+	}
+
+	/******************************************************************************
+		Function     : AddComponent
+		Description  : Moves the entity to the archetype with T and copies i_Value
+					in, an existing T is overwritten
+		Input        : const EntityId i_Entity, const T &i_Value
+		Output       :
+		Return Value : T *, valid until the next structural change
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class T>
+	T *EntityStore::AddComponent(const EntityId i_Entity, const T &i_Value)
+	{
+		assert(IsAlive(i_Entity));
+
+		const unsigned long ulComponent = GetComponentId<T>();
+		const ComponentMask Mask = m_Archetypes[m_Entities[i_Entity].m_ulArchetype]->m_Mask;
+
+		if (0 != (Mask & (static_cast<ComponentMask>(1) << ulComponent)))
+		{
+			T *pComponent = static_cast<T *>(GetComponentPointer(i_Entity, ulComponent));
+			*pComponent = i_Value;
+
+			return pComponent;
+		}
+
+		MoveToArchetype(i_Entity, Mask | (static_cast<ComponentMask>(1) << ulComponent));
+
+		return new (GetComponentPointer(i_Entity, ulComponent)) T(i_Value);
+	}
+
+	template<class T>
+	void EntityStore::RemoveComponent(const EntityId i_Entity)
+	{
+		assert(IsAlive(i_Entity));
+
+		const ComponentMask Bit = static_cast<ComponentMask>(1) << GetComponentId<T>();
+		const ComponentMask Mask = m_Archetypes[m_Entities[i_Entity].m_ulArchetype]->m_Mask;
+
+		if (0 != (Mask & Bit))
+		{
+			MoveToArchetype(i_Entity, Mask & ~Bit);
+		}
+	}
+
+	template<class T>
+	T *EntityStore::GetComponent(const EntityId i_Entity) const
+	{
+		if (false == HasComponent<T>(i_Entity))
+		{
+			return NULL;
+		}
+
+		return static_cast<T *>(GetComponentPointer(i_Entity, GetComponentId<T>()));
+	}
+
+	template<class T>
+	bool EntityStore::HasComponent(const EntityId i_Entity) const
+	{
+		assert(IsAlive(i_Entity));
+
+		const ComponentMask Mask = m_Archetypes[m_Entities[i_Entity].m_ulArchetype]->m_Mask;
+
+		return 0 != (Mask & (static_cast<ComponentMask>(1) << GetComponentId<T>()));
+	}
+
+	/******************************************************************************
+		Function     : ForEach
+		Description  : Calls i_Function(EntityId, Components &...) for every entity
+					that has all Components, chunk by chunk in storage order
+		Input        : Function i_Function
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class... Components, class Function>
+	void EntityStore::ForEach(Function i_Function)
+	{
+		const ComponentMask Mask = GetMask<Components...>();
+
+		m_ulIterationDepth++;
+
+		for (unsigned long ulArchetype = 0; ulArchetype < m_Archetypes.size(); ulArchetype++)
+		{
+			const sArchetype &Archetype = *m_Archetypes[ulArchetype];
+
+			if (Mask != (Archetype.m_Mask & Mask))
+			{
+				continue;
+			}
+
+			for (unsigned long ulChunk = 0; ulChunk < Archetype.m_Chunks.size(); ulChunk++)
+			{
+				const sChunk &Chunk = Archetype.m_Chunks[ulChunk];
+
+				CallForEachRow(i_Function, Chunk.m_ulCount, static_cast<const EntityId *>(GetEntities(Chunk)),
+					reinterpret_cast<Components *>(GetArray(Archetype, Chunk, GetComponentId<Components>()))...);
+			}
+		}
+
+		m_ulIterationDepth--;
+	}
+
+	/******************************************************************************
+		Function     : ForEachChunk
+		Description  : Calls i_Function(Count, const EntityId *, Components *...)
+					once for every chunk of every archetype that has all
+					Components, the arrays hold Count entries each
+		Input        : Function i_Function
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class... Components, class Function>
+	void EntityStore::ForEachChunk(Function i_Function)
+	{
+		const ComponentMask Mask = GetMask<Components...>();
+
+		m_ulIterationDepth++;
+
+		for (unsigned long ulArchetype = 0; ulArchetype < m_Archetypes.size(); ulArchetype++)
+		{
+			const sArchetype &Archetype = *m_Archetypes[ulArchetype];
+
+			if (Mask != (Archetype.m_Mask & Mask))
+			{
+				continue;
+			}
+
+			for (unsigned long ulChunk = 0; ulChunk < Archetype.m_Chunks.size(); ulChunk++)
+			{
+				const sChunk &Chunk = Archetype.m_Chunks[ulChunk];
+
+				i_Function(Chunk.m_ulCount, static_cast<const EntityId *>(GetEntities(Chunk)),
+					reinterpret_cast<Components *>(GetArray(Archetype, Chunk, GetComponentId<Components>()))...);
+			}
+		}
+
+		m_ulIterationDepth--;
+	}
+
+	template<class... Components>
+	unsigned long EntityStore::Count(void) const
+	{
+		const ComponentMask Mask = GetMask<Components...>();
+		unsigned long ulCount = 0;
+
+		for (unsigned long ulArchetype = 0; ulArchetype < m_Archetypes.size(); ulArchetype++)
+		{
+			if (Mask == (m_Archetypes[ulArchetype]->m_Mask & Mask))
+			{
+				ulCount += m_Archetypes[ulArchetype]->m_ulEntityCount;
+			}
+		}
+
+		return ulCount;
+	}
+}
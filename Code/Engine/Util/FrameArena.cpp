@@ -0,0 +1,262 @@
+#include "PreCompiled.h"
+
+#include "FrameArena.h"
+#include "Debug.h"
+
+//Largest alignment Allocate can honour, offsets are aligned relative to the buffer start
+#define FRAME_BUFFER_ALIGNMENT	64
+
+namespace Engine
+{
+	FrameArena * FrameArena::mInstance = NULL;
+
+	/******************************************************************************
+		Function     : FrameArena
+		Description  : Constructor, reserves both frame buffers from the page
+					allocator
+		Input        : const unsigned long i_ulBytesPerFrame
+		Output       :
+		Return Value :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	FrameArena::FrameArena(const unsigned long i_ulBytesPerFrame):
+		m_ulBufferSize(i_ulBytesPerFrame),
+		m_ulCurrentBuffer(0),
+		m_ulUsed(0),
+		m_ulHighWaterMark(0),
+		m_ulOverflowCount(0),
+		mInitilized(false)
+	{
+		m_pOverflowBlocks[0] = NULL;
+		m_pOverflowBlocks[1] = NULL;
+
+		//Blocks from the page allocator start on a page, which covers FRAME_BUFFER_ALIGNMENT
+		m_pBuffers[0] = static_cast<char *>(PageAllocator::Reserve(m_ulBufferSize, &m_eBufferBacking[0]));
+		m_pBuffers[1] = static_cast<char *>(PageAllocator::Reserve(m_ulBufferSize, &m_eBufferBacking[1]));
+
+		mInitilized = (NULL != m_pBuffers[0]) && (NULL != m_pBuffers[1]);
+	}
+
+	FrameArena::~FrameArena()
+	{
+		FreeOverflowBlocks(0);
+		FreeOverflowBlocks(1);
+
+		PageAllocator::Release(m_pBuffers[0], m_ulBufferSize, m_eBufferBacking[0]);
+		PageAllocator::Release(m_pBuffers[1], m_ulBufferSize, m_eBufferBacking[1]);
+	}
+
+	bool FrameArena::CreateInstance(const unsigned long i_ulBytesPerFrame)
+	{
+		if (mInstance == NULL)
+		{
+			mInstance = new FrameArena(i_ulBytesPerFrame);
+
+			if (mInstance == NULL)
+			{
+				return false;
+			}
+
+			if (mInstance->mInitilized == false)
+			{
+				delete mInstance;
+				mInstance = NULL;
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	FrameArena * FrameArena::GetInstance()
+	{
+		if (mInstance != NULL)
+		{
+			return mInstance;
+		}
+
+		assert(false);
+
+		return NULL;
+	}
+
+	void FrameArena::Destroy()
+	{
+		if (mInstance)
+		{
+			delete mInstance;
+			mInstance = NULL;
+		}
+	}
+
+	/******************************************************************************
+		Function     : Allocate
+		Description  : Bumps the current buffer, when the frame is out of arena
+					the memory comes from the heap and is freed with the buffer
+		Input        : const size_t i_size, const unsigned long i_ulAlignment
+		Output       :
+		Return Value : void *
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void * FrameArena::Allocate(const size_t i_size, const unsigned long i_ulAlignment)
+	{
+		assert((i_ulAlignment != 0) && (0 == (i_ulAlignment & (i_ulAlignment - 1))));
+		assert(i_ulAlignment <= FRAME_BUFFER_ALIGNMENT);
+
+		unsigned long ulAlignment = (i_ulAlignment < DEFAULT_ALIGNMENT) ? DEFAULT_ALIGNMENT : i_ulAlignment;
+		unsigned long ulStart = (m_ulUsed + ulAlignment - 1) & ~(ulAlignment - 1);
+
+		if ((ulStart <= m_ulBufferSize) && (i_size <= m_ulBufferSize - ulStart))
+		{
+			m_ulUsed = ulStart + i_size;
+
+			if (m_ulUsed > m_ulHighWaterMark)
+			{
+				m_ulHighWaterMark = m_ulUsed;
+			}
+
+			return m_pBuffers[m_ulCurrentBuffer] + ulStart;
+		}
+
+		if (0 == m_ulOverflowCount)
+		{
+			CONSOLE_PRINT("Frame arena of %d bytes is full, falling back to heap", m_ulBufferSize);
+		}
+
+		m_ulOverflowCount++;
+
+		//Header is padded to the alignment so the user block stays aligned
+		unsigned long ulHeaderSize = (sizeof(sOverflowBlock) + ulAlignment - 1) & ~(ulAlignment - 1);
+		sOverflowBlock *pBlock = static_cast<sOverflowBlock *>(_aligned_malloc(ulHeaderSize + i_size, ulAlignment));
+
+		if (NULL == pBlock)
+		{
+			return NULL;
+		}
+
+		pBlock->m_pNext = m_pOverflowBlocks[m_ulCurrentBuffer];
+		m_pOverflowBlocks[m_ulCurrentBuffer] = pBlock;
+
+		return reinterpret_cast<char *>(pBlock) + ulHeaderSize;
+	}
+
+	/******************************************************************************
+		Function     : EndFrame
+		Description  : Swaps buffers, the buffer used two frames ago is reset
+					and becomes the current one
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void FrameArena::EndFrame(void)
+	{
+		m_ulCurrentBuffer = 1 - m_ulCurrentBuffer;
+		m_ulUsed = 0;
+
+		FreeOverflowBlocks(m_ulCurrentBuffer);
+	}
+
+	void FrameArena::FreeOverflowBlocks(const unsigned long i_ulBuffer)
+	{
+		while (NULL != m_pOverflowBlocks[i_ulBuffer])
+		{
+			sOverflowBlock *pNext = m_pOverflowBlocks[i_ulBuffer]->m_pNext;
+			_aligned_free(m_pOverflowBlocks[i_ulBuffer]);
+			m_pOverflowBlocks[i_ulBuffer] = pNext;
+		}
+	}
+
+	unsigned long FrameArena::GetUsedBytes(void) const
+	{
+		return m_ulUsed;
+	}
+
+	unsigned long FrameArena::GetHighWaterMark(void) const
+	{
+		return m_ulHighWaterMark;
+	}
+
+	unsigned long FrameArena::GetOverflowCount(void) const
+	{
+		return m_ulOverflowCount;
+	}
+
+	ePageBacking FrameArena::GetPageBacking(void) const
+	{
+		return (m_eBufferBacking[0] == m_eBufferBacking[1]) ? m_eBufferBacking[0] : PAGE_BACKING_MIXED;
+	}
+
+	/******************************************************************************
+		Function     : FrameArena_UnitTest
+		Description  : UnitTest function to test FrameArena and FrameVector
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void FrameArena_UnitTest(void)
+	{
+	#ifdef _DEBUG
+		//Run before the game creates its own frame arena
+		FrameArena::CreateInstance(1024);
+
+		FrameArena *pArena = FrameArena::GetInstance();
+
+		double *pDouble = static_cast<double *>(pArena->Allocate(sizeof(double), __alignof(double)));
+		char *pChar = static_cast<char *>(pArena->Allocate(1, 1));
+		double *pAligned = static_cast<double *>(pArena->Allocate(sizeof(double), 16));
+
+		assert(0 == (reinterpret_cast<uintptr_t>(pDouble) % __alignof(double)));
+		assert(0 == (reinterpret_cast<uintptr_t>(pAligned) % 16));
+		assert(pChar >= reinterpret_cast<char *>(pDouble + 1));
+		*pDouble = 1.0;
+		*pChar = 'a';
+		*pAligned = 2.0;
+
+		{
+			FrameVector<unsigned long> UTVector;
+			UTVector.reserve(16);
+
+			for (unsigned long i = 0; i < 16; i++)
+			{
+				UTVector.push_back(i);
+			}
+
+			for (unsigned long i = 0; i < 16; i++)
+			{
+				assert(UTVector[i] == i);
+			}
+		}
+
+		//Last frame's memory is still valid after one EndFrame
+		pArena->EndFrame();
+		assert(*pDouble == 1.0);
+		assert(*pChar == 'a');
+		assert(0 == pArena->GetUsedBytes());
+
+		//Too big for the arena, taken from the heap until the buffer is reused
+		void *pLarge = pArena->Allocate(4096);
+		assert(pLarge != NULL);
+		assert(pArena->GetOverflowCount() == 1);
+		memset(pLarge, 0, 4096);
+
+		pArena->EndFrame();
+		pArena->EndFrame();
+
+		FrameArena::Destroy();
+	#endif
+	}
+}
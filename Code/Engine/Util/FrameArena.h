@@ -0,0 +1,108 @@
+#ifndef __FRAME_ARENA_HEADER
+#define __FRAME_ARENA_HEADER
+
+#include "PreCompiled.h"
+
+#include <vector>
+
+#include "PageAllocator.h"
+
+namespace Engine
+{
+	//Double buffered linear allocator for data that only lives for a frame.
+	//Memory handed out in one frame stays valid until the end of the next
+	//frame, then the whole buffer is reset at once. Main thread only.
+	class FrameArena
+	{
+		struct sOverflowBlock
+		{
+			sOverflowBlock	*m_pNext;
+		};
+
+		char			*m_pBuffers[2];
+		ePageBacking	m_eBufferBacking[2];
+		sOverflowBlock	*m_pOverflowBlocks[2];		//Heap fallback when a frame runs out of arena
+		unsigned long	m_ulBufferSize;
+		unsigned long	m_ulCurrentBuffer;
+		unsigned long	m_ulUsed;
+		unsigned long	m_ulHighWaterMark;
+		unsigned long	m_ulOverflowCount;
+		bool			mInitilized;
+
+		static FrameArena * mInstance;
+
+		FrameArena(const unsigned long i_ulBytesPerFrame);
+		~FrameArena();
+		FrameArena(const FrameArena & i_Other);
+		FrameArena & operator=(const FrameArena & i_rhs);
+
+		void FreeOverflowBlocks(const unsigned long i_ulBuffer);
+
+	public:
+		static const unsigned long DEFAULT_BYTES_PER_FRAME = 1024 * 1024;
+		static const unsigned long DEFAULT_ALIGNMENT = 8;
+
+		static bool CreateInstance(const unsigned long i_ulBytesPerFrame = DEFAULT_BYTES_PER_FRAME);
+		static FrameArena * GetInstance();
+		static void Destroy();
+
+		void *Allocate(const size_t i_size, const unsigned long i_ulAlignment = DEFAULT_ALIGNMENT);
+		void EndFrame(void);
+
+		unsigned long GetUsedBytes(void) const;
+		unsigned long GetHighWaterMark(void) const;
+		unsigned long GetOverflowCount(void) const;
+		ePageBacking GetPageBacking(void) const;
+	};
+
+	//STL allocator that takes its memory from the frame arena, deallocate does nothing
+	template<class T>
+	class FrameAllocator
+	{
+	public:
+		typedef T				value_type;
+		typedef T*				pointer;
+		typedef const T*		const_pointer;
+		typedef T&				reference;
+		typedef const T&		const_reference;
+		typedef size_t			size_type;
+		typedef ptrdiff_t		difference_type;
+
+		template<class U>
+		struct rebind
+		{
+			typedef FrameAllocator<U> other;
+		};
+
+		FrameAllocator(void);
+		FrameAllocator(const FrameAllocator & i_Other);
+		template<class U>
+		FrameAllocator(const FrameAllocator<U> & i_Other);
+
+		pointer address(reference i_Value) const;
+		const_pointer address(const_reference i_Value) const;
+		pointer allocate(size_type i_Count, const void *i_pHint = NULL);
+		void deallocate(pointer i_pPointer, size_type i_Count);
+		size_type max_size(void) const;
+
+		template<class U, class... Args>
+		void construct(U *i_pPointer, Args&&... i_Args);
+		template<class U>
+		void destroy(U *i_pPointer);
+	};
+
+	template<class T, class U>
+	bool operator==(const FrameAllocator<T> &, const FrameAllocator<U> &);
+	template<class T, class U>
+	bool operator!=(const FrameAllocator<T> &, const FrameAllocator<U> &);
+
+	//Never keep one of these past the end of the next frame
+	template<class T>
+	using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+	void FrameArena_UnitTest(void);
+}
+
+#include "FrameArena.inl"
+
+#endif //__FRAME_ARENA_HEADER
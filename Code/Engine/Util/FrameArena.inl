@@ -0,0 +1,83 @@
+#include "PreCompiled.h"
+
+#include <limits>
+#include <new>
+#include <utility>
+
+namespace Engine
+{
+	template<class T>
+	inline FrameAllocator<T>::FrameAllocator(void)
+	{
+
+	}
+
+	template<class T>
+	inline FrameAllocator<T>::FrameAllocator(const FrameAllocator & i_Other)
+	{
+
+	}
+
+	template<class T>
+	template<class U>
+	inline FrameAllocator<T>::FrameAllocator(const FrameAllocator<U> & i_Other)
+	{
+
+	}
+
+	template<class T>
+	inline T * FrameAllocator<T>::address(T & i_Value) const
+	{
+		return &i_Value;
+	}
+
+	template<class T>
+	inline const T * FrameAllocator<T>::address(const T & i_Value) const
+	{
+		return &i_Value;
+	}
+
+	template<class T>
+	inline T * FrameAllocator<T>::allocate(size_t i_Count, const void *i_pHint)
+	{
+		return static_cast<T *>(FrameArena::GetInstance()->Allocate(i_Count * sizeof(T), __alignof(T)));
+	}
+
+	template<class T>
+	inline void FrameAllocator<T>::deallocate(T *i_pPointer, size_t i_Count)
+	{
+		//Released in bulk by FrameArena::EndFrame
+	}
+
+	template<class T>
+	inline size_t FrameAllocator<T>::max_size(void) const
+	{
+		return (std::numeric_limits<size_t>::max)() / sizeof(T);
+	}
+
+	template<class T>
+	template<class U, class... Args>
+	inline void FrameAllocator<T>::construct(U *i_pPointer, Args&&... i_Args)
+	{
+		::new(static_cast<void *>(i_pPointer)) U(std::forward<Args>(i_Args)...);
+	}
+
+	template<class T>
+	template<class U>
+	inline void FrameAllocator<T>::destroy(U *i_pPointer)
+	{
+		i_pPointer->~U();
+	}
+
+	template<class T, class U>
+	inline bool operator==(const FrameAllocator<T> &, const FrameAllocator<U> &)
+	{
+		return true;
+	}
+
+	template<class T, class U>
+	inline bool operator!=(const FrameAllocator<T> &, const FrameAllocator<U> &)
+	{
+		return false;
+	}
+}
@@ -0,0 +1,898 @@
+#include "PreCompiled.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "FrameGraph.h"
+#include "JobSystem.h"
+#include "Debug.h"
+
+//Characters of the timeline in PrintCriticalPath
+#define FRAME_GRAPH_TIMELINE_WIDTH	40
+
+namespace Engine
+{
+	FrameGraph * FrameGraph::mInstance = NULL;
+
+	FrameGraph::FrameGraph(const bool i_bPipelined):
+		m_dLastFrameMS(0.0),
+		m_dStepMS(0.0),
+		m_dAccumulatedMS(0.0),
+		m_uiMaxStepsPerFrame(1),
+		m_ulDroppedSteps(0),
+		m_ulNextFrame(0),
+		m_ulFinishedFrames(0),
+		m_bPipelined(i_bPipelined),
+		m_bCompiled(false),
+		mInitilized(true)
+	{
+		for (unsigned long ulSlot = 0; ulSlot < 2; ulSlot++)
+		{
+			m_Frames[ulSlot].m_ulFrame = 0;
+			m_Frames[ulSlot].m_Time.m_fDeltaTime = 0.0f;
+			m_Frames[ulSlot].m_Time.m_fInterpolation = 1.0f;
+			m_Frames[ulSlot].m_bStep = false;
+			m_Frames[ulSlot].m_bPresent = false;
+			m_Frames[ulSlot].m_bActive = false;
+			m_Frames[ulSlot].m_ulTasksLeft = 0;
+		}
+
+		for (unsigned long ulTask = 0; ulTask < MAX_FRAME_TASKS; ulTask++)
+		{
+			m_LastTimings[ulTask].m_dStartMS = 0.0;
+			m_LastTimings[ulTask].m_dDurationMS = 0.0;
+			m_LastTimings[ulTask].m_lWorker = -1;
+		}
+
+		m_MainThreadReady.reserve(2 * MAX_FRAME_TASKS);
+	}
+
+	FrameGraph::~FrameGraph()
+	{
+		Flush();
+	}
+
+	bool FrameGraph::CreateInstance(const bool i_bPipelined)
+	{
+		if (mInstance == NULL)
+		{
+			mInstance = new FrameGraph(i_bPipelined);
+
+			if (mInstance == NULL)
+			{
+				return false;
+			}
+
+			if (mInstance->mInitilized == false)
+			{
+				delete mInstance;
+				mInstance = NULL;
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	FrameGraph * FrameGraph::GetInstance()
+	{
+		if (mInstance != NULL)
+		{
+			return mInstance;
+		}
+
+		assert(false);
+
+		return NULL;
+	}
+
+	void FrameGraph::Destroy()
+	{
+		if (mInstance)
+		{
+			delete mInstance;
+			mInstance = NULL;
+		}
+	}
+
+	//Bit of the named resource, for the read and write sets of AddTask
+	unsigned int FrameGraph::GetResource(const char *i_pName)
+	{
+		return m_Resources.GetBitMask(i_pName);
+	}
+
+	/******************************************************************************
+		Function     : AddTask
+		Description  : Adds a task that runs once every frame. It runs after
+					every task added before it that writes what it reads or
+					writes, or reads what it writes
+		Input        : const char *i_pName, FrameTaskFunction i_pFunction,
+					const unsigned int i_uiReads, const unsigned int i_uiWrites,
+					const eTaskThread i_eThread, const eTaskRate i_eRate
+		Output       :
+		Return Value : unsigned long, index of the task
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	unsigned long FrameGraph::AddTask(const char *i_pName, FrameTaskFunction i_pFunction, const unsigned int i_uiReads, const unsigned int i_uiWrites,
+									  const eTaskThread i_eThread, const eTaskRate i_eRate)
+	{
+		assert(i_pName && i_pFunction);
+		assert(false == m_bCompiled);
+		assert(m_Tasks.size() < MAX_FRAME_TASKS);
+
+		sTask Task;
+		Task.m_pName = i_pName;
+		Task.m_pFunction = i_pFunction;
+		Task.m_uiReads = i_uiReads;
+		Task.m_uiWrites = i_uiWrites;
+		Task.m_eThread = i_eThread;
+		Task.m_eRate = i_eRate;
+		Task.m_ulDependencyCount = 0;
+
+		m_Tasks.push_back(Task);
+
+		return static_cast<unsigned long>(m_Tasks.size() - 1);
+	}
+
+	/******************************************************************************
+		Function     : SetFixedStep
+		Description  : Makes RunFrame step the simulation by a fixed time, as
+					many steps as the frame time holds. A frame that would
+					need more than i_uiMaxStepsPerFrame steps gives up the
+					rest, so a slow frame cannot make the next one slower
+		Input        : const float i_fStepsPerSecond, 0 steps once per frame
+					by the frame time
+					const unsigned int i_uiMaxStepsPerFrame
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void FrameGraph::SetFixedStep(const float i_fStepsPerSecond, const unsigned int i_uiMaxStepsPerFrame)
+	{
+		assert(i_fStepsPerSecond >= 0.0f);
+		assert(i_uiMaxStepsPerFrame > 0);
+
+		m_dStepMS = (i_fStepsPerSecond > 0.0f) ? (1000.0 / i_fStepsPerSecond) : 0.0;
+		m_uiMaxStepsPerFrame = i_uiMaxStepsPerFrame;
+		m_dAccumulatedMS = 0.0;
+	}
+
+	bool FrameGraph::Conflicts(const sTask &i_First, const sTask &i_Second)
+	{
+		return (0 != (i_First.m_uiWrites & (i_Second.m_uiReads | i_Second.m_uiWrites))) || (0 != (i_First.m_uiReads & i_Second.m_uiWrites));
+	}
+
+	/******************************************************************************
+		Function     : Compile
+		Description  : Turns the read and write sets into dependencies, within
+					a frame and, when pipelined, on the frame before. A task
+					always waits for itself of the frame before
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void FrameGraph::Compile(void)
+	{
+		for (unsigned long ulTask = 0; ulTask < m_Tasks.size(); ulTask++)
+		{
+			sTask &Task = m_Tasks[ulTask];
+
+			for (unsigned long ulEarlier = 0; ulEarlier < ulTask; ulEarlier++)
+			{
+				if (Conflicts(m_Tasks[ulEarlier], Task))
+				{
+					m_Tasks[ulEarlier].m_Dependents.push_back(ulTask);
+					Task.m_Dependencies.push_back(ulEarlier);
+				}
+			}
+
+			Task.m_ulDependencyCount = static_cast<unsigned long>(Task.m_Dependencies.size());
+
+			if (m_bPipelined)
+			{
+				for (unsigned long ulPrevious = 0; ulPrevious < m_Tasks.size(); ulPrevious++)
+				{
+					if ((ulPrevious == ulTask) || Conflicts(m_Tasks[ulPrevious], Task))
+					{
+						m_Tasks[ulPrevious].m_NextFrameDependents.push_back(ulTask);
+						Task.m_PreviousFrameDependencies.push_back(ulPrevious);
+					}
+				}
+			}
+		}
+
+		m_bCompiled = true;
+	}
+
+	//Called with m_Mutex held, main thread tasks wait in the ready list and
+	//the rest go to the job system in Dispatch
+	void FrameGraph::MakeReady(const unsigned long i_ulSlot, const unsigned long i_ulTask, sReadyTask *o_pReady, unsigned long &io_ulReadyCount)
+	{
+		sReadyTask Ready;
+		Ready.m_ulSlot = i_ulSlot;
+		Ready.m_ulTask = i_ulTask;
+
+		if (TASK_MAIN_THREAD == m_Tasks[i_ulTask].m_eThread)
+		{
+			m_MainThreadReady.push_back(Ready);
+		}
+		else
+		{
+			o_pReady[io_ulReadyCount++] = Ready;
+		}
+	}
+
+	void FrameGraph::Dispatch(const sReadyTask *i_pReady, const unsigned long i_ulReadyCount)
+	{
+		for (unsigned long ulReady = 0; ulReady < i_ulReadyCount; ulReady++)
+		{
+			JobSystem::GetInstance()->Run(&FrameGraph::RunTaskJob, this, i_pReady[ulReady].m_ulSlot, i_pReady[ulReady].m_ulTask, NULL);
+		}
+	}
+
+	void FrameGraph::RunTaskJob(void *i_pData, const unsigned long i_ulSlot, const unsigned long i_ulTask)
+	{
+		static_cast<FrameGraph *>(i_pData)->RunTask(i_ulSlot, i_ulTask);
+	}
+
+	/******************************************************************************
+		Function     : StartFrame
+		Description  : Sets up the next frame and queues its tasks that wait on
+					nothing. With the last frame still in flight, tasks also
+					count its unfinished tasks they conflict with
+		Input        : const sFrameTime &i_Time, const bool i_bStep,
+					const bool i_bPresent
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void FrameGraph::StartFrame(const sFrameTime &i_Time, const bool i_bStep, const bool i_bPresent)
+	{
+		const unsigned long ulSlot = m_ulNextFrame % 2;
+		sFrame &Frame = m_Frames[ulSlot];
+		const sFrame &Previous = m_Frames[1 - ulSlot];
+		sReadyTask Ready[MAX_FRAME_TASKS];
+		unsigned long ulReadyCount = 0;
+
+		assert(false == Frame.m_bActive);
+
+		{
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+
+			Frame.m_ulFrame = m_ulNextFrame++;
+			Frame.m_Time = i_Time;
+			Frame.m_bStep = i_bStep;
+			Frame.m_bPresent = i_bPresent;
+			Frame.m_ulTasksLeft = static_cast<unsigned long>(m_Tasks.size());
+			Frame.m_bActive = true;
+			Frame.m_Start.CalcCurrentTick();
+
+			for (unsigned long ulTask = 0; ulTask < m_Tasks.size(); ulTask++)
+			{
+				const sTask &Task = m_Tasks[ulTask];
+
+				Frame.m_bDone[ulTask] = false;
+				Frame.m_lWaiting[ulTask] = Task.m_ulDependencyCount;
+
+				if (Previous.m_bActive)
+				{
+					for (unsigned long ulDependency = 0; ulDependency < Task.m_PreviousFrameDependencies.size(); ulDependency++)
+					{
+						if (false == Previous.m_bDone[Task.m_PreviousFrameDependencies[ulDependency]])
+						{
+							Frame.m_lWaiting[ulTask]++;
+						}
+					}
+				}
+			}
+
+			for (unsigned long ulTask = 0; ulTask < m_Tasks.size(); ulTask++)
+			{
+				if (0 == Frame.m_lWaiting[ulTask])
+				{
+					MakeReady(ulSlot, ulTask, Ready, ulReadyCount);
+				}
+			}
+		}
+
+		Dispatch(Ready, ulReadyCount);
+	}
+
+	/******************************************************************************
+		Function     : RunTask
+		Description  : Runs one task of a frame, then queues the tasks of this
+					frame and of the next that were only waiting for it. A
+					task the frame does not run still passes on its turn
+		Input        : const unsigned long i_ulSlot, const unsigned long i_ulTask
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void FrameGraph::RunTask(const unsigned long i_ulSlot, const unsigned long i_ulTask)
+	{
+		sFrame &Frame = m_Frames[i_ulSlot];
+		sFrame &Next = m_Frames[1 - i_ulSlot];
+		const sTask &Task = m_Tasks[i_ulTask];
+		sTaskTiming &Timing = Frame.m_Timings[i_ulTask];
+
+		const bool bRun = (TASK_EVERY_STEP == Task.m_eRate) ? Frame.m_bStep : Frame.m_bPresent;
+
+		Timing.m_dStartMS = Frame.m_Start.GetTickDifferenceinMS();
+		Timing.m_lWorker = -1;
+
+		if (bRun)
+		{
+			Tick TaskStart;
+			TaskStart.CalcCurrentTick();
+
+			Task.m_pFunction(Frame.m_Time);
+
+			Timing.m_dDurationMS = TaskStart.GetTickDifferenceinMS();
+			Timing.m_lWorker = JobSystem::GetWorkerIndex();
+		}
+
+		sReadyTask Ready[2 * MAX_FRAME_TASKS];
+		unsigned long ulReadyCount = 0;
+
+		{
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+
+			Frame.m_bDone[i_ulTask] = true;
+
+			for (unsigned long ulDependent = 0; ulDependent < Task.m_Dependents.size(); ulDependent++)
+			{
+				const unsigned long ulTask = Task.m_Dependents[ulDependent];
+
+				if (0 == --Frame.m_lWaiting[ulTask])
+				{
+					MakeReady(i_ulSlot, ulTask, Ready, ulReadyCount);
+				}
+			}
+
+			if (Next.m_bActive && (Next.m_ulFrame == (Frame.m_ulFrame + 1)))
+			{
+				for (unsigned long ulDependent = 0; ulDependent < Task.m_NextFrameDependents.size(); ulDependent++)
+				{
+					const unsigned long ulTask = Task.m_NextFrameDependents[ulDependent];
+
+					if (0 == --Next.m_lWaiting[ulTask])
+					{
+						MakeReady(1 - i_ulSlot, ulTask, Ready, ulReadyCount);
+					}
+				}
+			}
+
+			Frame.m_ulTasksLeft--;
+		}
+
+		Dispatch(Ready, ulReadyCount);
+	}
+
+	/******************************************************************************
+		Function     : FinishFrame
+		Description  : Returns once every task of the frame has run. The main
+					thread runs the main thread tasks as they get ready, the
+					oldest frame's first, and helps with jobs in between
+		Input        : const unsigned long i_ulSlot
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void FrameGraph::FinishFrame(const unsigned long i_ulSlot)
+	{
+		sFrame &Frame = m_Frames[i_ulSlot];
+
+		while (true)
+		{
+			sReadyTask Task;
+			bool bHaveTask = false;
+
+			{
+				std::lock_guard<std::mutex> Lock(m_Mutex);
+
+				if (0 == Frame.m_ulTasksLeft)
+				{
+					//Tasks the frame did not run keep the timing of their last run
+					for (unsigned long ulTask = 0; ulTask < m_Tasks.size(); ulTask++)
+					{
+						if (-1 != Frame.m_Timings[ulTask].m_lWorker)
+						{
+							m_LastTimings[ulTask] = Frame.m_Timings[ulTask];
+						}
+					}
+
+					m_dLastFrameMS = Frame.m_Start.GetTickDifferenceinMS();
+					m_ulFinishedFrames++;
+					Frame.m_bActive = false;
+					return;
+				}
+
+				if (false == m_MainThreadReady.empty())
+				{
+					unsigned long ulOldest = 0;
+
+					for (unsigned long ulReady = 1; ulReady < m_MainThreadReady.size(); ulReady++)
+					{
+						if (m_Frames[m_MainThreadReady[ulReady].m_ulSlot].m_ulFrame < m_Frames[m_MainThreadReady[ulOldest].m_ulSlot].m_ulFrame)
+						{
+							ulOldest = ulReady;
+						}
+					}
+
+					Task = m_MainThreadReady[ulOldest];
+					m_MainThreadReady.erase(m_MainThreadReady.begin() + ulOldest);
+					bHaveTask = true;
+				}
+			}
+
+			if (bHaveTask)
+			{
+				RunTask(Task.m_ulSlot, Task.m_ulTask);
+			}
+			else if (false == JobSystem::GetInstance()->TryRunJob())
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	//Starts a frame, then finishes the frame before when pipelined, otherwise
+	//the new one. Pipelined, the new frame is still running when it returns
+	void FrameGraph::RunGraphFrame(const sFrameTime &i_Time, const bool i_bStep, const bool i_bPresent)
+	{
+		StartFrame(i_Time, i_bStep, i_bPresent);
+
+		const unsigned long ulFinish = m_bPipelined ? (m_ulNextFrame - 1) : m_ulNextFrame;
+
+		if (ulFinish > 0)
+		{
+			const unsigned long ulSlot = (ulFinish - 1) % 2;
+
+			if (m_Frames[ulSlot].m_bActive)
+			{
+				FinishFrame(ulSlot);
+			}
+		}
+	}
+
+	/******************************************************************************
+		Function     : RunFrame
+		Description  : Runs the tasks for a frame that took i_FrameMS. With a
+					fixed step, the step tasks run once per whole step in the
+					time not yet stepped, up to the most steps per frame, and
+					the frame tasks once after the last step with how far the
+					left over time is into the next step
+		Input        : const float i_FrameMS
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void FrameGraph::RunFrame(const float i_FrameMS)
+	{
+		assert(0 == JobSystem::GetWorkerIndex());
+
+		if (false == m_bCompiled)
+		{
+			Compile();
+		}
+
+		sFrameTime Time;
+
+		if (m_dStepMS <= 0.0)
+		{
+			Time.m_fDeltaTime = i_FrameMS;
+			Time.m_fInterpolation = 1.0f;
+
+			RunGraphFrame(Time, true, true);
+			return;
+		}
+
+		m_dAccumulatedMS += i_FrameMS;
+
+		unsigned int uiSteps = static_cast<unsigned int>(m_dAccumulatedMS / m_dStepMS);
+
+		if (uiSteps > m_uiMaxStepsPerFrame)
+		{
+			//Too far behind to catch up, the game slows down instead
+			m_ulDroppedSteps += uiSteps - m_uiMaxStepsPerFrame;
+			m_dAccumulatedMS -= (uiSteps - m_uiMaxStepsPerFrame) * m_dStepMS;
+			uiSteps = m_uiMaxStepsPerFrame;
+		}
+
+		m_dAccumulatedMS -= uiSteps * m_dStepMS;
+
+		Time.m_fDeltaTime = static_cast<float>(m_dStepMS);
+		Time.m_fInterpolation = static_cast<float>(m_dAccumulatedMS / m_dStepMS);
+
+		for (unsigned int uiStep = 0; uiStep < uiSteps; uiStep++)
+		{
+			RunGraphFrame(Time, true, (uiStep + 1) == uiSteps);
+		}
+
+		//Not a whole step yet, still draw with the later interpolation
+		if (0 == uiSteps)
+		{
+			Time.m_fDeltaTime = 0.0f;
+
+			RunGraphFrame(Time, false, true);
+		}
+	}
+
+	//Finishes every frame in flight, oldest first
+	void FrameGraph::Flush(void)
+	{
+		for (unsigned long ulFrame = ((m_ulNextFrame > 2) ? (m_ulNextFrame - 2) : 0); ulFrame < m_ulNextFrame; ulFrame++)
+		{
+			const unsigned long ulSlot = ulFrame % 2;
+
+			if (m_Frames[ulSlot].m_bActive && (m_Frames[ulSlot].m_ulFrame == ulFrame))
+			{
+				FinishFrame(ulSlot);
+			}
+		}
+	}
+
+	/******************************************************************************
+		Function     : GetCriticalPath
+		Description  : Longest chain of dependent tasks in the last finished
+					frame, by how long each task took. No frame can take less
+					than this however many workers there are
+		Input        : void
+		Output       : unsigned long *o_pPath, MAX_FRAME_TASKS entries, the task
+					indices first to last
+					unsigned long &o_ulPathLength
+		Return Value : double, MS the chain took
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	double FrameGraph::GetCriticalPath(unsigned long *o_pPath, unsigned long &o_ulPathLength) const
+	{
+		assert(o_pPath);
+
+		double Finish[MAX_FRAME_TASKS];
+		long Before[MAX_FRAME_TASKS];
+		long lLast = -1;
+
+		o_ulPathLength = 0;
+
+		//Dependencies are always on earlier tasks, so one pass in order does it
+		for (unsigned long ulTask = 0; ulTask < m_Tasks.size(); ulTask++)
+		{
+			const sTask &Task = m_Tasks[ulTask];
+
+			Finish[ulTask] = 0.0;
+			Before[ulTask] = -1;
+
+			for (unsigned long ulDependency = 0; ulDependency < Task.m_Dependencies.size(); ulDependency++)
+			{
+				const unsigned long ulEarlier = Task.m_Dependencies[ulDependency];
+
+				if ((-1 == Before[ulTask]) || (Finish[ulEarlier] > Finish[ulTask]))
+				{
+					Finish[ulTask] = Finish[ulEarlier];
+					Before[ulTask] = ulEarlier;
+				}
+			}
+
+			Finish[ulTask] += m_LastTimings[ulTask].m_dDurationMS;
+
+			if ((-1 == lLast) || (Finish[ulTask] > Finish[lLast]))
+			{
+				lLast = ulTask;
+			}
+		}
+
+		if (-1 == lLast)
+		{
+			return 0.0;
+		}
+
+		for (long lTask = lLast; -1 != lTask; lTask = Before[lTask])
+		{
+			o_pPath[o_ulPathLength++] = lTask;
+		}
+
+		for (unsigned long ulFront = 0, ulBack = o_ulPathLength - 1; ulFront < ulBack; ulFront++, ulBack--)
+		{
+			const unsigned long ulTask = o_pPath[ulFront];
+			o_pPath[ulFront] = o_pPath[ulBack];
+			o_pPath[ulBack] = ulTask;
+		}
+
+		return Finish[lLast];
+	}
+
+	/******************************************************************************
+		Function     : PrintCriticalPath
+		Description  : Prints the last finished frame as a timeline, one line
+					per task with the worker it ran on, critical path tasks
+					marked with a *
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void FrameGraph::PrintCriticalPath(void) const
+	{
+		unsigned long Path[MAX_FRAME_TASKS];
+		unsigned long ulPathLength = 0;
+		bool bOnPath[MAX_FRAME_TASKS] = { false };
+
+		const double CriticalMS = GetCriticalPath(Path, ulPathLength);
+
+		for (unsigned long ulStep = 0; ulStep < ulPathLength; ulStep++)
+		{
+			bOnPath[Path[ulStep]] = true;
+		}
+
+		DebugPrint("Frame graph: %u tasks, %s, frame %lu took %f MS, critical path %f MS, %lu steps dropped", static_cast<unsigned int>(m_Tasks.size()),
+				   m_bPipelined ? "pipelined" : "not pipelined", m_ulFinishedFrames, m_dLastFrameMS, CriticalMS, m_ulDroppedSteps);
+
+		const double ScaleMS = (m_dLastFrameMS > 0.0) ? m_dLastFrameMS : 1.0;
+
+		for (unsigned long ulTask = 0; ulTask < m_Tasks.size(); ulTask++)
+		{
+			const sTaskTiming &Timing = m_LastTimings[ulTask];
+			std::string Timeline(FRAME_GRAPH_TIMELINE_WIDTH, '.');
+
+			unsigned long ulFirst = static_cast<unsigned long>((Timing.m_dStartMS / ScaleMS) * FRAME_GRAPH_TIMELINE_WIDTH);
+			unsigned long ulLast = static_cast<unsigned long>(((Timing.m_dStartMS + Timing.m_dDurationMS) / ScaleMS) * FRAME_GRAPH_TIMELINE_WIDTH);
+
+			for (unsigned long ulColumn = ulFirst; (ulColumn <= ulLast) && (ulColumn < FRAME_GRAPH_TIMELINE_WIDTH); ulColumn++)
+			{
+				Timeline[ulColumn] = '#';
+			}
+
+			DebugPrint("%c %-20s	|	Worker: %ld	|	Start MS: %f	|	MS: %f	|	%s", bOnPath[ulTask] ? '*' : ' ', m_Tasks[ulTask].m_pName,
+					   Timing.m_lWorker, Timing.m_dStartMS, Timing.m_dDurationMS, Timeline.c_str());
+		}
+
+		std::string PathNames;
+
+		for (unsigned long ulStep = 0; ulStep < ulPathLength; ulStep++)
+		{
+			if (0 != ulStep)
+			{
+				PathNames += " -> ";
+			}
+
+			PathNames += m_Tasks[Path[ulStep]].m_pName;
+		}
+
+		DebugPrint("Critical path: %s", PathNames.c_str());
+	}
+
+	namespace
+	{
+		enum eUTTask
+		{
+			UT_WRITE_X,			//Writes X
+			UT_X_TO_Y,			//Reads X, writes Y
+			UT_WRITE_Z,			//Writes Z, free of the others
+			UT_MAIN_READ_YZ,	//Reads Y and Z on the main thread
+			UT_TASK_COUNT
+		};
+
+		const unsigned long UTFrames = 50;
+
+		std::atomic<long> s_lUTClock;
+		long s_UTStart[UTFrames][UT_TASK_COUNT];
+		long s_UTEnd[UTFrames][UT_TASK_COUNT];
+		std::atomic<long> s_lUTWrongThread;
+
+		//The delta time carries the frame number
+		void UTRecord(const sFrameTime &i_Time, const unsigned long i_ulTask)
+		{
+			const unsigned long ulFrame = static_cast<unsigned long>(i_Time.m_fDeltaTime);
+
+			s_UTStart[ulFrame][i_ulTask] = s_lUTClock.fetch_add(1);
+			std::this_thread::yield();
+			s_UTEnd[ulFrame][i_ulTask] = s_lUTClock.fetch_add(1);
+		}
+
+		void UTWriteX(const sFrameTime &i_Time)
+		{
+			UTRecord(i_Time, UT_WRITE_X);
+		}
+
+		void UTXToY(const sFrameTime &i_Time)
+		{
+			UTRecord(i_Time, UT_X_TO_Y);
+		}
+
+		void UTWriteZ(const sFrameTime &i_Time)
+		{
+			UTRecord(i_Time, UT_WRITE_Z);
+		}
+
+		void UTMainReadYZ(const sFrameTime &i_Time)
+		{
+			if (0 != JobSystem::GetWorkerIndex())
+			{
+				s_lUTWrongThread.fetch_add(1);
+			}
+
+			UTRecord(i_Time, UT_MAIN_READ_YZ);
+		}
+
+		unsigned long s_ulUTSteps;
+		unsigned long s_ulUTPresents;
+		float s_fUTStepMS;
+		float s_fUTInterpolation;
+
+		void UTStep(const sFrameTime &i_Time)
+		{
+			s_ulUTSteps++;
+			s_fUTStepMS = i_Time.m_fDeltaTime;
+		}
+
+		void UTPresent(const sFrameTime &i_Time)
+		{
+			s_ulUTPresents++;
+			s_fUTInterpolation = i_Time.m_fInterpolation;
+		}
+
+		bool UTNear(const float i_fValue, const float i_fExpected)
+		{
+			return ((i_fValue - i_fExpected) < 0.001f) && ((i_fExpected - i_fValue) < 0.001f);
+		}
+
+		//i_ulFirst of a frame ended before i_ulSecond of the same or a later frame started
+		bool UTRanBefore(const unsigned long i_ulFirstFrame, const unsigned long i_ulFirst, const unsigned long i_ulSecondFrame, const unsigned long i_ulSecond)
+		{
+			return s_UTEnd[i_ulFirstFrame][i_ulFirst] < s_UTStart[i_ulSecondFrame][i_ulSecond];
+		}
+	}
+
+	/******************************************************************************
+		Function     : FrameGraph_UnitTest
+		Description  : UnitTest function to test task order within a frame and
+					across pipelined frames, main thread tasks, the critical
+					path and fixed steps
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void FrameGraph_UnitTest(void)
+	{
+	#ifdef _DEBUG
+		//Run before the game creates its own job system and frame graph
+		JobSystem::CreateInstance(4);
+
+		for (unsigned int uPipelined = 0; uPipelined < 2; uPipelined++)
+		{
+			s_lUTClock = 0;
+			s_lUTWrongThread = 0;
+
+			FrameGraph::CreateInstance(1 == uPipelined);
+			FrameGraph *pGraph = FrameGraph::GetInstance();
+
+			const unsigned int X = pGraph->GetResource("X");
+			const unsigned int Y = pGraph->GetResource("Y");
+			const unsigned int Z = pGraph->GetResource("Z");
+			assert((X != Y) && (Y != Z) && (X != Z));
+			assert(X == pGraph->GetResource("X"));
+
+			assert(UT_WRITE_X == pGraph->AddTask("WriteX", &UTWriteX, 0, X));
+			assert(UT_X_TO_Y == pGraph->AddTask("XToY", &UTXToY, X, Y));
+			assert(UT_WRITE_Z == pGraph->AddTask("WriteZ", &UTWriteZ, 0, Z));
+			assert(UT_MAIN_READ_YZ == pGraph->AddTask("MainReadYZ", &UTMainReadYZ, Y | Z, 0, FrameGraph::TASK_MAIN_THREAD));
+
+			for (unsigned long ulFrame = 0; ulFrame < UTFrames; ulFrame++)
+			{
+				pGraph->RunFrame(static_cast<float>(ulFrame));
+			}
+
+			pGraph->Flush();
+
+			assert(0 == s_lUTWrongThread.load());
+
+			for (unsigned long ulFrame = 0; ulFrame < UTFrames; ulFrame++)
+			{
+				assert(UTRanBefore(ulFrame, UT_WRITE_X, ulFrame, UT_X_TO_Y));
+				assert(UTRanBefore(ulFrame, UT_X_TO_Y, ulFrame, UT_MAIN_READ_YZ));
+				assert(UTRanBefore(ulFrame, UT_WRITE_Z, ulFrame, UT_MAIN_READ_YZ));
+
+				if ((ulFrame + 1) < UTFrames)
+				{
+					//Across frames a writer waits for the readers of the frame before
+					assert(UTRanBefore(ulFrame, UT_X_TO_Y, ulFrame + 1, UT_WRITE_X));
+					assert(UTRanBefore(ulFrame, UT_MAIN_READ_YZ, ulFrame + 1, UT_X_TO_Y));
+					assert(UTRanBefore(ulFrame, UT_MAIN_READ_YZ, ulFrame + 1, UT_WRITE_Z));
+
+					for (unsigned long ulTask = 0; ulTask < UT_TASK_COUNT; ulTask++)
+					{
+						assert(UTRanBefore(ulFrame, ulTask, ulFrame + 1, ulTask));
+					}
+				}
+			}
+
+			//Every step of the path depends on the one before it
+			unsigned long Path[MAX_FRAME_TASKS];
+			unsigned long ulPathLength = 0;
+
+			assert(pGraph->GetCriticalPath(Path, ulPathLength) >= 0.0);
+			assert((ulPathLength >= 1) && (ulPathLength <= 3));
+
+			for (unsigned long ulStep = 1; ulStep < ulPathLength; ulStep++)
+			{
+				assert(Path[ulStep - 1] < Path[ulStep]);
+				assert((UT_MAIN_READ_YZ == Path[ulStep]) || ((UT_WRITE_X == Path[ulStep - 1]) && (UT_X_TO_Y == Path[ulStep])));
+			}
+
+			pGraph->PrintCriticalPath();
+
+			FrameGraph::Destroy();
+		}
+
+		//Fixed steps of 10 MS, at most 4 a frame
+		{
+			s_ulUTSteps = 0;
+			s_ulUTPresents = 0;
+
+			FrameGraph::CreateInstance(true);
+			FrameGraph *pGraph = FrameGraph::GetInstance();
+			const unsigned int State = pGraph->GetResource("State");
+
+			pGraph->AddTask("Step", &UTStep, 0, State);
+			pGraph->AddTask("Present", &UTPresent, State, 0, FrameGraph::TASK_MAIN_THREAD, FrameGraph::TASK_EVERY_FRAME);
+			pGraph->SetFixedStep(100.0f, 4);
+
+			//Two steps and a half
+			pGraph->RunFrame(25.0f);
+			pGraph->Flush();
+			assert((2 == s_ulUTSteps) && (1 == s_ulUTPresents));
+			assert(UTNear(s_fUTStepMS, 10.0f) && UTNear(s_fUTInterpolation, 0.5f));
+
+			//No whole step yet, it still presents
+			pGraph->RunFrame(3.0f);
+			pGraph->Flush();
+			assert((2 == s_ulUTSteps) && (2 == s_ulUTPresents));
+			assert(UTNear(s_fUTInterpolation, 0.8f));
+
+			//Ten steps behind, four run and the rest is dropped
+			pGraph->RunFrame(100.0f);
+			pGraph->Flush();
+			assert((6 == s_ulUTSteps) && (3 == s_ulUTPresents));
+			assert(6 == pGraph->GetDroppedSteps());
+			assert(UTNear(s_fUTInterpolation, 0.8f));
+
+			FrameGraph::Destroy();
+		}
+
+		JobSystem::Destroy();
+	#endif
+	}
+}
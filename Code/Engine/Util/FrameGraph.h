@@ -0,0 +1,153 @@
+#ifndef __FRAME_GRAPH_HEADER
+#define __FRAME_GRAPH_HEADER
+
+#include "PreCompiled.h"
+
+#include <mutex>
+#include <vector>
+
+#include "HighResTime.h"
+#include "NamedBitSet.h"
+
+#define MAX_FRAME_TASKS	32
+
+namespace Engine
+{
+	struct sFrameTime
+	{
+		float	m_fDeltaTime;		//MS the simulation step moves the game on, 0 if no step ran
+		float	m_fInterpolation;	//0 to 1, where rendering is between the state before the step and after it
+	};
+
+	typedef void (*FrameTaskFunction)(const sFrameTime &i_Time);
+
+	//The work of one frame as tasks that name the resources they read and
+	//write. A task waits for every earlier task it conflicts with, anything
+	//else runs alongside it on the job system workers. Pipelined, a frame
+	//is started before the last one is finished, so a task of the new frame
+	//only waits for the tasks of the old frame it conflicts with.
+	//Tasks are added in the order the frame ran them before, then RunFrame
+	//is called once per frame from the thread that created the job system.
+	//With a fixed step, RunFrame runs the step tasks as many times as the
+	//elapsed time holds whole steps, then the frame tasks once.
+	class FrameGraph
+	{
+	public:
+		enum eTaskThread
+		{
+			TASK_ANY_THREAD,
+			TASK_MAIN_THREAD		//Rendering, window messages, the frame arena
+		};
+
+		enum eTaskRate
+		{
+			TASK_EVERY_STEP,		//Simulation, once per fixed step
+			TASK_EVERY_FRAME		//Presentation, once per RunFrame after the last step
+		};
+
+	private:
+		struct sTask
+		{
+			const char					*m_pName;
+			FrameTaskFunction			m_pFunction;
+			unsigned int				m_uiReads;
+			unsigned int				m_uiWrites;
+			eTaskThread					m_eThread;
+			eTaskRate					m_eRate;
+			unsigned long				m_ulDependencyCount;			//Earlier tasks of the same frame
+			std::vector<unsigned long>	m_Dependencies;
+			std::vector<unsigned long>	m_PreviousFrameDependencies;	//Tasks of the frame before
+			std::vector<unsigned long>	m_Dependents;
+			std::vector<unsigned long>	m_NextFrameDependents;
+		};
+
+		struct sTaskTiming
+		{
+			double	m_dStartMS;				//From the start of the frame
+			double	m_dDurationMS;
+			long	m_lWorker;
+		};
+
+		//A frame in flight, there are at most two. With a fixed step each
+		//step is a frame of its own and only the last one presents
+		struct sFrame
+		{
+			unsigned long	m_ulFrame;
+			sFrameTime		m_Time;
+			bool			m_bStep;						//Runs the TASK_EVERY_STEP tasks
+			bool			m_bPresent;						//Runs the TASK_EVERY_FRAME tasks
+			bool			m_bActive;
+			unsigned long	m_ulTasksLeft;
+			long			m_lWaiting[MAX_FRAME_TASKS];	//Unfinished dependencies of each task
+			bool			m_bDone[MAX_FRAME_TASKS];
+			sTaskTiming		m_Timings[MAX_FRAME_TASKS];
+			Tick			m_Start;
+		};
+
+		struct sReadyTask
+		{
+			unsigned long	m_ulSlot;
+			unsigned long	m_ulTask;
+		};
+
+		std::vector<sTask>			m_Tasks;
+		NamedBitSet<unsigned int>	m_Resources;
+		sFrame						m_Frames[2];
+		std::vector<sReadyTask>		m_MainThreadReady;
+		std::mutex					m_Mutex;				//Guards the frames and the ready list
+		sTaskTiming					m_LastTimings[MAX_FRAME_TASKS];	//Of the last finished frame
+		double						m_dLastFrameMS;
+		double						m_dStepMS;				//0 steps once per RunFrame by the frame time
+		double						m_dAccumulatedMS;		//Frame time not yet stepped
+		unsigned int				m_uiMaxStepsPerFrame;
+		unsigned long				m_ulDroppedSteps;		//Steps given up to not fall further behind
+		unsigned long				m_ulNextFrame;
+		unsigned long				m_ulFinishedFrames;
+		bool						m_bPipelined;
+		bool						m_bCompiled;
+		bool						mInitilized;
+
+		static FrameGraph	*mInstance;
+
+		FrameGraph(const bool i_bPipelined);
+		~FrameGraph();
+		FrameGraph(const FrameGraph & i_Other);
+		FrameGraph & operator=(const FrameGraph & i_rhs);
+
+		static bool Conflicts(const sTask &i_First, const sTask &i_Second);
+		static void RunTaskJob(void *i_pData, const unsigned long i_ulSlot, const unsigned long i_ulTask);
+
+		void Compile(void);
+		void StartFrame(const sFrameTime &i_Time, const bool i_bStep, const bool i_bPresent);
+		void RunGraphFrame(const sFrameTime &i_Time, const bool i_bStep, const bool i_bPresent);
+		void FinishFrame(const unsigned long i_ulSlot);
+		void RunTask(const unsigned long i_ulSlot, const unsigned long i_ulTask);
+		void MakeReady(const unsigned long i_ulSlot, const unsigned long i_ulTask, sReadyTask *o_pReady, unsigned long &io_ulReadyCount);
+		void Dispatch(const sReadyTask *i_pReady, const unsigned long i_ulReadyCount);
+
+	public:
+		static bool CreateInstance(const bool i_bPipelined = true);
+		static FrameGraph * GetInstance();
+		static void Destroy();
+
+		unsigned int GetResource(const char *i_pName);
+		unsigned long AddTask(const char *i_pName, FrameTaskFunction i_pFunction, const unsigned int i_uiReads, const unsigned int i_uiWrites,
+							  const eTaskThread i_eThread = TASK_ANY_THREAD, const eTaskRate i_eRate = TASK_EVERY_STEP);
+		void SetFixedStep(const float i_fStepsPerSecond, const unsigned int i_uiMaxStepsPerFrame);
+
+		void RunFrame(const float i_FrameMS);
+		void Flush(void);
+
+		double GetCriticalPath(unsigned long *o_pPath, unsigned long &o_ulPathLength) const;
+		void PrintCriticalPath(void) const;
+
+		inline unsigned long GetDroppedSteps(void) const
+		{
+			return m_ulDroppedSteps;
+		}
+	};
+
+	void FrameGraph_UnitTest(void);
+}
+
+#endif //__FRAME_GRAPH_HEADER
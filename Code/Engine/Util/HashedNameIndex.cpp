@@ -0,0 +1,58 @@
+#include "PreCompiled.h"
+
+#include "HashedNameIndex.h"
+#include "Debug.h"
+
+namespace Engine
+{
+	/******************************************************************************
+		Function     : HashedNameIndex_UnitTest
+		Description  : UnitTest function to test adding, finding and removing
+					objects by name, shared names included
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void HashedNameIndex_UnitTest(void)
+	{
+	#ifdef _DEBUG
+		HashedNameIndex<int> UTIndex;
+		int Found = -1;
+
+		assert(false == UTIndex.Find("Player", Found));
+		assert(-1 == Found);
+
+		UTIndex.Add("Player", 1);
+		UTIndex.Add("Enemy", 2);
+		UTIndex.Add("data/numbers.dds", 3);
+		assert(3 == UTIndex.GetCount());
+
+		assert(UTIndex.Find("Player", Found) && (1 == Found));
+		assert(UTIndex.Find("Enemy", Found) && (2 == Found));
+		assert(UTIndex.Find("data/numbers.dds", Found) && (3 == Found));
+		assert(false == UTIndex.Find("Camera", Found));
+
+		//A second object with a name is found once the first is gone
+		UTIndex.Add("Enemy", 4);
+		assert(UTIndex.Find("Enemy", Found) && ((2 == Found) || (4 == Found)));
+
+		assert(UTIndex.Remove("Enemy", 2));
+		assert(false == UTIndex.Remove("Enemy", 2));
+		assert(UTIndex.Find("Enemy", Found) && (4 == Found));
+
+		//Removing needs both the name and the object
+		assert(false == UTIndex.Remove("Player", 4));
+		assert(UTIndex.Remove("Enemy", 4));
+		assert(false == UTIndex.Find("Enemy", Found));
+		assert(2 == UTIndex.GetCount());
+
+		UTIndex.Clear();
+		assert(0 == UTIndex.GetCount());
+		assert(false == UTIndex.Find("Player", Found));
+	#endif
+	}
+}
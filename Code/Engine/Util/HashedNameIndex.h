@@ -0,0 +1,48 @@
+#ifndef __HASHED_NAME_INDEX_HEADER
+#define __HASHED_NAME_INDEX_HEADER
+
+#include "PreCompiled.h"
+
+#include <string>
+#include <unordered_map>
+
+#include "HashedString.h"
+
+namespace Engine
+{
+	//Finds objects by name through the HashedString of the name. Several
+	//objects may share a name, Find returns one of them. Only the hash is
+	//kept in release, debug builds also keep the names and assert when two
+	//different names hash the same.
+	template<class T>
+	class HashedNameIndex
+	{
+		struct sEntry
+		{
+			T				m_Object;
+#ifdef _DEBUG
+			std::string		m_Name;
+#endif
+		};
+
+		typedef std::unordered_multimap<unsigned int, sEntry> EntryMap;
+
+		EntryMap	m_Entries;
+
+		void CheckCollision(const char *i_Name, const typename EntryMap::const_iterator &i_Entry) const;
+
+	public:
+		void Add(const char *i_Name, const T &i_Object);
+		bool Remove(const char *i_Name, const T &i_Object);
+		bool Find(const char *i_Name, T &o_Object) const;
+		void Clear(void);
+
+		unsigned long GetCount(void) const;
+	};
+
+	void HashedNameIndex_UnitTest(void);
+}
+
+#include "HashedNameIndex.inl"
+
+#endif //__HASHED_NAME_INDEX_HEADER
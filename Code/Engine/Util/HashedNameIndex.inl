@@ -0,0 +1,128 @@
+#include "Debug.h"
+
+namespace Engine
+{
+	//Two names with one hash would make lookups return the wrong object
+	template<class T>
+	void HashedNameIndex<T>::CheckCollision(const char *i_Name, const typename EntryMap::const_iterator &i_Entry) const
+	{
+#ifdef _DEBUG
+		if (i_Entry->second.m_Name != i_Name)
+		{
+			CONSOLE_PRINT("Names %s and %s have the same hash %u", i_Name, i_Entry->second.m_Name.c_str(), i_Entry->first);
+			assert(false);
+		}
+#else
+		(void)i_Name;
+		(void)i_Entry;
+#endif
+	}
+
+	/******************************************************************************
+		Function     : Add
+		Description  : Indexes i_Object under i_Name
+		Input        : const char *i_Name, const T &i_Object
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class T>
+	void HashedNameIndex<T>::Add(const char *i_Name, const T &i_Object)
+	{
+		assert(i_Name);
+
+		const unsigned int uiHash = HashedString(i_Name).Get();
+
+#ifdef _DEBUG
+		typename EntryMap::const_iterator Existing = m_Entries.find(uiHash);
+
+		if (Existing != m_Entries.end())
+		{
+			CheckCollision(i_Name, Existing);
+		}
+#endif
+
+		sEntry Entry;
+		Entry.m_Object = i_Object;
+#ifdef _DEBUG
+		Entry.m_Name = i_Name;
+#endif
+
+		m_Entries.insert(typename EntryMap::value_type(uiHash, Entry));
+	}
+
+	/******************************************************************************
+		Function     : Remove
+		Description  : Removes i_Object from under i_Name, other objects with
+					the same name stay
+		Input        : const char *i_Name, const T &i_Object
+		Output       :
+		Return Value : bool, false if it was not indexed under the name
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class T>
+	bool HashedNameIndex<T>::Remove(const char *i_Name, const T &i_Object)
+	{
+		assert(i_Name);
+
+		std::pair<typename EntryMap::iterator, typename EntryMap::iterator> Range = m_Entries.equal_range(HashedString(i_Name).Get());
+
+		for (typename EntryMap::iterator it = Range.first; it != Range.second; ++it)
+		{
+			if (it->second.m_Object == i_Object)
+			{
+				m_Entries.erase(it);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/******************************************************************************
+		Function     : Find
+		Description  : Looks up an object by name
+		Input        : const char *i_Name
+		Output       : T &o_Object, untouched when nothing has the name
+		Return Value : bool
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class T>
+	bool HashedNameIndex<T>::Find(const char *i_Name, T &o_Object) const
+	{
+		assert(i_Name);
+
+		typename EntryMap::const_iterator it = m_Entries.find(HashedString(i_Name).Get());
+
+		if (it == m_Entries.end())
+		{
+			return false;
+		}
+
+		CheckCollision(i_Name, it);
+
+		o_Object = it->second.m_Object;
+		return true;
+	}
+
+	template<class T>
+	void HashedNameIndex<T>::Clear(void)
+	{
+		m_Entries.clear();
+	}
+
+	template<class T>
+	unsigned long HashedNameIndex<T>::GetCount(void) const
+	{
+		return static_cast<unsigned long>(m_Entries.size());
+	}
+}
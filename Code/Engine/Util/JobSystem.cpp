@@ -0,0 +1,891 @@
+#include "PreCompiled.h"
+
+#include <math.h>
+
+#include "JobSystem.h"
+#include "MagazineMemoryPool.h"
+#include "Debug.h"
+#include "HighResTime.h"
+
+//Jobs a worker can have queued, a push past this runs the job right away
+#define JOB_DEQUE_CAPACITY			4096
+//Failed looks for work before an idle worker goes to sleep
+#define JOB_IDLE_SPINS_BEFORE_SLEEP	64
+
+namespace Engine
+{
+	JobSystem * JobSystem::mInstance = NULL;
+
+	//Index of the calling thread's deque, -1 on threads that are not workers
+	static THREAD_LOCAL long s_lWorkerIndex = -1;
+	static THREAD_LOCAL unsigned long s_ulStealSeed = 1;
+
+	JobCounter::JobCounter(void):
+		m_lPending(0),
+		m_lUnfinished(0)
+	{
+		m_Lock.clear();
+	}
+
+	JobCounter::~JobCounter()
+	{
+		assert(IsDone());
+		assert(m_Continuations.empty());
+	}
+
+	void JobCounter::Lock(void)
+	{
+		while (m_Lock.test_and_set(std::memory_order_acquire))
+		{
+		}
+	}
+
+	void JobCounter::Unlock(void)
+	{
+		m_Lock.clear(std::memory_order_release);
+	}
+
+	JobSystem::WorkDeque::WorkDeque(void):
+		m_pSlots(new sSlot[JOB_DEQUE_CAPACITY]),
+		m_llMask(JOB_DEQUE_CAPACITY - 1),
+		m_llTop(0),
+		m_llBottom(0)
+	{
+		assert(0 == (JOB_DEQUE_CAPACITY & m_llMask));
+	}
+
+	JobSystem::WorkDeque::~WorkDeque()
+	{
+		assert(IsEmpty());
+
+		delete[] m_pSlots;
+	}
+
+	void JobSystem::WorkDeque::ReadSlot(const long long i_llIndex, sJob &o_Job) const
+	{
+		const sSlot &Slot = m_pSlots[i_llIndex & m_llMask];
+
+		o_Job.m_pFunction = Slot.m_pFunction.load(std::memory_order_relaxed);
+		o_Job.m_pData = Slot.m_pData.load(std::memory_order_relaxed);
+		o_Job.m_ulBegin = Slot.m_ulBegin.load(std::memory_order_relaxed);
+		o_Job.m_ulEnd = Slot.m_ulEnd.load(std::memory_order_relaxed);
+		o_Job.m_pCounter = Slot.m_pCounter.load(std::memory_order_relaxed);
+	}
+
+	/******************************************************************************
+		Function     : Push
+		Description  : Adds a job at the bottom, owner only
+		Input        : const sJob &i_Job
+		Output       :
+		Return Value : bool, false when the deque is full
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	bool JobSystem::WorkDeque::Push(const sJob &i_Job)
+	{
+		const long long llBottom = m_llBottom.load(std::memory_order_relaxed);
+		const long long llTop = m_llTop.load(std::memory_order_acquire);
+
+		if ((llBottom - llTop) > m_llMask)
+		{
+			return false;
+		}
+
+		sSlot &Slot = m_pSlots[llBottom & m_llMask];
+
+		Slot.m_pFunction.store(i_Job.m_pFunction, std::memory_order_relaxed);
+		Slot.m_pData.store(i_Job.m_pData, std::memory_order_relaxed);
+		Slot.m_ulBegin.store(i_Job.m_ulBegin, std::memory_order_relaxed);
+		Slot.m_ulEnd.store(i_Job.m_ulEnd, std::memory_order_relaxed);
+		Slot.m_pCounter.store(i_Job.m_pCounter, std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_release);
+		m_llBottom.store(llBottom + 1, std::memory_order_relaxed);
+
+		return true;
+	}
+
+	/******************************************************************************
+		Function     : Pop
+		Description  : Takes the newest job from the bottom, owner only. Races
+					thieves through the top CAS when one job is left
+		Input        : void
+		Output       : sJob &o_Job
+		Return Value : bool, false when there was nothing to take
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	bool JobSystem::WorkDeque::Pop(sJob &o_Job)
+	{
+		const long long llBottom = m_llBottom.load(std::memory_order_relaxed) - 1;
+		m_llBottom.store(llBottom, std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		long long llTop = m_llTop.load(std::memory_order_relaxed);
+
+		if (llTop > llBottom)
+		{
+			m_llBottom.store(llBottom + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		ReadSlot(llBottom, o_Job);
+
+		if (llTop < llBottom)
+		{
+			return true;
+		}
+
+		//Last job, whoever moves the top first gets it
+		const bool bWon = m_llTop.compare_exchange_strong(llTop, llTop + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		m_llBottom.store(llBottom + 1, std::memory_order_relaxed);
+
+		return bWon;
+	}
+
+	/******************************************************************************
+		Function     : Steal
+		Description  : Takes the oldest job from the top, any thread
+		Input        : void
+		Output       : sJob &o_Job
+		Return Value : bool, false when empty or another thread got there first
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	bool JobSystem::WorkDeque::Steal(sJob &o_Job)
+	{
+		long long llTop = m_llTop.load(std::memory_order_acquire);
+
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		const long long llBottom = m_llBottom.load(std::memory_order_acquire);
+
+		if (llTop >= llBottom)
+		{
+			return false;
+		}
+
+		ReadSlot(llTop, o_Job);
+
+		return m_llTop.compare_exchange_strong(llTop, llTop + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+	}
+
+	/******************************************************************************
+		Function     : JobSystem
+		Description  : Constructor, the calling thread becomes worker 0 and the
+					rest are started
+		Input        : const unsigned int i_uiWorkerCount
+		Output       :
+		Return Value :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	JobSystem::JobSystem(const unsigned int i_uiWorkerCount):
+		m_pDeques(new WorkDeque[i_uiWorkerCount]),
+		m_uiWorkerCount(i_uiWorkerCount),
+		m_lQueuedJobs(0),
+		m_lSleeping(0),
+		m_bQuit(false),
+		mInitilized(true)
+	{
+		assert(-1 == s_lWorkerIndex);
+
+		s_lWorkerIndex = 0;
+		s_ulStealSeed = 1;
+
+		for (unsigned int uiWorker = 1; uiWorker < m_uiWorkerCount; uiWorker++)
+		{
+			m_Workers.push_back(std::thread(&JobSystem::WorkerMain, this, uiWorker));
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		m_bQuit.store(true);
+
+		{
+			std::lock_guard<std::mutex> Lock(m_SleepMutex);
+			m_WakeUp.notify_all();
+		}
+
+		for (unsigned long ulWorker = 0; ulWorker < m_Workers.size(); ulWorker++)
+		{
+			m_Workers[ulWorker].join();
+		}
+
+		delete[] m_pDeques;
+
+		s_lWorkerIndex = -1;
+	}
+
+	/******************************************************************************
+		Function     : CreateInstance
+		Description  : Creates the job system with one worker per core when
+					i_uiWorkerCount is 0, the calling thread counts as one
+		Input        : const unsigned int i_uiWorkerCount
+		Output       :
+		Return Value : bool
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	bool JobSystem::CreateInstance(const unsigned int i_uiWorkerCount)
+	{
+		if (mInstance == NULL)
+		{
+			unsigned int uiWorkerCount = i_uiWorkerCount;
+
+			if (0 == uiWorkerCount)
+			{
+				uiWorkerCount = std::thread::hardware_concurrency();
+			}
+
+			if (0 == uiWorkerCount)
+			{
+				uiWorkerCount = 1;
+			}
+
+			mInstance = new JobSystem(uiWorkerCount);
+
+			if (mInstance == NULL)
+			{
+				return false;
+			}
+
+			if (mInstance->mInitilized == false)
+			{
+				delete mInstance;
+				mInstance = NULL;
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	JobSystem * JobSystem::GetInstance()
+	{
+		if (mInstance != NULL)
+		{
+			return mInstance;
+		}
+
+		assert(false);
+
+		return NULL;
+	}
+
+	void JobSystem::Destroy()
+	{
+		if (mInstance)
+		{
+			delete mInstance;
+			mInstance = NULL;
+		}
+	}
+
+	/******************************************************************************
+		Function     : WorkerMain
+		Description  : Runs jobs until the job system goes. An idle worker keeps
+					looking for a while, then sleeps until a job is pushed
+		Input        : const unsigned int i_uiWorkerIndex
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void JobSystem::WorkerMain(const unsigned int i_uiWorkerIndex)
+	{
+		s_lWorkerIndex = i_uiWorkerIndex;
+		s_ulStealSeed = i_uiWorkerIndex + 1;
+
+		unsigned long ulIdleSpins = 0;
+
+		while (false == m_bQuit.load(std::memory_order_relaxed))
+		{
+			sJob Job;
+
+			if (FindJob(Job))
+			{
+				Execute(Job);
+				ulIdleSpins = 0;
+				continue;
+			}
+
+			if (++ulIdleSpins < JOB_IDLE_SPINS_BEFORE_SLEEP)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			//Paired with Push, either the pusher sees this worker sleeping or
+			//this worker sees the queued job
+			std::unique_lock<std::mutex> Lock(m_SleepMutex);
+			m_lSleeping.fetch_add(1);
+
+			while ((0 >= m_lQueuedJobs.load()) && (false == m_bQuit.load()))
+			{
+				m_WakeUp.wait(Lock);
+			}
+
+			m_lSleeping.fetch_sub(1);
+			ulIdleSpins = 0;
+		}
+
+		MagazineMemoryPool::FlushAllThreadMagazines();
+	}
+
+	/******************************************************************************
+		Function     : Push
+		Description  : Queues a job whose counter is already counted up on the
+					calling worker's deque, waking a sleeping worker. A full
+					deque runs the job here instead
+		Input        : const sJob &i_Job
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void JobSystem::Push(const sJob &i_Job)
+	{
+		assert(s_lWorkerIndex >= 0);
+
+		m_lQueuedJobs.fetch_add(1);
+
+		if (false == m_pDeques[s_lWorkerIndex].Push(i_Job))
+		{
+			m_lQueuedJobs.fetch_sub(1);
+			Execute(i_Job);
+			return;
+		}
+
+		if (0 < m_lSleeping.load())
+		{
+			std::lock_guard<std::mutex> Lock(m_SleepMutex);
+			m_WakeUp.notify_one();
+		}
+	}
+
+	/******************************************************************************
+		Function     : FindJob
+		Description  : Pops from the calling worker's deque, or steals from the
+					others starting at a random one
+		Input        : void
+		Output       : sJob &o_Job
+		Return Value : bool
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	bool JobSystem::FindJob(sJob &o_Job)
+	{
+		const long lSelf = s_lWorkerIndex;
+
+		if (m_pDeques[lSelf].Pop(o_Job))
+		{
+			m_lQueuedJobs.fetch_sub(1);
+			return true;
+		}
+
+		//xorshift, spreads the thieves over the victims
+		s_ulStealSeed ^= s_ulStealSeed << 13;
+		s_ulStealSeed ^= s_ulStealSeed >> 17;
+		s_ulStealSeed ^= s_ulStealSeed << 5;
+
+		const unsigned int uiFirst = s_ulStealSeed % m_uiWorkerCount;
+
+		for (unsigned int uiTry = 0; uiTry < m_uiWorkerCount; uiTry++)
+		{
+			const unsigned int uiVictim = (uiFirst + uiTry) % m_uiWorkerCount;
+
+			if ((static_cast<long>(uiVictim) != lSelf) && m_pDeques[uiVictim].Steal(o_Job))
+			{
+				m_lQueuedJobs.fetch_sub(1);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void JobSystem::Execute(const sJob &i_Job)
+	{
+		i_Job.m_pFunction(i_Job.m_pData, i_Job.m_ulBegin, i_Job.m_ulEnd);
+
+		FinishJob(i_Job.m_pCounter);
+	}
+
+	/******************************************************************************
+		Function     : FinishJob
+		Description  : Counts a job off its counter. The last one queues the
+					jobs that ran after the counter, then lets waiters go, the
+					counter may be gone right after that
+		Input        : JobCounter *i_pCounter
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void JobSystem::FinishJob(JobCounter *i_pCounter)
+	{
+		if (NULL == i_pCounter)
+		{
+			return;
+		}
+
+		std::vector<sJob> Ready;
+
+		i_pCounter->Lock();
+
+		assert(0 < i_pCounter->m_lPending);
+
+		if (0 == --i_pCounter->m_lPending)
+		{
+			Ready.swap(i_pCounter->m_Continuations);
+		}
+
+		i_pCounter->Unlock();
+
+		for (unsigned long ulJob = 0; ulJob < Ready.size(); ulJob++)
+		{
+			Push(Ready[ulJob]);
+		}
+
+		i_pCounter->m_lUnfinished.fetch_sub(1, std::memory_order_release);
+	}
+
+	bool JobSystem::IsLocalQueueEmpty(void) const
+	{
+		return m_pDeques[s_lWorkerIndex].IsEmpty();
+	}
+
+	/******************************************************************************
+		Function     : Run
+		Description  : Queues a job on the calling worker, i_pCounter is counted
+					up now and down when the job is done
+		Input        : JobFunction i_pFunction, void *i_pData,
+					const unsigned long i_ulBegin, const unsigned long i_ulEnd,
+					JobCounter *i_pCounter
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void JobSystem::Run(JobFunction i_pFunction, void *i_pData, const unsigned long i_ulBegin, const unsigned long i_ulEnd, JobCounter *i_pCounter)
+	{
+		assert(i_pFunction);
+
+		if (NULL != i_pCounter)
+		{
+			i_pCounter->Lock();
+			i_pCounter->m_lPending++;
+			i_pCounter->Unlock();
+			i_pCounter->m_lUnfinished.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		sJob Job;
+		Job.m_pFunction = i_pFunction;
+		Job.m_pData = i_pData;
+		Job.m_ulBegin = i_ulBegin;
+		Job.m_ulEnd = i_ulEnd;
+		Job.m_pCounter = i_pCounter;
+
+		Push(Job);
+	}
+
+	/******************************************************************************
+		Function     : RunAfter
+		Description  : Like Run, but the job is only queued once i_Dependency
+					gets to zero. i_pCounter counts it from now on, so waiting
+					on it also waits for the dependency
+		Input        : JobCounter &i_Dependency, JobFunction i_pFunction,
+					void *i_pData, const unsigned long i_ulBegin,
+					const unsigned long i_ulEnd, JobCounter *i_pCounter
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void JobSystem::RunAfter(JobCounter &i_Dependency, JobFunction i_pFunction, void *i_pData, const unsigned long i_ulBegin, const unsigned long i_ulEnd, JobCounter *i_pCounter)
+	{
+		assert(i_pFunction);
+		assert(&i_Dependency != i_pCounter);
+
+		if (NULL != i_pCounter)
+		{
+			i_pCounter->Lock();
+			i_pCounter->m_lPending++;
+			i_pCounter->Unlock();
+			i_pCounter->m_lUnfinished.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		sJob Job;
+		Job.m_pFunction = i_pFunction;
+		Job.m_pData = i_pData;
+		Job.m_ulBegin = i_ulBegin;
+		Job.m_ulEnd = i_ulEnd;
+		Job.m_pCounter = i_pCounter;
+
+		i_Dependency.Lock();
+
+		if (0 < i_Dependency.m_lPending)
+		{
+			i_Dependency.m_Continuations.push_back(Job);
+			i_Dependency.Unlock();
+			return;
+		}
+
+		i_Dependency.Unlock();
+
+		Push(Job);
+	}
+
+	/******************************************************************************
+		Function     : Wait
+		Description  : Returns once i_Counter is done, running queued jobs in
+					the meantime instead of blocking the worker
+		Input        : JobCounter &i_Counter
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void JobSystem::Wait(JobCounter &i_Counter)
+	{
+		assert(s_lWorkerIndex >= 0);
+
+		while (false == i_Counter.IsDone())
+		{
+			if (false == TryRunJob())
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	/******************************************************************************
+		Function     : TryRunJob
+		Description  : Runs one queued job if there is one, for a worker that
+					waits on something other than a counter
+		Input        : void
+		Output       :
+		Return Value : bool, false when no job was found
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	bool JobSystem::TryRunJob(void)
+	{
+		assert(s_lWorkerIndex >= 0);
+
+		sJob Job;
+
+		if (false == FindJob(Job))
+		{
+			return false;
+		}
+
+		Execute(Job);
+		return true;
+	}
+
+	unsigned int JobSystem::GetWorkerCount(void) const
+	{
+		return m_uiWorkerCount;
+	}
+
+	long JobSystem::GetWorkerIndex(void)
+	{
+		return s_lWorkerIndex;
+	}
+
+	struct sUTChain
+	{
+		std::atomic<long>	m_lStage;
+		std::atomic<long>	m_lOutOfOrder;
+	};
+
+	static void UTAddRange(void *i_pData, const unsigned long i_ulBegin, const unsigned long i_ulEnd)
+	{
+		std::atomic<unsigned long> *pSum = static_cast<std::atomic<unsigned long> *>(i_pData);
+
+		for (unsigned long i = i_ulBegin; i < i_ulEnd; i++)
+		{
+			pSum->fetch_add(i, std::memory_order_relaxed);
+		}
+	}
+
+	//i_ulBegin is the stage of the job, every job of the stage before must be done
+	static void UTChainStage(void *i_pData, const unsigned long i_ulBegin, const unsigned long)
+	{
+		sUTChain *pChain = static_cast<sUTChain *>(i_pData);
+
+		if (static_cast<long>(i_ulBegin) != pChain->m_lStage.load())
+		{
+			pChain->m_lOutOfOrder.fetch_add(1);
+		}
+	}
+
+	static void UTAdvanceStage(void *i_pData, const unsigned long, const unsigned long)
+	{
+		static_cast<sUTChain *>(i_pData)->m_lStage.fetch_add(1);
+	}
+
+	/******************************************************************************
+		Function     : JobSystem_UnitTest
+		Description  : UnitTest function to test ParallelFor, counters, jobs
+					that run after others and nested waits
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void JobSystem_UnitTest(void)
+	{
+	#ifdef _DEBUG
+		//Run before the game creates its own job system. Four workers even on
+		//fewer cores, so jobs do get stolen
+		JobSystem::CreateInstance(4);
+
+		JobSystem *pJobSystem = JobSystem::GetInstance();
+		assert(4 == pJobSystem->GetWorkerCount());
+		assert(0 == JobSystem::GetWorkerIndex());
+
+		//Every index is visited exactly once, whatever the grain
+		{
+			const unsigned long UTCount = 100000;
+			std::vector<unsigned char> UTVisits(UTCount, 0);
+			const unsigned long UTGrains[] = { 0, 1, 7, UTCount };
+
+			for (unsigned int uGrain = 0; uGrain < (sizeof(UTGrains) / sizeof(UTGrains[0])); uGrain++)
+			{
+				auto Visit = [&UTVisits](const unsigned long i_ulBegin, const unsigned long i_ulEnd)
+				{
+					for (unsigned long i = i_ulBegin; i < i_ulEnd; i++)
+					{
+						UTVisits[i]++;
+					}
+				};
+
+				pJobSystem->ParallelFor(0, UTCount, Visit, UTGrains[uGrain]);
+			}
+
+			for (unsigned long i = 0; i < UTCount; i++)
+			{
+				assert(4 == UTVisits[i]);
+			}
+		}
+
+		//Jobs on one counter
+		{
+			std::atomic<unsigned long> UTSum(0);
+			JobCounter UTCounter;
+
+			for (unsigned long i = 0; i < 100; i++)
+			{
+				pJobSystem->Run(&UTAddRange, &UTSum, i * 10, (i + 1) * 10, &UTCounter);
+			}
+
+			pJobSystem->Wait(UTCounter);
+			assert(UTCounter.IsDone());
+			assert((999 * 1000 / 2) == UTSum.load());
+		}
+
+		//Stages chained through counters, a stage never starts early
+		{
+			const unsigned long UTStages = 8;
+			const unsigned long UTJobsPerStage = 16;
+			sUTChain UTChain;
+			UTChain.m_lStage = 0;
+			UTChain.m_lOutOfOrder = 0;
+
+			JobCounter UTStageDone[UTStages];
+			JobCounter UTAdvanced[UTStages];
+
+			for (unsigned long ulStage = 0; ulStage < UTStages; ulStage++)
+			{
+				for (unsigned long ulJob = 0; ulJob < UTJobsPerStage; ulJob++)
+				{
+					if (0 == ulStage)
+					{
+						pJobSystem->Run(&UTChainStage, &UTChain, ulStage, ulStage, &UTStageDone[ulStage]);
+					}
+					else
+					{
+						pJobSystem->RunAfter(UTAdvanced[ulStage - 1], &UTChainStage, &UTChain, ulStage, ulStage, &UTStageDone[ulStage]);
+					}
+				}
+
+				pJobSystem->RunAfter(UTStageDone[ulStage], &UTAdvanceStage, &UTChain, 0, 0, &UTAdvanced[ulStage]);
+			}
+
+			pJobSystem->Wait(UTAdvanced[UTStages - 1]);
+
+			//The last job of a stage may still be letting go of its counter
+			for (unsigned long ulStage = 0; ulStage < UTStages; ulStage++)
+			{
+				pJobSystem->Wait(UTStageDone[ulStage]);
+				pJobSystem->Wait(UTAdvanced[ulStage]);
+			}
+
+			assert(UTStages == static_cast<unsigned long>(UTChain.m_lStage.load()));
+			assert(0 == UTChain.m_lOutOfOrder.load());
+
+			//A dependency that is already done runs the job right away
+			std::atomic<unsigned long> UTSum(0);
+			JobCounter UTCounter;
+
+			pJobSystem->RunAfter(UTStageDone[0], &UTAddRange, &UTSum, 0, 10, &UTCounter);
+			pJobSystem->Wait(UTCounter);
+			assert(45 == UTSum.load());
+		}
+
+		//ParallelFor inside jobs, the inner waits help instead of blocking
+		{
+			const unsigned long UTOuter = 16;
+			const unsigned long UTInner = 1000;
+			std::atomic<unsigned long> UTSum(0);
+
+			auto Outer = [pJobSystem, &UTSum, UTInner](const unsigned long i_ulBegin, const unsigned long i_ulEnd)
+			{
+				for (unsigned long i = i_ulBegin; i < i_ulEnd; i++)
+				{
+					auto Inner = [&UTSum](const unsigned long i_ulInnerBegin, const unsigned long i_ulInnerEnd)
+					{
+						UTSum.fetch_add(i_ulInnerEnd - i_ulInnerBegin);
+					};
+
+					pJobSystem->ParallelFor(0, UTInner, Inner, 10);
+				}
+			};
+
+			pJobSystem->ParallelFor(0, UTOuter, Outer, 1);
+			assert((UTOuter * UTInner) == UTSum.load());
+		}
+
+		JobSystem::Destroy();
+		assert(-1 == JobSystem::GetWorkerIndex());
+	#endif
+	}
+
+	/******************************************************************************
+		Function     : JobSystem_Benchmark
+		Description  : Times ParallelFor over an Euler step of a particle array
+					and over uneven work, from 1 worker up to one per core
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void JobSystem_Benchmark(void)
+	{
+		static const unsigned long BenchParticles = 1000000;
+		static const unsigned long BenchFrames = 50;
+		static const unsigned long BenchUnevenItems = 4096;
+		static const float BenchDeltaTime = 1.0f / 60.0f;
+		unsigned int uMaxWorkers = std::thread::hardware_concurrency();
+
+		if (0 == uMaxWorkers)
+		{
+			uMaxWorkers = 1;
+		}
+
+		std::vector<float> Position(BenchParticles * 3, 0.0f);
+		std::vector<float> Velocity(BenchParticles * 3, 1.0f);
+		std::vector<float> Uneven(BenchUnevenItems, 0.0f);
+		double OneWorkerMS[2] = { 0.0, 0.0 };
+
+		for (unsigned int uWorkers = 1; uWorkers <= uMaxWorkers; uWorkers++)
+		{
+			JobSystem::CreateInstance(uWorkers);
+			JobSystem *pJobSystem = JobSystem::GetInstance();
+			double BenchMS[2];
+
+			auto Integrate = [&Position, &Velocity](const unsigned long i_ulBegin, const unsigned long i_ulEnd)
+			{
+				for (unsigned long i = i_ulBegin * 3; i < i_ulEnd * 3; i++)
+				{
+					Velocity[i] -= Velocity[i] * 0.1f * BenchDeltaTime;
+					Position[i] += Velocity[i] * BenchDeltaTime;
+				}
+			};
+
+			//Item i costs i, so fixed size pieces would leave workers idle
+			auto UnevenWork = [&Uneven](const unsigned long i_ulBegin, const unsigned long i_ulEnd)
+			{
+				for (unsigned long i = i_ulBegin; i < i_ulEnd; i++)
+				{
+					float fValue = 0.0f;
+
+					for (unsigned long ulStep = 0; ulStep < i; ulStep++)
+					{
+						fValue += sqrtf(static_cast<float>(ulStep));
+					}
+
+					Uneven[i] = fValue;
+				}
+			};
+
+			Tick IntegrateStart;
+			IntegrateStart.CalcCurrentTick();
+
+			for (unsigned long ulFrame = 0; ulFrame < BenchFrames; ulFrame++)
+			{
+				pJobSystem->ParallelFor(0, BenchParticles, Integrate);
+			}
+
+			BenchMS[0] = IntegrateStart.GetTickDifferenceinMS();
+
+			Tick UnevenStart;
+			UnevenStart.CalcCurrentTick();
+
+			for (unsigned long ulFrame = 0; ulFrame < BenchFrames; ulFrame++)
+			{
+				pJobSystem->ParallelFor(0, BenchUnevenItems, UnevenWork);
+			}
+
+			BenchMS[1] = UnevenStart.GetTickDifferenceinMS();
+
+			JobSystem::Destroy();
+
+			if (1 == uWorkers)
+			{
+				OneWorkerMS[0] = BenchMS[0];
+				OneWorkerMS[1] = BenchMS[1];
+			}
+
+			DebugPrint("JobSystem Benchmark: Workers: %u	|	Integrate MS: %f (x%.2f)	|	Uneven MS: %f (x%.2f)", uWorkers,
+					   BenchMS[0], OneWorkerMS[0] / BenchMS[0], BenchMS[1], OneWorkerMS[1] / BenchMS[1]);
+		}
+	}
+}
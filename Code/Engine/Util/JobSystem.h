@@ -0,0 +1,158 @@
+#ifndef __JOB_SYSTEM_HEADER
+#define __JOB_SYSTEM_HEADER
+
+#include "PreCompiled.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Engine
+{
+	class JobCounter;
+
+	//A job runs i_pFunction over [i_ulBegin, i_ulEnd) of whatever i_pData is
+	typedef void (*JobFunction)(void *i_pData, const unsigned long i_ulBegin, const unsigned long i_ulEnd);
+
+	struct sJob
+	{
+		JobFunction		m_pFunction;
+		void			*m_pData;
+		unsigned long	m_ulBegin;
+		unsigned long	m_ulEnd;
+		JobCounter		*m_pCounter;		//Counted down when the job is done, may be NULL
+	};
+
+	//Number of jobs still to run. Jobs given to RunAfter start once the
+	//counter gets to zero. A counter must not be reused until IsDone.
+	class JobCounter
+	{
+		friend class JobSystem;
+
+		std::atomic_flag	m_Lock;				//Guards the pending count and the continuations
+		long				m_lPending;			//Jobs not yet run to the end
+		std::atomic<long>	m_lUnfinished;		//Same, but only counted down once a job no longer touches the counter
+		std::vector<sJob>	m_Continuations;
+
+		JobCounter(const JobCounter & i_Other);
+		JobCounter & operator=(const JobCounter & i_rhs);
+
+		void Lock(void);
+		void Unlock(void);
+
+	public:
+		JobCounter(void);
+		~JobCounter();
+
+		inline bool IsDone(void) const
+		{
+			return 0 == m_lUnfinished.load(std::memory_order_acquire);
+		}
+	};
+
+	//Runs jobs on one worker per core, the thread that creates the job system
+	//is worker 0 and runs jobs while it waits. Each worker owns a Chase-Lev
+	//deque, it pushes and pops at the bottom while idle workers steal from the
+	//top. Only worker threads may add jobs.
+	class JobSystem
+	{
+		class WorkDeque
+		{
+			//Each field is atomic so a thief reading a slot the owner is writing
+			//is not a data race, the top CAS throws such a read away
+			struct sSlot
+			{
+				std::atomic<JobFunction>	m_pFunction;
+				std::atomic<void *>			m_pData;
+				std::atomic<unsigned long>	m_ulBegin;
+				std::atomic<unsigned long>	m_ulEnd;
+				std::atomic<JobCounter *>	m_pCounter;
+			};
+
+			sSlot					*m_pSlots;
+			long long				m_llMask;
+			std::atomic<long long>	m_llTop;
+			std::atomic<long long>	m_llBottom;
+
+			WorkDeque(const WorkDeque & i_Other);
+			WorkDeque & operator=(const WorkDeque & i_rhs);
+
+			void ReadSlot(const long long i_llIndex, sJob &o_Job) const;
+
+		public:
+			WorkDeque(void);
+			~WorkDeque();
+
+			bool Push(const sJob &i_Job);
+			bool Pop(sJob &o_Job);
+			bool Steal(sJob &o_Job);
+
+			inline bool IsEmpty(void) const
+			{
+				return m_llBottom.load(std::memory_order_relaxed) <= m_llTop.load(std::memory_order_relaxed);
+			}
+		};
+
+		template<class Function>
+		struct sParallelFor
+		{
+			Function		*m_pFunction;
+			unsigned long	m_ulGrain;
+			JobCounter		*m_pCounter;
+		};
+
+		std::vector<std::thread>	m_Workers;
+		WorkDeque					*m_pDeques;		//One per worker, the creating thread's first
+		unsigned int				m_uiWorkerCount;
+		std::atomic<long>			m_lQueuedJobs;	//Pushed and not yet taken, wakes sleeping workers
+		std::atomic<long>			m_lSleeping;
+		std::atomic<bool>			m_bQuit;
+		std::mutex					m_SleepMutex;
+		std::condition_variable		m_WakeUp;
+		bool						mInitilized;
+
+		static JobSystem	*mInstance;
+
+		JobSystem(const unsigned int i_uiWorkerCount);
+		~JobSystem();
+		JobSystem(const JobSystem & i_Other);
+		JobSystem & operator=(const JobSystem & i_rhs);
+
+		void WorkerMain(const unsigned int i_uiWorkerIndex);
+		void Push(const sJob &i_Job);
+		bool FindJob(sJob &o_Job);
+		void Execute(const sJob &i_Job);
+		void FinishJob(JobCounter *i_pCounter);
+		bool IsLocalQueueEmpty(void) const;
+
+		template<class Function>
+		static void ParallelForJob(void *i_pData, const unsigned long i_ulBegin, const unsigned long i_ulEnd);
+
+	public:
+		static bool CreateInstance(const unsigned int i_uiWorkerCount = 0);
+		static JobSystem * GetInstance();
+		static void Destroy();
+
+		void Run(JobFunction i_pFunction, void *i_pData, const unsigned long i_ulBegin, const unsigned long i_ulEnd, JobCounter *i_pCounter);
+		void RunAfter(JobCounter &i_Dependency, JobFunction i_pFunction, void *i_pData, const unsigned long i_ulBegin, const unsigned long i_ulEnd, JobCounter *i_pCounter);
+		void Wait(JobCounter &i_Counter);
+		bool TryRunJob(void);
+
+		//Calls i_Function(ulBegin, ulEnd) over sub ranges of [i_ulBegin, i_ulEnd)
+		//on all workers and returns once all are done. i_ulMinGrain of 0 picks one
+		template<class Function>
+		void ParallelFor(const unsigned long i_ulBegin, const unsigned long i_ulEnd, Function &i_Function, const unsigned long i_ulMinGrain = 0);
+
+		unsigned int GetWorkerCount(void) const;
+		static long GetWorkerIndex(void);
+	};
+
+	void JobSystem_UnitTest(void);
+	void JobSystem_Benchmark(void);
+}
+
+#include "JobSystem.inl"
+
+#endif //__JOB_SYSTEM_HEADER
@@ -0,0 +1,98 @@
+#include "Debug.h"
+
+namespace Engine
+{
+	/******************************************************************************
+		Function     : ParallelForJob
+		Description  : Runs one range of a ParallelFor. The upper half is split
+					off for thieves only while this worker's deque is empty,
+					otherwise a grain is run and the deque checked again. A
+					range nobody steals from is run in grain sized pieces with
+					one push in total
+		Input        : void *i_pData, const unsigned long i_ulBegin,
+					const unsigned long i_ulEnd
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class Function>
+	void JobSystem::ParallelForJob(void *i_pData, const unsigned long i_ulBegin, const unsigned long i_ulEnd)
+	{
+		const sParallelFor<Function> &For = *static_cast<const sParallelFor<Function> *>(i_pData);
+		JobSystem *pJobSystem = mInstance;
+		unsigned long ulBegin = i_ulBegin;
+		unsigned long ulEnd = i_ulEnd;
+
+		while ((ulEnd - ulBegin) > For.m_ulGrain)
+		{
+			if (pJobSystem->IsLocalQueueEmpty())
+			{
+				const unsigned long ulMiddle = ulBegin + ((ulEnd - ulBegin) / 2);
+
+				pJobSystem->Run(&ParallelForJob<Function>, i_pData, ulMiddle, ulEnd, For.m_pCounter);
+				ulEnd = ulMiddle;
+			}
+			else
+			{
+				(*For.m_pFunction)(ulBegin, ulBegin + For.m_ulGrain);
+				ulBegin += For.m_ulGrain;
+			}
+		}
+
+		(*For.m_pFunction)(ulBegin, ulEnd);
+	}
+
+	/******************************************************************************
+		Function     : ParallelFor
+		Description  : Runs i_Function over the range on all workers, the calling
+					worker takes part and returns once every piece is done
+		Input        : const unsigned long i_ulBegin, const unsigned long i_ulEnd,
+					Function &i_Function, const unsigned long i_ulMinGrain
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class Function>
+	void JobSystem::ParallelFor(const unsigned long i_ulBegin, const unsigned long i_ulEnd, Function &i_Function, const unsigned long i_ulMinGrain)
+	{
+		if (i_ulEnd <= i_ulBegin)
+		{
+			return;
+		}
+
+		unsigned long ulGrain = i_ulMinGrain;
+
+		//Enough pieces for stealing to even out uneven work, few enough that
+		//the per piece cost does not show
+		if (0 == ulGrain)
+		{
+			ulGrain = (i_ulEnd - i_ulBegin) / (64 * m_uiWorkerCount);
+		}
+
+		if (0 == ulGrain)
+		{
+			ulGrain = 1;
+		}
+
+		if ((1 == m_uiWorkerCount) || ((i_ulEnd - i_ulBegin) <= ulGrain))
+		{
+			i_Function(i_ulBegin, i_ulEnd);
+			return;
+		}
+
+		JobCounter Counter;
+		sParallelFor<Function> For;
+		For.m_pFunction = &i_Function;
+		For.m_ulGrain = ulGrain;
+		For.m_pCounter = &Counter;
+
+		ParallelForJob<Function>(&For, i_ulBegin, i_ulEnd);
+		Wait(Counter);
+	}
+}
@@ -0,0 +1,483 @@
+#include "PreCompiled.h"
+
+#include <string.h>
+
+#include "LevelArena.h"
+#include "Debug.h"
+
+//Largest alignment the arena can honour, the region starts on a page
+#define LEVEL_ARENA_MAX_ALIGNMENT	64
+
+namespace Engine
+{
+	LevelArena * LevelArena::mInstance = NULL;
+
+	/******************************************************************************
+		Function     : LevelArena
+		Description  : Constructor, reserves the region from the page allocator
+		Input        : const unsigned long i_ulRegionBytes
+		Output       :
+		Return Value :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	LevelArena::LevelArena(const unsigned long i_ulRegionBytes):
+		m_pRegion(NULL),
+		m_ulRegionBytes(i_ulRegionBytes),
+		m_eBacking(PAGE_BACKING_OS_PAGES),
+		m_ulLevelUsed(0),
+		m_ulTemporaryUsed(0),
+		m_ulHighWaterMark(0),
+		m_ulOverflowCount(0),
+		m_pLevelOverflow(NULL),
+		m_pTemporaryOverflow(NULL),
+		m_ulLoadDepth(0),
+		mInitilized(false)
+	{
+		m_pRegion = static_cast<char *>(PageAllocator::Reserve(m_ulRegionBytes, &m_eBacking));
+
+		mInitilized = (NULL != m_pRegion);
+	}
+
+	LevelArena::~LevelArena()
+	{
+		FreeOverflowBlocks(m_pLevelOverflow, NULL);
+		FreeOverflowBlocks(m_pTemporaryOverflow, NULL);
+
+		PageAllocator::Release(m_pRegion, m_ulRegionBytes, m_eBacking);
+	}
+
+	bool LevelArena::CreateInstance(const unsigned long i_ulRegionBytes)
+	{
+		if (mInstance == NULL)
+		{
+			mInstance = new LevelArena(i_ulRegionBytes);
+
+			if (mInstance == NULL)
+			{
+				return false;
+			}
+
+			if (mInstance->mInitilized == false)
+			{
+				delete mInstance;
+				mInstance = NULL;
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	LevelArena * LevelArena::GetInstance()
+	{
+		if (mInstance != NULL)
+		{
+			return mInstance;
+		}
+
+		assert(false);
+
+		return NULL;
+	}
+
+	void LevelArena::Destroy()
+	{
+		if (mInstance)
+		{
+			delete mInstance;
+			mInstance = NULL;
+		}
+	}
+
+	/******************************************************************************
+		Function     : Allocate
+		Description  : Takes level lifetime memory from the bottom of the region,
+					when the two ends meet the memory comes from the heap and
+					is freed by Reset
+		Input        : const size_t i_size, const unsigned long i_ulAlignment
+		Output       :
+		Return Value : void *
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void * LevelArena::Allocate(const size_t i_size, const unsigned long i_ulAlignment)
+	{
+		assert((i_ulAlignment != 0) && (0 == (i_ulAlignment & (i_ulAlignment - 1))));
+		assert(i_ulAlignment <= LEVEL_ARENA_MAX_ALIGNMENT);
+
+		unsigned long ulAlignment = (i_ulAlignment < DEFAULT_ALIGNMENT) ? DEFAULT_ALIGNMENT : i_ulAlignment;
+		unsigned long ulStart = (m_ulLevelUsed + ulAlignment - 1) & ~(ulAlignment - 1);
+		unsigned long ulTop = m_ulRegionBytes - m_ulTemporaryUsed;
+
+		if ((ulStart <= ulTop) && (i_size <= ulTop - ulStart))
+		{
+			m_ulLevelUsed = ulStart + i_size;
+			UpdateHighWaterMark();
+
+			return m_pRegion + ulStart;
+		}
+
+		return AllocateOverflow(m_pLevelOverflow, i_size, ulAlignment);
+	}
+
+	/******************************************************************************
+		Function     : StrDup
+		Description  : Copies the string into level lifetime memory
+		Input        : const char *i_pString
+		Output       :
+		Return Value : char *
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	char * LevelArena::StrDup(const char *i_pString)
+	{
+		assert(i_pString);
+
+		size_t Length = strlen(i_pString) + 1;
+		char *pCopy = static_cast<char *>(Allocate(Length, 1));
+
+		if (NULL != pCopy)
+		{
+			memcpy(pCopy, i_pString, Length);
+		}
+
+		return pCopy;
+	}
+
+	/******************************************************************************
+		Function     : AllocateTemporary
+		Description  : Takes load time memory from the top of the region, it is
+					released by RewindTemporaries
+		Input        : const size_t i_size, const unsigned long i_ulAlignment
+		Output       :
+		Return Value : void *
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void * LevelArena::AllocateTemporary(const size_t i_size, const unsigned long i_ulAlignment)
+	{
+		assert((i_ulAlignment != 0) && (0 == (i_ulAlignment & (i_ulAlignment - 1))));
+		assert(i_ulAlignment <= LEVEL_ARENA_MAX_ALIGNMENT);
+
+		unsigned long ulAlignment = (i_ulAlignment < DEFAULT_ALIGNMENT) ? DEFAULT_ALIGNMENT : i_ulAlignment;
+		unsigned long ulTop = m_ulRegionBytes - m_ulTemporaryUsed;
+
+		if ((i_size <= ulTop) && (((ulTop - i_size) & ~(ulAlignment - 1)) >= m_ulLevelUsed))
+		{
+			unsigned long ulStart = (ulTop - i_size) & ~(ulAlignment - 1);
+
+			m_ulTemporaryUsed = m_ulRegionBytes - ulStart;
+			UpdateHighWaterMark();
+
+			return m_pRegion + ulStart;
+		}
+
+		return AllocateOverflow(m_pTemporaryOverflow, i_size, ulAlignment);
+	}
+
+	void * LevelArena::AllocateOverflow(sOverflowBlock *&io_pOverflow, const size_t i_size, const unsigned long i_ulAlignment)
+	{
+		if (0 == m_ulOverflowCount)
+		{
+			CONSOLE_PRINT("Level arena of %d bytes is full, falling back to heap", m_ulRegionBytes);
+		}
+
+		m_ulOverflowCount++;
+
+		//Header is padded to the alignment so the user block stays aligned
+		unsigned long ulHeaderSize = (sizeof(sOverflowBlock) + i_ulAlignment - 1) & ~(i_ulAlignment - 1);
+		sOverflowBlock *pBlock = static_cast<sOverflowBlock *>(_aligned_malloc(ulHeaderSize + i_size, i_ulAlignment));
+
+		if (NULL == pBlock)
+		{
+			return NULL;
+		}
+
+		pBlock->m_pNext = io_pOverflow;
+		pBlock->m_pEnd = reinterpret_cast<char *>(pBlock) + ulHeaderSize + i_size;
+		io_pOverflow = pBlock;
+
+		return reinterpret_cast<char *>(pBlock) + ulHeaderSize;
+	}
+
+	//Frees the overflow blocks made after i_pKeep, which is NULL to free them all
+	void LevelArena::FreeOverflowBlocks(sOverflowBlock *&io_pOverflow, const sOverflowBlock *i_pKeep)
+	{
+		while ((NULL != io_pOverflow) && (i_pKeep != io_pOverflow))
+		{
+			sOverflowBlock *pNext = io_pOverflow->m_pNext;
+			_aligned_free(io_pOverflow);
+			io_pOverflow = pNext;
+		}
+	}
+
+	void LevelArena::UpdateHighWaterMark(void)
+	{
+		if (m_ulLevelUsed + m_ulTemporaryUsed > m_ulHighWaterMark)
+		{
+			m_ulHighWaterMark = m_ulLevelUsed + m_ulTemporaryUsed;
+		}
+	}
+
+	LevelArena::sMarker LevelArena::GetMarker(void) const
+	{
+		sMarker Marker = { m_ulLevelUsed, m_ulTemporaryUsed, m_pLevelOverflow, m_pTemporaryOverflow };
+		return Marker;
+	}
+
+	/******************************************************************************
+		Function     : RewindTemporaries
+		Description  : Frees every temporary allocated after the marker, level
+					data is kept
+		Input        : const sMarker &i_Marker
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void LevelArena::RewindTemporaries(const sMarker &i_Marker)
+	{
+		assert(i_Marker.m_ulTemporaryUsed <= m_ulTemporaryUsed);
+
+		m_ulTemporaryUsed = i_Marker.m_ulTemporaryUsed;
+		FreeOverflowBlocks(m_pTemporaryOverflow, i_Marker.m_pTemporaryOverflow);
+	}
+
+	/******************************************************************************
+		Function     : RewindToMarker
+		Description  : Frees everything allocated after the marker from both
+					ends, e.g. to throw away a level that failed to load
+		Input        : const sMarker &i_Marker
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void LevelArena::RewindToMarker(const sMarker &i_Marker)
+	{
+		assert(i_Marker.m_ulLevelUsed <= m_ulLevelUsed);
+
+		RewindTemporaries(i_Marker);
+
+		m_ulLevelUsed = i_Marker.m_ulLevelUsed;
+		FreeOverflowBlocks(m_pLevelOverflow, i_Marker.m_pLevelOverflow);
+	}
+
+	/******************************************************************************
+		Function     : Reset
+		Description  : Releases everything of the level in one go, call on level
+					unload once nothing points into the arena any more
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void LevelArena::Reset(void)
+	{
+		assert(0 == m_ulLoadDepth);
+
+		m_ulLevelUsed = 0;
+		m_ulTemporaryUsed = 0;
+
+		FreeOverflowBlocks(m_pLevelOverflow, NULL);
+		FreeOverflowBlocks(m_pTemporaryOverflow, NULL);
+	}
+
+	/******************************************************************************
+		Function     : BeginLevelLoad
+		Description  : Marks the start of a level load, strings that belong to
+					the level are taken from the arena until EndLevelLoad
+		Input        : void
+		Output       :
+		Return Value : sMarker, pass it to EndLevelLoad
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	LevelArena::sMarker LevelArena::BeginLevelLoad(void)
+	{
+		m_ulLoadDepth++;
+
+		return GetMarker();
+	}
+
+	void LevelArena::EndLevelLoad(const sMarker &i_Marker)
+	{
+		assert(m_ulLoadDepth > 0);
+
+		RewindTemporaries(i_Marker);
+		m_ulLoadDepth--;
+	}
+
+	bool LevelArena::IsLoadingLevel(void)
+	{
+		return (NULL != mInstance) && (mInstance->m_ulLoadDepth > 0);
+	}
+
+	/******************************************************************************
+		Function     : IsLevelData
+		Description  : Tells if the pointer is level lifetime memory of the
+					arena, such memory is never freed on its own
+		Input        : const void *i_pPointer
+		Output       :
+		Return Value : bool
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	bool LevelArena::IsLevelData(const void *i_pPointer)
+	{
+		if (NULL == mInstance)
+		{
+			return false;
+		}
+
+		const char *pAddress = static_cast<const char *>(i_pPointer);
+
+		if ((pAddress >= mInstance->m_pRegion) && (pAddress < mInstance->m_pRegion + mInstance->m_ulLevelUsed))
+		{
+			return true;
+		}
+
+		for (const sOverflowBlock *pBlock = mInstance->m_pLevelOverflow; NULL != pBlock; pBlock = pBlock->m_pNext)
+		{
+			if ((pAddress > reinterpret_cast<const char *>(pBlock)) && (pAddress < pBlock->m_pEnd))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	unsigned long LevelArena::GetLevelBytes(void) const
+	{
+		return m_ulLevelUsed;
+	}
+
+	unsigned long LevelArena::GetTemporaryBytes(void) const
+	{
+		return m_ulTemporaryUsed;
+	}
+
+	unsigned long LevelArena::GetHighWaterMark(void) const
+	{
+		return m_ulHighWaterMark;
+	}
+
+	unsigned long LevelArena::GetOverflowCount(void) const
+	{
+		return m_ulOverflowCount;
+	}
+
+	ePageBacking LevelArena::GetPageBacking(void) const
+	{
+		return m_eBacking;
+	}
+
+	/******************************************************************************
+		Function     : LevelArena_UnitTest
+		Description  : UnitTest function to test both ends of the LevelArena,
+					markers, rewinding and LevelLoadVector
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void LevelArena_UnitTest(void)
+	{
+	#ifdef _DEBUG
+		//Run before the game creates its own level arena
+		const unsigned long UTRegionBytes = 4096;
+
+		LevelArena::CreateInstance(UTRegionBytes);
+
+		LevelArena *pArena = LevelArena::GetInstance();
+		assert(false == LevelArena::IsLoadingLevel());
+
+		LevelArena::sMarker LoadMarker = pArena->BeginLevelLoad();
+		assert(LevelArena::IsLoadingLevel());
+
+		char *pName = pArena->StrDup("Player");
+		double *pTemporary = static_cast<double *>(pArena->AllocateTemporary(sizeof(double), __alignof(double)));
+		double *pAligned = static_cast<double *>(pArena->Allocate(sizeof(double), 16));
+
+		assert(0 == strcmp(pName, "Player"));
+		assert(0 == (reinterpret_cast<uintptr_t>(pTemporary) % __alignof(double)));
+		assert(0 == (reinterpret_cast<uintptr_t>(pAligned) % 16));
+		assert((pName < reinterpret_cast<char *>(pAligned)) && (reinterpret_cast<char *>(pAligned) < reinterpret_cast<char *>(pTemporary)));
+		*pTemporary = 1.0;
+		*pAligned = 2.0;
+
+		{
+			LevelLoadVector<LevelLoadString> UTStrings;
+
+			for (unsigned long i = 0; i < 16; i++)
+			{
+				UTStrings.push_back("A string that is too long for the small string buffer");
+			}
+
+			assert(UTStrings[15] == "A string that is too long for the small string buffer");
+		}
+
+		assert(LevelArena::IsLevelData(pName));
+		assert(false == LevelArena::IsLevelData(pTemporary));
+		assert(pArena->GetTemporaryBytes() > sizeof(double));
+
+		//The load ends, its temporaries go and the level data stays
+		unsigned long ulLevelBytes = pArena->GetLevelBytes();
+
+		pArena->EndLevelLoad(LoadMarker);
+		assert(false == LevelArena::IsLoadingLevel());
+		assert(0 == pArena->GetTemporaryBytes());
+		assert(pArena->GetLevelBytes() == ulLevelBytes);
+		assert(0 == strcmp(pName, "Player"));
+		assert(*pAligned == 2.0);
+
+		//When the ends meet the level data comes from the heap, it is still level data
+		LevelArena::sMarker Marker = pArena->GetMarker();
+
+		void *pFiller = pArena->AllocateTemporary(UTRegionBytes - ulLevelBytes);
+		assert(pFiller != NULL);
+		assert(0 == pArena->GetOverflowCount());
+
+		char *pOverflowName = pArena->StrDup("Overflow");
+		assert(pArena->GetOverflowCount() == 1);
+		assert(LevelArena::IsLevelData(pOverflowName));
+
+		pArena->RewindToMarker(Marker);
+		assert(false == LevelArena::IsLevelData(pOverflowName));
+		assert(pArena->GetLevelBytes() == ulLevelBytes);
+
+		//Level unload
+		pArena->Reset();
+		assert(0 == pArena->GetLevelBytes());
+		assert(false == LevelArena::IsLevelData(pName));
+		assert(pArena->GetHighWaterMark() == UTRegionBytes);
+
+		LevelArena::Destroy();
+		assert(false == LevelArena::IsLevelData(pName));
+	#endif
+	}
+}
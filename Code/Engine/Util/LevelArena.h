@@ -0,0 +1,139 @@
+#ifndef __LEVEL_ARENA_HEADER
+#define __LEVEL_ARENA_HEADER
+
+#include "PreCompiled.h"
+
+#include <string>
+#include <vector>
+
+#include "PageAllocator.h"
+
+namespace Engine
+{
+	//Double ended stack allocator for one level. Data that lives as long as the
+	//level is taken from the bottom of the region, temporaries of LoadLevel
+	//from the top, so the temporaries can be rewound while the level data
+	//stays. Everything is released at once by Reset when the level is
+	//unloaded. Main thread only.
+	class LevelArena
+	{
+		struct sOverflowBlock
+		{
+			sOverflowBlock	*m_pNext;
+			char			*m_pEnd;
+		};
+
+		char			*m_pRegion;
+		unsigned long	m_ulRegionBytes;
+		ePageBacking	m_eBacking;
+		unsigned long	m_ulLevelUsed;			//Bytes used from the bottom
+		unsigned long	m_ulTemporaryUsed;		//Bytes used from the top
+		unsigned long	m_ulHighWaterMark;		//Of both ends together
+		unsigned long	m_ulOverflowCount;
+		sOverflowBlock	*m_pLevelOverflow;		//Heap fallback when the two ends meet
+		sOverflowBlock	*m_pTemporaryOverflow;
+		unsigned long	m_ulLoadDepth;
+		bool			mInitilized;
+
+		static LevelArena * mInstance;
+
+		LevelArena(const unsigned long i_ulRegionBytes);
+		~LevelArena();
+		LevelArena(const LevelArena & i_Other);
+		LevelArena & operator=(const LevelArena & i_rhs);
+
+		void *AllocateOverflow(sOverflowBlock *&io_pOverflow, const size_t i_size, const unsigned long i_ulAlignment);
+		static void FreeOverflowBlocks(sOverflowBlock *&io_pOverflow, const sOverflowBlock *i_pKeep);
+		void UpdateHighWaterMark(void);
+
+	public:
+		//Position of both ends, rewinding to it frees everything allocated after
+		struct sMarker
+		{
+			unsigned long	m_ulLevelUsed;
+			unsigned long	m_ulTemporaryUsed;
+			sOverflowBlock	*m_pLevelOverflow;
+			sOverflowBlock	*m_pTemporaryOverflow;
+		};
+
+		static const unsigned long DEFAULT_REGION_BYTES = 4 * 1024 * 1024;
+		static const unsigned long DEFAULT_ALIGNMENT = 8;
+
+		static bool CreateInstance(const unsigned long i_ulRegionBytes = DEFAULT_REGION_BYTES);
+		static LevelArena * GetInstance();
+		static void Destroy();
+
+		void *Allocate(const size_t i_size, const unsigned long i_ulAlignment = DEFAULT_ALIGNMENT);
+		char *StrDup(const char *i_pString);
+		void *AllocateTemporary(const size_t i_size, const unsigned long i_ulAlignment = DEFAULT_ALIGNMENT);
+
+		sMarker GetMarker(void) const;
+		void RewindTemporaries(const sMarker &i_Marker);
+		void RewindToMarker(const sMarker &i_Marker);
+		void Reset(void);
+
+		sMarker BeginLevelLoad(void);
+		void EndLevelLoad(const sMarker &i_Marker);
+		static bool IsLoadingLevel(void);
+		static bool IsLevelData(const void *i_pPointer);
+
+		unsigned long GetLevelBytes(void) const;
+		unsigned long GetTemporaryBytes(void) const;
+		unsigned long GetHighWaterMark(void) const;
+		unsigned long GetOverflowCount(void) const;
+		ePageBacking GetPageBacking(void) const;
+	};
+
+	//STL allocator for the temporaries of a level load, deallocate does nothing
+	template<class T>
+	class LevelLoadAllocator
+	{
+	public:
+		typedef T				value_type;
+		typedef T*				pointer;
+		typedef const T*		const_pointer;
+		typedef T&				reference;
+		typedef const T&		const_reference;
+		typedef size_t			size_type;
+		typedef ptrdiff_t		difference_type;
+
+		template<class U>
+		struct rebind
+		{
+			typedef LevelLoadAllocator<U> other;
+		};
+
+		LevelLoadAllocator(void);
+		LevelLoadAllocator(const LevelLoadAllocator & i_Other);
+		template<class U>
+		LevelLoadAllocator(const LevelLoadAllocator<U> & i_Other);
+
+		pointer address(reference i_Value) const;
+		const_pointer address(const_reference i_Value) const;
+		pointer allocate(size_type i_Count, const void *i_pHint = NULL);
+		void deallocate(pointer i_pPointer, size_type i_Count);
+		size_type max_size(void) const;
+
+		template<class U, class... Args>
+		void construct(U *i_pPointer, Args&&... i_Args);
+		template<class U>
+		void destroy(U *i_pPointer);
+	};
+
+	template<class T, class U>
+	bool operator==(const LevelLoadAllocator<T> &, const LevelLoadAllocator<U> &);
+	template<class T, class U>
+	bool operator!=(const LevelLoadAllocator<T> &, const LevelLoadAllocator<U> &);
+
+	//Never keep one of these past the LoadLevel that made it
+	template<class T>
+	using LevelLoadVector = std::vector<T, LevelLoadAllocator<T>>;
+
+	typedef std::basic_string<char, std::char_traits<char>, LevelLoadAllocator<char>> LevelLoadString;
+
+	void LevelArena_UnitTest(void);
+}
+
+#include "LevelArena.inl"
+
+#endif //__LEVEL_ARENA_HEADER
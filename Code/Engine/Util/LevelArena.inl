@@ -0,0 +1,83 @@
+#include "PreCompiled.h"
+
+#include <limits>
+#include <new>
+#include <utility>
+
+namespace Engine
+{
+	template<class T>
+	inline LevelLoadAllocator<T>::LevelLoadAllocator(void)
+	{
+
+	}
+
+	template<class T>
+	inline LevelLoadAllocator<T>::LevelLoadAllocator(const LevelLoadAllocator & i_Other)
+	{
+
+	}
+
+	template<class T>
+	template<class U>
+	inline LevelLoadAllocator<T>::LevelLoadAllocator(const LevelLoadAllocator<U> & i_Other)
+	{
+
+	}
+
+	template<class T>
+	inline T * LevelLoadAllocator<T>::address(T & i_Value) const
+	{
+		return &i_Value;
+	}
+
+	template<class T>
+	inline const T * LevelLoadAllocator<T>::address(const T & i_Value) const
+	{
+		return &i_Value;
+	}
+
+	template<class T>
+	inline T * LevelLoadAllocator<T>::allocate(size_t i_Count, const void *i_pHint)
+	{
+		return static_cast<T *>(LevelArena::GetInstance()->AllocateTemporary(i_Count * sizeof(T), __alignof(T)));
+	}
+
+	template<class T>
+	inline void LevelLoadAllocator<T>::deallocate(T *i_pPointer, size_t i_Count)
+	{
+		//Released in bulk when the level load rewinds its temporaries
+	}
+
+	template<class T>
+	inline size_t LevelLoadAllocator<T>::max_size(void) const
+	{
+		return (std::numeric_limits<size_t>::max)() / sizeof(T);
+	}
+
+	template<class T>
+	template<class U, class... Args>
+	inline void LevelLoadAllocator<T>::construct(U *i_pPointer, Args&&... i_Args)
+	{
+		::new(static_cast<void *>(i_pPointer)) U(std::forward<Args>(i_Args)...);
+	}
+
+	template<class T>
+	template<class U>
+	inline void LevelLoadAllocator<T>::destroy(U *i_pPointer)
+	{
+		i_pPointer->~U();
+	}
+
+	template<class T, class U>
+	inline bool operator==(const LevelLoadAllocator<T> &, const LevelLoadAllocator<U> &)
+	{
+		return true;
+	}
+
+	template<class T, class U>
+	inline bool operator!=(const LevelLoadAllocator<T> &, const LevelLoadAllocator<U> &)
+	{
+		return false;
+	}
+}
@@ -0,0 +1,681 @@
+#include "PreCompiled.h"
+
+#include <string.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MagazineMemoryPool.h"
+#include "Debug.h"
+#include "HighResTime.h"
+
+namespace Engine
+{
+	struct sMagazine
+	{
+		void			*m_pSlots[MAX_MAGAZINE_SIZE];
+		unsigned long	m_ulCount;
+		unsigned long	m_ulAllocateHits;
+		unsigned long	m_ulAllocateMisses;
+		unsigned long	m_ulFreeHits;
+		unsigned long	m_ulFreeMisses;
+		unsigned long	m_ulPendingAllocations;		//Not yet added to the pool's totals
+		unsigned long	m_ulPendingFrees;
+		unsigned long	m_ulGeneration;				//Of the pool id the slots belong to
+	};
+
+	static THREAD_LOCAL sMagazine s_Magazines[MAX_MAGAZINE_POOLS];
+
+	//Live pools by id, for threads that exit without knowing which pools they used
+	static std::atomic<MagazineMemoryPool *> s_pPools[MAX_MAGAZINE_POOLS];
+
+	//Taken when a pool gets or gives back its id only
+	static std::mutex s_PoolIdMutex;
+
+	long MagazineMemoryPool::s_lNextPoolId = 0;
+	long MagazineMemoryPool::s_lFreePoolIds[MAX_MAGAZINE_POOLS];
+	long MagazineMemoryPool::s_lFreePoolIdCount = 0;
+	unsigned long MagazineMemoryPool::s_ulPoolIdGenerations[MAX_MAGAZINE_POOLS];
+
+	//The calling thread's magazine for the pool id. One left behind by a
+	//destroyed pool that had the id before is dropped, its slots were given
+	//back to the old pool's memory with the pool
+	static inline sMagazine & GetMagazine(const long i_lPoolId, const unsigned long i_ulGeneration)
+	{
+		sMagazine &Magazine = s_Magazines[i_lPoolId];
+
+		if (i_ulGeneration != Magazine.m_ulGeneration)
+		{
+			memset(&Magazine, 0, sizeof(Magazine));
+			Magazine.m_ulGeneration = i_ulGeneration;
+		}
+
+		return Magazine;
+	}
+
+	/******************************************************************************
+		Function     : MagazineMemoryPool
+		Description  : Constructor, takes a magazine id, one given back by a
+					destroyed pool first. When all ids are in use the pool still
+					works but every call goes to the shared pool
+		Input        : ConcurrentMemoryPool *i_pPool, const unsigned long i_ulMagazineSize
+		Output       :
+		Return Value :
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	MagazineMemoryPool::MagazineMemoryPool(ConcurrentMemoryPool *i_pPool, const unsigned long i_ulMagazineSize):
+		m_pPool(i_pPool),
+		m_ulMagazineSize(i_ulMagazineSize),
+		m_ulBatchSize((i_ulMagazineSize + 1) / 2),
+		m_lCachedCount(0),
+		m_ulAllocations(0),
+		m_ulFrees(0)
+	{
+		std::lock_guard<std::mutex> Lock(s_PoolIdMutex);
+
+		if (0 != s_lFreePoolIdCount)
+		{
+			m_lPoolId = s_lFreePoolIds[--s_lFreePoolIdCount];
+		}
+		else if (s_lNextPoolId < MAX_MAGAZINE_POOLS)
+		{
+			m_lPoolId = s_lNextPoolId++;
+		}
+		else
+		{
+			CONSOLE_PRINT("Out of magazine ids, %d pools are alive, this one will use the shared free list only", MAX_MAGAZINE_POOLS);
+			m_lPoolId = -1;
+			m_ulGeneration = 0;
+			return;
+		}
+
+		//Starts at 1, a magazine no thread has used yet is generation 0
+		m_ulGeneration = ++s_ulPoolIdGenerations[m_lPoolId];
+		s_pPools[m_lPoolId].store(this);
+	}
+
+	MagazineMemoryPool::~MagazineMemoryPool()
+	{
+		UnregisterStats();
+		FlushThreadMagazine();
+
+		if (-1 != m_lPoolId)
+		{
+			std::lock_guard<std::mutex> Lock(s_PoolIdMutex);
+
+			s_pPools[m_lPoolId].store(NULL);
+			s_lFreePoolIds[s_lFreePoolIdCount++] = m_lPoolId;
+		}
+
+		m_pPool->Destroy();
+	}
+
+	/******************************************************************************
+		Function     : Create
+		Description  : Static function to create a magazine memory pool
+		Input        : const unsigned long i_ulSize, const unsigned long i_ulItemsPerChunk,
+					const unsigned long i_ulMaxChunks, const unsigned long i_ulMagazineSize
+		Output       :
+		Return Value : MagazineMemoryPool *
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	MagazineMemoryPool * MagazineMemoryPool::Create
+	(
+		const unsigned long i_ulSize,
+		const unsigned long i_ulItemsPerChunk,
+		const unsigned long i_ulMaxChunks,
+		const unsigned long i_ulMagazineSize
+	)
+	{
+		if ((0 == i_ulMagazineSize) || (i_ulMagazineSize > MAX_MAGAZINE_SIZE))
+		{
+			CONSOLE_PRINT("Magazine size %d must be between 1 and %d", i_ulMagazineSize, MAX_MAGAZINE_SIZE);
+			return NULL;
+		}
+
+		ConcurrentMemoryPool *pPool = ConcurrentMemoryPool::Create(i_ulSize, i_ulItemsPerChunk, i_ulMaxChunks);
+
+		if (NULL == pPool)
+		{
+			return NULL;
+		}
+
+		return new MagazineMemoryPool(pPool, i_ulMagazineSize);
+	}
+
+	/******************************************************************************
+		Function     : Destroy
+		Description  : Flushes the calling thread's magazine and deletes the pool,
+					other threads must be done with it
+		Input        : void
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void MagazineMemoryPool::Destroy(void)
+	{
+		delete this;
+	}
+
+	/******************************************************************************
+		Function     : Allocate
+		Description  : Takes a slot from the thread's magazine, refills half a
+					magazine from the shared pool when it is empty
+		Input        : const size_t i_size
+		Output       :
+		Return Value : void *
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void * MagazineMemoryPool::Allocate(const size_t i_size)
+	{
+		if (-1 == m_lPoolId)
+		{
+			return m_pPool->Allocate(i_size);
+		}
+
+		sMagazine &Magazine = GetMagazine(m_lPoolId, m_ulGeneration);
+
+		if (0 == Magazine.m_ulCount)
+		{
+			Magazine.m_ulAllocateMisses++;
+			Magazine.m_ulCount = m_pPool->AllocateBatch(Magazine.m_pSlots, m_ulBatchSize);
+
+			if (0 == Magazine.m_ulCount)
+			{
+				return NULL;
+			}
+
+			m_ulAllocations.fetch_add(Magazine.m_ulPendingAllocations, std::memory_order_relaxed);
+			Magazine.m_ulPendingAllocations = 0;
+
+			m_lCachedCount.fetch_add(Magazine.m_ulCount, std::memory_order_relaxed);
+		}
+		else
+		{
+			Magazine.m_ulAllocateHits++;
+		}
+
+		m_lCachedCount.fetch_sub(1, std::memory_order_relaxed);
+		Magazine.m_ulPendingAllocations++;
+
+		void *pSlot = Magazine.m_pSlots[--Magazine.m_ulCount];
+		m_pPool->MarkAllocated(pSlot);
+
+		return pSlot;
+	}
+
+	/******************************************************************************
+		Function     : DeAllocate
+		Description  : Puts the slot in the thread's magazine, a full magazine
+					flushes its older half to the shared pool first
+		Input        : const void *pPointer
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void MagazineMemoryPool::DeAllocate(const void *pPointer)
+	{
+		assert(pPointer != NULL);
+
+		if (-1 == m_lPoolId)
+		{
+			m_pPool->DeAllocate(pPointer);
+			return;
+		}
+
+		sMagazine &Magazine = GetMagazine(m_lPoolId, m_ulGeneration);
+
+		m_pPool->MarkFreed(pPointer);
+
+		if (Magazine.m_ulCount == m_ulMagazineSize)
+		{
+			Magazine.m_ulFreeMisses++;
+
+			//Recently freed slots are at the top and likely still in cache, give back the bottom
+			m_pPool->DeAllocateBatch(Magazine.m_pSlots, m_ulBatchSize);
+			Magazine.m_ulCount -= m_ulBatchSize;
+			memmove(Magazine.m_pSlots, Magazine.m_pSlots + m_ulBatchSize, Magazine.m_ulCount * sizeof(void *));
+
+			m_lCachedCount.fetch_sub(m_ulBatchSize, std::memory_order_relaxed);
+			m_ulFrees.fetch_add(Magazine.m_ulPendingFrees, std::memory_order_relaxed);
+			Magazine.m_ulPendingFrees = 0;
+		}
+		else
+		{
+			Magazine.m_ulFreeHits++;
+		}
+
+		Magazine.m_pSlots[Magazine.m_ulCount++] = const_cast<void *>(pPointer);
+		m_lCachedCount.fetch_add(1, std::memory_order_relaxed);
+		Magazine.m_ulPendingFrees++;
+	}
+
+	/******************************************************************************
+		Function     : FlushThreadMagazine
+		Description  : Gives every slot in the calling thread's magazine back to
+					the shared pool. Worker threads call this before exiting.
+		Input        : void
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void MagazineMemoryPool::FlushThreadMagazine(void)
+	{
+		if (-1 == m_lPoolId)
+		{
+			return;
+		}
+
+		sMagazine &Magazine = GetMagazine(m_lPoolId, m_ulGeneration);
+
+		m_pPool->DeAllocateBatch(Magazine.m_pSlots, Magazine.m_ulCount);
+		m_lCachedCount.fetch_sub(Magazine.m_ulCount, std::memory_order_relaxed);
+		Magazine.m_ulCount = 0;
+
+		m_ulAllocations.fetch_add(Magazine.m_ulPendingAllocations, std::memory_order_relaxed);
+		m_ulFrees.fetch_add(Magazine.m_ulPendingFrees, std::memory_order_relaxed);
+		Magazine.m_ulPendingAllocations = 0;
+		Magazine.m_ulPendingFrees = 0;
+	}
+
+	/******************************************************************************
+		Function     : FlushAllThreadMagazines
+		Description  : FlushThreadMagazine on every live pool, for worker threads
+					that run jobs touching any pool. Pools must not be destroyed
+					while a thread is in here
+		Input        : void
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void MagazineMemoryPool::FlushAllThreadMagazines(void)
+	{
+		for (long lPoolId = 0; lPoolId < MAX_MAGAZINE_POOLS; lPoolId++)
+		{
+			MagazineMemoryPool *pPool = s_pPools[lPoolId].load();
+
+			if (NULL != pPool)
+			{
+				pPool->FlushThreadMagazine();
+			}
+		}
+	}
+
+	bool MagazineMemoryPool::Contains(const void *pPointer) const
+	{
+		return m_pPool->Contains(pPointer);
+	}
+
+	unsigned long MagazineMemoryPool::GetLiveCount(void) const
+	{
+		return m_pPool->GetLiveCount() - m_lCachedCount.load(std::memory_order_relaxed);
+	}
+
+	unsigned long MagazineMemoryPool::GetCapacity(void) const
+	{
+		return m_pPool->GetCapacity();
+	}
+
+	unsigned long MagazineMemoryPool::GetChunkCount(void) const
+	{
+		return m_pPool->GetChunkCount();
+	}
+
+	/******************************************************************************
+		Function     : GetThreadStats
+		Description  : Hit and miss counters of the calling thread's magazine
+		Input        : sMagazineStats &o_Stats
+		Output       : sMagazineStats &o_Stats
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void MagazineMemoryPool::GetThreadStats(sMagazineStats &o_Stats) const
+	{
+		memset(&o_Stats, 0, sizeof(o_Stats));
+
+		if (-1 == m_lPoolId)
+		{
+			return;
+		}
+
+		const sMagazine &Magazine = GetMagazine(m_lPoolId, m_ulGeneration);
+
+		o_Stats.m_ulAllocateHits = Magazine.m_ulAllocateHits;
+		o_Stats.m_ulAllocateMisses = Magazine.m_ulAllocateMisses;
+		o_Stats.m_ulFreeHits = Magazine.m_ulFreeHits;
+		o_Stats.m_ulFreeMisses = Magazine.m_ulFreeMisses;
+		o_Stats.m_ulCachedSlots = Magazine.m_ulCount;
+	}
+
+	void MagazineMemoryPool::PrintThreadStats(const char *i_pName) const
+	{
+		sMagazineStats Stats;
+		GetThreadStats(Stats);
+
+		DebugPrint("Magazine %s: Allocate hits: %lu	misses: %lu	|	Free hits: %lu	misses: %lu	|	Cached: %lu",
+			i_pName, Stats.m_ulAllocateHits, Stats.m_ulAllocateMisses, Stats.m_ulFreeHits, Stats.m_ulFreeMisses, Stats.m_ulCachedSlots);
+	}
+
+	/******************************************************************************
+		Function     : GetPoolStats
+		Description  : Fills the stats of this pool for the pool registry. Counts
+					kept in magazines are published on refill and flush, so the
+					totals can trail the live count by up to a magazine per thread.
+		Input        : sPoolStats &o_Stats
+		Output       : sPoolStats &o_Stats
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void MagazineMemoryPool::GetPoolStats(sPoolStats &o_Stats) const
+	{
+		m_pPool->GetPoolStats(o_Stats);
+
+		if (-1 == m_lPoolId)
+		{
+			return;
+		}
+
+		o_Stats.m_ulLiveCount = GetLiveCount();
+		o_Stats.m_ulAllocations = m_ulAllocations.load(std::memory_order_relaxed);
+		o_Stats.m_ulFrees = m_ulFrees.load(std::memory_order_relaxed);
+	}
+
+	/******************************************************************************
+		Function     : MagazineMemoryPool_UnitTest
+		Description  : Checks the hit/miss accounting, bounded hoarding and slots
+					freed by a different thread than the one that allocated them
+		Input        : void
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void MagazineMemoryPool_UnitTest(void)
+	{
+	#ifdef _DEBUG
+		static const unsigned long UTItemSize = 4 * sizeof(unsigned long);
+		static const unsigned long UTMagazineSize = 8;
+		static const unsigned long UTItemCount = 100;
+
+		MagazineMemoryPool *pUTPool = MagazineMemoryPool::Create(UTItemSize, 16, ConcurrentMemoryPool::DEFAULT_MAX_CHUNKS, UTMagazineSize);
+		assert(pUTPool != NULL);
+
+		std::vector<void *> UTSlots;
+		MagazineMemoryPool::sMagazineStats Stats;
+
+		for (unsigned long i = 0; i < UTItemCount; i++)
+		{
+			UTSlots.push_back(pUTPool->Allocate(UTItemSize));
+			assert(UTSlots[i] != NULL);
+		}
+
+		//Refills bring half a magazine
+		pUTPool->GetThreadStats(Stats);
+		assert(Stats.m_ulAllocateMisses == UTItemCount / (UTMagazineSize / 2));
+		assert(Stats.m_ulAllocateHits + Stats.m_ulAllocateMisses == UTItemCount);
+		assert(pUTPool->GetLiveCount() == UTItemCount);
+
+		unsigned long ulVisited = 0;
+
+		pUTPool->ForEachAllocated([&ulVisited](void *i_pSlot)
+		{
+			ulVisited++;
+		});
+
+		assert(ulVisited == UTItemCount);
+
+		for (unsigned long i = 0; i < UTItemCount; i++)
+		{
+			pUTPool->DeAllocate(UTSlots[i]);
+		}
+
+		//Never more than a magazine of free slots is kept by a thread
+		pUTPool->GetThreadStats(Stats);
+		assert(Stats.m_ulCachedSlots <= UTMagazineSize);
+		assert(Stats.m_ulFreeHits + Stats.m_ulFreeMisses == UTItemCount);
+		assert(pUTPool->GetLiveCount() == 0);
+
+		//Slots cached in the magazine are free as far as the walk is concerned
+		ulVisited = 0;
+
+		pUTPool->ForEachAllocated([&ulVisited](void *i_pSlot)
+		{
+			ulVisited++;
+		});
+
+		assert(ulVisited == 0);
+
+		//Allocated here, freed on a worker thread
+		for (unsigned long i = 0; i < UTItemCount; i++)
+		{
+			UTSlots[i] = pUTPool->Allocate(UTItemSize);
+			static_cast<unsigned long *>(UTSlots[i])[0] = i;
+		}
+
+		std::thread UTWorker([pUTPool, &UTSlots]()
+		{
+			for (unsigned long i = 0; i < UTItemCount; i++)
+			{
+				assert(static_cast<unsigned long *>(UTSlots[i])[0] == i);
+				pUTPool->DeAllocate(UTSlots[i]);
+			}
+
+			MagazineMemoryPool::sMagazineStats WorkerStats;
+			pUTPool->GetThreadStats(WorkerStats);
+			assert(WorkerStats.m_ulAllocateHits == 0);
+			assert(WorkerStats.m_ulFreeHits + WorkerStats.m_ulFreeMisses == UTItemCount);
+
+			pUTPool->FlushThreadMagazine();
+		});
+
+		UTWorker.join();
+
+		assert(pUTPool->GetLiveCount() == 0);
+
+		//Stress with every thread allocating and freeing through its own magazine
+		std::atomic<unsigned long> ulErrors(0);
+		std::vector<std::thread> UTThreads;
+
+		for (unsigned int uThread = 0; uThread < 4; uThread++)
+		{
+			UTThreads.push_back(std::thread([pUTPool, uThread, &ulErrors]()
+			{
+				unsigned long *pSlots[UTItemCount];
+
+				for (unsigned long ulRound = 0; ulRound < 200; ulRound++)
+				{
+					for (unsigned long i = 0; i < UTItemCount; i++)
+					{
+						pSlots[i] = static_cast<unsigned long *>(pUTPool->Allocate(UTItemSize));
+						pSlots[i][0] = uThread;
+						pSlots[i][1] = i;
+					}
+
+					for (unsigned long i = 0; i < UTItemCount; i++)
+					{
+						if ((pSlots[i][0] != uThread) || (pSlots[i][1] != i))
+						{
+							ulErrors++;
+						}
+
+						pUTPool->DeAllocate(pSlots[i]);
+					}
+				}
+
+				pUTPool->FlushThreadMagazine();
+			}));
+		}
+
+		for (unsigned int uThread = 0; uThread < UTThreads.size(); uThread++)
+		{
+			UTThreads[uThread].join();
+		}
+
+		assert(0 == ulErrors.load());
+		assert(pUTPool->GetLiveCount() == 0);
+
+		//A destroyed pool's id goes to the next pool, slots still in the
+		//magazine of a thread for the old pool are never handed out by it
+		void *pCached = pUTPool->Allocate(UTItemSize);
+		pUTPool->DeAllocate(pCached);
+		pUTPool->Destroy();
+
+		for (unsigned long ulPool = 0; ulPool < 2 * MAX_MAGAZINE_POOLS; ulPool++)
+		{
+			pUTPool = MagazineMemoryPool::Create(UTItemSize, 16, ConcurrentMemoryPool::DEFAULT_MAX_CHUNKS, UTMagazineSize);
+
+			pCached = pUTPool->Allocate(UTItemSize);
+			assert(true == pUTPool->Contains(pCached));
+
+			//Still gets a magazine after more pools than there are ids
+			pUTPool->DeAllocate(pCached);
+			assert(pCached == pUTPool->Allocate(UTItemSize));
+			pUTPool->GetThreadStats(Stats);
+			assert(1 == Stats.m_ulAllocateHits);
+
+			pUTPool->DeAllocate(pCached);
+			pUTPool->Destroy();
+		}
+	#endif
+	}
+
+	/******************************************************************************
+		Function     : MagazineMemoryPool_Benchmark
+		Description  : Allocate and free throughput of the shared pool alone and
+					with magazines from 1 to hardware thread count threads
+		Input        : void
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void MagazineMemoryPool_Benchmark(void)
+	{
+		static const unsigned long BenchItemSize = 32;
+		static const unsigned long BenchBatchSize = 16;
+		static const unsigned long BenchOpsPerThread = 1000000;
+		unsigned int uMaxThreads = std::thread::hardware_concurrency();
+
+		if (0 == uMaxThreads)
+		{
+			uMaxThreads = 1;
+		}
+
+		//Made once so every thread count runs on the same pools
+		ConcurrentMemoryPool *pSharedPool = ConcurrentMemoryPool::Create(BenchItemSize, uMaxThreads * BenchBatchSize);
+		MagazineMemoryPool *pMagazinePool = MagazineMemoryPool::Create(BenchItemSize, uMaxThreads * BenchBatchSize);
+
+		assert((pSharedPool != NULL) && (pMagazinePool != NULL));
+
+		for (unsigned int uThreadCount = 1; uThreadCount <= uMaxThreads; uThreadCount++)
+		{
+			double BenchMS[2];
+
+			for (unsigned int uPool = 0; uPool < 2; uPool++)
+			{
+				std::vector<std::thread> BenchThreads;
+
+				Tick BenchStart;
+				BenchStart.CalcCurrentTick();
+
+				for (unsigned int uThread = 0; uThread < uThreadCount; uThread++)
+				{
+					BenchThreads.push_back(std::thread([pSharedPool, pMagazinePool, uPool]()
+					{
+						void *pSlots[BenchBatchSize];
+
+						for (unsigned long ulOps = 0; ulOps < BenchOpsPerThread; ulOps += BenchBatchSize)
+						{
+							for (unsigned long i = 0; i < BenchBatchSize; i++)
+							{
+								pSlots[i] = (0 == uPool) ? pSharedPool->Allocate(BenchItemSize) : pMagazinePool->Allocate(BenchItemSize);
+							}
+
+							for (unsigned long i = 0; i < BenchBatchSize; i++)
+							{
+								if (0 == uPool)
+								{
+									pSharedPool->DeAllocate(pSlots[i]);
+								}
+								else
+								{
+									pMagazinePool->DeAllocate(pSlots[i]);
+								}
+							}
+						}
+
+						if (0 != uPool)
+						{
+							pMagazinePool->FlushThreadMagazine();
+						}
+					}));
+				}
+
+				for (unsigned int uThread = 0; uThread < uThreadCount; uThread++)
+				{
+					BenchThreads[uThread].join();
+				}
+
+				BenchMS[uPool] = BenchStart.GetTickDifferenceinMS();
+			}
+
+			DebugPrint("MagazineMemoryPool Benchmark: Threads: %u	|	Shared pool MS: %f	|	With magazines MS: %f", uThreadCount, BenchMS[0], BenchMS[1]);
+		}
+
+		pMagazinePool->Destroy();
+		pSharedPool->Destroy();
+	}
+}
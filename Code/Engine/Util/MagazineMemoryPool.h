@@ -0,0 +1,91 @@
+#ifndef __MAGAZINE_MEMORY_POOL_HEADER
+#define __MAGAZINE_MEMORY_POOL_HEADER
+
+#include "PreCompiled.h"
+
+#include <atomic>
+
+#include "ConcurrentMemoryPool.h"
+
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+#define MAX_MAGAZINE_POOLS	16
+#define MAX_MAGAZINE_SIZE	64
+
+namespace Engine
+{
+	//Per thread cache of free slots in front of a ConcurrentMemoryPool. Allocate
+	//and DeAllocate only touch the calling thread's magazine, the shared free
+	//list is hit once per refill or flush of half a magazine. A thread never
+	//holds more than the magazine size of free slots per pool. Magazine ids
+	//are reused after a pool is destroyed, a thread drops what its magazine
+	//still holds for the old pool the first time it touches the new one.
+	class MagazineMemoryPool : public IPoolStats
+	{
+	public:
+		struct sMagazineStats
+		{
+			unsigned long m_ulAllocateHits;
+			unsigned long m_ulAllocateMisses;		//Refills from the shared pool
+			unsigned long m_ulFreeHits;
+			unsigned long m_ulFreeMisses;			//Flushes to the shared pool
+			unsigned long m_ulCachedSlots;
+		};
+
+	private:
+		ConcurrentMemoryPool *m_pPool;
+		long m_lPoolId;							//Index of this pool's magazine in every thread, -1 if none
+		unsigned long m_ulGeneration;			//Of m_lPoolId, tells this pool's magazines from a destroyed one's
+		unsigned long m_ulMagazineSize;
+		unsigned long m_ulBatchSize;
+		std::atomic<long> m_lCachedCount;		//Free slots held in magazines of all threads
+		std::atomic<unsigned long> m_ulAllocations;	//Published by each thread on refill and flush
+		std::atomic<unsigned long> m_ulFrees;
+
+		static long s_lNextPoolId;				//Ids above this were never handed out
+		static long s_lFreePoolIds[MAX_MAGAZINE_POOLS];	//Ids given back by destroyed pools
+		static long s_lFreePoolIdCount;
+		static unsigned long s_ulPoolIdGenerations[MAX_MAGAZINE_POOLS];
+
+		MagazineMemoryPool(ConcurrentMemoryPool *i_pPool, const unsigned long i_ulMagazineSize);
+		~MagazineMemoryPool();
+		MagazineMemoryPool(const MagazineMemoryPool & i_Other);
+		MagazineMemoryPool & operator=(const MagazineMemoryPool & i_rhs);
+
+	public:
+		static const unsigned long DEFAULT_MAGAZINE_SIZE = 32;
+
+		static MagazineMemoryPool *Create(const unsigned long i_ulSize, const unsigned long i_ulItemsPerChunk,
+										  const unsigned long i_ulMaxChunks = ConcurrentMemoryPool::DEFAULT_MAX_CHUNKS,
+										  const unsigned long i_ulMagazineSize = DEFAULT_MAGAZINE_SIZE);
+		void Destroy(void);
+
+		void *Allocate(const size_t i_size);
+		void DeAllocate(const void *pPointer);
+		void FlushThreadMagazine(void);
+		static void FlushAllThreadMagazines(void);
+		bool Contains(const void *pPointer) const;
+
+		unsigned long GetLiveCount(void) const;
+		unsigned long GetCapacity(void) const;
+		unsigned long GetChunkCount(void) const;
+		void GetThreadStats(sMagazineStats &o_Stats) const;
+		void PrintThreadStats(const char *i_pName) const;
+		void GetPoolStats(sPoolStats &o_Stats) const;
+
+		//Slots cached in magazines are not visited, see ConcurrentMemoryPool::ForEachAllocated
+		template<class Function>
+		void ForEachAllocated(Function i_Function) const
+		{
+			m_pPool->ForEachAllocated(i_Function);
+		}
+	};
+
+	void MagazineMemoryPool_UnitTest(void);
+	void MagazineMemoryPool_Benchmark(void);
+}
+#endif //__MAGAZINE_MEMORY_POOL_HEADER
@@ -4,6 +4,7 @@
 #include <stdio.h>
 
 #include "Debug.h"
+#include "HighResTime.h"
 #include "MemoryPool.h"
 
 
@@ -13,7 +14,8 @@ namespace Engine
 		Function     : MemoryPool
 		Description  : Constructor for memory pool class, set the memory pool pointer and bitarray
 		Input        : char *i_MemoryPointer, BitArray *i_BitArray, const unsigned long i_ulSize, 
-					const unsigned long i_ulNumOfItems
+					const unsigned long i_ulNumOfItems, const bool i_bIsPlacementCreate,
+					const eAllocationMode i_eMode
 		Output       : 
 		Return Value : 
 		Data Accessed: 
@@ -29,15 +31,82 @@ namespace Engine
 		BitArray *i_BitArray, 
 		const unsigned long i_ulSize, 
 		const unsigned long i_ulNumOfItems,
-		const bool i_bIsPlacementCreate
+		const bool i_bIsPlacementCreate,
+		const eAllocationMode i_eMode
 	):
 		m_pMemoryPool(i_MemoryPointer),
 		m_BitArray(i_BitArray),
 		m_ulSize(i_ulSize), 
+		m_ulSlotSize(GetSlotSize(i_ulSize, i_eMode)),
 		m_ulNumOfItems(i_ulNumOfItems),
-		bIsPlacementCreate(i_bIsPlacementCreate)
+		m_pFreeListHead(NULL),
+		m_eMode(i_eMode),
+		m_eBacking(PAGE_BACKING_HEAP),
+		bIsPlacementCreate(i_bIsPlacementCreate),
+		m_ulLiveCount(0),
+		m_ulHighWaterMark(0),
+		m_ulAllocations(0),
+		m_ulFrees(0),
+		m_ulFailedAllocations(0)
 	{
+		if (FREE_LIST == m_eMode)
+		{
+			InitilizeFreeList();
+		}
+	}
+
+	/******************************************************************************
+		Function     : InitilizeFreeList
+		Description  : Links every slot of the pool into the free list, each free
+					slot stores the address of the next free slot in its first bytes
+		Input        : void
+		Output       : 
+		Return Value : void
+		Data Accessed: 
+		Data Updated : 
+ 
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void MemoryPool::InitilizeFreeList(void)
+	{
+		m_pFreeListHead = NULL;
 
+		//Link backwards so that the first allocation returns the lowest address
+		for (unsigned long ulCount = m_ulNumOfItems; ulCount > 0; ulCount--)
+		{
+			char *pSlot = m_pMemoryPool + (ulCount - 1) * m_ulSlotSize;
+
+			*reinterpret_cast<char **>(pSlot) = m_pFreeListHead;
+			m_pFreeListHead = pSlot;
+		}
+	}
+
+	/******************************************************************************
+		Function     : GetSlotSize
+		Description  : Returns the stride of one slot, free list slots must be big 
+					enough and aligned to hold the next pointer
+		Input        : const unsigned long i_ulSize, const eAllocationMode i_eMode
+		Output       : 
+		Return Value : unsigned long
+		Data Accessed: 
+		Data Updated : 
+ 
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	unsigned long MemoryPool::GetSlotSize(const unsigned long i_ulSize, const eAllocationMode i_eMode)
+	{
+		if (FREE_LIST != i_eMode)
+		{
+			return i_ulSize;
+		}
+
+		const unsigned long ulPointerSize = sizeof(char *);
+
+		return ((i_ulSize + ulPointerSize - 1) / ulPointerSize) * ulPointerSize;
 	}
 
 	/******************************************************************************
@@ -55,7 +124,7 @@ namespace Engine
 	******************************************************************************/
 	MemoryPool::~MemoryPool(void)
 	{
-	
+		UnregisterStats();
 	}
 
 	/******************************************************************************
@@ -87,14 +156,21 @@ namespace Engine
 		{
 			if (NULL != m_pMemoryPool)
 			{
-				delete [] m_pMemoryPool;
+				if (PAGE_BACKING_HEAP == m_eBacking)
+				{
+					delete [] m_pMemoryPool;
+				}
+				else
+				{
+					PageAllocator::Release(m_pMemoryPool, m_ulSlotSize * m_ulNumOfItems, m_eBacking);
+				}
 			}
 
 			delete this;
 		}
 		else
 		{
-			*o_ulOutPutLen += m_ulSize * m_ulNumOfItems + sizeof(MemoryPool);
+			*o_ulOutPutLen += m_ulSlotSize * m_ulNumOfItems + sizeof(MemoryPool);
 		
 			this->~MemoryPool();
 		}
@@ -103,9 +179,10 @@ namespace Engine
 	/******************************************************************************
 		Function     : Create
 		Description  : Static function to alllocate pool memory and create a new memory 
-					pool
+					pool, pools of at least a huge page get their slots from
+					the page allocator
 		Input        : const unsigned long i_ulSize, 
-					const unsigned long i_ulNumOfItems
+					const unsigned long i_ulNumOfItems, const eAllocationMode i_eMode
 		Output       : 
 		Return Value : MemoryPool * 
 		Data Accessed: 
@@ -118,10 +195,22 @@ namespace Engine
 	MemoryPool * MemoryPool::Create
 	(
 		const unsigned long i_ulSize, 
-		const unsigned long i_ulNumOfItems
+		const unsigned long i_ulNumOfItems,
+		const eAllocationMode i_eMode
 	)
 	{
-		char *pNewMemoryPool = new char[i_ulSize * i_ulNumOfItems];
+		unsigned long ulPoolBytes = GetSlotSize(i_ulSize, i_eMode) * i_ulNumOfItems;
+		ePageBacking eBacking = PAGE_BACKING_HEAP;
+		char *pNewMemoryPool = NULL;
+
+		if (ulPoolBytes >= PageAllocator::HUGE_PAGE_SIZE)
+		{
+			pNewMemoryPool = static_cast<char *>(PageAllocator::Reserve(ulPoolBytes, &eBacking));
+		}
+		else
+		{
+			pNewMemoryPool = new char[ulPoolBytes];
+		}
 
 		if(NULL == pNewMemoryPool)
 		{
@@ -130,16 +219,27 @@ namespace Engine
 
 		pNewMemoryPool[0] = '\0';
 
-		BitArray *pNewBitArray = BitArray::Create(i_ulNumOfItems);
 		bool bIsPlacementCreate = false;
+		BitArray *pNewBitArray = BitArray::Create(i_ulNumOfItems);
 
 		if (NULL == pNewBitArray)
 		{
-			delete [] pNewMemoryPool;
+			if (PAGE_BACKING_HEAP == eBacking)
+			{
+				delete [] pNewMemoryPool;
+			}
+			else
+			{
+				PageAllocator::Release(pNewMemoryPool, ulPoolBytes, eBacking);
+			}
+
 			return NULL;
 		}
 
-		return new MemoryPool(pNewMemoryPool, pNewBitArray, i_ulSize, i_ulNumOfItems, bIsPlacementCreate);
+		MemoryPool *pNewPool = new MemoryPool(pNewMemoryPool, pNewBitArray, i_ulSize, i_ulNumOfItems, bIsPlacementCreate, i_eMode);
+		pNewPool->m_eBacking = eBacking;
+
+		return pNewPool;
 	}
 
 	/******************************************************************************
@@ -147,7 +247,8 @@ namespace Engine
 		Description  : Static function to create pool memory with an existing
 					memory for Memory Manager
 		Input        : const unsigned long i_ulSize, 
-					const unsigned long i_ulNumOfItems
+					const unsigned long i_ulNumOfItems, unsigned long *o_pulUsed,
+					const eAllocationMode i_eMode
 		Output       : 
 		Return Value : MemoryPool * 
 		Data Accessed: 
@@ -162,7 +263,8 @@ namespace Engine
 		void * i_MemoryBlock,
 		const unsigned long i_ulSize, 
 		const unsigned long i_ulNumOfItems,
-		unsigned long *o_pulUsed
+		unsigned long *o_pulUsed,
+		const eAllocationMode i_eMode
 	)
 	{
 		if ((NULL == i_MemoryBlock) || (NULL == o_pulUsed))
@@ -181,11 +283,50 @@ namespace Engine
 
 		CONSOLE_PRINT("*Memory Used by BitArray: %d [%X]", *o_pulUsed, pMemPointer);
 
-		*o_pulUsed += i_ulSize * i_ulNumOfItems + sizeof(MemoryPool);
+		*o_pulUsed += GetSlotSize(i_ulSize, i_eMode) * i_ulNumOfItems + sizeof(MemoryPool);
+
+		assert(*o_pulUsed == GetRequiredMemorySize(i_ulSize, i_ulNumOfItems, i_eMode));
 		
 		CONSOLE_PRINT("*Total Memory Used By Memorymanager: %d", *o_pulUsed);
 
-		return new (reinterpret_cast<void *>(pMemPointer)) MemoryPool((reinterpret_cast<char *>(pMemPointer + sizeof(MemoryPool))), pBitArray, i_ulSize, i_ulNumOfItems, bIsPlacementCreate);
+		return new (reinterpret_cast<void *>(pMemPointer)) MemoryPool((reinterpret_cast<char *>(pMemPointer + sizeof(MemoryPool))), pBitArray, i_ulSize, i_ulNumOfItems, bIsPlacementCreate, i_eMode);
+	}
+
+	/******************************************************************************
+		Function     : GetRequiredMemorySize
+		Description  : Returns the bytes CreateFromExistingMemory will use for the
+					pool, so callers can reserve the block up front
+		Input        : const unsigned long i_ulSize, 
+					const unsigned long i_ulNumOfItems, const eAllocationMode i_eMode
+		Output       : 
+		Return Value : unsigned long
+		Data Accessed: 
+		Data Updated : 
+ 
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	unsigned long MemoryPool::GetRequiredMemorySize
+	(
+		const unsigned long i_ulSize, 
+		const unsigned long i_ulNumOfItems,
+		const eAllocationMode i_eMode
+	)
+	{
+		return GetSlotSize(i_ulSize, i_eMode) * i_ulNumOfItems + sizeof(MemoryPool) + BitArray::GetRequiredMemorySize(i_ulNumOfItems);
+	}
+
+	inline void * MemoryPool::OnAllocated(char *i_pSlot)
+	{
+		m_ulAllocations++;
+
+		if (++m_ulLiveCount > m_ulHighWaterMark)
+		{
+			m_ulHighWaterMark = m_ulLiveCount;
+		}
+
+		return i_pSlot;
 	}
 
 	/******************************************************************************
@@ -208,67 +349,136 @@ namespace Engine
 
 		//assert(i_size < (m_ulSize * m_ulNumOfItems));
 		assert(i_size == m_ulSize);
+
+		if (FREE_LIST == m_eMode)
+		{
+			if (NULL == m_pFreeListHead)
+			{
+				if (0 == m_ulFailedAllocations++)
+				{
+					CONSOLE_PRINT("Memory full, free list of %s is empty", GetPoolName());
+				}
+				return NULL;
+			}
+
+			char *pSlot = m_pFreeListHead;
+			m_pFreeListHead = *reinterpret_cast<char **>(pSlot);
+
+			m_BitArray->SetBit((pSlot - m_pMemoryPool) / m_ulSlotSize);
+			return OnAllocated(pSlot);
+		}
+
 		ulFirstFreeBit = m_BitArray->GetAndSetFirstFreeBitIndex();
 		
 		if (-1 == ulFirstFreeBit)
 		{
-			CONSOLE_PRINT("Memory full, cannot find free bit");
+			if (0 == m_ulFailedAllocations++)
+			{
+				CONSOLE_PRINT("Memory full, cannot find free bit in %s", GetPoolName());
+			}
 			return NULL;
 		}
-		void *ptr = m_pMemoryPool + ulFirstFreeBit * m_ulSize;
-		return ptr;
 
-	//this Memory pool doesnt work for array allocation
-	#if 0
-		if( 1 == (i_size / m_ulSize ))
+		return OnAllocated(m_pMemoryPool + ulFirstFreeBit * m_ulSlotSize);
+	}
+
+	/******************************************************************************
+		Function     : AllocateArray
+		Description  : Allocates i_ulCount consecutive slots, the run is found in
+					the bitarray a word at a time. Only bitarray scan pools
+					support arrays, free list slots are linked in any order,
+					a free list pool returns NULL.
+		Input        : const unsigned long i_ulCount, const eFitPolicy i_ePolicy
+		Output       : 
+		Return Value : void *, first slot of the run or NULL
+		Data Accessed: 
+		Data Updated : 
+ 
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void * MemoryPool::AllocateArray(const unsigned long i_ulCount, const eFitPolicy i_ePolicy)
+	{
+		assert(i_ulCount > 0);
+
+		//Free list mode keeps the free slots on the list as well, a run taken
+		//from the bitarray alone would be handed out again by Allocate
+		if (BITARRAY_SCAN != m_eMode)
 		{
-			assert(i_size == m_ulSize);
-			ulFirstFreeBit = m_BitArray->GetAndSetFirstFreeBitIndex();
-		
-			if (-1 == ulFirstFreeBit)
+			CONSOLE_PRINT("Cannot allocate %d slots in a row from free list pool %s", i_ulCount, GetPoolName());
+			m_ulFailedAllocations++;
+			return NULL;
+		}
+
+		long lFirstSlot = m_BitArray->FindFreeRun(i_ulCount, BEST_FIT == i_ePolicy);
+
+		if (-1 == lFirstSlot)
+		{
+			if (0 == m_ulFailedAllocations++)
 			{
-				CONSOLE_PRINT("Memory full, cannot find free bit");
-				return NULL;
+				CONSOLE_PRINT("Memory full, cannot find %d free slots in a row in %s", i_ulCount, GetPoolName());
 			}
-
-			return m_pMemoryPool + ulFirstFreeBit * i_size;
+			return NULL;
 		}
-		else
-		{
-			ulInputNumItems = (i_size / m_ulSize);
-			ulFirstFreeBit = m_BitArray->GetAndSetFirstFreeBitIndex();
-			
-			unsigned long ulCount;
 
-			for(ulCount = ulFirstFreeBit; ulCount < (m_ulNumOfItems - ulInputNumItems); ulCount++)
-			{
-				unsigned long ulInnerCountCount;
-				for( ulInnerCountCount= ulCount; ulInnerCountCount < ulInputNumItems; ulInnerCountCount++)
-				{
-					if (true == m_BitArray->CheckBit(ulCount))
-					{
-						break;
-					}
-				}
+		m_BitArray->SetBitRange(lFirstSlot, i_ulCount);
 
-				if(ulInnerCountCount != ulInputNumItems)
-				{
-					continue;
-				}
+		//Stats count slots, an array of N slots is N allocations
+		m_ulAllocations += i_ulCount;
+		m_ulLiveCount += i_ulCount;
 
-				for(ulInnerCountCount= ulCount; ulInnerCountCount < ulInputNumItems; ulInnerCountCount++)
-				{
-					m_BitArray->SetBit(ulInnerCountCount);
-				}
+		if (m_ulLiveCount > m_ulHighWaterMark)
+		{
+			m_ulHighWaterMark = m_ulLiveCount;
+		}
 
-				return m_pMemoryPool + ulCount * i_size;
-			}
+		return m_pMemoryPool + lFirstSlot * m_ulSlotSize;
+	}
+
+	/******************************************************************************
+		Function     : DeAllocateArray
+		Description  : Frees a run of slots from AllocateArray
+		Input        : const void *pPointer, const unsigned long i_ulCount (as
+					passed to AllocateArray)
+		Output       : 
+		Return Value : void
+		Data Accessed: 
+		Data Updated : 
+ 
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void MemoryPool::DeAllocateArray(const void *pPointer, const unsigned long i_ulCount)
+	{
+		assert(pPointer != NULL);
+		assert(true == Contains(pPointer));
+
+		if (BITARRAY_SCAN != m_eMode)
+		{
+			CONSOLE_PRINT("Free list pool %s has no arrays to free", GetPoolName());
+			return;
 		}
 
-		CONSOLE_PRINT("Memory full, cannot find free bit for the array");
-		return NULL;
+		const char *pSlot = static_cast<const char *>(pPointer);
+		unsigned long ulIndex = static_cast<unsigned long>((pSlot - m_pMemoryPool) / m_ulSlotSize);
+
+		assert(pSlot == (m_pMemoryPool + ulIndex * m_ulSlotSize));
+		assert((ulIndex + i_ulCount) <= m_ulNumOfItems);
+
+	#ifdef MEMORY_POOL_DOUBLE_FREE_CHECK
+		if (false == m_BitArray->IsBitRangeSet(ulIndex, i_ulCount))
+		{
+			CONSOLE_PRINT("Double free of memory pool slots %d to %d", ulIndex, ulIndex + i_ulCount - 1);
+			assert(false);
+			return;
+		}
 	#endif
 
+		m_BitArray->ClearBitRange(ulIndex, i_ulCount);
+		m_ulLiveCount -= i_ulCount;
+		m_ulFrees += i_ulCount;
 	}
 
 	/******************************************************************************
@@ -287,16 +497,444 @@ namespace Engine
 	void MemoryPool::DeAllocate(const void *pPointer)
 	{
 		assert(pPointer !=NULL);
+		assert(true == Contains(pPointer));
+
+		//Slot index comes straight from the offset into the pool
+		const char *pSlot = static_cast<const char *>(pPointer);
+		unsigned long ulIndex = static_cast<unsigned long>((pSlot - m_pMemoryPool) / m_ulSlotSize);
+
+		assert(pSlot == (m_pMemoryPool + ulIndex * m_ulSlotSize));
+
+		if (FREE_LIST == m_eMode)
+		{
+		#ifdef MEMORY_POOL_DOUBLE_FREE_CHECK
+			if (false == m_BitArray->CheckBit(ulIndex))
+			{
+				CONSOLE_PRINT("Double free of memory pool slot %d", ulIndex);
+				assert(false);
+				return;
+			}
+		#endif
+
+			m_BitArray->ClearSetBit(ulIndex);
+			char *pFreeSlot = m_pMemoryPool + ulIndex * m_ulSlotSize;
+
+			*reinterpret_cast<char **>(pFreeSlot) = m_pFreeListHead;
+			m_pFreeListHead = pFreeSlot;
+			m_ulLiveCount--;
+			m_ulFrees++;
+			return;
+		}
+
+		m_BitArray->ClearSetBit(ulIndex);
+		m_ulLiveCount--;
+		m_ulFrees++;
+
+		return;
+	}
+
+	/******************************************************************************
+		Function     : DeAllocateLinearScan
+		Description  : The old free, compares the pointer against every slot until
+					it matches. Only kept so MemoryPool_Benchmark can compare
+					against it, DeAllocate finds the slot from the offset.
+		Input        : const void *pPointer
+		Output       : 
+		Return Value : void  
+		Data Accessed: 
+		Data Updated : 
+ 
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void MemoryPool::DeAllocateLinearScan(const void *pPointer)
+	{
+		assert(pPointer != NULL);
+		assert(BITARRAY_SCAN == m_eMode);
 
 		for (unsigned long ulCount = 0; ulCount < m_ulNumOfItems; ulCount++)
 		{
-			if(pPointer == (m_pMemoryPool + ulCount * m_ulSize))
+			if (pPointer == (m_pMemoryPool + ulCount * m_ulSlotSize))
 			{
 				m_BitArray->ClearSetBit(ulCount);
+				m_ulLiveCount--;
+				m_ulFrees++;
 				break;
 			}
 		}
 
 		return;
 	}
+
+	/******************************************************************************
+		Function     : Contains
+		Description  : Returns true if the pointer belongs to this memory pool
+		Input        : const void *pPointer
+		Output       : 
+		Return Value : bool
+		Data Accessed: 
+		Data Updated : 
+ 
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	bool MemoryPool::Contains(const void *pPointer) const
+	{
+		const char *pSlot = static_cast<const char *>(pPointer);
+
+		if ((pSlot >= m_pMemoryPool) && (pSlot < (m_pMemoryPool + m_ulSlotSize * m_ulNumOfItems)))
+		{
+			return true;
+		}
+
+		return false;
+	}
+
+	/******************************************************************************
+		Function     : GetPoolStats
+		Description  : Fills the stats of this pool for the pool registry
+		Input        : sPoolStats &o_Stats
+		Output       : sPoolStats &o_Stats
+		Return Value : void
+		Data Accessed: 
+		Data Updated : 
+ 
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void MemoryPool::GetPoolStats(sPoolStats &o_Stats) const
+	{
+		memset(&o_Stats, 0, sizeof(o_Stats));
+
+		o_Stats.m_ulSlotSize = m_ulSize;
+		o_Stats.m_ulCapacity = m_ulNumOfItems;
+		o_Stats.m_ulLiveCount = m_ulLiveCount;
+		o_Stats.m_ulHighWaterMark = m_ulHighWaterMark;
+		o_Stats.m_ulAllocations = m_ulAllocations;
+		o_Stats.m_ulFrees = m_ulFrees;
+		o_Stats.m_ulFailedAllocations = m_ulFailedAllocations;
+		o_Stats.m_eBacking = m_eBacking;
+	}
+
+	//Pools created in existing memory report the backing of the block they sit in
+	void MemoryPool::SetPageBacking(const ePageBacking i_eBacking)
+	{
+		m_eBacking = i_eBacking;
+	}
+
+	/******************************************************************************
+		Function     : GetStartAddress
+		Description  : Returns the address of the first slot
+		Input        : void
+		Output       : 
+		Return Value : const char *
+		Data Accessed: 
+		Data Updated : 
+ 
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	const char * MemoryPool::GetStartAddress(void) const
+	{
+		return m_pMemoryPool;
+	}
+
+	/******************************************************************************
+		Function     : GetEndAddress
+		Description  : Returns the address one past the last slot
+		Input        : void
+		Output       : 
+		Return Value : const char *
+		Data Accessed: 
+		Data Updated : 
+ 
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	const char * MemoryPool::GetEndAddress(void) const
+	{
+		return m_pMemoryPool + m_ulSlotSize * m_ulNumOfItems;
+	}
+
+	/******************************************************************************
+		Function     : MemoryPool_UnitTest
+		Description  : UnitTest function to test both allocation modes of MemoryPool
+					and array allocation
+		Input        : void
+		Output       : 
+		Return Value : void
+		Data Accessed: 
+		Data Updated : 
+ 
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void MemoryPool_UnitTest(void)
+	{
+	#ifdef _DEBUG
+		const unsigned long UTItemSize = 12;
+		const unsigned long UTItemCount = 100;
+		const MemoryPool::eAllocationMode Modes[] = { MemoryPool::BITARRAY_SCAN, MemoryPool::FREE_LIST };
+
+		for (unsigned int uMode = 0; uMode < (sizeof(Modes) / sizeof(Modes[0])); uMode++)
+		{
+			void *UTPointers[UTItemCount];
+			MemoryPool *pUTPool = MemoryPool::Create(UTItemSize, UTItemCount, Modes[uMode]);
+
+			assert(pUTPool != NULL);
+
+			for (unsigned long i = 0; i < UTItemCount; i++)
+			{
+				UTPointers[i] = pUTPool->Allocate(UTItemSize);
+				assert(UTPointers[i] != NULL);
+				assert(pUTPool->Contains(UTPointers[i]));
+				memset(UTPointers[i], 0xCD, UTItemSize);
+			}
+
+			assert(pUTPool->Allocate(UTItemSize) == NULL);
+
+			//Free every other slot and make sure the same slots come back
+			for (unsigned long i = 0; i < UTItemCount; i += 2)
+			{
+				pUTPool->DeAllocate(UTPointers[i]);
+			}
+
+			//The odd slots are still live and come back in address order
+			const char *pLastVisited = NULL;
+			unsigned long ulVisited = 0;
+
+			pUTPool->ForEachAllocated([&](void *i_pSlot)
+			{
+				assert((NULL == pLastVisited) || (static_cast<const char *>(i_pSlot) > pLastVisited));
+				bool bFound = false;
+
+				for (unsigned long j = 1; j < UTItemCount; j += 2)
+				{
+					if (UTPointers[j] == i_pSlot)
+					{
+						bFound = true;
+					}
+				}
+
+				assert(bFound == true);
+
+				pLastVisited = static_cast<const char *>(i_pSlot);
+				ulVisited++;
+			});
+
+			assert(ulVisited == UTItemCount / 2);
+
+			for (unsigned long i = 0; i < UTItemCount; i += 2)
+			{
+				void *pReused = pUTPool->Allocate(UTItemSize);
+				bool bFound = false;
+
+				for (unsigned long j = 0; j < UTItemCount; j += 2)
+				{
+					if (UTPointers[j] == pReused)
+					{
+						bFound = true;
+					}
+				}
+
+				assert(bFound == true);
+			}
+
+			assert(pUTPool->Allocate(UTItemSize) == NULL);
+
+			for (unsigned long i = 0; i < UTItemCount; i++)
+			{
+				pUTPool->DeAllocate(UTPointers[i]);
+			}
+
+			//Arrays are refused by a free list pool, in release builds as well
+			if (MemoryPool::FREE_LIST == Modes[uMode])
+			{
+				assert(pUTPool->AllocateArray(2) == NULL);
+			}
+
+			unsigned long ulOutputLength = 0;
+			pUTPool->Destroy(&ulOutputLength);
+		}
+
+		//Arrays take consecutive slots of a bitarray scan pool
+		const unsigned long UTArrayItemCount = 200;
+		MemoryPool *pUTArrayPool = MemoryPool::Create(UTItemSize, UTArrayItemCount, MemoryPool::BITARRAY_SCAN);
+		assert(pUTArrayPool != NULL);
+
+		char *pFirstArray = static_cast<char *>(pUTArrayPool->AllocateArray(70));
+		char *pSingle = static_cast<char *>(pUTArrayPool->Allocate(UTItemSize));
+		char *pSecondArray = static_cast<char *>(pUTArrayPool->AllocateArray(10));
+		char *pThirdArray = static_cast<char *>(pUTArrayPool->AllocateArray(100));
+
+		assert((pFirstArray != NULL) && (pSingle != NULL) && (pSecondArray != NULL) && (pThirdArray != NULL));
+		assert(pFirstArray == pUTArrayPool->GetStartAddress());
+		assert(pSingle == pFirstArray + 70 * UTItemSize);
+		assert(pSecondArray == pSingle + UTItemSize);
+		assert(pThirdArray == pSecondArray + 10 * UTItemSize);
+		memset(pFirstArray, 0xAB, 70 * UTItemSize);
+		memset(pThirdArray, 0xCD, 100 * UTItemSize);
+
+		//19 slots are left at the end, more than that does not fit anywhere
+		assert(pUTArrayPool->AllocateArray(20) == NULL);
+
+		sPoolStats ArrayStats;
+		pUTArrayPool->GetPoolStats(ArrayStats);
+		assert(ArrayStats.m_ulLiveCount == 181);
+		assert(ArrayStats.m_ulFailedAllocations == 1);
+
+		//Holes of 70 and 10 slots before the 19 at the end
+		pUTArrayPool->DeAllocateArray(pFirstArray, 70);
+		pUTArrayPool->DeAllocateArray(pSecondArray, 10);
+
+		assert(pUTArrayPool->AllocateArray(8, MemoryPool::FIRST_FIT) == pFirstArray);
+		pUTArrayPool->DeAllocateArray(pFirstArray, 8);
+		assert(pUTArrayPool->AllocateArray(8, MemoryPool::BEST_FIT) == pSecondArray);
+		assert(pUTArrayPool->AllocateArray(15, MemoryPool::BEST_FIT) == pThirdArray + 100 * UTItemSize);
+		pUTArrayPool->DeAllocateArray(pSecondArray, 8);
+		pUTArrayPool->DeAllocateArray(pThirdArray + 100 * UTItemSize, 15);
+
+		//Freeing the single slot joins the holes around it
+		pUTArrayPool->DeAllocate(pSingle);
+		assert(pUTArrayPool->AllocateArray(81, MemoryPool::BEST_FIT) == pFirstArray);
+		pUTArrayPool->DeAllocateArray(pFirstArray, 81);
+		pUTArrayPool->DeAllocateArray(pThirdArray, 100);
+
+		pUTArrayPool->GetPoolStats(ArrayStats);
+		assert(ArrayStats.m_ulLiveCount == 0);
+		assert(ArrayStats.m_ulHighWaterMark == 181);
+		assert(pUTArrayPool->AllocateArray(UTArrayItemCount) == pUTArrayPool->GetStartAddress());
+
+		unsigned long ulArrayOutputLength = 0;
+		pUTArrayPool->Destroy(&ulArrayOutputLength);
+
+		//Pools of at least a huge page take their slots from the page allocator
+		const unsigned long UTLargeItemCount = PageAllocator::HUGE_PAGE_SIZE / UTItemSize;
+		sPoolStats Stats;
+
+		MemoryPool *pUTLargePool = MemoryPool::Create(UTItemSize, UTLargeItemCount);
+		assert(pUTLargePool != NULL);
+
+		pUTLargePool->GetPoolStats(Stats);
+		assert(Stats.m_eBacking != PAGE_BACKING_HEAP);
+
+		void *pLast = NULL;
+
+		for (unsigned long i = 0; i < UTLargeItemCount; i++)
+		{
+			pLast = pUTLargePool->Allocate(UTItemSize);
+			assert(pLast != NULL);
+		}
+
+		memset(pLast, 0, UTItemSize);
+
+		unsigned long ulLargeOutputLength = 0;
+		pUTLargePool->Destroy(&ulLargeOutputLength);
+	#endif
+	}
+
+	/******************************************************************************
+		Function     : MemoryPool_Benchmark
+		Description  : Times a full allocate and free cycle at 100, 10k and 1M slots
+					for the old linear scan free, bitarray scan mode and free
+					list mode
+		Input        : void
+		Output       : 
+		Return Value : void
+		Data Accessed: 
+		Data Updated : 
+ 
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void MemoryPool_Benchmark(void)
+	{
+		const unsigned long BenchItemSize = 32;
+		const unsigned long BenchItemCounts[] = { 100, 10000, 1000000 };
+		const unsigned long BenchMaxLinearScanFrees = 10000;	//The old free is O(n), all 1M of them would take hours
+		const MemoryPool::eAllocationMode Modes[] = { MemoryPool::BITARRAY_SCAN, MemoryPool::BITARRAY_SCAN, MemoryPool::FREE_LIST };
+		const bool LinearScanFree[] = { true, false, false };
+		const char *ModeNames[] = { "LinearScanFree", "BitArrayScan", "FreeList" };
+
+		for (unsigned int uCount = 0; uCount < (sizeof(BenchItemCounts) / sizeof(BenchItemCounts[0])); uCount++)
+		{
+			const unsigned long ulItemCount = BenchItemCounts[uCount];
+			void **pPointers = new void*[ulItemCount];
+
+			for (unsigned int uMode = 0; uMode < (sizeof(Modes) / sizeof(Modes[0])); uMode++)
+			{
+				MemoryPool *pBenchPool = MemoryPool::Create(BenchItemSize, ulItemCount, Modes[uMode]);
+
+				assert(pBenchPool != NULL);
+
+				Tick AllocateStart;
+				AllocateStart.CalcCurrentTick();
+
+				for (unsigned long i = 0; i < ulItemCount; i++)
+				{
+					pPointers[i] = pBenchPool->Allocate(BenchItemSize);
+				}
+
+				double AllocateMS = AllocateStart.GetTickDifferenceinMS();
+				double FreeMS;
+
+				if (true == LinearScanFree[uMode])
+				{
+					//Time every stride-th free spread over the pool and scale up,
+					//the rest is given back through the normal free untimed
+					const unsigned long ulStride = (ulItemCount > BenchMaxLinearScanFrees) ? (ulItemCount / BenchMaxLinearScanFrees) : 1;
+
+					Tick FreeStart;
+					FreeStart.CalcCurrentTick();
+
+					for (unsigned long i = 0; i < ulItemCount; i += ulStride)
+					{
+						pBenchPool->DeAllocateLinearScan(pPointers[i]);
+					}
+
+					FreeMS = FreeStart.GetTickDifferenceinMS() * ulStride;
+
+					for (unsigned long i = 0; i < ulItemCount; i++)
+					{
+						if (0 != (i % ulStride))
+						{
+							pBenchPool->DeAllocate(pPointers[i]);
+						}
+					}
+
+					if (ulStride > 1)
+					{
+						DebugPrint("MemoryPool Benchmark %s: Slots: %lu	|	Free MS scaled up from every %lu th free", ModeNames[uMode], ulItemCount, ulStride);
+					}
+				}
+				else
+				{
+					Tick FreeStart;
+					FreeStart.CalcCurrentTick();
+
+					//Free in reverse order so the next bitarray scan starts from a full pool
+					for (unsigned long i = ulItemCount; i > 0; i--)
+					{
+						pBenchPool->DeAllocate(pPointers[i - 1]);
+					}
+
+					FreeMS = FreeStart.GetTickDifferenceinMS();
+				}
+
+				DebugPrint("MemoryPool Benchmark %s: Slots: %lu	|	Allocate MS: %f	|	Free MS: %f", ModeNames[uMode], ulItemCount, AllocateMS, FreeMS);
+
+				unsigned long ulOutputLength = 0;
+				pBenchPool->Destroy(&ulOutputLength);
+			}
+
+			delete [] pPointers;
+		}
+	}
 }
\ No newline at end of file
@@ -5,36 +5,89 @@
 
 
 #include "BitArray.h"
+#include "PoolStats.h"
 
+//Free list mode keeps the bitarray for ForEachAllocated, debug builds also
+//check it to catch double frees
+#if defined(_DEBUG)
+#define MEMORY_POOL_DOUBLE_FREE_CHECK
+#endif
 
 namespace Engine
 {
-	class MemoryPool
+	class MemoryPool : public IPoolStats
 	{
+	public:
+		enum eAllocationMode
+		{
+			BITARRAY_SCAN,		//Find free slot by scanning the bitarray
+			FREE_LIST			//Free slots are linked through their own memory, O(1) allocate and free
+		};
+
+		//Which run of free slots AllocateArray takes
+		enum eFitPolicy
+		{
+			FIRST_FIT,			//Lowest run that is long enough
+			BEST_FIT			//Shortest run that is long enough, keeps long runs for long arrays
+		};
+
+	private:
 		unsigned long m_ulSize;
+		unsigned long m_ulSlotSize;
 		unsigned long m_ulNumOfItems;
 		BitArray *m_BitArray;
 		char *m_pMemoryPool;
+		char *m_pFreeListHead;
+		eAllocationMode m_eMode;
+		ePageBacking m_eBacking;
 		bool bIsPlacementCreate;
-		MemoryPool(char *i_MemoryPointer, BitArray *i_BitArray, const unsigned long i_ulSize, 
-				   const unsigned long i_ulNumOfItems, const bool i_bIsPlacementCreate);
+		unsigned long m_ulLiveCount;
+		unsigned long m_ulHighWaterMark;
+		unsigned long m_ulAllocations;
+		unsigned long m_ulFrees;
+		unsigned long m_ulFailedAllocations;
+		MemoryPool(char *i_MemoryPointer, BitArray *i_BitArray, const unsigned long i_ulSize,
+				   const unsigned long i_ulNumOfItems, const bool i_bIsPlacementCreate,
+				   const eAllocationMode i_eMode);
 		~MemoryPool();
+
+		void InitilizeFreeList(void);
+		inline void *OnAllocated(char *i_pSlot);
+		static unsigned long GetSlotSize(const unsigned long i_ulSize, const eAllocationMode i_eMode);
+		void DeAllocateLinearScan(const void *pPointer);
+
+		friend void MemoryPool_Benchmark(void);
 	public:
-	
-		static MemoryPool *Create(const unsigned long ulSize, const unsigned long ulNumOfItems);
 
-		static MemoryPool *CreateFromExistingMemory(void * i_MemoryBlock,	const unsigned long i_ulSize, 
-												  const unsigned long i_ulNumOfItems, unsigned long *o_pulUsed);
+		static MemoryPool *Create(const unsigned long ulSize, const unsigned long ulNumOfItems,
+								  const eAllocationMode i_eMode = FREE_LIST);
+
+		static MemoryPool *CreateFromExistingMemory(void * i_MemoryBlock,	const unsigned long i_ulSize,
+												  const unsigned long i_ulNumOfItems, unsigned long *o_pulUsed,
+												  const eAllocationMode i_eMode = FREE_LIST);
+
+		static unsigned long GetRequiredMemorySize(const unsigned long i_ulSize, const unsigned long i_ulNumOfItems,
+												   const eAllocationMode i_eMode = FREE_LIST);
 
 		void Destroy(unsigned long *o_ulOutPutLen);
 
 		void *Allocate(const size_t i_size);
 		void DeAllocate(const void *pPointer);
+		void *AllocateArray(const unsigned long i_ulCount, const eFitPolicy i_ePolicy = FIRST_FIT);
+		void DeAllocateArray(const void *pPointer, const unsigned long i_ulCount);
+		bool Contains(const void *pPointer) const;
+		const char *GetStartAddress(void) const;
+		const char *GetEndAddress(void) const;
+		void GetPoolStats(sPoolStats &o_Stats) const;
+		void SetPageBacking(const ePageBacking i_eBacking);
+
+		template<class Function>
+		void ForEachAllocated(Function i_Function) const;
 
 		inline void * operator new(size_t i_size)
 		{
 			return malloc(i_size);
-		} 
+		}
 
 		inline void operator delete(void * i_ptr)
 		{
@@ -47,12 +100,18 @@ namespace Engine
 		inline void * operator new(size_t i_size, void * i_Where)
 		{
 			return i_Where;
-		} 
+		}
 
 		inline void operator delete(void * i_ptr, void * i_Where)
 		{
 			return;
 		}
 	};
+
+	void MemoryPool_UnitTest(void);
+	void MemoryPool_Benchmark(void);
 }
-#endif //__MEMORY_POOL_HEADER
\ No newline at end of file
+
+#include "MemoryPool.inl"
+
+#endif //__MEMORY_POOL_HEADER
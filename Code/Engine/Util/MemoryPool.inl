@@ -0,0 +1,30 @@
+namespace Engine
+{
+	/******************************************************************************
+		Function     : ForEachAllocated
+		Description  : Calls i_Function with every allocated slot in address order,
+					walking the set bits of the bitarray. The function may free
+					the slot it is given, slots allocated by it may or may not
+					be visited. Each slot of an array is visited on its own.
+		Input        : Function i_Function, called as i_Function(void *)
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	template<class Function>
+	void MemoryPool::ForEachAllocated(Function i_Function) const
+	{
+		char *pMemoryPool = m_pMemoryPool;
+		unsigned long ulSlotSize = m_ulSlotSize;
+
+		m_BitArray->ForEachSetBit([&i_Function, pMemoryPool, ulSlotSize](unsigned long i_ulIndex)
+		{
+			i_Function(static_cast<void *>(pMemoryPool + i_ulIndex * ulSlotSize));
+		});
+	}
+}
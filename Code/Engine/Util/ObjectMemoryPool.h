@@ -0,0 +1,23 @@
+#ifndef __OBJECT_MEMORY_POOL_HEADER
+#define __OBJECT_MEMORY_POOL_HEADER
+
+#include "PreCompiled.h"
+
+#include "ChunkedMemoryPool.h"
+#include "MagazineMemoryPool.h"
+
+//Pool behind the operator new/delete of Actor and the system objects.
+//Comment out to go back to the single threaded ChunkedMemoryPool, which
+//also gives empty chunks back to the OS. The thread safe pool is the lock
+//free ConcurrentMemoryPool with per thread magazines in front of it.
+#define THREAD_SAFE_OBJECT_POOLS
+
+namespace Engine
+{
+#ifdef THREAD_SAFE_OBJECT_POOLS
+	typedef MagazineMemoryPool ObjectMemoryPool;
+#else
+	typedef ChunkedMemoryPool ObjectMemoryPool;
+#endif
+}
+#endif //__OBJECT_MEMORY_POOL_HEADER
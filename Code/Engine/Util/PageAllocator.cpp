@@ -0,0 +1,239 @@
+#include "PreCompiled.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "PageAllocator.h"
+#include "Debug.h"
+
+//Alignment of blocks on platforms without a page level allocator
+#define PAGE_FALLBACK_ALIGNMENT	64
+
+namespace Engine
+{
+	const unsigned long PageAllocator::HUGE_PAGE_SIZE;
+
+#if defined(__linux__)
+	//Blocks that may get huge pages are mapped in whole huge pages, Reserve and
+	//Release must agree on the length
+	static unsigned long GetMappedSize(const unsigned long i_ulBytes)
+	{
+	#ifdef USE_HUGE_PAGES
+		if (i_ulBytes >= PageAllocator::HUGE_PAGE_SIZE)
+		{
+			return (i_ulBytes + PageAllocator::HUGE_PAGE_SIZE - 1) & ~(PageAllocator::HUGE_PAGE_SIZE - 1);
+		}
+	#endif
+
+		return i_ulBytes;
+	}
+
+	static void * MapPages(const unsigned long i_ulBytes, const int i_iExtraFlags)
+	{
+		void *pBlock = mmap(NULL, i_ulBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | i_iExtraFlags, -1, 0);
+
+		return (MAP_FAILED == pBlock) ? NULL : pBlock;
+	}
+
+	//Transparent huge pages only back whole aligned huge pages, map one extra
+	//huge page and trim the ends so the block starts on a boundary
+	static void * MapHugePageAligned(const unsigned long i_ulBytes)
+	{
+		unsigned long ulOverMapped = i_ulBytes + PageAllocator::HUGE_PAGE_SIZE;
+		char *pMapped = static_cast<char *>(MapPages(ulOverMapped, 0));
+
+		if (NULL == pMapped)
+		{
+			return NULL;
+		}
+
+		uintptr_t Start = reinterpret_cast<uintptr_t>(pMapped);
+		uintptr_t AlignedStart = (Start + PageAllocator::HUGE_PAGE_SIZE - 1) & ~static_cast<uintptr_t>(PageAllocator::HUGE_PAGE_SIZE - 1);
+		char *pBlock = reinterpret_cast<char *>(AlignedStart);
+
+		unsigned long ulHead = static_cast<unsigned long>(pBlock - pMapped);
+		unsigned long ulTail = ulOverMapped - ulHead - i_ulBytes;
+
+		if (ulHead > 0)
+		{
+			munmap(pMapped, ulHead);
+		}
+
+		if (ulTail > 0)
+		{
+			munmap(pBlock + i_ulBytes, ulTail);
+		}
+
+		return pBlock;
+	}
+#endif
+
+	/******************************************************************************
+		Function     : Reserve
+		Description  : Gets a block straight from the OS. On Linux a block of at
+					least one huge page tries explicit huge pages first, then
+					a normal mapping advised for transparent huge pages, then
+					plain normal pages.
+		Input        : const unsigned long i_ulBytes, ePageBacking *o_peBacking
+		Output       : ePageBacking *o_peBacking, backing that was obtained
+		Return Value : void *, NULL if the OS is out of memory
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void * PageAllocator::Reserve(const unsigned long i_ulBytes, ePageBacking *o_peBacking)
+	{
+		assert(o_peBacking != NULL);
+
+		*o_peBacking = PAGE_BACKING_OS_PAGES;
+
+	#if defined(_WIN32)
+		//Large pages need the lock pages privilege, which the game does not have
+		return VirtualAlloc(NULL, i_ulBytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	#elif defined(__linux__)
+		unsigned long ulMappedBytes = GetMappedSize(i_ulBytes);
+		void *pBlock = NULL;
+
+	#ifdef USE_HUGE_PAGES
+		if (i_ulBytes >= HUGE_PAGE_SIZE)
+		{
+		#ifdef MAP_HUGETLB
+			pBlock = MapPages(ulMappedBytes, MAP_HUGETLB);
+
+			if (NULL != pBlock)
+			{
+				*o_peBacking = PAGE_BACKING_HUGE_PAGES;
+				return pBlock;
+			}
+		#endif
+
+			pBlock = MapHugePageAligned(ulMappedBytes);
+
+		#ifdef MADV_HUGEPAGE
+			if ((NULL != pBlock) && (0 == madvise(pBlock, ulMappedBytes, MADV_HUGEPAGE)))
+			{
+				*o_peBacking = PAGE_BACKING_TRANSPARENT_HUGE_PAGES;
+			}
+		#endif
+
+			if (NULL != pBlock)
+			{
+				return pBlock;
+			}
+		}
+	#endif
+
+		pBlock = MapPages(ulMappedBytes, 0);
+
+		if (NULL == pBlock)
+		{
+			CONSOLE_PRINT("Failed to map %lu bytes", ulMappedBytes);
+		}
+
+		return pBlock;
+	#else
+		*o_peBacking = PAGE_BACKING_HEAP;
+		return _aligned_malloc(i_ulBytes, PAGE_FALLBACK_ALIGNMENT);
+	#endif
+	}
+
+	/******************************************************************************
+		Function     : Release
+		Description  : Gives a block from Reserve back to the OS
+		Input        : void *i_pBlock, const unsigned long i_ulBytes (as passed
+					to Reserve), const ePageBacking i_eBacking
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void PageAllocator::Release(void *i_pBlock, const unsigned long i_ulBytes, const ePageBacking i_eBacking)
+	{
+		if (NULL == i_pBlock)
+		{
+			return;
+		}
+
+	#if defined(_WIN32)
+		VirtualFree(i_pBlock, 0, MEM_RELEASE);
+	#elif defined(__linux__)
+		munmap(i_pBlock, GetMappedSize(i_ulBytes));
+	#else
+		_aligned_free(i_pBlock);
+	#endif
+	}
+
+	const char * PageAllocator::GetBackingName(const ePageBacking i_eBacking)
+	{
+		switch (i_eBacking)
+		{
+		case PAGE_BACKING_HEAP:
+			return "Heap";
+		case PAGE_BACKING_OS_PAGES:
+			return "Pages";
+		case PAGE_BACKING_TRANSPARENT_HUGE_PAGES:
+			return "THP";
+		case PAGE_BACKING_HUGE_PAGES:
+			return "Huge pages";
+		case PAGE_BACKING_MIXED:
+			return "Mixed";
+		}
+
+		return "Unknown";
+	}
+
+	/******************************************************************************
+		Function     : PageAllocator_UnitTest
+		Description  : UnitTest function to test reserving and releasing small
+					and huge page sized blocks
+		Input        : void
+		Output       :
+		Return Value : void
+		Data Accessed:
+		Data Updated :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void PageAllocator_UnitTest(void)
+	{
+	#ifdef _DEBUG
+		const unsigned long UTSmallBytes = 4096;
+		const unsigned long UTLargeBytes = PageAllocator::HUGE_PAGE_SIZE * 2 + 1;
+
+		ePageBacking eSmallBacking;
+		ePageBacking eLargeBacking;
+
+		char *pSmall = static_cast<char *>(PageAllocator::Reserve(UTSmallBytes, &eSmallBacking));
+		char *pLarge = static_cast<char *>(PageAllocator::Reserve(UTLargeBytes, &eLargeBacking));
+
+		assert((pSmall != NULL) && (pLarge != NULL));
+
+		//Blocks smaller than a huge page never get huge pages
+		assert((PAGE_BACKING_HUGE_PAGES != eSmallBacking) && (PAGE_BACKING_TRANSPARENT_HUGE_PAGES != eSmallBacking));
+		assert(PAGE_BACKING_MIXED != eLargeBacking);
+
+		//Every byte asked for is usable
+		memset(pSmall, 0xAB, UTSmallBytes);
+		memset(pLarge, 0xCD, UTLargeBytes);
+		assert((pSmall[UTSmallBytes - 1] == static_cast<char>(0xAB)) && (pLarge[UTLargeBytes - 1] == static_cast<char>(0xCD)));
+
+		CONSOLE_PRINT("Huge page test block backed by %s", PageAllocator::GetBackingName(eLargeBacking));
+
+		PageAllocator::Release(pSmall, UTSmallBytes, eSmallBacking);
+		PageAllocator::Release(pLarge, UTLargeBytes, eLargeBacking);
+	#endif
+	}
+}
@@ -0,0 +1,35 @@
+#ifndef __PAGE_ALLOCATOR_HEADER
+#define __PAGE_ALLOCATOR_HEADER
+
+#include "PreCompiled.h"
+
+//Lets large pool and arena reservations ask the OS for huge pages on Linux,
+//first explicit MAP_HUGETLB pages, then transparent huge pages. Comment out
+//to always use normal pages.
+#define USE_HUGE_PAGES
+
+namespace Engine
+{
+	//Where the memory behind a pool or arena came from
+	enum ePageBacking
+	{
+		PAGE_BACKING_HEAP,						//Operator new or malloc
+		PAGE_BACKING_OS_PAGES,					//Normal pages straight from the OS
+		PAGE_BACKING_TRANSPARENT_HUGE_PAGES,	//Normal mapping the kernel was asked to back with huge pages
+		PAGE_BACKING_HUGE_PAGES,				//Explicit huge pages
+		PAGE_BACKING_MIXED						//Pool made of blocks with different backings
+	};
+
+	class PageAllocator
+	{
+	public:
+		static const unsigned long HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+		static void *Reserve(const unsigned long i_ulBytes, ePageBacking *o_peBacking);
+		static void Release(void *i_pBlock, const unsigned long i_ulBytes, const ePageBacking i_eBacking);
+		static const char *GetBackingName(const ePageBacking i_eBacking);
+	};
+
+	void PageAllocator_UnitTest(void);
+}
+#endif //__PAGE_ALLOCATOR_HEADER
@@ -0,0 +1,335 @@
+#include "PreCompiled.h"
+
+#include <atomic>
+#include <string.h>
+
+#include "PoolStats.h"
+#include "MemoryPool.h"
+#include "Debug.h"
+
+namespace Engine
+{
+	static IPoolStats *s_pFirstPool = NULL;
+	static std::atomic_flag s_RegistryLock = ATOMIC_FLAG_INIT;
+
+	static void LockRegistry(void)
+	{
+		while (s_RegistryLock.test_and_set(std::memory_order_acquire))
+		{
+		}
+	}
+
+	static void UnlockRegistry(void)
+	{
+		s_RegistryLock.clear(std::memory_order_release);
+	}
+
+	IPoolStats::IPoolStats(void):
+		m_pPoolName(NULL),
+		m_pNextPool(NULL),
+		m_pPrevPool(NULL),
+		m_bRegistered(false),
+		m_ulFrameStartAllocations(0),
+		m_ulFrameStartFrees(0),
+		m_ulLastFrameAllocations(0),
+		m_ulLastFrameFrees(0),
+		m_ulSampledHighWaterMark(0)
+	{
+
+	}
+
+	IPoolStats::~IPoolStats()
+	{
+		UnregisterStats();
+	}
+
+	/******************************************************************************
+		Function     : RegisterStats
+		Description  : Names the pool and adds it to the registry, the name must
+					outlive the pool
+		Input        : const char *i_pName
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void IPoolStats::RegisterStats(const char *i_pName)
+	{
+		assert(i_pName);
+
+		LockRegistry();
+
+		m_pPoolName = i_pName;
+
+		if (false == m_bRegistered)
+		{
+			m_pPrevPool = NULL;
+			m_pNextPool = s_pFirstPool;
+
+			if (NULL != s_pFirstPool)
+			{
+				s_pFirstPool->m_pPrevPool = this;
+			}
+
+			s_pFirstPool = this;
+			m_bRegistered = true;
+		}
+
+		UnlockRegistry();
+	}
+
+	/******************************************************************************
+		Function     : UnregisterStats
+		Description  : Removes the pool from the registry. Pools call this first
+					thing in their destructor so a registry walk never sees a
+					half destroyed pool.
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void IPoolStats::UnregisterStats(void)
+	{
+		LockRegistry();
+
+		if (m_bRegistered)
+		{
+			if (NULL != m_pPrevPool)
+			{
+				m_pPrevPool->m_pNextPool = m_pNextPool;
+			}
+			else
+			{
+				s_pFirstPool = m_pNextPool;
+			}
+
+			if (NULL != m_pNextPool)
+			{
+				m_pNextPool->m_pPrevPool = m_pPrevPool;
+			}
+
+			m_pNextPool = NULL;
+			m_pPrevPool = NULL;
+			m_bRegistered = false;
+		}
+
+		UnlockRegistry();
+	}
+
+	const char * IPoolStats::GetPoolName(void) const
+	{
+		return (NULL == m_pPoolName) ? "Unnamed pool" : m_pPoolName;
+	}
+
+	/******************************************************************************
+		Function     : EndFrame
+		Description  : Takes the allocations and frees of the frame that just
+					ended for every registered pool and samples its live count
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void PoolRegistry::EndFrame(void)
+	{
+		sPoolStats Stats;
+
+		LockRegistry();
+
+		for (IPoolStats *pPool = s_pFirstPool; NULL != pPool; pPool = pPool->m_pNextPool)
+		{
+			pPool->GetPoolStats(Stats);
+
+			pPool->m_ulLastFrameAllocations = Stats.m_ulAllocations - pPool->m_ulFrameStartAllocations;
+			pPool->m_ulLastFrameFrees = Stats.m_ulFrees - pPool->m_ulFrameStartFrees;
+			pPool->m_ulFrameStartAllocations = Stats.m_ulAllocations;
+			pPool->m_ulFrameStartFrees = Stats.m_ulFrees;
+
+			if (Stats.m_ulLiveCount > pPool->m_ulSampledHighWaterMark)
+			{
+				pPool->m_ulSampledHighWaterMark = Stats.m_ulLiveCount;
+			}
+		}
+
+		UnlockRegistry();
+	}
+
+	unsigned long PoolRegistry::GetPoolCount(void)
+	{
+		unsigned long ulCount = 0;
+
+		LockRegistry();
+
+		for (IPoolStats *pPool = s_pFirstPool; NULL != pPool; pPool = pPool->m_pNextPool)
+		{
+			ulCount++;
+		}
+
+		UnlockRegistry();
+
+		return ulCount;
+	}
+
+	/******************************************************************************
+		Function     : GetAllPoolStats
+		Description  : Copies the stats of up to i_ulMaxPools registered pools
+		Input        : sPoolStats *o_pStats, const unsigned long i_ulMaxPools
+		Output       : sPoolStats *o_pStats
+		Return Value : unsigned long, number of pools written
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	unsigned long PoolRegistry::GetAllPoolStats(sPoolStats *o_pStats, const unsigned long i_ulMaxPools)
+	{
+		unsigned long ulCount = 0;
+
+		LockRegistry();
+
+		for (IPoolStats *pPool = s_pFirstPool; (NULL != pPool) && (ulCount < i_ulMaxPools); pPool = pPool->m_pNextPool)
+		{
+			sPoolStats &Stats = o_pStats[ulCount++];
+
+			pPool->GetPoolStats(Stats);
+
+			Stats.m_pName = pPool->GetPoolName();
+			Stats.m_ulFrameAllocations = pPool->m_ulLastFrameAllocations;
+			Stats.m_ulFrameFrees = pPool->m_ulLastFrameFrees;
+
+			if (Stats.m_ulHighWaterMark < pPool->m_ulSampledHighWaterMark)
+			{
+				Stats.m_ulHighWaterMark = pPool->m_ulSampledHighWaterMark;
+			}
+		}
+
+		UnlockRegistry();
+
+		return ulCount;
+	}
+
+	void PoolRegistry::PrintStats(void)
+	{
+		static const unsigned long MaxPrintedPools = 64;
+		sPoolStats Stats[MaxPrintedPools];
+
+		unsigned long ulCount = GetAllPoolStats(Stats, MaxPrintedPools);
+
+		for (unsigned long i = 0; i < ulCount; i++)
+		{
+			DebugPrint("Pool %s: Slot: %lu	|	Live: %lu / %lu	|	Peak: %lu	|	Allocations: %lu	|	Frees: %lu	|	Last frame: +%lu -%lu	|	Failed: %lu	|	Backing: %s",
+				Stats[i].m_pName, Stats[i].m_ulSlotSize, Stats[i].m_ulLiveCount, Stats[i].m_ulCapacity, Stats[i].m_ulHighWaterMark,
+				Stats[i].m_ulAllocations, Stats[i].m_ulFrees, Stats[i].m_ulFrameAllocations, Stats[i].m_ulFrameFrees, Stats[i].m_ulFailedAllocations,
+				PageAllocator::GetBackingName(Stats[i].m_eBacking));
+		}
+	}
+
+#ifdef _DEBUG
+	static bool FindPoolStats(const char *i_pName, sPoolStats &o_Stats)
+	{
+		static const unsigned long MaxTestedPools = 64;
+		sPoolStats Stats[MaxTestedPools];
+
+		unsigned long ulCount = PoolRegistry::GetAllPoolStats(Stats, MaxTestedPools);
+
+		for (unsigned long i = 0; i < ulCount; i++)
+		{
+			if (0 == strcmp(Stats[i].m_pName, i_pName))
+			{
+				o_Stats = Stats[i];
+				return true;
+			}
+		}
+
+		return false;
+	}
+#endif
+
+	/******************************************************************************
+		Function     : PoolStats_UnitTest
+		Description  : Checks registration, live and peak counts, per frame rates
+					and failed allocations of a registered pool
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void PoolStats_UnitTest(void)
+	{
+	#ifdef _DEBUG
+		static const unsigned long UTItemSize = sizeof(unsigned long);
+		static const unsigned long UTItemCount = 10;
+		static const char *UTPoolName = "PoolStats unit test";
+
+		unsigned long ulPoolsBefore = PoolRegistry::GetPoolCount();
+		unsigned long ulOutputLength = 0;
+		void *UTSlots[UTItemCount];
+		sPoolStats Stats;
+
+		MemoryPool *pUTPool = MemoryPool::Create(UTItemSize, UTItemCount);
+		assert(pUTPool != NULL);
+
+		//Pools are not reported until they are named
+		assert(PoolRegistry::GetPoolCount() == ulPoolsBefore);
+		pUTPool->RegisterStats(UTPoolName);
+		assert(PoolRegistry::GetPoolCount() == ulPoolsBefore + 1);
+
+		PoolRegistry::EndFrame();
+
+		for (unsigned long i = 0; i < UTItemCount; i++)
+		{
+			UTSlots[i] = pUTPool->Allocate(UTItemSize);
+			assert(UTSlots[i] != NULL);
+		}
+
+		//Pool is full
+		assert(pUTPool->Allocate(UTItemSize) == NULL);
+
+		for (unsigned long i = 0; i < UTItemCount / 2; i++)
+		{
+			pUTPool->DeAllocate(UTSlots[i]);
+		}
+
+		PoolRegistry::EndFrame();
+
+		assert(FindPoolStats(UTPoolName, Stats));
+		assert(Stats.m_ulCapacity == UTItemCount);
+		assert(Stats.m_ulLiveCount == UTItemCount - UTItemCount / 2);
+		assert(Stats.m_ulHighWaterMark == UTItemCount);
+		assert(Stats.m_ulFailedAllocations == 1);
+		assert(Stats.m_ulFrameAllocations == UTItemCount);
+		assert(Stats.m_ulFrameFrees == UTItemCount / 2);
+		assert(Stats.m_eBacking == PAGE_BACKING_HEAP);
+
+		//A frame without traffic reports no rate but keeps the peak
+		PoolRegistry::EndFrame();
+
+		assert(FindPoolStats(UTPoolName, Stats));
+		assert(Stats.m_ulFrameAllocations == 0);
+		assert(Stats.m_ulFrameFrees == 0);
+		assert(Stats.m_ulHighWaterMark == UTItemCount);
+		assert(Stats.m_ulAllocations == UTItemCount);
+
+		for (unsigned long i = UTItemCount / 2; i < UTItemCount; i++)
+		{
+			pUTPool->DeAllocate(UTSlots[i]);
+		}
+
+		pUTPool->Destroy(&ulOutputLength);
+
+		assert(PoolRegistry::GetPoolCount() == ulPoolsBefore);
+		assert(false == FindPoolStats(UTPoolName, Stats));
+	#endif
+	}
+}
@@ -0,0 +1,69 @@
+#ifndef __POOL_STATS_HEADER
+#define __POOL_STATS_HEADER
+
+#include "PreCompiled.h"
+
+#include "PageAllocator.h"
+
+namespace Engine
+{
+	//Snapshot of one pool as reported by the PoolRegistry
+	struct sPoolStats
+	{
+		const char		*m_pName;
+		unsigned long	m_ulSlotSize;
+		unsigned long	m_ulCapacity;
+		unsigned long	m_ulLiveCount;
+		unsigned long	m_ulHighWaterMark;
+		unsigned long	m_ulAllocations;			//Since the pool was created
+		unsigned long	m_ulFrees;
+		unsigned long	m_ulFailedAllocations;
+		unsigned long	m_ulFrameAllocations;		//During the last completed frame
+		unsigned long	m_ulFrameFrees;
+		ePageBacking	m_eBacking;					//Memory the slots live in
+	};
+
+	//Base of every pool that can report to the PoolRegistry. Registered pools
+	//form an intrusive list, so registering never allocates and works for pools
+	//that sit under the global operator new.
+	class IPoolStats
+	{
+		const char		*m_pPoolName;
+		IPoolStats		*m_pNextPool;
+		IPoolStats		*m_pPrevPool;
+		bool			m_bRegistered;
+		unsigned long	m_ulFrameStartAllocations;
+		unsigned long	m_ulFrameStartFrees;
+		unsigned long	m_ulLastFrameAllocations;
+		unsigned long	m_ulLastFrameFrees;
+		unsigned long	m_ulSampledHighWaterMark;	//For pools that cannot track their peak exactly
+
+		friend class PoolRegistry;
+
+	protected:
+		IPoolStats(void);
+		virtual ~IPoolStats();
+
+	public:
+		void RegisterStats(const char *i_pName);
+		void UnregisterStats(void);
+		const char *GetPoolName(void) const;
+
+		//Fills everything except the name and the per frame counts. A pool that
+		//does not track its peak leaves the high-water mark at 0, the registry
+		//then reports the peak live count seen at the end of a frame.
+		virtual void GetPoolStats(sPoolStats &o_Stats) const = 0;
+	};
+
+	class PoolRegistry
+	{
+	public:
+		static void EndFrame(void);
+		static unsigned long GetPoolCount(void);
+		static unsigned long GetAllPoolStats(sPoolStats *o_pStats, const unsigned long i_ulMaxPools);
+		static void PrintStats(void);
+	};
+
+	void PoolStats_UnitTest(void);
+}
+#endif //__POOL_STATS_HEADER
@@ -1,6 +1,8 @@
 
 #include "PreCompiled.h"
 #include "Profiling.h"
+#include "HashedString.h"
+#include "PoolStats.h"
 #include "Debug.h"
 
 #ifdef _PROFILER
@@ -100,7 +102,7 @@ namespace Engine
 	/******************************************************************************
 	Function     : AddTimingData
 	Description  : Adds timing data with name and tick difference
-	Input        : const std::string i_pTimerName, const double i_TimeDifferenceinMS
+	Input        : const char *i_pTimerName, const double i_TimeDifferenceinMS
 	Output       : 
 	Return Value : 
 
@@ -108,13 +110,14 @@ namespace Engine
 	Author       : Vinod VM
 	Modification : Created function
 	******************************************************************************/
-	void Profiler::AddTimingData(const std::string i_pTimerName, const double i_TimeDifferenceinMS)
+	void Profiler::AddTimingData(const char *i_pTimerName, const double i_TimeDifferenceinMS)
 	{
 		using namespace std;
 
-		map<string,Accumulator>::iterator iter;
+		unsigned int uiNameHash = HashedString::Hash(i_pTimerName);
+		map<unsigned int,Accumulator>::iterator iter;
 
-		iter = mProfileData.find(i_pTimerName);
+		iter = mProfileData.find(uiNameHash);
 
 		if (iter != mProfileData.end())
 		{
@@ -126,13 +129,15 @@ namespace Engine
 		else
 		{
 			Accumulator NewAccumulator(i_TimeDifferenceinMS);
-			mProfileData.insert ( pair<string,Accumulator>(i_pTimerName,NewAccumulator) );
+			mProfileData.insert ( pair<unsigned int,Accumulator>(uiNameHash,NewAccumulator) );
+			mProfileNames.insert ( pair<unsigned int,string>(uiNameHash,i_pTimerName) );
 		}
 	}
 
 	/******************************************************************************
 	Function     : PrintTimingData
-	Description  : print timing data to Console
+	Description  : print timing data and the stats of every registered memory
+					pool to Console
 	Input        : 
 	Output       : 
 	Return Value : 
@@ -145,17 +150,32 @@ namespace Engine
 	{
 		using namespace std;
 
-		map<string,Accumulator>::iterator iter;
+		map<unsigned int,Accumulator>::iterator iter;
 		
 		for (iter = mProfileData.begin(); iter != mProfileData.end(); ++iter)
 		{
 			Accumulator pIterator = iter->second;
 
 			ProfileDebugPrint("Timer Name: %s			|	Count: %lf	|	Max:%lf	|	Min:%lf	|	Sum:%lf	|	Average:%lf	|", 
-									iter->first.c_str(), iter->second.GetCount(), 
+									mProfileNames[iter->first].c_str(), iter->second.GetCount(), 
 									iter->second.GetMax(), iter->second.GetMin(), 
 									iter->second.GetSum(), iter->second.GetAverage());
 		}
+
+		static const unsigned long MaxPrintedPools = 64;
+		sPoolStats PoolStats[MaxPrintedPools];
+		unsigned long ulPoolCount = PoolRegistry::GetAllPoolStats(PoolStats, MaxPrintedPools);
+
+		for (unsigned long i = 0; i < ulPoolCount; i++)
+		{
+			const sPoolStats &Stats = PoolStats[i];
+			double Occupancy = (0 == Stats.m_ulCapacity) ? 0.0 : (100.0 * Stats.m_ulLiveCount) / Stats.m_ulCapacity;
+
+			ProfileDebugPrint("Pool Name: %s			|	Slot: %lu	|	Live: %lu / %lu (%.1lf%%)	|	Peak: %lu	|	Allocs/Frame: %lu	|	Frees/Frame: %lu	|	Failed: %lu	|	Backing: %s	|",
+									Stats.m_pName, Stats.m_ulSlotSize, Stats.m_ulLiveCount, Stats.m_ulCapacity, Occupancy,
+									Stats.m_ulHighWaterMark, Stats.m_ulFrameAllocations, Stats.m_ulFrameFrees, Stats.m_ulFailedAllocations,
+									PageAllocator::GetBackingName(Stats.m_eBacking));
+		}
 	}
 
 	
@@ -173,6 +193,7 @@ namespace Engine
 	Profiler::~Profiler()
 	{
 		mProfileData.clear();
+		mProfileNames.clear();
 	}
 
 	/******************************************************************************
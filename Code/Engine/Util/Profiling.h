@@ -93,10 +93,12 @@ namespace Engine
 
 	class Profiler
 	{
-		std::map<std::string, Accumulator> mProfileData;
+		//Keyed by the hash of the timer name so a timer ending does not build a string
+		std::map<unsigned int, Accumulator> mProfileData;
+		std::map<unsigned int, std::string> mProfileNames;
 	public:
 		~Profiler();
-		void AddTimingData(const std::string i_pTimerName, const double i_TimeDifferenceinMS);
+		void AddTimingData(const char *i_pTimerName, const double i_TimeDifferenceinMS);
 		void PrintTimingData(void);
 	} ;
 
@@ -106,10 +108,10 @@ namespace Engine
 #endif
 
 #if defined(_PROFILER)
-#define PROFILE_SCOPE_BEGIN(Name) { Gameme::ScopedTimer MyTimer(Name);
+#define PROFILE_SCOPE_BEGIN(Name) { Engine::ScopedTimer MyTimer(Name);
 #define PROFILE_SCOPE_END() }
-#define PROFILE_UNSCOPED(Name) Gameme::ScopedTimer MyTimer(Name);
-#define PROFILE_PRINT_RESULTS() Gameme::PrintAccumulators();
+#define PROFILE_UNSCOPED(Name) Engine::ScopedTimer MyTimer(Name);
+#define PROFILE_PRINT_RESULTS() Engine::PrintAccumulators();
 #else
 #define PROFILE_SCOPE_BEGIN(Name) __noop;
 #define PROFILE_SCOPE_END() __noop;
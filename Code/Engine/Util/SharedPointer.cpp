@@ -0,0 +1,225 @@
+#include "PreCompiled.h"
+
+#include <thread>
+#include <vector>
+
+#include "SharedPointer.h"
+#include "WeakPointer.h"
+#include "HighResTime.h"
+#include "Debug.h"
+
+namespace Engine
+{
+	namespace
+	{
+		struct sUTCounted
+		{
+			unsigned long *m_pulDestroyed;
+			double m_Value;
+
+			sUTCounted(unsigned long *i_pulDestroyed, double i_Value) :
+				m_pulDestroyed(i_pulDestroyed),
+				m_Value(i_Value)
+			{
+			}
+
+			~sUTCounted()
+			{
+				(*m_pulDestroyed)++;
+			}
+		};
+
+		//Copies one pointer into a batch of slots and clears them again, every
+		//copy and every clear is one count update
+		template<class RefCountPolicy>
+		void CopyAndRelease(const SharedPointer<double, RefCountPolicy> &i_Shared, const unsigned long i_ulCopies)
+		{
+			static const unsigned long BatchSize = 64;
+			SharedPointer<double, RefCountPolicy> Copies[BatchSize];
+
+			for (unsigned long ulCopies = 0; ulCopies < i_ulCopies; ulCopies += BatchSize)
+			{
+				for (unsigned long i = 0; i < BatchSize; i++)
+				{
+					Copies[i] = i_Shared;
+				}
+
+				for (unsigned long i = 0; i < BatchSize; i++)
+				{
+					Copies[i] = SharedPointer<double, RefCountPolicy>();
+				}
+			}
+		}
+
+		template<class RefCountPolicy>
+		double TimeCopies(const char *i_pPolicyName, const unsigned int i_uThreadCount, const unsigned long i_ulCopiesPerThread)
+		{
+			SharedPointer<double, RefCountPolicy> Shared = SharedPointer<double, RefCountPolicy>::Create(1.0);
+			std::vector<std::thread> BenchThreads;
+
+			Tick BenchStart;
+			BenchStart.CalcCurrentTick();
+
+			if (1 == i_uThreadCount)
+			{
+				CopyAndRelease(Shared, i_ulCopiesPerThread);
+			}
+			else
+			{
+				for (unsigned int uThread = 0; uThread < i_uThreadCount; uThread++)
+				{
+					BenchThreads.push_back(std::thread([&Shared, i_ulCopiesPerThread]()
+					{
+						CopyAndRelease(Shared, i_ulCopiesPerThread);
+					}));
+				}
+
+				for (unsigned int uThread = 0; uThread < i_uThreadCount; uThread++)
+				{
+					BenchThreads[uThread].join();
+				}
+			}
+
+			double BenchMS = BenchStart.GetTickDifferenceinMS();
+			double NSPerCopy = (BenchMS * 1000000.0) / (static_cast<double>(i_ulCopiesPerThread) * i_uThreadCount);
+
+			DebugPrint("SharedPointer Benchmark: %s	|	Threads: %u	|	Total MS: %f	|	NS per copy+release: %f", i_pPolicyName, i_uThreadCount, BenchMS, NSPerCopy);
+
+			return NSPerCopy;
+		}
+	}
+
+	/******************************************************************************
+		Function     : SharedPointer_UnitTest
+		Description  : UnitTest function to test SharedPointer and WeakPointer
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void SharedPointer_UnitTest(void)
+	{
+	#ifdef _DEBUG
+		unsigned long ulDestroyed = 0;
+
+		{
+			SharedPointer<sUTCounted> UTNull;
+			SharedPointer<sUTCounted> UTNullCopy = UTNull;
+			assert(UTNull == NULL);
+			assert(UTNullCopy.GetReferenceCount() == 0);
+		}
+
+		{
+			SharedPointer<sUTCounted> UTFirst(new sUTCounted(&ulDestroyed, 1.0));
+			SharedPointer<sUTCounted> UTSecond = MakeShared<sUTCounted>(&ulDestroyed, 2.0);
+			assert(UTSecond->m_Value == 2.0);
+
+			SharedPointer<sUTCounted> UTCopy = UTFirst;
+			assert(UTFirst.GetReferenceCount() == 2);
+
+			UTCopy = UTCopy;
+			assert(UTFirst.GetReferenceCount() == 2);
+
+			//Move leaves the source null without touching the count
+			SharedPointer<sUTCounted> UTMoved(std::move(UTCopy));
+			assert(UTCopy == NULL);
+			assert(UTFirst.GetReferenceCount() == 2);
+
+			UTMoved = std::move(UTSecond);
+			assert(ulDestroyed == 0);
+			assert(UTFirst.GetReferenceCount() == 1);
+			assert(UTMoved->m_Value == 2.0);
+		}
+
+		assert(ulDestroyed == 2);
+
+		{
+			WeakPointer<sUTCounted> UTWeak;
+			assert(UTWeak.IsExpired());
+
+			{
+				SharedPointer<sUTCounted> UTOwner = MakeShared<sUTCounted>(&ulDestroyed, 3.0);
+				UTWeak = UTOwner;
+				assert(false == UTWeak.IsExpired());
+				assert(UTWeak.Lock()->m_Value == 3.0);
+				assert(UTOwner.GetReferenceCount() == 1);
+			}
+
+			//Object is gone, the control block lives until the weak pointer dies
+			assert(ulDestroyed == 3);
+			assert(UTWeak.IsExpired());
+			assert(UTWeak.Lock() == NULL);
+		}
+
+		//Atomic counts stay exact with several threads copying the same pointer
+		{
+			static const unsigned long UTCopiesPerThread = 100000;
+			static const unsigned int UTThreadCount = 4;
+			std::vector<std::thread> UTThreads;
+
+			ThreadSafeSharedPointer<sUTCounted> UTShared = ThreadSafeSharedPointer<sUTCounted>::Create(&ulDestroyed, 4.0);
+			WeakPointer<sUTCounted, AtomicRefCount> UTWeak = UTShared;
+
+			for (unsigned int uThread = 0; uThread < UTThreadCount; uThread++)
+			{
+				UTThreads.push_back(std::thread([&UTShared, &UTWeak]()
+				{
+					for (unsigned long i = 0; i < UTCopiesPerThread; i++)
+					{
+						ThreadSafeSharedPointer<sUTCounted> UTCopy = UTShared;
+						ThreadSafeSharedPointer<sUTCounted> UTLocked = UTWeak.Lock();
+						assert(UTLocked->m_Value == 4.0);
+					}
+				}));
+			}
+
+			for (unsigned int uThread = 0; uThread < UTThreadCount; uThread++)
+			{
+				UTThreads[uThread].join();
+			}
+
+			assert(UTShared.GetReferenceCount() == 1);
+			assert(ulDestroyed == 3);
+
+			UTShared = ThreadSafeSharedPointer<sUTCounted>();
+			assert(ulDestroyed == 4);
+			assert(UTWeak.IsExpired());
+		}
+	#endif
+	}
+
+	/******************************************************************************
+		Function     : SharedPointer_Benchmark
+		Description  : Cost of copying and releasing a SharedPointer with plain
+					and atomic counts, then atomic counts with every hardware
+					thread sharing one pointer
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void SharedPointer_Benchmark(void)
+	{
+		static const unsigned long BenchCopies = 10000000;
+		unsigned int uMaxThreads = std::thread::hardware_concurrency();
+
+		if (0 == uMaxThreads)
+		{
+			uMaxThreads = 1;
+		}
+
+		TimeCopies<NonAtomicRefCount>("NonAtomicRefCount", 1, BenchCopies);
+		TimeCopies<AtomicRefCount>("AtomicRefCount", 1, BenchCopies);
+
+		for (unsigned int uThreadCount = 2; uThreadCount <= uMaxThreads; uThreadCount++)
+		{
+			TimeCopies<AtomicRefCount>("AtomicRefCount", uThreadCount, BenchCopies / uThreadCount);
+		}
+	}
+}
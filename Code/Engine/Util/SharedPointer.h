@@ -2,34 +2,151 @@
 #define __SHARED_POINTER_HEADER
 #include "PreCompiled.h"
 
+#include <atomic>
+#include <type_traits>
+
+#include "SmallObjectAllocator.h"
+
 namespace Engine
 {
-	template<class T>
+	//Plain counts, for pointers that never leave one thread
+	struct NonAtomicRefCount
+	{
+		typedef unsigned long CountType;
+
+		static void Increment(CountType &io_Count)
+		{
+			io_Count++;
+		}
+
+		static unsigned long Decrement(CountType &io_Count)
+		{
+			return --io_Count;
+		}
+
+		static bool IncrementIfNotZero(CountType &io_Count)
+		{
+			if (0 == io_Count)
+			{
+				return false;
+			}
+
+			io_Count++;
+			return true;
+		}
+
+		static unsigned long Load(const CountType &i_Count)
+		{
+			return i_Count;
+		}
+	};
+
+	//Counts that can be shared between threads. Taking a reference needs no
+	//ordering, the release that drops the last one must see every write made
+	//through the other references before the object is destroyed
+	struct AtomicRefCount
+	{
+		typedef std::atomic<unsigned long> CountType;
+
+		static void Increment(CountType &io_Count)
+		{
+			io_Count.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		static unsigned long Decrement(CountType &io_Count)
+		{
+			return io_Count.fetch_sub(1, std::memory_order_acq_rel) - 1;
+		}
+
+		static bool IncrementIfNotZero(CountType &io_Count)
+		{
+			unsigned long ulCount = io_Count.load(std::memory_order_relaxed);
+
+			do
+			{
+				if (0 == ulCount)
+				{
+					return false;
+				}
+			} while (false == io_Count.compare_exchange_weak(ulCount, ulCount + 1, std::memory_order_relaxed));
+
+			return true;
+		}
+
+		static unsigned long Load(const CountType &i_Count)
+		{
+			return i_Count.load(std::memory_order_acquire);
+		}
+	};
+
+	//Reference counts of one shared object. While any SharedPointer is alive the
+	//weak count holds one extra reference, the block is freed when it drops to 0
+	template<class RefCountPolicy>
+	struct sSharedControlBlock
+	{
+		typename RefCountPolicy::CountType	m_StrongCount;
+		typename RefCountPolicy::CountType	m_WeakCount;
+		void								(*m_pDestroyObject)(sSharedControlBlock *i_pBlock, void *i_pObject);
+		void								(*m_pFreeBlock)(sSharedControlBlock *i_pBlock);
+	};
+
+	template<class T, class RefCountPolicy = NonAtomicRefCount>
+	class WeakPointer;
+
+	template<class T, class RefCountPolicy = NonAtomicRefCount>
 	class SharedPointer
 	{
 	private:
+		typedef sSharedControlBlock<RefCountPolicy> ControlBlock;
+
+		//Object and control block from one allocation, used by Create
+		struct sSharedStorage
+		{
+			ControlBlock m_ControlBlock;
+			typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type m_Object;
+		};
+
 		T * m_pPtr;
-		unsigned long * m_pulReferenceCount;
+		ControlBlock * m_pControlBlock;
+
+		//Every null pointer shares this block, it is never freed
+		static ControlBlock sNullControlBlock;
+
+		SharedPointer(T * i_pPtr, ControlBlock * i_pControlBlock);
 		void Destroy(void);
+
+		static void DeleteObject(ControlBlock *i_pBlock, void *i_pObject);
+		static void DestructObject(ControlBlock *i_pBlock, void *i_pObject);
+		static void IgnoreObject(ControlBlock *i_pBlock, void *i_pObject);
+		static void FreeControlBlock(ControlBlock *i_pBlock);
+		static void FreeSharedStorage(ControlBlock *i_pBlock);
+		static void IgnoreControlBlock(ControlBlock *i_pBlock);
+
+		friend class WeakPointer<T, RefCountPolicy>;
 	public:
 		SharedPointer(void);
 		SharedPointer(T * i_pPtr);
-		SharedPointer(const SharedPointer<T> & i_Other);
-		SharedPointer<T> & operator=(const SharedPointer<T> &i_rhs);
-	
-		T* operator->(void)
+		SharedPointer(const SharedPointer<T, RefCountPolicy> & i_Other);
+		SharedPointer(SharedPointer<T, RefCountPolicy> && i_Other);
+		SharedPointer<T, RefCountPolicy> & operator=(const SharedPointer<T, RefCountPolicy> &i_rhs);
+		SharedPointer<T, RefCountPolicy> & operator=(SharedPointer<T, RefCountPolicy> &&i_rhs);
+
+		template<class... Args>
+		static SharedPointer<T, RefCountPolicy> Create(Args&&... i_Args);
+
+		T* operator->(void) const
 		{
 			assert(m_pPtr != nullptr);
 			return m_pPtr;
 		}
 
-		T & operator*(void)
+		T & operator*(void) const
 		{
 			assert(m_pPtr != nullptr);
 			return *m_pPtr;
 		}
 
-		bool operator!=(void * Ptr)
+		bool operator!=(void * Ptr) const
 		{
 			if (m_pPtr != Ptr)
 			{
@@ -39,7 +156,7 @@ namespace Engine
 			return false;
 		}
 
-		bool operator==(void * Ptr)
+		bool operator==(void * Ptr) const
 		{
 			if (m_pPtr == Ptr)
 			{
@@ -49,11 +166,28 @@ namespace Engine
 			return false;
 		}
 
+		T * Get(void) const
+		{
+			return m_pPtr;
+		}
+
+		unsigned long GetReferenceCount(void) const;
+
 		~SharedPointer(void);
 
 	} ;
+
+	//For objects that are handed between the game and render threads
+	template<class T>
+	using ThreadSafeSharedPointer = SharedPointer<T, AtomicRefCount>;
+
+	template<class T, class... Args>
+	SharedPointer<T> MakeShared(Args&&... i_Args);
+
+	void SharedPointer_UnitTest(void);
+	void SharedPointer_Benchmark(void);
 }
 
 #include "SharedPointer.inl"
 
-#endif //__SHARED_POINTER_HEADER
\ No newline at end of file
+#endif //__SHARED_POINTER_HEADER
@@ -1,79 +1,223 @@
+#include <new>
+#include <utility>
 
 namespace Engine
 {
+	template<class T, class RefCountPolicy>
+	typename SharedPointer<T, RefCountPolicy>::ControlBlock SharedPointer<T, RefCountPolicy>::sNullControlBlock =
+	{
+		{ 1 },
+		{ 1 },
+		&SharedPointer<T, RefCountPolicy>::IgnoreObject,
+		&SharedPointer<T, RefCountPolicy>::IgnoreControlBlock
+	};
+
 	/******************************************************************************
 	Function     : Sharedpointer functions
-	Description  :  
-	Input        : 
-	Output       : 
-	Return Value : 
+	Description  : Null pointers share a static control block, owning pointers
+				get a control block from the small object allocator
+	Input        :
+	Output       :
+	Return Value :
 
 	History      :
 	Author       : Vinod VM
 	Modification : Created function
 	******************************************************************************/
 
-	template<class T>
-	SharedPointer<T>::SharedPointer(void):
+	template<class T, class RefCountPolicy>
+	SharedPointer<T, RefCountPolicy>::SharedPointer(void):
 		m_pPtr(NULL),
-		m_pulReferenceCount(new unsigned long)
+		m_pControlBlock(&sNullControlBlock)
 	{
-		assert(m_pulReferenceCount != nullptr);
-		*m_pulReferenceCount = 1;
+		RefCountPolicy::Increment(m_pControlBlock->m_StrongCount);
 	}
 
-	template<class T>
-	SharedPointer<T>::SharedPointer(T* i_pPtr):
+	template<class T, class RefCountPolicy>
+	SharedPointer<T, RefCountPolicy>::SharedPointer(T* i_pPtr):
 		m_pPtr(i_pPtr),
-		m_pulReferenceCount(new unsigned long)
+		m_pControlBlock(&sNullControlBlock)
 	{
-		assert(m_pulReferenceCount != nullptr);
+		if (NULL == m_pPtr)
+		{
+			RefCountPolicy::Increment(m_pControlBlock->m_StrongCount);
+			return;
+		}
 
-		*m_pulReferenceCount = 1;
+		m_pControlBlock = static_cast<ControlBlock *>(SmallObjectAllocator::GetInstance()->Allocate(sizeof(ControlBlock)));
+		assert(m_pControlBlock != nullptr);
+
+		new (m_pControlBlock) ControlBlock();
+		RefCountPolicy::Increment(m_pControlBlock->m_StrongCount);
+		RefCountPolicy::Increment(m_pControlBlock->m_WeakCount);
+		m_pControlBlock->m_pDestroyObject = &DeleteObject;
+		m_pControlBlock->m_pFreeBlock = &FreeControlBlock;
+	}
+
+	//Takes over a reference that the caller has already counted
+	template<class T, class RefCountPolicy>
+	SharedPointer<T, RefCountPolicy>::SharedPointer(T* i_pPtr, ControlBlock * i_pControlBlock):
+		m_pPtr(i_pPtr),
+		m_pControlBlock(i_pControlBlock)
+	{
+		assert(m_pControlBlock != nullptr);
 	}
 
-	template<class T>
-	SharedPointer<T>::SharedPointer(const SharedPointer<T> &i_Other):
+	template<class T, class RefCountPolicy>
+	SharedPointer<T, RefCountPolicy>::SharedPointer(const SharedPointer<T, RefCountPolicy> &i_Other):
 		m_pPtr(i_Other.m_pPtr),
-		m_pulReferenceCount(i_Other.m_pulReferenceCount)
+		m_pControlBlock(i_Other.m_pControlBlock)
 	{
-		//assert(m_pPtr != nullptr);
-		assert(m_pulReferenceCount != nullptr);
+		assert(m_pControlBlock != nullptr);
+
+		RefCountPolicy::Increment(m_pControlBlock->m_StrongCount);
+	}
 
-		(*m_pulReferenceCount)++;
+	template<class T, class RefCountPolicy>
+	SharedPointer<T, RefCountPolicy>::SharedPointer(SharedPointer<T, RefCountPolicy> &&i_Other):
+		m_pPtr(i_Other.m_pPtr),
+		m_pControlBlock(i_Other.m_pControlBlock)
+	{
+		i_Other.m_pPtr = NULL;
+		i_Other.m_pControlBlock = &sNullControlBlock;
+		RefCountPolicy::Increment(sNullControlBlock.m_StrongCount);
 	}
 
-	template<class T>
-	void SharedPointer<T>::Destroy(void)
+	template<class T, class RefCountPolicy>
+	void SharedPointer<T, RefCountPolicy>::Destroy(void)
 	{
-		assert(m_pulReferenceCount != nullptr);
+		assert(m_pControlBlock != nullptr);
 
-		if(--(*m_pulReferenceCount) == 0)
+		if (RefCountPolicy::Decrement(m_pControlBlock->m_StrongCount) == 0)
 		{
-			if (m_pPtr)
-				delete m_pPtr;
+			m_pControlBlock->m_pDestroyObject(m_pControlBlock, m_pPtr);
 
-			delete m_pulReferenceCount;
+			if (RefCountPolicy::Decrement(m_pControlBlock->m_WeakCount) == 0)
+			{
+				m_pControlBlock->m_pFreeBlock(m_pControlBlock);
+			}
 		}
 	}
 
-	template<class T>
-	SharedPointer<T> & SharedPointer<T>::operator=(const SharedPointer<T> &i_rhs)
+	template<class T, class RefCountPolicy>
+	SharedPointer<T, RefCountPolicy> & SharedPointer<T, RefCountPolicy>::operator=(const SharedPointer<T, RefCountPolicy> &i_rhs)
 	{
+		assert(i_rhs.m_pControlBlock != nullptr);
+
+		//Count the new reference first so self assignment is safe
+		RefCountPolicy::Increment(i_rhs.m_pControlBlock->m_StrongCount);
+
 		Destroy();
 		m_pPtr = i_rhs.m_pPtr;
-		m_pulReferenceCount = i_rhs.m_pulReferenceCount;
+		m_pControlBlock = i_rhs.m_pControlBlock;
 
-		assert(m_pulReferenceCount != nullptr);
+		return *this;
+	}
+
+	template<class T, class RefCountPolicy>
+	SharedPointer<T, RefCountPolicy> & SharedPointer<T, RefCountPolicy>::operator=(SharedPointer<T, RefCountPolicy> &&i_rhs)
+	{
+		if (this != &i_rhs)
+		{
+			T *pPtr = i_rhs.m_pPtr;
+			ControlBlock *pControlBlock = i_rhs.m_pControlBlock;
+
+			i_rhs.m_pPtr = NULL;
+			i_rhs.m_pControlBlock = &sNullControlBlock;
+			RefCountPolicy::Increment(sNullControlBlock.m_StrongCount);
+
+			Destroy();
+			m_pPtr = pPtr;
+			m_pControlBlock = pControlBlock;
+		}
 
-		(*m_pulReferenceCount)++;
-		
 		return *this;
 	}
 
-	template<class T>
-	SharedPointer<T>::~SharedPointer(void)
+	/******************************************************************************
+	Function     : Create
+	Description  : Constructs the object and its control block in one allocation
+				from the small object allocator
+	Input        : Args&&... i_Args, forwarded to the constructor of T
+	Output       :
+	Return Value : SharedPointer<T>
+
+	History      :
+	Author       : Vinod VM
+	Modification : Created function
+	******************************************************************************/
+	template<class T, class RefCountPolicy>
+	template<class... Args>
+	SharedPointer<T, RefCountPolicy> SharedPointer<T, RefCountPolicy>::Create(Args&&... i_Args)
+	{
+		static_assert(std::alignment_of<T>::value <= SMALL_OBJECT_GRANULARITY, "Type is over aligned for the small object allocator");
+
+		sSharedStorage *pStorage = static_cast<sSharedStorage *>(SmallObjectAllocator::GetInstance()->Allocate(sizeof(sSharedStorage)));
+		assert(pStorage != nullptr);
+
+		T *pObject = new (&pStorage->m_Object) T(std::forward<Args>(i_Args)...);
+
+		new (&pStorage->m_ControlBlock) ControlBlock();
+		RefCountPolicy::Increment(pStorage->m_ControlBlock.m_StrongCount);
+		RefCountPolicy::Increment(pStorage->m_ControlBlock.m_WeakCount);
+		pStorage->m_ControlBlock.m_pDestroyObject = &DestructObject;
+		pStorage->m_ControlBlock.m_pFreeBlock = &FreeSharedStorage;
+
+		return SharedPointer<T, RefCountPolicy>(pObject, &pStorage->m_ControlBlock);
+	}
+
+	template<class T, class RefCountPolicy>
+	unsigned long SharedPointer<T, RefCountPolicy>::GetReferenceCount(void) const
+	{
+		return (NULL == m_pPtr) ? 0 : RefCountPolicy::Load(m_pControlBlock->m_StrongCount);
+	}
+
+	template<class T, class RefCountPolicy>
+	void SharedPointer<T, RefCountPolicy>::DeleteObject(ControlBlock *i_pBlock, void *i_pObject)
+	{
+		delete static_cast<T *>(i_pObject);
+	}
+
+	template<class T, class RefCountPolicy>
+	void SharedPointer<T, RefCountPolicy>::DestructObject(ControlBlock *i_pBlock, void *i_pObject)
+	{
+		static_cast<T *>(i_pObject)->~T();
+	}
+
+	template<class T, class RefCountPolicy>
+	void SharedPointer<T, RefCountPolicy>::IgnoreObject(ControlBlock *i_pBlock, void *i_pObject)
+	{
+
+	}
+
+	template<class T, class RefCountPolicy>
+	void SharedPointer<T, RefCountPolicy>::FreeControlBlock(ControlBlock *i_pBlock)
+	{
+		SmallObjectAllocator::GetInstance()->DeAllocate(i_pBlock, sizeof(ControlBlock));
+	}
+
+	template<class T, class RefCountPolicy>
+	void SharedPointer<T, RefCountPolicy>::FreeSharedStorage(ControlBlock *i_pBlock)
+	{
+		//Control block is the first member of the storage
+		SmallObjectAllocator::GetInstance()->DeAllocate(reinterpret_cast<sSharedStorage *>(i_pBlock), sizeof(sSharedStorage));
+	}
+
+	template<class T, class RefCountPolicy>
+	void SharedPointer<T, RefCountPolicy>::IgnoreControlBlock(ControlBlock *i_pBlock)
+	{
+
+	}
+
+	template<class T, class RefCountPolicy>
+	SharedPointer<T, RefCountPolicy>::~SharedPointer(void)
 	{
 		Destroy();
 	}
-}
\ No newline at end of file
+
+	template<class T, class... Args>
+	inline SharedPointer<T> MakeShared(Args&&... i_Args)
+	{
+		return SharedPointer<T>::Create(std::forward<Args>(i_Args)...);
+	}
+}
@@ -0,0 +1,591 @@
+#include "PreCompiled.h"
+
+#include <stdlib.h>
+#include <vector>
+
+#include "SmallObjectAllocator.h"
+#include "Debug.h"
+
+#define SLOT_START_ALIGNMENT	16
+
+namespace Engine
+{
+	SmallObjectAllocator * SmallObjectAllocator::mInstance = NULL;
+
+	//Roughly 1.5x steps so a request wastes at most a third of its slot
+	const unsigned long SmallObjectAllocator::SizeClassSlotSizes[SMALL_OBJECT_CLASS_COUNT] =
+	{
+		16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512
+	};
+
+	static const char * const s_SizeClassPoolNames[SMALL_OBJECT_CLASS_COUNT] =
+	{
+		"SmallObject 16", "SmallObject 24", "SmallObject 32", "SmallObject 48", "SmallObject 64", "SmallObject 96",
+		"SmallObject 128", "SmallObject 192", "SmallObject 256", "SmallObject 384", "SmallObject 512"
+	};
+
+	static std::atomic_flag s_CreateLock = ATOMIC_FLAG_INIT;
+
+	/******************************************************************************
+		Function     : SmallObjectAllocator
+		Description  : Constructor, reserves the region and gives every size
+					class an equal share of it
+		Input        : const unsigned long i_ulRegionBytes
+		Output       :
+		Return Value :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	SmallObjectAllocator::SmallObjectAllocator(const unsigned long i_ulRegionBytes):
+		m_pRegion(NULL),
+		m_ulRegionBytes(i_ulRegionBytes),
+		m_eRegionBacking(PAGE_BACKING_OS_PAGES),
+		m_ulHeapAllocations(0),
+		m_RequestedBytes(0),
+		m_HandedOutBytes(0),
+		mInitilized(false)
+	{
+		m_Lock.clear();
+		memset(m_SizeClasses, 0, sizeof(m_SizeClasses));
+
+		unsigned long ulClass = 0;
+
+		for (unsigned long ulIndex = 0; ulIndex < sizeof(m_SizeToClass); ulIndex++)
+		{
+			while (SizeClassSlotSizes[ulClass] < ulIndex * SMALL_OBJECT_GRANULARITY)
+			{
+				ulClass++;
+			}
+
+			m_SizeToClass[ulIndex] = static_cast<unsigned char>(ulClass);
+		}
+
+		m_pRegion = static_cast<char *>(PageAllocator::Reserve(m_ulRegionBytes, &m_eRegionBacking));
+
+		if (NULL == m_pRegion)
+		{
+			CONSOLE_PRINT("Failed to reserve %d bytes for small object allocator", m_ulRegionBytes);
+			return;
+		}
+
+		unsigned long ulClassBudget = m_ulRegionBytes / SMALL_OBJECT_CLASS_COUNT;
+		unsigned long ulOffset = 0;
+
+		for (ulClass = 0; ulClass < SMALL_OBJECT_CLASS_COUNT; ulClass++)
+		{
+			unsigned long ulSlotSize = SizeClassSlotSizes[ulClass];
+			unsigned long ulSlotCount = ulClassBudget / ulSlotSize;
+
+			while ((ulSlotCount > 0) && (MemoryPool::GetRequiredMemorySize(ulSlotSize, ulSlotCount) + SLOT_START_ALIGNMENT > ulClassBudget))
+			{
+				ulSlotCount--;
+			}
+
+			if (0 == ulSlotCount)
+			{
+				CONSOLE_PRINT("Small object region of %d bytes is too small", m_ulRegionBytes);
+				return;
+			}
+
+			//Pool header sits in front of the slots, pad so that the first slot is aligned
+			unsigned long ulUsed = 0;
+			unsigned long ulHeaderSize = MemoryPool::GetRequiredMemorySize(ulSlotSize, ulSlotCount) - (ulSlotSize * ulSlotCount);
+			unsigned long ulStart = ((ulOffset + ulHeaderSize + SLOT_START_ALIGNMENT - 1) & ~(SLOT_START_ALIGNMENT - 1)) - ulHeaderSize;
+
+			m_SizeClasses[ulClass].m_pPool = MemoryPool::CreateFromExistingMemory(m_pRegion + ulStart, ulSlotSize, ulSlotCount, &ulUsed);
+			assert(m_SizeClasses[ulClass].m_pPool != NULL);
+			assert(m_SizeClasses[ulClass].m_pPool->GetStartAddress() == m_pRegion + ulStart + ulHeaderSize);
+			m_SizeClasses[ulClass].m_pPool->SetPageBacking(m_eRegionBacking);
+			m_SizeClasses[ulClass].m_pPool->RegisterStats(s_SizeClassPoolNames[ulClass]);
+
+			m_SizeClasses[ulClass].m_Stats.m_ulSlotSize = ulSlotSize;
+			m_SizeClasses[ulClass].m_Stats.m_ulCapacity = ulSlotCount;
+
+			ulOffset = ulStart + ulUsed;
+		}
+
+		assert(ulOffset <= m_ulRegionBytes);
+
+		mInitilized = true;
+	}
+
+	SmallObjectAllocator::~SmallObjectAllocator()
+	{
+		for (unsigned long ulClass = 0; ulClass < SMALL_OBJECT_CLASS_COUNT; ulClass++)
+		{
+			if (NULL != m_SizeClasses[ulClass].m_pPool)
+			{
+				unsigned long ulOutputLength = 0;
+				m_SizeClasses[ulClass].m_pPool->Destroy(&ulOutputLength);
+			}
+		}
+
+		if (NULL != m_pRegion)
+		{
+			PageAllocator::Release(m_pRegion, m_ulRegionBytes, m_eRegionBacking);
+		}
+	}
+
+	/******************************************************************************
+		Function     : CreateInstance
+		Description  : Creates the allocator, the instance itself comes from
+					malloc so a global operator new can sit on top of it
+		Input        : const unsigned long i_ulRegionBytes
+		Output       :
+		Return Value : bool
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	bool SmallObjectAllocator::CreateInstance(const unsigned long i_ulRegionBytes)
+	{
+		while (s_CreateLock.test_and_set(std::memory_order_acquire))
+		{
+		}
+
+		if (mInstance == NULL)
+		{
+			void *pMemory = malloc(sizeof(SmallObjectAllocator));
+
+			if (pMemory != NULL)
+			{
+				SmallObjectAllocator *pInstance = new (pMemory) SmallObjectAllocator(i_ulRegionBytes);
+
+				if (pInstance->mInitilized == false)
+				{
+					pInstance->~SmallObjectAllocator();
+					free(pMemory);
+				}
+				else
+				{
+					mInstance = pInstance;
+				}
+			}
+		}
+
+		s_CreateLock.clear(std::memory_order_release);
+
+		return (mInstance != NULL);
+	}
+
+	/******************************************************************************
+		Function     : GetInstance
+		Description  : Returns the allocator, creating it with the default region
+					on first use since allocations can happen before game init
+		Input        :
+		Output       :
+		Return Value : SmallObjectAllocator *
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	SmallObjectAllocator * SmallObjectAllocator::GetInstance()
+	{
+		if (mInstance == NULL)
+		{
+			CreateInstance();
+		}
+
+		assert(mInstance != NULL);
+
+		return mInstance;
+	}
+
+	/******************************************************************************
+		Function     : Destroy
+		Description  : Frees the region, it is kept if any block is still live
+		Input        :
+		Output       :
+		Return Value :
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void SmallObjectAllocator::Destroy()
+	{
+		if (mInstance)
+		{
+			for (unsigned long ulClass = 0; ulClass < SMALL_OBJECT_CLASS_COUNT; ulClass++)
+			{
+				if (mInstance->m_SizeClasses[ulClass].m_Stats.m_ulLiveCount != 0)
+				{
+					CONSOLE_PRINT("Small object allocator has live %d byte blocks, region is not freed", mInstance->m_SizeClasses[ulClass].m_Stats.m_ulSlotSize);
+					return;
+				}
+			}
+
+			mInstance->~SmallObjectAllocator();
+			free(mInstance);
+			mInstance = NULL;
+		}
+	}
+
+	/******************************************************************************
+		Function     : Allocate
+		Description  : Allocates from the smallest size class that fits, falls
+					back to the heap for large requests or a full class
+		Input        : const size_t i_size
+		Output       :
+		Return Value : void *
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void * SmallObjectAllocator::Allocate(const size_t i_size)
+	{
+		void *pPointer = NULL;
+
+		if (i_size <= SMALL_OBJECT_MAX_SIZE)
+		{
+			sSizeClass &SizeClass = m_SizeClasses[m_SizeToClass[(i_size + SMALL_OBJECT_GRANULARITY - 1) / SMALL_OBJECT_GRANULARITY]];
+			sSizeClassStats &Stats = SizeClass.m_Stats;
+
+			Lock();
+
+			if (Stats.m_ulLiveCount < Stats.m_ulCapacity)
+			{
+				pPointer = SizeClass.m_pPool->Allocate(Stats.m_ulSlotSize);
+				assert(pPointer != NULL);
+
+				Stats.m_ulAllocations++;
+				Stats.m_ulLiveCount++;
+
+				if (Stats.m_ulLiveCount > Stats.m_ulHighWaterMark)
+				{
+					Stats.m_ulHighWaterMark = Stats.m_ulLiveCount;
+				}
+
+				m_RequestedBytes += i_size;
+				m_HandedOutBytes += Stats.m_ulSlotSize;
+			}
+			else
+			{
+				Stats.m_ulFailedAllocations++;
+				m_ulHeapAllocations++;
+			}
+
+			Unlock();
+		}
+		else
+		{
+			Lock();
+			m_ulHeapAllocations++;
+			Unlock();
+		}
+
+		if (NULL == pPointer)
+		{
+			pPointer = malloc(i_size ? i_size : 1);
+		}
+
+		return pPointer;
+	}
+
+	void SmallObjectAllocator::DeAllocateFromClass(void *pPointer, const long i_lClass)
+	{
+		sSizeClass &SizeClass = m_SizeClasses[i_lClass];
+
+		Lock();
+
+		SizeClass.m_pPool->DeAllocate(pPointer);
+		SizeClass.m_Stats.m_ulLiveCount--;
+
+		Unlock();
+	}
+
+	/******************************************************************************
+		Function     : DeAllocate
+		Description  : Frees a block, finds its size class from the address
+		Input        : void *pPointer
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void SmallObjectAllocator::DeAllocate(void *pPointer)
+	{
+		if (NULL == pPointer)
+		{
+			return;
+		}
+
+		long lClass = FindSizeClass(pPointer);
+
+		if (-1 == lClass)
+		{
+			free(pPointer);
+			return;
+		}
+
+		DeAllocateFromClass(pPointer, lClass);
+	}
+
+	/******************************************************************************
+		Function     : DeAllocate
+		Description  : Frees a block when the caller knows the requested size,
+					the size class comes from the lookup table
+		Input        : void *pPointer, const size_t i_size
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void SmallObjectAllocator::DeAllocate(void *pPointer, const size_t i_size)
+	{
+		if (NULL == pPointer)
+		{
+			return;
+		}
+
+		if ((i_size > SMALL_OBJECT_MAX_SIZE) || (false == Contains(pPointer)))
+		{
+			free(pPointer);
+			return;
+		}
+
+		long lClass = m_SizeToClass[(i_size + SMALL_OBJECT_GRANULARITY - 1) / SMALL_OBJECT_GRANULARITY];
+		assert(lClass == FindSizeClass(pPointer));
+
+		DeAllocateFromClass(pPointer, lClass);
+	}
+
+	bool SmallObjectAllocator::Contains(const void *pPointer) const
+	{
+		const char *pAddress = static_cast<const char *>(pPointer);
+
+		return (pAddress >= m_pRegion) && (pAddress < m_pRegion + m_ulRegionBytes);
+	}
+
+	long SmallObjectAllocator::FindSizeClass(const void *pPointer) const
+	{
+		if (false == Contains(pPointer))
+		{
+			return -1;
+		}
+
+		const char *pAddress = static_cast<const char *>(pPointer);
+
+		for (long lClass = 0; lClass < SMALL_OBJECT_CLASS_COUNT; lClass++)
+		{
+			if (pAddress < m_SizeClasses[lClass].m_pPool->GetEndAddress())
+			{
+				assert(pAddress >= m_SizeClasses[lClass].m_pPool->GetStartAddress());
+				return lClass;
+			}
+		}
+
+		return -1;
+	}
+
+	void SmallObjectAllocator::GetSizeClassStats(const unsigned long i_ulClass, sSizeClassStats &o_Stats) const
+	{
+		assert(i_ulClass < SMALL_OBJECT_CLASS_COUNT);
+
+		o_Stats = m_SizeClasses[i_ulClass].m_Stats;
+	}
+
+	unsigned long SmallObjectAllocator::GetHeapAllocations(void) const
+	{
+		return m_ulHeapAllocations;
+	}
+
+	/******************************************************************************
+		Function     : GetUtilization
+		Description  : Bytes held by live blocks over the size of the region
+		Input        : void
+		Output       :
+		Return Value : float
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	float SmallObjectAllocator::GetUtilization(void) const
+	{
+		unsigned long ulLiveBytes = 0;
+
+		for (unsigned long ulClass = 0; ulClass < SMALL_OBJECT_CLASS_COUNT; ulClass++)
+		{
+			ulLiveBytes += m_SizeClasses[ulClass].m_Stats.m_ulLiveCount * m_SizeClasses[ulClass].m_Stats.m_ulSlotSize;
+		}
+
+		return static_cast<float>(ulLiveBytes) / static_cast<float>(m_ulRegionBytes);
+	}
+
+	/******************************************************************************
+		Function     : GetInternalFragmentation
+		Description  : Share of handed out slot bytes that were not requested,
+					over every allocation made from the size classes
+		Input        : void
+		Output       :
+		Return Value : float
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	float SmallObjectAllocator::GetInternalFragmentation(void) const
+	{
+		if (0 == m_HandedOutBytes)
+		{
+			return 0.0f;
+		}
+
+		return 1.0f - static_cast<float>(static_cast<double>(m_RequestedBytes) / static_cast<double>(m_HandedOutBytes));
+	}
+
+	void SmallObjectAllocator::PrintStats(void) const
+	{
+		for (unsigned long ulClass = 0; ulClass < SMALL_OBJECT_CLASS_COUNT; ulClass++)
+		{
+			const sSizeClassStats &Stats = m_SizeClasses[ulClass].m_Stats;
+
+			DebugPrint("SmallObject %lu bytes: Live: %lu / %lu	|	Peak: %lu	|	Allocations: %lu	|	Class full: %lu",
+				Stats.m_ulSlotSize, Stats.m_ulLiveCount, Stats.m_ulCapacity, Stats.m_ulHighWaterMark, Stats.m_ulAllocations, Stats.m_ulFailedAllocations);
+		}
+
+		DebugPrint("SmallObject Utilization: %f	|	Internal fragmentation: %f	|	Heap allocations: %lu",
+			GetUtilization(), GetInternalFragmentation(), m_ulHeapAllocations);
+	}
+
+	char * SmallStrDup(const char *i_pString)
+	{
+		assert(i_pString);
+
+		size_t Length = strlen(i_pString) + 1;
+		char *pCopy = static_cast<char *>(SmallObjectAllocator::GetInstance()->Allocate(Length));
+
+		if (pCopy)
+		{
+			memcpy(pCopy, i_pString, Length);
+		}
+
+		return pCopy;
+	}
+
+	void SmallFree(void *i_pPointer)
+	{
+		SmallObjectAllocator::GetInstance()->DeAllocate(i_pPointer);
+	}
+
+	/******************************************************************************
+		Function     : SmallObjectAllocator_UnitTest
+		Description  : UnitTest function to test size class selection, the heap
+					fallback and the stats
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void SmallObjectAllocator_UnitTest(void)
+	{
+	#ifdef _DEBUG
+		SmallObjectAllocator *pAllocator = SmallObjectAllocator::GetInstance();
+		SmallObjectAllocator::sSizeClassStats Stats;
+		std::vector<void *> UTPointers;
+
+		//Every size up to the largest class gets a slot that fits it
+		for (unsigned long ulSize = 0; ulSize <= SMALL_OBJECT_MAX_SIZE; ulSize++)
+		{
+			unsigned char *pBlock = static_cast<unsigned char *>(pAllocator->Allocate(ulSize));
+			assert(pAllocator->Contains(pBlock));
+			assert(0 == (reinterpret_cast<uintptr_t>(pBlock) % SMALL_OBJECT_GRANULARITY));
+			memset(pBlock, ulSize & 0xff, ulSize);
+			UTPointers.push_back(pBlock);
+		}
+
+		for (unsigned long ulSize = 0; ulSize <= SMALL_OBJECT_MAX_SIZE; ulSize++)
+		{
+			unsigned char *pBlock = static_cast<unsigned char *>(UTPointers[ulSize]);
+
+			for (unsigned long i = 0; i < ulSize; i++)
+			{
+				assert(pBlock[i] == (ulSize & 0xff));
+			}
+
+			if (ulSize & 1)
+			{
+				pAllocator->DeAllocate(pBlock);
+			}
+			else
+			{
+				pAllocator->DeAllocate(pBlock, ulSize);
+			}
+		}
+
+		UTPointers.clear();
+
+		void *pLarge = pAllocator->Allocate(SMALL_OBJECT_MAX_SIZE + 1);
+		assert(false == pAllocator->Contains(pLarge));
+		pAllocator->DeAllocate(pLarge);
+
+		//Fill the largest class, the next request goes to the heap
+		pAllocator->GetSizeClassStats(SMALL_OBJECT_CLASS_COUNT - 1, Stats);
+		unsigned long ulFailed = Stats.m_ulFailedAllocations;
+
+		while (Stats.m_ulLiveCount < Stats.m_ulCapacity)
+		{
+			UTPointers.push_back(pAllocator->Allocate(SMALL_OBJECT_MAX_SIZE));
+			pAllocator->GetSizeClassStats(SMALL_OBJECT_CLASS_COUNT - 1, Stats);
+		}
+
+		void *pOverflow = pAllocator->Allocate(SMALL_OBJECT_MAX_SIZE);
+		assert(false == pAllocator->Contains(pOverflow));
+		pAllocator->GetSizeClassStats(SMALL_OBJECT_CLASS_COUNT - 1, Stats);
+		assert(Stats.m_ulFailedAllocations == ulFailed + 1);
+		assert(Stats.m_ulHighWaterMark == Stats.m_ulCapacity);
+		pAllocator->DeAllocate(pOverflow, SMALL_OBJECT_MAX_SIZE);
+
+		for (unsigned long i = 0; i < UTPointers.size(); i++)
+		{
+			pAllocator->DeAllocate(UTPointers[i], SMALL_OBJECT_MAX_SIZE);
+		}
+
+		char *pName = SmallStrDup("SmallObjectAllocator");
+		assert(0 == strcmp(pName, "SmallObjectAllocator"));
+		SmallFree(pName);
+
+		float *pFloats = SmallNewArray<float>(10);
+		assert(pAllocator->Contains(pFloats));
+		SmallDeleteArray(pFloats, 10);
+
+		assert(pAllocator->GetInternalFragmentation() >= 0.0f);
+		assert(pAllocator->GetInternalFragmentation() < 0.5f);
+	#endif
+	}
+}
+
+#ifdef SMALL_OBJECT_GLOBAL_NEW
+void * operator new(size_t i_size)
+{
+	return Engine::SmallObjectAllocator::GetInstance()->Allocate(i_size);
+}
+
+void * operator new[](size_t i_size)
+{
+	return Engine::SmallObjectAllocator::GetInstance()->Allocate(i_size);
+}
+
+void operator delete(void * i_ptr)
+{
+	Engine::SmallObjectAllocator::GetInstance()->DeAllocate(i_ptr);
+}
+
+void operator delete[](void * i_ptr)
+{
+	Engine::SmallObjectAllocator::GetInstance()->DeAllocate(i_ptr);
+}
+#endif
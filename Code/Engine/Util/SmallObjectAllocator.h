@@ -0,0 +1,108 @@
+#ifndef __SMALL_OBJECT_ALLOCATOR_HEADER
+#define __SMALL_OBJECT_ALLOCATOR_HEADER
+
+#include "PreCompiled.h"
+
+#include <stdint.h>
+#include <atomic>
+
+#include "MemoryPool.h"
+
+#define SMALL_OBJECT_MIN_SIZE		16
+#define SMALL_OBJECT_MAX_SIZE		512
+#define SMALL_OBJECT_CLASS_COUNT	11
+#define SMALL_OBJECT_GRANULARITY	8
+
+//Define to send every global new/delete through the small object allocator
+//#define SMALL_OBJECT_GLOBAL_NEW
+
+namespace Engine
+{
+	//Size class allocator for 16 to 512 byte blocks. Every size class is a free
+	//list MemoryPool carved out of one reserved region, larger requests and
+	//requests to a full class go to the heap.
+	class SmallObjectAllocator
+	{
+	public:
+		struct sSizeClassStats
+		{
+			unsigned long m_ulSlotSize;
+			unsigned long m_ulCapacity;
+			unsigned long m_ulLiveCount;
+			unsigned long m_ulHighWaterMark;
+			unsigned long m_ulAllocations;
+			unsigned long m_ulFailedAllocations;		//Class was full, went to the heap
+		};
+
+	private:
+		struct sSizeClass
+		{
+			MemoryPool		*m_pPool;
+			sSizeClassStats	m_Stats;
+		};
+
+		sSizeClass		m_SizeClasses[SMALL_OBJECT_CLASS_COUNT];
+		unsigned char	m_SizeToClass[(SMALL_OBJECT_MAX_SIZE / SMALL_OBJECT_GRANULARITY) + 1];
+		char			*m_pRegion;
+		unsigned long	m_ulRegionBytes;
+		ePageBacking	m_eRegionBacking;
+		unsigned long	m_ulHeapAllocations;
+		uint64_t		m_RequestedBytes;
+		uint64_t		m_HandedOutBytes;
+		std::atomic_flag m_Lock;
+		bool			mInitilized;
+
+		static SmallObjectAllocator * mInstance;
+		static const unsigned long SizeClassSlotSizes[SMALL_OBJECT_CLASS_COUNT];
+
+		SmallObjectAllocator(const unsigned long i_ulRegionBytes);
+		~SmallObjectAllocator();
+		SmallObjectAllocator(const SmallObjectAllocator & i_Other);
+		SmallObjectAllocator & operator=(const SmallObjectAllocator & i_rhs);
+
+		inline void Lock(void);
+		inline void Unlock(void);
+		long FindSizeClass(const void *pPointer) const;
+		void DeAllocateFromClass(void *pPointer, const long i_lClass);
+
+	public:
+		static const unsigned long DEFAULT_REGION_BYTES = 4 * 1024 * 1024;
+
+		static bool CreateInstance(const unsigned long i_ulRegionBytes = DEFAULT_REGION_BYTES);
+		static SmallObjectAllocator * GetInstance();
+		static void Destroy();
+
+		void *Allocate(const size_t i_size);
+		void DeAllocate(void *pPointer);
+		void DeAllocate(void *pPointer, const size_t i_size);
+		bool Contains(const void *pPointer) const;
+
+		void GetSizeClassStats(const unsigned long i_ulClass, sSizeClassStats &o_Stats) const;
+		unsigned long GetHeapAllocations(void) const;
+		float GetUtilization(void) const;
+		float GetInternalFragmentation(void) const;
+		void PrintStats(void) const;
+	};
+
+	//Derive from this to opt a class in to the small object allocator
+	class SmallObject
+	{
+	public:
+		static void * operator new(size_t i_size);
+		static void operator delete(void * i_ptr, size_t i_size);
+	};
+
+	template<class T>
+	T * SmallNewArray(const unsigned long i_ulCount);
+	template<class T>
+	void SmallDeleteArray(T *i_pArray, const unsigned long i_ulCount);
+
+	char * SmallStrDup(const char *i_pString);
+	void SmallFree(void *i_pPointer);
+
+	void SmallObjectAllocator_UnitTest(void);
+}
+
+#include "SmallObjectAllocator.inl"
+
+#endif //__SMALL_OBJECT_ALLOCATOR_HEADER
@@ -0,0 +1,60 @@
+#include "PreCompiled.h"
+
+#include <new>
+
+namespace Engine
+{
+	inline void SmallObjectAllocator::Lock(void)
+	{
+		while (m_Lock.test_and_set(std::memory_order_acquire))
+		{
+		}
+	}
+
+	inline void SmallObjectAllocator::Unlock(void)
+	{
+		m_Lock.clear(std::memory_order_release);
+	}
+
+	inline void * SmallObject::operator new(size_t i_size)
+	{
+		return SmallObjectAllocator::GetInstance()->Allocate(i_size);
+	}
+
+	inline void SmallObject::operator delete(void * i_ptr, size_t i_size)
+	{
+		if (i_ptr)
+		{
+			SmallObjectAllocator::GetInstance()->DeAllocate(i_ptr, i_size);
+		}
+	}
+
+	template<class T>
+	inline T * SmallNewArray(const unsigned long i_ulCount)
+	{
+		T *pArray = static_cast<T *>(SmallObjectAllocator::GetInstance()->Allocate(sizeof(T) * i_ulCount));
+
+		for (unsigned long i = 0; i < i_ulCount; i++)
+		{
+			new (&pArray[i]) T();
+		}
+
+		return pArray;
+	}
+
+	template<class T>
+	inline void SmallDeleteArray(T *i_pArray, const unsigned long i_ulCount)
+	{
+		if (NULL == i_pArray)
+		{
+			return;
+		}
+
+		for (unsigned long i = 0; i < i_ulCount; i++)
+		{
+			i_pArray[i].~T();
+		}
+
+		SmallObjectAllocator::GetInstance()->DeAllocate(i_pArray, sizeof(T) * i_ulCount);
+	}
+}
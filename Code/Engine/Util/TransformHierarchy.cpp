@@ -0,0 +1,540 @@
+#include "PreCompiled.h"
+
+#include <algorithm>
+
+#include "TransformHierarchy.h"
+#include "Actor.h"
+#include "ActorTable.h"
+#include "Vector4.h"
+#include "Debug.h"
+
+namespace Engine
+{
+	TransformHierarchy * TransformHierarchy::mInstance = NULL;
+
+	TransformHierarchy::TransformHierarchy(void):
+		m_bSorted(true),
+		m_bHasOrphans(false),
+		mInitilized(true)
+	{
+		ActorTable::GetInstance()->AddDestroyedCallback(&TransformHierarchy::OnActorDestroyed);
+	}
+
+	TransformHierarchy::~TransformHierarchy()
+	{
+		ActorTable::GetInstance()->RemoveDestroyedCallback(&TransformHierarchy::OnActorDestroyed);
+	}
+
+	bool TransformHierarchy::CreateInstance()
+	{
+		if (mInstance == NULL)
+		{
+			mInstance = new TransformHierarchy();
+
+			if (mInstance == NULL)
+			{
+				return false;
+			}
+
+			if (mInstance->mInitilized == false)
+			{
+				delete mInstance;
+				mInstance = NULL;
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	TransformHierarchy * TransformHierarchy::GetInstance()
+	{
+		if (mInstance != NULL)
+		{
+			return mInstance;
+		}
+
+		assert(false);
+
+		return NULL;
+	}
+
+	void TransformHierarchy::Destroy()
+	{
+		if (mInstance)
+		{
+			delete mInstance;
+			mInstance = NULL;
+		}
+	}
+
+	void TransformHierarchy::OnActorDestroyed(Actor &i_Actor)
+	{
+		GetInstance()->Remove(i_Actor.GetEntity());
+	}
+
+	unsigned long TransformHierarchy::FindNode(const EntityId i_Entity) const
+	{
+		if (i_Entity < m_NodeOfEntity.size())
+		{
+			return m_NodeOfEntity[i_Entity];
+		}
+
+		return NO_TRANSFORM_NODE;
+	}
+
+	//Node of the entity, a new one is added at the top of its own hierarchy
+	unsigned long TransformHierarchy::AddNode(const EntityId i_Entity)
+	{
+		unsigned long ulNode = FindNode(i_Entity);
+
+		if (NO_TRANSFORM_NODE != ulNode)
+		{
+			return ulNode;
+		}
+
+		//The id may be one a removed parent had, its old children must not take it
+		DetachOrphans();
+
+		sNode Node;
+		Node.m_Entity = i_Entity;
+		Node.m_Parent = INVALID_ENTITY;
+		Node.m_ulParentNode = NO_TRANSFORM_NODE;
+		Node.m_ulDepth = 0;
+		Node.m_LocalPosition = Vector3(0.0f, 0.0f, 0.0f);
+		Node.m_fLocalRotation = 0.0f;
+		Node.m_bLocalDirty = false;
+
+		ulNode = static_cast<unsigned long>(m_Nodes.size());
+		m_Nodes.push_back(Node);
+
+		if (i_Entity >= m_NodeOfEntity.size())
+		{
+			m_NodeOfEntity.resize(i_Entity + 1, NO_TRANSFORM_NODE);
+		}
+
+		m_NodeOfEntity[i_Entity] = ulNode;
+		m_bSorted = false;
+
+		return ulNode;
+	}
+
+	//Children of removed entities go to the top of their own hierarchies
+	void TransformHierarchy::DetachOrphans(void)
+	{
+		if (false == m_bHasOrphans)
+		{
+			return;
+		}
+
+		for (unsigned long ulNode = 0; ulNode < m_Nodes.size(); ulNode++)
+		{
+			const EntityId Parent = m_Nodes[ulNode].m_Parent;
+
+			if ((INVALID_ENTITY != Parent) && (NO_TRANSFORM_NODE == FindNode(Parent)))
+			{
+				m_Nodes[ulNode].m_Parent = INVALID_ENTITY;
+			}
+		}
+
+		m_bHasOrphans = false;
+	}
+
+	/******************************************************************************
+		Function     : SetParent
+		Description  : Attaches the child to the parent, or detaches it with
+					INVALID_ENTITY. The child stays where it is in the world,
+					its offset from the parent is taken from there
+		Input        : const EntityId i_Child, const EntityId i_Parent
+		Output       :
+		Return Value : bool, false if the parent is below the child
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	bool TransformHierarchy::SetParent(const EntityId i_Child, const EntityId i_Parent)
+	{
+		assert((INVALID_ENTITY != i_Child) && (i_Child != i_Parent));
+
+		EntityStore *pStore = EntityStore::GetInstance();
+		const sTransform *pChildTransform = pStore->GetComponent<sTransform>(i_Child);
+		assert(pChildTransform);
+
+		if (INVALID_ENTITY == i_Parent)
+		{
+			const unsigned long ulNode = FindNode(i_Child);
+
+			if ((NO_TRANSFORM_NODE != ulNode) && (INVALID_ENTITY != m_Nodes[ulNode].m_Parent))
+			{
+				m_Nodes[ulNode].m_Parent = INVALID_ENTITY;
+				m_bSorted = false;
+			}
+
+			return true;
+		}
+
+		const sTransform *pParentTransform = pStore->GetComponent<sTransform>(i_Parent);
+		assert(pParentTransform);
+
+		for (EntityId Ancestor = i_Parent; INVALID_ENTITY != Ancestor; )
+		{
+			if (Ancestor == i_Child)
+			{
+				CONSOLE_PRINT("Entity %lu is above entity %lu, it cannot be attached to it", i_Child, i_Parent);
+				return false;
+			}
+
+			const unsigned long ulAncestorNode = FindNode(Ancestor);
+			Ancestor = (NO_TRANSFORM_NODE == ulAncestorNode) ? INVALID_ENTITY : m_Nodes[ulAncestorNode].m_Parent;
+		}
+
+		(void)AddNode(i_Parent);
+		sNode &Child = m_Nodes[AddNode(i_Child)];
+
+		//From where the parent is now, it may have moved since its matrices were built
+		sTransform Parent = *pParentTransform;
+		Parent.UpdateMatrices();
+
+		Child.m_Parent = i_Parent;
+		Child.m_LocalPosition = (Parent.mWorldToLocal * Vector4(pChildTransform->mPosition, 1.0f)).GetAsVector3();
+		Child.m_fLocalRotation = pChildTransform->mRotation - Parent.mRotation;
+		Child.m_bLocalDirty = false;
+		m_bSorted = false;
+
+		return true;
+	}
+
+	EntityId TransformHierarchy::GetParent(const EntityId i_Child) const
+	{
+		const unsigned long ulNode = FindNode(i_Child);
+
+		if (NO_TRANSFORM_NODE == ulNode)
+		{
+			return INVALID_ENTITY;
+		}
+
+		//A removed parent may not be detached yet
+		const EntityId Parent = m_Nodes[ulNode].m_Parent;
+
+		return ((INVALID_ENTITY == Parent) || (NO_TRANSFORM_NODE == FindNode(Parent))) ? INVALID_ENTITY : Parent;
+	}
+
+	//Offset of an attached child from its parent, in the parent's space
+	void TransformHierarchy::SetLocalPosition(const EntityId i_Child, const Vector3 &i_Position)
+	{
+		const unsigned long ulNode = FindNode(i_Child);
+		assert((NO_TRANSFORM_NODE != ulNode) && (INVALID_ENTITY != m_Nodes[ulNode].m_Parent));
+
+		m_Nodes[ulNode].m_LocalPosition = i_Position;
+		m_Nodes[ulNode].m_bLocalDirty = true;
+	}
+
+	void TransformHierarchy::SetLocalRotation(const EntityId i_Child, const float i_Rotation)
+	{
+		const unsigned long ulNode = FindNode(i_Child);
+		assert((NO_TRANSFORM_NODE != ulNode) && (INVALID_ENTITY != m_Nodes[ulNode].m_Parent));
+
+		m_Nodes[ulNode].m_fLocalRotation = i_Rotation;
+		m_Nodes[ulNode].m_bLocalDirty = true;
+	}
+
+	//Drops the node of a destroyed entity, its children stay where they are
+	//in the world at the top of their own hierarchies. The last node takes
+	//its place, the children are detached by the next Sort or AddNode so a
+	//queue of deaths costs O(1) each
+	void TransformHierarchy::Remove(const EntityId i_Entity)
+	{
+		const unsigned long ulNode = FindNode(i_Entity);
+
+		if (NO_TRANSFORM_NODE == ulNode)
+		{
+			return;
+		}
+
+		const unsigned long ulLast = static_cast<unsigned long>(m_Nodes.size()) - 1;
+
+		if (ulNode != ulLast)
+		{
+			m_Nodes[ulNode] = m_Nodes[ulLast];
+			m_NodeOfEntity[m_Nodes[ulNode].m_Entity] = ulNode;
+		}
+
+		m_Nodes.pop_back();
+		m_NodeOfEntity[i_Entity] = NO_TRANSFORM_NODE;
+		m_bHasOrphans = true;
+		m_bSorted = false;
+	}
+
+	/******************************************************************************
+		Function     : Sort
+		Description  : Puts the nodes in breadth first order after attaching,
+					detaching or removing, children of removed entities become
+					roots. Sorted by depth, then every level
+					by the index of the parent in the level above, which is
+					already in place
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void TransformHierarchy::Sort(void)
+	{
+		DetachOrphans();
+
+		for (unsigned long ulNode = 0; ulNode < m_Nodes.size(); ulNode++)
+		{
+			unsigned long ulDepth = 0;
+
+			for (EntityId Parent = m_Nodes[ulNode].m_Parent; INVALID_ENTITY != Parent; Parent = m_Nodes[m_NodeOfEntity[Parent]].m_Parent)
+			{
+				ulDepth++;
+			}
+
+			m_Nodes[ulNode].m_ulDepth = ulDepth;
+		}
+
+		std::stable_sort(m_Nodes.begin(), m_Nodes.end(), [](const sNode &i_Left, const sNode &i_Right)
+		{
+			return i_Left.m_ulDepth < i_Right.m_ulDepth;
+		});
+
+		unsigned long ulLevelStart = 0;
+
+		while (ulLevelStart < m_Nodes.size())
+		{
+			unsigned long ulLevelEnd = ulLevelStart;
+
+			while ((ulLevelEnd < m_Nodes.size()) && (m_Nodes[ulLevelEnd].m_ulDepth == m_Nodes[ulLevelStart].m_ulDepth))
+			{
+				ulLevelEnd++;
+			}
+
+			//m_NodeOfEntity is already updated for the levels above
+			for (unsigned long ulNode = ulLevelStart; ulNode < ulLevelEnd; ulNode++)
+			{
+				const EntityId Parent = m_Nodes[ulNode].m_Parent;
+				m_Nodes[ulNode].m_ulParentNode = (INVALID_ENTITY == Parent) ? NO_TRANSFORM_NODE : m_NodeOfEntity[Parent];
+			}
+
+			std::stable_sort(m_Nodes.begin() + ulLevelStart, m_Nodes.begin() + ulLevelEnd, [](const sNode &i_Left, const sNode &i_Right)
+			{
+				return i_Left.m_ulParentNode < i_Right.m_ulParentNode;
+			});
+
+			for (unsigned long ulNode = ulLevelStart; ulNode < ulLevelEnd; ulNode++)
+			{
+				m_NodeOfEntity[m_Nodes[ulNode].m_Entity] = ulNode;
+			}
+
+			ulLevelStart = ulLevelEnd;
+		}
+
+		m_Moved.resize(m_Nodes.size());
+		m_bSorted = true;
+	}
+
+	/******************************************************************************
+		Function     : Update
+		Description  : Places the children whose parent moved or whose offset
+					changed, and rebuilds the matrices of every node that
+					moved, in one walk over the nodes. A child moved in the
+					world by itself keeps its new place and takes its offset
+					from there
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void TransformHierarchy::Update(void)
+	{
+		if (false == m_bSorted)
+		{
+			Sort();
+		}
+
+		EntityStore *pStore = EntityStore::GetInstance();
+
+		for (unsigned long ulNode = 0; ulNode < m_Nodes.size(); ulNode++)
+		{
+			sNode &Node = m_Nodes[ulNode];
+			sTransform &Transform = *pStore->GetComponent<sTransform>(Node.m_Entity);
+
+			if (NO_TRANSFORM_NODE != Node.m_ulParentNode)
+			{
+				//Came earlier in the walk, its matrices are up to date
+				const sTransform &Parent = *pStore->GetComponent<sTransform>(m_Nodes[Node.m_ulParentNode].m_Entity);
+
+				if (Node.m_bLocalDirty || m_Moved[Node.m_ulParentNode])
+				{
+					Transform.mPosition = (Parent.mLocalToWorld * Vector4(Node.m_LocalPosition, 1.0f)).GetAsVector3();
+					Transform.mRotation = Parent.mRotation + Node.m_fLocalRotation;
+					Transform.mDirty = true;
+				}
+				else if (Transform.mDirty)
+				{
+					Node.m_LocalPosition = (Parent.mWorldToLocal * Vector4(Transform.mPosition, 1.0f)).GetAsVector3();
+					Node.m_fLocalRotation = Transform.mRotation - Parent.mRotation;
+				}
+
+				Node.m_bLocalDirty = false;
+			}
+
+			m_Moved[ulNode] = Transform.mDirty ? 1 : 0;
+
+			if (Transform.mDirty)
+			{
+				Transform.UpdateMatrices();
+			}
+		}
+	}
+
+	//Unit test helpers
+	static EntityId UTCreate(const Vector3 &i_Position, const float i_Rotation)
+	{
+		EntityId Entity = EntityStore::GetInstance()->CreateEntity<sTransform>();
+		sTransform *pTransform = EntityStore::GetInstance()->GetComponent<sTransform>(Entity);
+
+		pTransform->mPosition = i_Position;
+		pTransform->mRotation = i_Rotation;
+		pTransform->UpdateMatrices();
+
+		return Entity;
+	}
+
+	static bool UTIsAt(const EntityId i_Entity, const Vector3 &i_Position)
+	{
+		const sTransform *pTransform = EntityStore::GetInstance()->GetComponent<sTransform>(i_Entity);
+
+		return (false == pTransform->mDirty) && ((pTransform->mPosition - i_Position).Length() < 0.001f);
+	}
+
+	/******************************************************************************
+		Function     : TransformHierarchy_UnitTest
+		Description  : UnitTest function to test attaching in any order,
+					placing children when the parent or the offset changes,
+					leaving other hierarchies alone, re-parenting, cycles and
+					removing a parent
+		Input        : void
+		Output       :
+		Return Value : void
+
+		History      :
+		Author       : Vinod VM
+		Modification : Created function
+	******************************************************************************/
+	void TransformHierarchy_UnitTest(void)
+	{
+	#ifdef _DEBUG
+		//Run before the game creates its own entity store, actor table and hierarchy
+		EntityStore::CreateInstance();
+		ActorTable::CreateInstance();
+		TransformHierarchy::CreateInstance();
+
+		EntityStore *pStore = EntityStore::GetInstance();
+		TransformHierarchy *pHierarchy = TransformHierarchy::GetInstance();
+
+		EntityId Root = UTCreate(Vector3(0.0f, 0.0f, 0.0f), 0.0f);
+		EntityId Child = UTCreate(Vector3(2.0f, 0.0f, 0.0f), 0.0f);
+		EntityId GrandChild = UTCreate(Vector3(3.0f, 0.0f, 0.0f), 0.0f);
+		EntityId Other = UTCreate(Vector3(-5.0f, 0.0f, 0.0f), 0.0f);
+		EntityId OtherChild = UTCreate(Vector3(-5.0f, 1.0f, 0.0f), 0.0f);
+
+		//Bottom up, Sort has to put the root first
+		assert(pHierarchy->SetParent(GrandChild, Child));
+		assert(pHierarchy->SetParent(Child, Root));
+		assert(pHierarchy->SetParent(OtherChild, Other));
+		assert(5 == pHierarchy->GetNodeCount());
+		assert(Child == pHierarchy->GetParent(GrandChild));
+		assert(INVALID_ENTITY == pHierarchy->GetParent(Root));
+
+		//Attaching does not move anything
+		pHierarchy->Update();
+		assert(UTIsAt(Child, Vector3(2.0f, 0.0f, 0.0f)));
+		assert(UTIsAt(GrandChild, Vector3(3.0f, 0.0f, 0.0f)));
+
+		//Moving and turning the root carries the subtree, the other hierarchy
+		//is not touched, its child would snap back to (-5, 1, 0) otherwise
+		sTransform *pRoot = pStore->GetComponent<sTransform>(Root);
+		pRoot->mPosition = Vector3(10.0f, 0.0f, 0.0f);
+		pRoot->mRotation = 90.0f;
+		pRoot->mDirty = true;
+		pStore->GetComponent<sTransform>(OtherChild)->mPosition = Vector3(100.0f, 0.0f, 0.0f);
+
+		pHierarchy->Update();
+		assert(UTIsAt(Root, Vector3(10.0f, 0.0f, 0.0f)));
+		assert(UTIsAt(Child, Vector3(10.0f, 2.0f, 0.0f)));
+		assert(UTIsAt(GrandChild, Vector3(10.0f, 3.0f, 0.0f)));
+		assert(90.0f == pStore->GetComponent<sTransform>(GrandChild)->mRotation);
+		assert(UTIsAt(OtherChild, Vector3(100.0f, 0.0f, 0.0f)));
+		pStore->GetComponent<sTransform>(OtherChild)->mPosition = Vector3(-5.0f, 1.0f, 0.0f);
+
+		//A new offset places only that child
+		pHierarchy->SetLocalPosition(GrandChild, Vector3(0.0f, 1.0f, 0.0f));
+		pHierarchy->Update();
+		assert(UTIsAt(GrandChild, Vector3(9.0f, 2.0f, 0.0f)));
+
+		//Re-parented, it keeps its place and follows the new parent only
+		assert(pHierarchy->SetParent(GrandChild, Other));
+		pHierarchy->Update();
+		assert(UTIsAt(GrandChild, Vector3(9.0f, 2.0f, 0.0f)));
+
+		pRoot = pStore->GetComponent<sTransform>(Root);
+		pRoot->mPosition = Vector3(0.0f, 0.0f, 0.0f);
+		pRoot->mDirty = true;
+		sTransform *pOther = pStore->GetComponent<sTransform>(Other);
+		pOther->mPosition = Vector3(-4.0f, 0.0f, 0.0f);
+		pOther->mDirty = true;
+
+		pHierarchy->Update();
+		assert(UTIsAt(Child, Vector3(0.0f, 2.0f, 0.0f)));
+		assert(UTIsAt(GrandChild, Vector3(10.0f, 2.0f, 0.0f)));
+		assert(UTIsAt(OtherChild, Vector3(-4.0f, 1.0f, 0.0f)));
+
+		//No cycles
+		assert(false == pHierarchy->SetParent(Other, GrandChild));
+		assert(false == pHierarchy->SetParent(Root, Child));
+
+		//Children of a removed parent stay where they are
+		pHierarchy->Remove(Root);
+		assert(4 == pHierarchy->GetNodeCount());
+		assert(INVALID_ENTITY == pHierarchy->GetParent(Child));
+
+		//The removed root's id comes back for the next entity, its old child
+		//must not end up below it
+		pStore->DestroyEntity(Root);
+		EntityId Reused = UTCreate(Vector3(0.0f, 5.0f, 0.0f), 0.0f);
+		assert(Root == Reused);
+		assert(pHierarchy->SetParent(Reused, Other));
+		assert(INVALID_ENTITY == pHierarchy->GetParent(Child));
+
+		pHierarchy->Update();
+		assert(UTIsAt(Child, Vector3(0.0f, 2.0f, 0.0f)));
+
+		assert(pHierarchy->SetParent(GrandChild, INVALID_ENTITY));
+		assert(INVALID_ENTITY == pHierarchy->GetParent(GrandChild));
+		pOther = pStore->GetComponent<sTransform>(Other);
+		pOther->mPosition = Vector3(0.0f, 0.0f, 0.0f);
+		pOther->mDirty = true;
+		pHierarchy->Update();
+		assert(UTIsAt(GrandChild, Vector3(10.0f, 2.0f, 0.0f)));
+		assert(UTIsAt(OtherChild, Vector3(0.0f, 1.0f, 0.0f)));
+
+		pStore->DestroyEntity(Reused);
+		pStore->DestroyEntity(Child);
+		pStore->DestroyEntity(GrandChild);
+		pStore->DestroyEntity(Other);
+		pStore->DestroyEntity(OtherChild);
+
+		TransformHierarchy::Destroy();
+		ActorTable::Destroy();
+		EntityStore::Destroy();
+	#endif
+	}
+}
@@ -0,0 +1,82 @@
+#ifndef __TRANSFORM_HIERARCHY_HEADER
+#define __TRANSFORM_HIERARCHY_HEADER
+
+#include "PreCompiled.h"
+
+#include <vector>
+
+#include "Vector3.h"
+#include "EntityStore.h"
+
+namespace Engine
+{
+	class Actor;
+
+	static const unsigned long NO_TRANSFORM_NODE = 0xffffffff;
+
+	//Parent and child links between the transforms of entities. Only entities
+	//that are a parent or a child have a node. The nodes are kept breadth
+	//first, a level after the one before and children of one parent next to
+	//each other, so Update places every child after its parent in one walk
+	//over the array. A child keeps its position and rotation relative to the
+	//parent, its sTransform is rebuilt from them when the parent moved or
+	//they changed, any other subtree is left alone.
+	//Attaching and detaching is done on the main thread while no frame task
+	//that touches actors runs, like creating actors. The local placement of
+	//a child may be changed from the actor update of that child.
+	class TransformHierarchy
+	{
+		struct sNode
+		{
+			EntityId		m_Entity;
+			EntityId		m_Parent;				//INVALID_ENTITY at the top of a hierarchy, or a removed entity until DetachOrphans
+			unsigned long	m_ulParentNode;			//Index of the parent node, valid while sorted
+			unsigned long	m_ulDepth;
+			Vector3			m_LocalPosition;
+			float			m_fLocalRotation;
+			bool			m_bLocalDirty;
+		};
+
+		std::vector<sNode>			m_Nodes;			//Breadth first while m_bSorted
+		std::vector<unsigned long>	m_NodeOfEntity;		//Indexed by entity, NO_TRANSFORM_NODE if it has none
+		std::vector<unsigned char>	m_Moved;			//Per node, set by Update when its transform was rebuilt
+		bool						m_bSorted;
+		bool						m_bHasOrphans;		//Remove left children pointing at an entity without a node
+		bool						mInitilized;
+
+		static TransformHierarchy	*mInstance;
+
+		TransformHierarchy(void);
+		~TransformHierarchy();
+		TransformHierarchy(const TransformHierarchy & i_Other);
+		TransformHierarchy & operator=(const TransformHierarchy & i_rhs);
+
+		static void OnActorDestroyed(Actor &i_Actor);
+		unsigned long FindNode(const EntityId i_Entity) const;
+		unsigned long AddNode(const EntityId i_Entity);
+		void DetachOrphans(void);
+		void Sort(void);
+
+	public:
+		static bool CreateInstance();
+		static TransformHierarchy * GetInstance();
+		static void Destroy();
+
+		bool SetParent(const EntityId i_Child, const EntityId i_Parent);
+		EntityId GetParent(const EntityId i_Child) const;
+		void SetLocalPosition(const EntityId i_Child, const Vector3 &i_Position);
+		void SetLocalRotation(const EntityId i_Child, const float i_Rotation);
+		void Remove(const EntityId i_Entity);
+		void Update(void);
+
+		//Entities with a node, the parents and children
+		inline unsigned long GetNodeCount(void) const
+		{
+			return static_cast<unsigned long>(m_Nodes.size());
+		}
+	};
+
+	void TransformHierarchy_UnitTest(void);
+}
+
+#endif //__TRANSFORM_HIERARCHY_HEADER
@@ -0,0 +1,36 @@
+#ifndef __WEAK_POINTER_HEADER
+#define __WEAK_POINTER_HEADER
+#include "PreCompiled.h"
+
+#include "SharedPointer.h"
+
+namespace Engine
+{
+	//Non owning reference to an object held by SharedPointer, Lock returns a
+	//SharedPointer that is null once every owner is gone
+	template<class T, class RefCountPolicy>
+	class WeakPointer
+	{
+	private:
+		typedef sSharedControlBlock<RefCountPolicy> ControlBlock;
+
+		T * m_pPtr;
+		ControlBlock * m_pControlBlock;
+		void Destroy(void);
+	public:
+		WeakPointer(void);
+		WeakPointer(const SharedPointer<T, RefCountPolicy> & i_Shared);
+		WeakPointer(const WeakPointer<T, RefCountPolicy> & i_Other);
+		WeakPointer<T, RefCountPolicy> & operator=(const WeakPointer<T, RefCountPolicy> &i_rhs);
+		WeakPointer<T, RefCountPolicy> & operator=(const SharedPointer<T, RefCountPolicy> &i_rhs);
+
+		bool IsExpired(void) const;
+		SharedPointer<T, RefCountPolicy> Lock(void) const;
+
+		~WeakPointer(void);
+	};
+}
+
+#include "WeakPointer.inl"
+
+#endif //__WEAK_POINTER_HEADER
@@ -0,0 +1,102 @@
+namespace Engine
+{
+	/******************************************************************************
+	Function     : WeakPointer functions
+	Description  : Weak references only keep the control block alive, the
+				object is destroyed with its last SharedPointer
+	Input        :
+	Output       :
+	Return Value :
+
+	History      :
+	Author       : Vinod VM
+	Modification : Created function
+	******************************************************************************/
+
+	template<class T, class RefCountPolicy>
+	WeakPointer<T, RefCountPolicy>::WeakPointer(void):
+		m_pPtr(NULL),
+		m_pControlBlock(&SharedPointer<T, RefCountPolicy>::sNullControlBlock)
+	{
+		RefCountPolicy::Increment(m_pControlBlock->m_WeakCount);
+	}
+
+	template<class T, class RefCountPolicy>
+	WeakPointer<T, RefCountPolicy>::WeakPointer(const SharedPointer<T, RefCountPolicy> &i_Shared):
+		m_pPtr(i_Shared.m_pPtr),
+		m_pControlBlock(i_Shared.m_pControlBlock)
+	{
+		assert(m_pControlBlock != nullptr);
+
+		RefCountPolicy::Increment(m_pControlBlock->m_WeakCount);
+	}
+
+	template<class T, class RefCountPolicy>
+	WeakPointer<T, RefCountPolicy>::WeakPointer(const WeakPointer<T, RefCountPolicy> &i_Other):
+		m_pPtr(i_Other.m_pPtr),
+		m_pControlBlock(i_Other.m_pControlBlock)
+	{
+		assert(m_pControlBlock != nullptr);
+
+		RefCountPolicy::Increment(m_pControlBlock->m_WeakCount);
+	}
+
+	template<class T, class RefCountPolicy>
+	void WeakPointer<T, RefCountPolicy>::Destroy(void)
+	{
+		assert(m_pControlBlock != nullptr);
+
+		if (RefCountPolicy::Decrement(m_pControlBlock->m_WeakCount) == 0)
+		{
+			m_pControlBlock->m_pFreeBlock(m_pControlBlock);
+		}
+	}
+
+	template<class T, class RefCountPolicy>
+	WeakPointer<T, RefCountPolicy> & WeakPointer<T, RefCountPolicy>::operator=(const WeakPointer<T, RefCountPolicy> &i_rhs)
+	{
+		RefCountPolicy::Increment(i_rhs.m_pControlBlock->m_WeakCount);
+
+		Destroy();
+		m_pPtr = i_rhs.m_pPtr;
+		m_pControlBlock = i_rhs.m_pControlBlock;
+
+		return *this;
+	}
+
+	template<class T, class RefCountPolicy>
+	WeakPointer<T, RefCountPolicy> & WeakPointer<T, RefCountPolicy>::operator=(const SharedPointer<T, RefCountPolicy> &i_rhs)
+	{
+		RefCountPolicy::Increment(i_rhs.m_pControlBlock->m_WeakCount);
+
+		Destroy();
+		m_pPtr = i_rhs.m_pPtr;
+		m_pControlBlock = i_rhs.m_pControlBlock;
+
+		return *this;
+	}
+
+	template<class T, class RefCountPolicy>
+	bool WeakPointer<T, RefCountPolicy>::IsExpired(void) const
+	{
+		return (NULL == m_pPtr) || (0 == RefCountPolicy::Load(m_pControlBlock->m_StrongCount));
+	}
+
+	template<class T, class RefCountPolicy>
+	SharedPointer<T, RefCountPolicy> WeakPointer<T, RefCountPolicy>::Lock(void) const
+	{
+		//Another thread may drop the last owner between a check and the increment
+		if ((NULL == m_pPtr) || (false == RefCountPolicy::IncrementIfNotZero(m_pControlBlock->m_StrongCount)))
+		{
+			return SharedPointer<T, RefCountPolicy>();
+		}
+
+		return SharedPointer<T, RefCountPolicy>(m_pPtr, m_pControlBlock);
+	}
+
+	template<class T, class RefCountPolicy>
+	WeakPointer<T, RefCountPolicy>::~WeakPointer(void)
+	{
+		Destroy();
+	}
+}
@@ -76,10 +76,12 @@ namespace Camera
 #if 0
 		else
 		{
-			if (m_pOtherActor != NULL && !m_pOtherActor->IsMarkedForDeath())
+			Actor *OtherActor = ActorTable::GetInstance()->Resolve(m_OtherActor);
+
+			if (OtherActor != NULL && !OtherActor->IsMarkedForDeath())
 			{
-				float OtherActorsXLocation = m_pOtherActor->GetPosition().x();
-				float OtherActorsZLocation = m_pOtherActor->GetPosition().z();
+				float OtherActorsXLocation = OtherActor->GetPosition().x();
+				float OtherActorsZLocation = OtherActor->GetPosition().z();
 				// I'm looking at someone
 				if (Engine::CameraSystem::GetInstance())
 				{
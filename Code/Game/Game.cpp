@@ -24,6 +24,16 @@
 #include "LightController.h"
 #include "Win32Management.h"
 #include "DebugLineRenderer.h"
+#include "FrameArena.h"
+#include "LevelArena.h"
+#include "EntityStore.h"
+#include "ActorTable.h"
+#include "JobSystem.h"
+#include "FrameGraph.h"
+#include "TransformHierarchy.h"
+#include "SmallObjectAllocator.h"
+#include "PoolStats.h"
+#include "Profiling.h"
 #include "../Engine/UserSettings/UserSettings.h"
 
 #ifdef _DEBUG
@@ -32,6 +42,12 @@
 	#include <stdlib.h>
 #endif
 
+//Actors marked during the frame go at its end, each system drops its part in a callback
+static void DestroyMarkedActorsTask(const Engine::sFrameTime &i_Time)
+{
+	Engine::ActorTable::GetInstance()->DestroyMarkedActors();
+}
+
 MainGame::MainGame():
 	mInitilized(false)
 
@@ -52,6 +68,67 @@ bool MainGame::Initilize(const HINSTANCE i_thisInstanceOfTheProgram, const int i
 		return mInitilized;
 	}
 
+	mInitilized = Engine::FrameArena::CreateInstance();
+
+	if (mInitilized == false)
+	{
+		Engine::DebugPrint("Failed to Create FrameArena Instance");
+		return mInitilized;
+	}
+
+	mInitilized = Engine::LevelArena::CreateInstance();
+
+	if (mInitilized == false)
+	{
+		Engine::DebugPrint("Failed to Create LevelArena Instance");
+		return mInitilized;
+	}
+
+	//One worker per core, this thread is worker 0
+	mInitilized = Engine::JobSystem::CreateInstance();
+
+	if (mInitilized == false)
+	{
+		Engine::DebugPrint("Failed to Create JobSystem Instance");
+		return mInitilized;
+	}
+
+	//Pipelined, a frame is drawn while the workers update the next one
+	mInitilized = Engine::FrameGraph::CreateInstance(true);
+
+	if (mInitilized == false)
+	{
+		Engine::DebugPrint("Failed to Create FrameGraph Instance");
+		return mInitilized;
+	}
+
+	//Actors keep their components in the entity store, it has to outlive them
+	mInitilized = Engine::EntityStore::CreateInstance();
+
+	if (mInitilized == false)
+	{
+		Engine::DebugPrint("Failed to Create EntityStore Instance");
+		return mInitilized;
+	}
+
+	//Owns the actors, systems refer to them by handle
+	mInitilized = Engine::ActorTable::CreateInstance();
+
+	if (mInitilized == false)
+	{
+		Engine::DebugPrint("Failed to Create ActorTable Instance");
+		return mInitilized;
+	}
+
+	//Parent and child actors, it drops the links of destroyed actors
+	mInitilized = Engine::TransformHierarchy::CreateInstance();
+
+	if (mInitilized == false)
+	{
+		Engine::DebugPrint("Failed to Create TransformHierarchy Instance");
+		return mInitilized;
+	}
+
 	HWND mainWindowHandle = Win32Management::WindowsManager::GetInstance()->GetReferenceToMainWindowHandle();
 
 	mInitilized = Engine::RenderableObjectSystem::CreateInstance(mainWindowHandle);
@@ -103,22 +180,24 @@ bool MainGame::Initilize(const HINSTANCE i_thisInstanceOfTheProgram, const int i
 		return false;
 	}
 
-	std::vector< SharedPointer<Actor>> PlayerActorsList = WorldSystem::GetInstance()->FindActorsByType("Player");
+	ActorSpan PlayerActorsList = WorldSystem::GetInstance()->FindActorsByType("Player");
 	
 	Player::CreateControllerAndCollisionHandler();
 
 	for (unsigned int i = 0; i < PlayerActorsList.size(); i++)
 	{
-		PlayerActorsList.at(i)->SetController(Player::GetController());
-		PlayerActorsList.at(i)->SetCollisionHandler(Player::GetCollisionHandler());
+		Actor *pPlayer = ActorTable::GetInstance()->Resolve(PlayerActorsList[i]);
+
+		pPlayer->SetController(Player::GetController());
+		pPlayer->SetCollisionHandler(Player::GetCollisionHandler());
 	}
 
 	Camera::CreateController();
 	Camera::GetController()->SetOtherActorReference(PlayerActorsList[0]);
-	CameraSystem::GetInstance()->m_WorldObject->SetController(Camera::GetController());
+	CameraSystem::GetInstance()->GetActor()->SetController(Camera::GetController());
 	
 	Light::CreateController();
-	LightingSystem::GetInstance()->m_WorldObject->SetController(Light::GetController());
+	LightingSystem::GetInstance()->GetActor()->SetController(Light::GetController());
 
 	const Engine::sRectangle Spritetextcoord = Engine::sRectangle(0.0f, 1.0f, 0.0f, 1.0f);
 	float left = 0.55f;
@@ -135,6 +214,19 @@ bool MainGame::Initilize(const HINSTANCE i_thisInstanceOfTheProgram, const int i
 
 	RenderableObjectSystem::GetInstance()->CreateDebugLines("ActorDebugLine", 30);
 
+	//In the order the systems used to run, tasks that do not share data may
+	//run at the same time
+	FrameGraph *pFrameGraph = FrameGraph::GetInstance();
+	WorldSystem::AddFrameTasks(*pFrameGraph);
+	CollisionSystem::AddFrameTasks(*pFrameGraph);
+	PhysicsSystem::AddFrameTasks(*pFrameGraph);
+	CameraSystem::AddFrameTasks(*pFrameGraph);
+	LightingSystem::AddFrameTasks(*pFrameGraph);
+	RenderableObjectSystem::AddFrameTasks(*pFrameGraph);
+	pFrameGraph->AddTask("DestroyMarkedActors", &DestroyMarkedActorsTask, 0,
+						 pFrameGraph->GetResource("Actors") | pFrameGraph->GetResource("Entities"), FrameGraph::TASK_MAIN_THREAD);
+	pFrameGraph->SetFixedStep(UserSettings::GetSimulationRate(), UserSettings::GetMaxSimulationSteps());
+
 	return mInitilized;
 }
 
@@ -150,7 +242,6 @@ int MainGame::Run(void)
 	unsigned int SpriteCount = 0;
 	
 	using namespace Engine;
-	std::vector< SharedPointer<Actor>> CubeActorsList = WorldSystem::GetInstance()->FindActorsByType("Cube");
 
 	//Game Loop
 	if (mInitilized)
@@ -160,13 +251,11 @@ int MainGame::Run(void)
 		{
 			GameTimer.CalculateFrameTime();
 			float DeltaTime = static_cast<float>(GameTimer.GetLastFrameMS());
-			Engine::WorldSystem::GetInstance()->ActorsUpdate(DeltaTime);
-			Engine::CollisionSystem::GetInstance()->Update(DeltaTime);
-			Engine::PhysicsSystem::GetInstance()->ApplyEulerPhysics(DeltaTime);
-			Engine::CameraSystem::GetInstance()->Update(DeltaTime);
-			Engine::LightingSystem::GetInstance()->Update(DeltaTime);
-			
-			Engine::RenderableObjectSystem::GetInstance()->Render();
+
+			//Starts this frame and finishes the one before, this frame's
+			//updates keep running on the workers after it returns
+			Engine::FrameGraph::GetInstance()->RunFrame(DeltaTime);
+
 			Win32Management::WindowsManager::GetInstance()->UpdateMainWindow(exitCode, QuitRequested);
 			
 			Engine::RenderableObjectSystem::RenderableSprites * NumbersSprite = Engine::RenderableObjectSystem::GetInstance()->FindSpriteGameObjectByName("data/numbers.dds");
@@ -180,7 +269,12 @@ int MainGame::Run(void)
 				NumbersSprite->GetSprite()->FillSpriteSheet(SpriteCount);
 				SpriteCount = (SpriteCount + 1) % MaxHorizontalCount;
 			}
+
+			Engine::FrameArena::GetInstance()->EndFrame();
+			Engine::PoolRegistry::EndFrame();
 		} while (QuitRequested == false);
+
+		Engine::FrameGraph::GetInstance()->Flush();
 	}
 
 	Engine::DebugPrint("End of Game Loop");
@@ -193,15 +287,30 @@ void MainGame::Shutdown(const HINSTANCE i_thisInstanceOfTheProgram)
 {
 	if (mInitilized)
 	{
+		//Pools unregister when their system is destroyed, print while they are all alive
+		PROFILE_PRINT_RESULTS();
+		Engine::FrameGraph::GetInstance()->PrintCriticalPath();
+		Engine::FrameGraph::Destroy();
+
+		//Workers hand their pool magazines back on the way out, while every pool is alive
+		Engine::JobSystem::Destroy();
 		Player::ShutDown();
 		Camera::ShutDown();
 		Engine::PhysicsSystem::Destroy();
+		Engine::CollisionSystem::Destroy();
 		Engine::UserInput::Destroy();
 		Engine::WorldSystem::Destroy();
 		Engine::CameraSystem::Destroy();
 		Engine::LightingSystem::Destroy();
 		Engine::RenderableObjectSystem::Destroy();
+		Engine::TransformHierarchy::Destroy();
+		Engine::ActorTable::Destroy();
+		Engine::EntityStore::Destroy();
+		Engine::UnloadLevel();
+		Engine::LevelArena::Destroy();
 		Win32Management::WindowsManager::Destroy();
+		Engine::FrameArena::Destroy();
+		Engine::SmallObjectAllocator::Destroy();
 	}
 
 	Engine::DebugPrint("ShutDown");
@@ -176,11 +176,11 @@ namespace Light
 
 		if (KeyPressed == true)
 		{
-			Vector3 CurrentXZPosition = Engine::LightingSystem::GetInstance()->m_WorldObject->GetPosition();
+			Vector3 CurrentXZPosition = Engine::LightingSystem::GetInstance()->GetActor()->GetPosition();
 
 			CurrentXZPosition += Offset * i_DeltaTime;
 
-			Engine::LightingSystem::GetInstance()->m_WorldObject->SetPosition(CurrentXZPosition);
+			Engine::LightingSystem::GetInstance()->GetActor()->SetPosition(CurrentXZPosition);
 
 			Vector3 Direction = Engine::LightingSystem::GetInstance()->GetLightDirection();
 
@@ -28,12 +28,12 @@ namespace Player
 		{
 			assert(ThisCollisionObject && OtherCollisionObject);
 
-			unsigned int MyCollisionBit = ThisCollisionObject->m_WorldObject->mCollidesWithBitIndex;
-			unsigned int OtherObjectCollisionBit = OtherCollisionObject->m_WorldObject->mClassBitIndex;
+			unsigned int MyCollisionBit = ThisCollisionObject->GetActor()->mCollidesWithBitIndex;
+			unsigned int OtherObjectCollisionBit = OtherCollisionObject->GetActor()->mClassBitIndex;
 
 			if (MyCollisionBit & OtherObjectCollisionBit)
 			{
-				Engine::DebugPrint("%s Collided with %s", ThisCollisionObject->m_WorldObject->GetName(), OtherCollisionObject->m_WorldObject->GetName());
+				Engine::DebugPrint("%s Collided with %s", ThisCollisionObject->GetActor()->GetName(), OtherCollisionObject->GetActor()->GetName());
 			}
 		}
 	};